@@ -0,0 +1,128 @@
+#ifndef WLED_HOST_ARDUINO_H
+#define WLED_HOST_ARDUINO_H
+
+/*
+ * Minimal Arduino core for host (Linux) builds of the effect engine, see test/host/wled_host.h
+ * Time is real (steady clock) unless frozen with hostSetMillis() so frames can be rendered at exact times.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <arpa/inet.h> // htons()/htonl() (lwip on ESP32)
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define IRAM_ATTR
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define F(s) (s)
+#define FPSTR(s) (s)
+#define SET_F(s) (s)
+
+#define pgm_read_byte(a)        (*(const uint8_t *)(a))
+#define pgm_read_byte_near(a)   (*(const uint8_t *)(a))
+#define pgm_read_word(a)        (*(a))
+#define pgm_read_dword(a)       (*(a)) // also used for pointer tables, so not truncated to 32 bit
+#define pgm_read_ptr(a)         (*(void * const *)(a))
+#define memcpy_P   memcpy
+#define strlen_P   strlen
+#define strcpy_P   strcpy
+#define strncpy_P  strncpy
+#define strcmp_P   strcmp
+#define strncmp_P  strncmp
+#define strstr_P   strstr
+#define sprintf_P  sprintf
+#define snprintf_P snprintf
+#define strcat_P   strcat
+#define strcasecmp_P strcasecmp
+#define printf_P   printf
+
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size) { size_t n = len < size - 1 ? len : size - 1; memcpy(dst, src, n); dst[n] = 0; }
+  return len;
+}
+inline size_t strlcat(char *dst, const char *src, size_t size) {
+  size_t len = strnlen(dst, size);
+  return len == size ? size + strlen(src) : len + strlcpy(dst + len, src, size - len);
+}
+#define strlcpy_P strlcpy
+#define strlcat_P strlcat
+
+#ifndef PI
+#define PI      3.1415926535897932384626433832795
+#endif
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI  6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define sq(x) ((x)*(x))
+#define word(h, l) ((uint16_t)(((h) << 8) | (l)))
+#define radians(deg) ((deg)*DEG_TO_RAD)
+#define degrees(rad) ((rad)*RAD_TO_DEG)
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+using std::min;
+using std::max;
+using std::abs;
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  if (in_max == in_min) return out_min;
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#include "WString.h"
+#include "Print.h"
+#include "IPAddress.h"
+#include "Esp.h"
+#include "HardwareSerial.h"
+
+uint32_t millis();
+uint32_t micros();
+void     delay(uint32_t ms);
+void     delayMicroseconds(uint32_t us);
+void     yield();
+long     random(long howbig);
+long     random(long howsmall, long howbig);
+void     randomSeed(unsigned long seed);
+
+// FreeRTOS task notifications (as used by ESP32 render workers), tasks are std::threads,
+// the "core" a task is pinned to is its worker ID (any number of cores, see WLED_RENDER_WORKERS)
+typedef int          BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t     TickType_t;
+typedef struct HostTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+#define pdFALSE       0
+#define pdTRUE        1
+#define pdPASS        1
+#define portMAX_DELAY 0xFFFFFFFFUL
+BaseType_t   xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio, TaskHandle_t *task, BaseType_t core);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+BaseType_t   xTaskNotifyGive(TaskHandle_t task);
+uint32_t     ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+BaseType_t   xPortGetCoreID();
+typedef std::mutex portMUX_TYPE; // critical sections are only entered for a few instructions
+#define portMUX_INITIALIZER_UNLOCKED {}
+#define portENTER_CRITICAL(mux) (mux)->lock()
+#define portEXIT_CRITICAL(mux)  (mux)->unlock()
+
+// host clock control (tests)
+void     hostSetMillis(uint32_t ms); // freezes millis()/micros() at given time (must not be before current time)
+void     hostRealTime();             // real time again (default), continues from frozen time
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef WLED_HOST_ASYNCTCP_H
+#define WLED_HOST_ASYNCTCP_H
+
+/*
+ * AsyncTCP for host builds: a client that is not connected (HTTP requests) or collects the data written to it
+ * (WS clients), data is sent right away and the send buffer is always empty
+ */
+
+#include <Arduino.h>
+#include <string>
+
+#define HOST_TCP_SND_BUF 5744 // CONFIG_TCP_SND_BUF_DEFAULT of ESP32
+
+class AsyncClient {
+  public:
+    bool      connected() { return _connected && !_closed; }
+    void      close(bool now = false) { _closed = true; }
+    void      abort() { _closed = true; }
+    IPAddress remoteIP()  { return IPAddress(); }
+    bool      canSend() { return connected(); }
+    size_t    space()   { return connected() ? HOST_TCP_SND_BUF : 0; }
+    size_t    add(const char *data, size_t size, uint8_t apiflags = 0) {
+      if (size > space()) return 0;
+      _sent.append(data, size);
+      return size;
+    }
+    bool      send() { return connected(); }
+
+    // host
+    bool      closed() const { return _closed; } // connection was dropped by the handler
+    void      hostConnect() { _connected = true; }
+    std::string &sent() { return _sent; } // data written since connected (may be consumed by the test)
+  private:
+    bool _closed = false;
+    bool _connected = false;
+    std::string _sent;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef WLED_HOST_ASYNCUDP_H
+#define WLED_HOST_ASYNCUDP_H
+
+/*
+ * AsyncUDP for host builds: listeners are accepted but never receive (E1.31/DDP input is not used on host)
+ */
+
+#include <Arduino.h>
+#include <functional>
+
+class AsyncUDPPacket {
+  public:
+    uint8_t  *data()          { return nullptr; }
+    size_t    length()        { return 0; }
+    IPAddress remoteIP()      { return IPAddress(); }
+    uint16_t  remotePort()    { return 0; }
+    IPAddress localIP()       { return IPAddress(); }
+    uint16_t  localPort()     { return 0; }
+    bool      isBroadcast()   { return false; }
+    bool      isMulticast()   { return false; }
+};
+
+typedef std::function<void(AsyncUDPPacket &packet)> AuPacketHandlerFunction;
+
+class AsyncUDP {
+  public:
+    bool listen(uint16_t port) { return true; }
+    bool listenMulticast(const IPAddress addr, uint16_t port, uint8_t ttl = 1) { return true; }
+    void onPacket(AuPacketHandlerFunction cb) {}
+    void close() {}
+    bool connected() { return true; }
+};
+
+#endif
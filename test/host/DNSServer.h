@@ -0,0 +1,11 @@
+#ifndef WLED_HOST_DNSSERVER_H
+#define WLED_HOST_DNSSERVER_H
+
+// captive portal DNS server: not running on host
+class DNSServer {
+  public:
+    void processNextRequest() {}
+    void stop() {}
+};
+
+#endif
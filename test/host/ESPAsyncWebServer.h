@@ -0,0 +1,338 @@
+#ifndef WLED_HOST_ESPASYNCWEBSERVER_H
+#define WLED_HOST_ESPASYNCWEBSERVER_H
+
+/*
+ * ESPAsyncWebServer for host builds: the types firmware modules use, requests and responses are recorded
+ * (a test can hand a request to a handler and read the response), there is no server
+ */
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include "AsyncTCP.h"
+#include "LittleFS.h"
+
+typedef enum {
+  HTTP_GET     = 0b00000001,
+  HTTP_POST    = 0b00000010,
+  HTTP_DELETE  = 0b00000100,
+  HTTP_PUT     = 0b00001000,
+  HTTP_PATCH   = 0b00010000,
+  HTTP_HEAD    = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY     = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+
+typedef std::function<size_t(uint8_t *buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+class AsyncWebParameter {
+  public:
+    AsyncWebParameter(const String &name, const String &value, bool form = false, bool file = false)
+    : _name(name), _value(value), _isForm(form), _isFile(file) {}
+    const String &name() const  { return _name; }
+    const String &value() const { return _value; }
+    bool isPost() const { return _isForm; }
+    bool isFile() const { return _isFile; }
+  private:
+    String _name, _value;
+    bool _isForm, _isFile;
+};
+
+class AsyncWebServerResponse {
+  public:
+    AsyncWebServerResponse() : _code(0), _contentLength(0), _sentLength(0) {}
+    virtual ~AsyncWebServerResponse() {}
+    void setCode(int code) { _code = code; }
+    void setContentLength(size_t len) { _contentLength = len; }
+    void setContentType(const String &type) { _contentType = type; }
+    void addHeader(const String &name, const String &value) { _headers.push_back(name + ": " + value); }
+    int  code() const { return _code; }
+    const String &contentType() const { return _contentType; }
+    const std::vector<String> &headers() const { return _headers; }
+    virtual bool _sourceValid() const { return false; }
+    // whole body, as the server would send it (RESPONSE_TRY_AGAIN is retried)
+    virtual String body() { return _content; }
+  protected:
+    int    _code;
+    String _contentType;
+    size_t _contentLength;
+    size_t _sentLength;
+    String _content;
+    std::vector<String> _headers;
+};
+
+class AsyncAbstractResponse : public AsyncWebServerResponse {
+  public:
+    virtual bool   _sourceValid() const { return false; }
+    virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) { return 0; }
+    String body() {
+      String s;
+      uint8_t buf[1460];
+      for (int tries = 0; tries < 10000; ) {
+        size_t len = _fillBuffer(buf, sizeof(buf));
+        if (len == RESPONSE_TRY_AGAIN) { tries++; yield(); continue; }
+        if (len == 0) break;
+        s.concat((const char *)buf, len);
+        _sentLength += len;
+        if (_contentLength && _sentLength >= _contentLength) break;
+      }
+      return s;
+    }
+};
+
+class AsyncCallbackResponse : public AsyncAbstractResponse {
+  public:
+    AsyncCallbackResponse(const String &contentType, size_t len, AwsResponseFiller callback) : _callback(callback) {
+      _code = 200; _contentType = contentType; _contentLength = len;
+    }
+    bool   _sourceValid() const { return !!_callback; }
+    size_t _fillBuffer(uint8_t *buf, size_t maxLen) {
+      if (_contentLength && maxLen > _contentLength - _sentLength) maxLen = _contentLength - _sentLength;
+      return _callback(buf, maxLen, _sentLength);
+    }
+  private:
+    AwsResponseFiller _callback;
+};
+
+class AsyncWebServerRequest {
+  public:
+    AsyncWebServerRequest(const String &url = "/", WebRequestMethodComposite method = HTTP_GET)
+    : _tempObject(nullptr), _url(url), _method(method), _response(nullptr) {}
+    ~AsyncWebServerRequest() { delete _response; free(_tempObject); }
+
+    void *_tempObject;
+
+    const String &url() const { return _url; }
+    WebRequestMethodComposite method() const { return _method; }
+    AsyncClient *client() { return &_client; }
+    void addInterestingHeader(const String &) {}
+    void onDisconnect(std::function<void(void)>) {}
+
+    void addParam(const String &name, const String &value, bool post = false) { _params.emplace_back(name, value, post); }
+    size_t params() const { return _params.size(); }
+    AsyncWebParameter *getParam(size_t i) { return i < _params.size() ? &_params[i] : nullptr; }
+    AsyncWebParameter *getParam(const String &name, bool post = false, bool file = false) {
+      for (auto &p : _params) if (p.name() == name && p.isPost() == post) return &p;
+      return nullptr;
+    }
+    bool hasParam(const String &name, bool post = false, bool file = false) { return getParam(name, post, file) != nullptr; }
+    bool hasArg(const char *name) { for (auto &p : _params) if (p.name() == name) return true; return false; }
+    const String &arg(const String &name) { static String empty; for (auto &p : _params) if (p.name() == name) return p.value(); return empty; }
+    bool hasHeader(const String &) const { return false; }
+    String header(const String &) const { return String(); }
+
+    AsyncWebServerResponse *beginResponse(int code, const String &contentType = String(), const String &content = String()) {
+      AsyncWebServerResponse *r = new ContentResponse(code, contentType, content);
+      return r;
+    }
+    AsyncWebServerResponse *beginResponse(const String &contentType, size_t len, AwsResponseFiller callback) {
+      return new AsyncCallbackResponse(contentType, len, callback);
+    }
+    AsyncWebServerResponse *beginResponse_P(int code, const String &contentType, const uint8_t *content, size_t len) {
+      return new ContentResponse(code, contentType, String(std::string((const char *)content, len)));
+    }
+    AsyncWebServerResponse *beginChunkedResponse(const String &contentType, AwsResponseFiller callback) {
+      return new AsyncCallbackResponse(contentType, 0, callback);
+    }
+    void send(AsyncWebServerResponse *response) { delete _response; _response = response; }
+    void send(int code, const String &contentType = String(), const String &content = String()) { send(beginResponse(code, contentType, content)); }
+    void send(HostFS &fs, const String &path, const String &contentType = String()) {
+      File f = fs.open(path, "r");
+      String content;
+      for (int c; f && (c = f.read()) >= 0; ) content += (char)c;
+      send(f ? 200 : 404, contentType, content);
+    }
+    void send_P(int code, const String &contentType, const char *content) { send(code, contentType, String(content)); }
+    void send_P(int code, const String &contentType, const uint8_t *content, size_t len) { send(beginResponse_P(code, contentType, content, len)); }
+
+    // test side
+    AsyncWebServerResponse *response() { return _response; }
+
+  private:
+    class ContentResponse : public AsyncWebServerResponse {
+      public:
+        ContentResponse(int code, const String &contentType, const String &content) { _code = code; _contentType = contentType; _content = content; }
+        bool _sourceValid() const { return true; }
+    };
+
+    String _url;
+    WebRequestMethodComposite _method;
+    AsyncWebServerResponse *_response;
+    AsyncClient _client;
+    std::vector<AsyncWebParameter> _params;
+};
+
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, const String &filename, size_t index, uint8_t *data, size_t len, bool final)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)> ArBodyHandlerFunction;
+
+class AsyncWebHandler {
+  public:
+    virtual ~AsyncWebHandler() {}
+    virtual bool canHandle(AsyncWebServerRequest *request) { return false; }
+    virtual void handleRequest(AsyncWebServerRequest *request) {}
+    virtual void handleUpload(AsyncWebServerRequest *request, const String &filename, size_t index, uint8_t *data, size_t len, bool final) {}
+    virtual void handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {}
+    virtual bool isRequestHandlerTrivial() { return true; }
+};
+
+class AsyncWebServer {
+  public:
+    AsyncWebServer(uint16_t port) {}
+    void begin() {}
+    void end() {}
+    AsyncWebHandler &addHandler(AsyncWebHandler *handler) { return *handler; }
+    bool removeHandler(AsyncWebHandler *handler) { return true; }
+};
+
+// web sockets: clients are added by the test (hostAddClient()), which also calls wsEvent() like the server would;
+// messages queued for a client are sent right away (frames are acknowledged as soon as they are written)
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+typedef enum { WS_DISCONNECTED, WS_CONNECTED, WS_DISCONNECTING } AwsClientStatus;
+typedef enum { WS_CONTINUATION, WS_TEXT, WS_BINARY, WS_DISCONNECT = 0x08, WS_PING, WS_PONG } AwsFrameType;
+typedef enum { WS_MSG_SENDING, WS_MSG_SENT, WS_MSG_ERROR } AwsMessageStatus;
+
+typedef struct {
+  uint8_t  message_opcode; // of the message the frame belongs to
+  uint32_t num;            // frame number within message
+  uint8_t  final;
+  uint8_t  masked;
+  uint8_t  opcode;         // of the frame
+  uint64_t len;            // of the frame
+  uint8_t  mask[4];
+  uint64_t index;          // of data within frame
+} AwsFrameInfo;
+
+class AsyncWebSocketMessageBuffer {
+  public:
+    AsyncWebSocketMessageBuffer(size_t size) : _data(size), _lock(false) {}
+    uint8_t *get()         { return _data.data(); }
+    size_t   length() const { return _data.size(); }
+    void     lock()        { _lock = true; }
+    void     unlock()      { _lock = false; }
+    bool     canDelete() const { return !_lock; }
+  private:
+    std::vector<uint8_t> _data;
+    bool _lock;
+};
+
+class AsyncWebSocketMessage {
+  protected:
+    uint8_t _opcode;
+    bool _mask;
+    AwsMessageStatus _status;
+  public:
+    AsyncWebSocketMessage() : _opcode(WS_TEXT), _mask(false), _status(WS_MSG_ERROR) {}
+    virtual ~AsyncWebSocketMessage() {}
+    virtual void   ack(size_t len, uint32_t time) {}
+    virtual size_t send(AsyncClient *client) { return 0; }
+    virtual bool   finished() { return _status != WS_MSG_SENDING; }
+    virtual bool   betweenFrames() const { return false; }
+};
+
+class AsyncWebSocketClient {
+  public:
+    AsyncWebSocketClient(uint32_t id) : _id(id) { _client.hostConnect(); }
+    uint32_t id() const { return _id; }
+    AwsClientStatus status() { return _client.connected() ? WS_CONNECTED : WS_DISCONNECTED; }
+    AsyncClient *client() { return &_client; }
+    bool queueIsFull() const { return false; }
+    size_t queueLength() const { return 0; }
+    void close(uint16_t code = 0) { _client.close(); }
+    void text(const char *message) { text(message, strlen(message)); }
+    void text(const char *message, size_t len) { if (status() == WS_CONNECTED) _texts.emplace_back(message, len); }
+    void text(const String &message) { text(message.c_str(), message.length()); }
+    void text(AsyncWebSocketMessageBuffer *buffer) { text((const char *)buffer->get(), buffer->length()); }
+    void binary(const uint8_t *message, size_t len) { if (status() == WS_CONNECTED) _binaries.emplace_back((const char *)message, len); }
+    void binary(AsyncWebSocketMessageBuffer *buffer) { binary(buffer->get(), buffer->length()); }
+    void message(AsyncWebSocketMessage *message) {
+      while (status() == WS_CONNECTED && !message->finished()) {
+        size_t before = _client.sent().size();
+        if (!message->send(&_client)) break;
+        message->ack(_client.sent().size() - before, 0);
+      }
+      delete message;
+      readFrames();
+    }
+
+    // test side: text messages (sent as text or in frames) and binary messages in the order they were sent
+    std::vector<std::string> &texts()    { return _texts; }
+    std::vector<std::string> &binaries() { return _binaries; }
+    bool framesValid() const { return _framesValid; } // data written to the connection was valid frames only
+  private:
+    uint32_t _id;
+    AsyncClient _client;
+    std::vector<std::string> _texts, _binaries;
+    std::string _message; // text message of continuation frames
+    bool _framesValid = true;
+
+    // unmasked frames with 7 or 16 bit length (frames written by messages)
+    void readFrames() {
+      std::string &data = _client.sent();
+      size_t pos = 0;
+      while (data.size() - pos >= 2) {
+        uint8_t opcode = data[pos] & 0x0F;
+        bool final = data[pos] & 0x80;
+        size_t len = (uint8_t)data[pos+1], header = 2;
+        if (len == 126) {
+          if (data.size() - pos < 4) break;
+          len = ((uint8_t)data[pos+2] << 8) | (uint8_t)data[pos+3];
+          header = 4;
+        } else if (len > 126) { _framesValid = false; break; }
+        if (data.size() - pos < header + len) break;
+        if (opcode == WS_TEXT) _message.clear();
+        else if (opcode != WS_CONTINUATION) _framesValid = false;
+        _message.append(data, pos + header, len);
+        if (final) _texts.push_back(_message);
+        pos += header + len;
+      }
+      data.erase(0, pos);
+    }
+};
+
+class AsyncWebSocket : public AsyncWebHandler {
+  public:
+    AsyncWebSocket(const String &url) {}
+    ~AsyncWebSocket() { for (auto c : _clients) delete c; _cleanBuffers(); }
+    size_t count() const {
+      size_t n = 0;
+      for (auto c : _clients) n += c->status() == WS_CONNECTED;
+      return n;
+    }
+    AsyncWebSocketClient *client(uint32_t id) {
+      for (auto c : _clients) if (c->id() == id && c->status() == WS_CONNECTED) return c;
+      return nullptr;
+    }
+    void cleanupClients(uint16_t maxClients = 4) {
+      for (auto c : _clients) if (count() > maxClients && c->status() == WS_CONNECTED) c->close(); // oldest first
+    }
+    void closeAll(uint16_t code = 0) { for (auto c : _clients) c->close(); }
+    void textAll(const char *message) { for (auto c : _clients) c->text(message); }
+    void textAll(const String &message) { for (auto c : _clients) c->text(message); }
+    AsyncWebSocketMessageBuffer *makeBuffer(size_t size = 0) {
+      AsyncWebSocketMessageBuffer *b = new AsyncWebSocketMessageBuffer(size);
+      _buffers.push_back(b);
+      return b;
+    }
+    void _cleanBuffers() {
+      for (size_t i = 0; i < _buffers.size(); ) {
+        if (_buffers[i]->canDelete()) { delete _buffers[i]; _buffers.erase(_buffers.begin() + i); }
+        else i++;
+      }
+    }
+
+    // test side: connected client (clients are kept until the server is destroyed)
+    AsyncWebSocketClient *hostAddClient() {
+      _clients.push_back(new AsyncWebSocketClient(++_lastId));
+      return _clients.back();
+    }
+  private:
+    std::vector<AsyncWebSocketClient *> _clients;
+    std::vector<AsyncWebSocketMessageBuffer *> _buffers;
+    uint32_t _lastId = 0;
+};
+
+#endif
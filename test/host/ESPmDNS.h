@@ -0,0 +1 @@
+// mDNS: not used by firmware modules built for the host
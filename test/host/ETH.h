@@ -0,0 +1,19 @@
+#ifndef WLED_HOST_ETH_H
+#define WLED_HOST_ETH_H
+
+/*
+ * Ethernet for host builds: not connected (network is WiFi, see WiFi.h)
+ */
+
+#include <Arduino.h>
+
+class ETHClass {
+  public:
+    IPAddress localIP()    { return IPAddress(); }
+    IPAddress subnetMask() { return IPAddress(); }
+    IPAddress gatewayIP()  { return IPAddress(); }
+    String    macAddress() { return String(); }
+};
+extern ETHClass ETH;
+
+#endif
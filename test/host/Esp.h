@@ -0,0 +1,42 @@
+#ifndef WLED_HOST_ESP_H
+#define WLED_HOST_ESP_H
+
+/*
+ * ESP32 system functions for host builds (see Arduino.h), a dual core ESP32 without PSRAM
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+class EspClass {
+  public:
+    uint32_t    getFreeHeap()      { return 200000; }
+    uint32_t    getHeapSize()      { return 320000; }
+    uint32_t    getMaxAllocHeap()  { return 100000; }
+    uint32_t    getFreePsram()     { return 0; }
+    uint32_t    getPsramSize()     { return 0; }
+    const char *getChipModel()     { return "host"; }
+    uint8_t     getChipRevision()  { return 0; }
+    uint8_t     getChipCores()     { return 2; }
+    uint32_t    getCpuFreqMHz()    { return 240; }
+    const char *getSdkVersion()    { return "host"; }
+    uint32_t    getFlashChipSize() { return 4 * 1024 * 1024; }
+    uint64_t    getEfuseMac()      { return 0; }
+    void        restart()          { exit(0); }
+};
+extern EspClass ESP;
+
+inline bool psramFound() { return false; }
+#define MALLOC_CAP_8BIT    0
+#define MALLOC_CAP_SPIRAM  0
+#define MALLOC_CAP_DEFAULT 0
+inline void *heap_caps_malloc(size_t size, uint32_t)            { return malloc(size); }
+inline void *heap_caps_calloc(size_t n, size_t size, uint32_t)  { return calloc(n, size); }
+inline void *heap_caps_realloc(void *p, size_t size, uint32_t)  { return realloc(p, size); }
+inline size_t heap_caps_get_free_size(uint32_t)                 { return 200000; }
+inline size_t heap_caps_get_largest_free_block(uint32_t)        { return 100000; }
+inline void *ps_malloc(size_t size)                             { return malloc(size); }
+inline void *ps_calloc(size_t n, size_t size)                   { return calloc(n, size); }
+int64_t esp_timer_get_time();
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef WLED_HOST_HARDWARESERIAL_H
+#define WLED_HOST_HARDWARESERIAL_H
+
+/*
+ * Serial for host builds: output goes to stdout, there is no input
+ */
+
+#include "Print.h"
+
+class HardwareSerial : public Stream {
+  public:
+    void   begin(unsigned long) {}
+    void   end() {}
+    void   updateBaudRate(unsigned long) {}
+    int    available() { return 0; }
+    int    read() { return -1; }
+    int    peek() { return -1; }
+    int    availableForWrite() { return 256; }
+    size_t write(uint8_t c) { return fwrite(&c, 1, 1, stdout); }
+    size_t write(const uint8_t *buf, size_t size) { return fwrite(buf, 1, size, stdout); }
+    using Print::write;
+    operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+#endif
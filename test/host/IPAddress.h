@@ -0,0 +1,48 @@
+#ifndef WLED_HOST_IPADDRESS_H
+#define WLED_HOST_IPADDRESS_H
+
+/*
+ * Arduino IPAddress for host builds (IPv4, network byte order like lwIP's ip4_addr)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "WString.h"
+
+class IPAddress {
+  public:
+    IPAddress() : _addr{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _addr{a, b, c, d} {}
+    IPAddress(uint32_t addr) { memcpy(_addr, &addr, 4); }
+    IPAddress(const uint8_t *addr) { memcpy(_addr, addr, 4); }
+
+    operator uint32_t() const { uint32_t a; memcpy(&a, _addr, 4); return a; }
+    bool operator==(const IPAddress &ip) const { return memcmp(_addr, ip._addr, 4) == 0; }
+    bool operator!=(const IPAddress &ip) const { return !(*this == ip); }
+    bool operator==(const uint8_t *addr) const { return memcmp(_addr, addr, 4) == 0; }
+    uint8_t operator[](int i) const { return _addr[i]; }
+    uint8_t &operator[](int i) { return _addr[i]; }
+
+    bool fromString(const char *s) {
+      unsigned a, b, c, d;
+      char end;
+      if (sscanf(s, "%u.%u.%u.%u%c", &a, &b, &c, &d, &end) != 4 || a > 255 || b > 255 || c > 255 || d > 255) return false;
+      *this = IPAddress(a, b, c, d);
+      return true;
+    }
+    bool fromString(const String &s) { return fromString(s.c_str()); }
+    String toString() const {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _addr[0], _addr[1], _addr[2], _addr[3]);
+      return String(buf);
+    }
+
+  private:
+    uint8_t _addr[4];
+};
+
+#undef INADDR_NONE // the IPAddress, not the in_addr_t of <netinet/in.h>
+extern const IPAddress INADDR_NONE;
+
+#endif
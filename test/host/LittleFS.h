@@ -0,0 +1,71 @@
+#ifndef WLED_HOST_LITTLEFS_H
+#define WLED_HOST_LITTLEFS_H
+
+/*
+ * LittleFS for host builds: files live in a temporary directory of the test process (empty at start,
+ * LittleFS.format() empties it), open modes and seek/write semantics are those of fopen() like on LittleFS
+ */
+
+#include <Arduino.h>
+#include <memory>
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Stream {
+  public:
+    File() {}
+    File(FILE *f, const char *name) : _f(f, fclose), _name(name) {}
+
+    operator bool() const { return !!_f; }
+    void   close() { _f.reset(); }
+    const char *name() const { return _name.c_str(); }
+    bool   isDirectory() const { return false; }
+
+    size_t write(uint8_t c) { return _f ? fwrite(&c, 1, 1, _f.get()) : 0; }
+    size_t write(const uint8_t *buf, size_t size) { return _f ? fwrite(buf, 1, size, _f.get()) : 0; }
+    using Print::write;
+    void   flush() { if (_f) fflush(_f.get()); }
+
+    int    read() { if (!_f) return -1; int c = fgetc(_f.get()); return c == EOF ? -1 : c; }
+    size_t read(uint8_t *buf, size_t size) { return _f ? fread(buf, 1, size, _f.get()) : 0; }
+    int    peek() { if (!_f) return -1; int c = fgetc(_f.get()); if (c == EOF) return -1; ungetc(c, _f.get()); return c; }
+    int    available() { return _f ? (int)(size() - position()) : 0; }
+    bool   seek(uint32_t pos, SeekMode mode = SeekSet) {
+      if (!_f) return false;
+      if (mode == SeekSet && pos > size()) return false; // LittleFS does not seek past the end
+      return fseek(_f.get(), pos, mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END) == 0;
+    }
+    size_t position() { return _f ? ftell(_f.get()) : 0; }
+    size_t size() {
+      if (!_f) return 0;
+      long pos = ftell(_f.get());
+      fseek(_f.get(), 0, SEEK_END);
+      long size = ftell(_f.get());
+      fseek(_f.get(), pos, SEEK_SET);
+      return size;
+    }
+
+  private:
+    std::shared_ptr<FILE> _f;
+    String _name;
+};
+
+class HostFS {
+  public:
+    bool   begin(bool formatOnFail = false) { return true; }
+    bool   format();
+    bool   exists(const char *path);
+    bool   exists(const String &path) { return exists(path.c_str()); }
+    File   open(const char *path, const char *mode = "r");
+    File   open(const String &path, const char *mode = "r") { return open(path.c_str(), mode); }
+    bool   remove(const char *path);
+    bool   remove(const String &path) { return remove(path.c_str()); }
+    bool   rename(const char *from, const char *to);
+    bool   rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+    size_t totalBytes() { return 1024 * 1024; }
+    size_t usedBytes();
+    String path(const char *path); // host path of a file
+};
+extern HostFS LittleFS;
+
+#endif
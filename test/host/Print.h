@@ -0,0 +1,87 @@
+#ifndef WLED_HOST_PRINT_H
+#define WLED_HOST_PRINT_H
+
+/*
+ * Arduino Print/Stream for host builds (see Arduino.h)
+ */
+
+#include <stdarg.h>
+#include "WString.h"
+
+class Print;
+
+class Printable {
+  public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size) {
+      size_t n = 0;
+      while (size-- && write(*buf++)) n++;
+      return n;
+    }
+    size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+    size_t write(const char *buf, size_t size) { return write((const uint8_t *)buf, size); }
+    virtual void flush() {}
+
+    size_t print(const char *s)    { return write(s); }
+    size_t print(const String &s)  { return write(s.c_str()); }
+    size_t print(char c)           { return write((uint8_t)c); }
+    size_t print(int v, int base = 10)           { return print(String(v, (unsigned char)base)); }
+    size_t print(unsigned v, int base = 10)      { return print(String(v, (unsigned char)base)); }
+    size_t print(long v, int base = 10)          { return print(String(v, (unsigned char)base)); }
+    size_t print(unsigned long v, int base = 10) { return print(String(v, (unsigned char)base)); }
+    size_t print(double v, int decimals = 2)     { return print(String(v, (unsigned char)decimals)); }
+    template<typename T> size_t println(T v) { size_t n = print(v); return n + print("\r\n"); }
+    template<typename T> size_t println(T v, int f) { size_t n = print(v, f); return n + print("\r\n"); }
+    size_t println() { return print("\r\n"); }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+      char buf[256];
+      va_list args;
+      va_start(args, format);
+      int len = vsnprintf(buf, sizeof(buf), format, args);
+      va_end(args);
+      return len > 0 ? write((const uint8_t *)buf, std::min((size_t)len, sizeof(buf) - 1)) : 0;
+    }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long) {}
+    size_t readBytes(uint8_t *buf, size_t len) {
+      size_t n = 0;
+      for (int c; n < len && (c = read()) >= 0; n++) buf[n] = c;
+      return n;
+    }
+    size_t readBytes(char *buf, size_t len) { return readBytes((uint8_t *)buf, len); }
+    size_t readBytesUntil(char terminator, char *buf, size_t len) {
+      size_t n = 0;
+      for (int c; n < len && (c = read()) >= 0 && c != terminator; n++) buf[n] = c;
+      return n;
+    }
+    String readStringUntil(char terminator) {
+      String s;
+      for (int c; (c = read()) >= 0 && c != terminator; ) s += (char)c;
+      return s;
+    }
+    bool find(const char *target) {
+      size_t len = strlen(target), matched = 0;
+      if (!len) return true;
+      for (int c; (c = read()) >= 0; ) {
+        if (c == target[matched]) { if (++matched == len) return true; }
+        else matched = (c == target[0]) ? 1 : 0;
+      }
+      return false;
+    }
+    bool find(char target) { char t[2] = {target, 0}; return find(t); }
+};
+
+#endif
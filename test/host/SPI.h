@@ -0,0 +1 @@
+// SPI: not used by firmware modules built for the host
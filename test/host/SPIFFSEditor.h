@@ -0,0 +1,2 @@
+// file editor: not served on host
+#define SPIFFS_EDITOR_AIRCOOOKIE
@@ -0,0 +1,132 @@
+#ifndef WLED_HOST_WSTRING_H
+#define WLED_HOST_WSTRING_H
+
+/*
+ * Arduino String for host builds, backed by std::string (see Arduino.h)
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <strings.h>
+#include <algorithm>
+#include <string>
+
+class __FlashStringHelper;
+
+class String {
+  public:
+    String() {}
+    String(const char *s) : _s(s ? s : "") {}
+    String(const std::string &s) : _s(s) {}
+    String(const String &s) = default;
+    explicit String(char c) : _s(1, c) {}
+    explicit String(unsigned char v, unsigned char base = 10) { setNum((unsigned long)v, base); }
+    explicit String(int v, unsigned char base = 10)           { setNum((long)v, base); }
+    explicit String(unsigned v, unsigned char base = 10)      { setNum((unsigned long)v, base); }
+    explicit String(long v, unsigned char base = 10)          { setNum(v, base); }
+    explicit String(unsigned long v, unsigned char base = 10) { setNum(v, base); }
+    explicit String(float v, unsigned char decimals = 2)      { setFloat(v, decimals); }
+    explicit String(double v, unsigned char decimals = 2)     { setFloat(v, decimals); }
+    String &operator=(const String &s) = default;
+    String &operator=(const char *s) { _s = s ? s : ""; return *this; }
+
+    const char *c_str() const        { return _s.c_str(); }
+    unsigned int length() const      { return _s.length(); }
+    bool isEmpty() const             { return _s.empty(); }
+    bool reserve(unsigned int size)  { _s.reserve(size); return true; }
+    char charAt(unsigned int i) const { return i < _s.length() ? _s[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    char &operator[](unsigned int i) { return _s[i]; }
+    void setCharAt(unsigned int i, char c) { if (i < _s.length()) _s[i] = c; }
+
+    bool concat(const String &s) { _s += s._s; return true; }
+    bool concat(const char *s)   { if (s) _s += s; return true; }
+    bool concat(const char *s, unsigned int len) { if (s) _s.append(s, len); return true; }
+    bool concat(char c)          { _s += c; return true; }
+    bool concat(int v)           { return concat(String(v)); }
+    bool concat(unsigned v)      { return concat(String(v)); }
+    bool concat(long v)          { return concat(String(v)); }
+    bool concat(unsigned long v) { return concat(String(v)); }
+    bool concat(float v)         { return concat(String(v)); }
+    bool concat(double v)        { return concat(String(v)); }
+    template<typename T> String &operator+=(const T &v) { concat(v); return *this; }
+
+    bool equals(const String &s) const     { return _s == s._s; }
+    bool equals(const char *s) const       { return _s == (s ? s : ""); }
+    bool equalsIgnoreCase(const String &s) const { return strcasecmp(c_str(), s.c_str()) == 0; }
+    bool operator==(const String &s) const { return equals(s); }
+    bool operator==(const char *s) const   { return equals(s); }
+    bool operator!=(const String &s) const { return !equals(s); }
+    bool operator!=(const char *s) const   { return !equals(s); }
+    bool operator<(const String &s) const  { return _s < s._s; }
+    int  compareTo(const String &s) const  { return _s.compare(s._s); }
+    bool startsWith(const String &s, unsigned int offset = 0) const { return _s.compare(offset, s.length(), s._s) == 0; }
+    bool endsWith(const String &s) const   { return _s.length() >= s.length() && _s.compare(_s.length() - s.length(), s.length(), s._s) == 0; }
+
+    int indexOf(char c, unsigned int from = 0) const            { return find(_s.find(c, from)); }
+    int indexOf(const String &s, unsigned int from = 0) const   { return find(_s.find(s._s, from)); }
+    int lastIndexOf(char c) const                               { return find(_s.rfind(c)); }
+    int lastIndexOf(const String &s) const                      { return find(_s.rfind(s._s)); }
+    String substring(unsigned int from) const                   { return from < _s.length() ? String(_s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const  { if (from > to) std::swap(from, to); return from < _s.length() ? String(_s.substr(from, to - from)) : String(); }
+
+    void replace(const String &find, const String &with) {
+      if (find.isEmpty()) return;
+      for (size_t pos = 0; (pos = _s.find(find._s, pos)) != std::string::npos; pos += with.length()) _s.replace(pos, find.length(), with._s);
+    }
+    void replace(char find, char with) { for (char &c : _s) if (c == find) c = with; }
+    void remove(unsigned int index)    { if (index < _s.length()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < _s.length()) _s.erase(index, count); }
+    void toLowerCase() { for (char &c : _s) c = tolower(c); }
+    void toUpperCase() { for (char &c : _s) c = toupper(c); }
+    void trim() {
+      size_t b = _s.find_first_not_of(" \t\r\n"), e = _s.find_last_not_of(" \t\r\n");
+      _s = b == std::string::npos ? "" : _s.substr(b, e - b + 1);
+    }
+    long  toInt() const   { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+    void  getBytes(unsigned char *buf, unsigned int len) const { toCharArray((char *)buf, len); }
+    void  toCharArray(char *buf, unsigned int len) const {
+      if (!len) return;
+      size_t n = std::min((size_t)len - 1, _s.length());
+      memcpy(buf, _s.data(), n);
+      buf[n] = 0;
+    }
+
+    // ArduinoJson writes to String (serializeJson(doc, string))
+    size_t write(uint8_t c) { _s += (char)c; return 1; }
+
+  private:
+    std::string _s;
+
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+    void setNum(unsigned long v, unsigned char base) {
+      char buf[33]; char *p = buf + sizeof(buf) - 1; *p = 0;
+      do { int d = v % base; *--p = d < 10 ? '0' + d : 'a' + d - 10; v /= base; } while (v);
+      _s = p;
+    }
+    void setNum(long v, unsigned char base) {
+      if (v < 0 && base == 10) { setNum((unsigned long)-v, base); _s.insert(0, 1, '-'); }
+      else setNum((unsigned long)v, base);
+    }
+    void setFloat(double v, unsigned char decimals) {
+      char buf[40];
+      snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+      _s = buf;
+    }
+};
+
+class StringSumHelper : public String {
+  public:
+    StringSumHelper(const String &s) : String(s) {}
+};
+
+inline StringSumHelper operator+(const String &a, const String &b) { StringSumHelper s(a); s.concat(b); return s; }
+inline StringSumHelper operator+(const String &a, const char *b)   { StringSumHelper s(a); s.concat(b); return s; }
+inline StringSumHelper operator+(const char *a, const String &b)   { StringSumHelper s{String(a)}; s.concat(b); return s; }
+inline StringSumHelper operator+(const String &a, char b)          { StringSumHelper s(a); s.concat(b); return s; }
+template<typename T> inline StringSumHelper operator+(const String &a, T b) { StringSumHelper s(a); s.concat(b); return s; }
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef WLED_HOST_WIFI_H
+#define WLED_HOST_WIFI_H
+
+/*
+ * WiFi for host builds: always connected with the host node address (see hostSetNetwork()), no scanning
+ */
+
+#include <Arduino.h>
+#include "WiFiUdp.h"
+
+typedef enum { WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL, WL_SCAN_COMPLETED, WL_CONNECTED, WL_CONNECT_FAILED, WL_CONNECTION_LOST, WL_DISCONNECTED } wl_status_t;
+typedef enum { WIFI_OFF = 0, WIFI_STA, WIFI_AP, WIFI_AP_STA } wifi_mode_t;
+typedef int WiFiEvent_t;
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+class WiFiClass {
+  public:
+    wl_status_t status()       { return WL_CONNECTED; }
+    IPAddress   localIP();
+    IPAddress   subnetMask();
+    IPAddress   gatewayIP();
+    IPAddress   softAPIP()     { return IPAddress(4, 3, 2, 1); }
+    String      macAddress()   { return String("02:00:00:00:00:01"); }
+    uint8_t    *macAddress(uint8_t *mac) { static const uint8_t m[6] = {2, 0, 0, 0, 0, 1}; memcpy(mac, m, 6); return mac; }
+    String      SSID()         { return String("host"); }
+    String      SSID(uint8_t)  { return String(); }
+    String      BSSIDstr()     { return String("00:00:00:00:00:00"); }
+    String      BSSIDstr(uint8_t) { return String(); }
+    int8_t      RSSI()         { return -50; }
+    int8_t      RSSI(uint8_t)  { return 0; }
+    int32_t     channel()      { return 1; }
+    int32_t     channel(uint8_t) { return 0; }
+    uint8_t     encryptionType(uint8_t) { return 0; }
+    int         getTxPower()   { return 78; }
+    bool        getSleep()     { return false; }
+    int16_t     scanNetworks(bool async = false) { return WIFI_SCAN_FAILED; }
+    int16_t     scanComplete() { return WIFI_SCAN_FAILED; }
+    void        scanDelete()   {}
+    wifi_mode_t getMode()      { return WIFI_STA; }
+    int         hostByName(const char *name, IPAddress &ip) { return 0; } // no DNS, NTP is not used on host
+};
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef WLED_HOST_WIFIUDP_H
+#define WLED_HOST_WIFIUDP_H
+
+/*
+ * WiFiUDP for host builds on POSIX sockets: packets are sent from the host node address (hostSetNetwork(),
+ * 127.0.0.x so several test processes can be separate nodes on the loopback interface), broadcasts and
+ * multicast groups joined with igmp_joingroup() are received by every node listening on the port.
+ * Received packets are delivered by parsePacket() after the latency set with hostSetLatency() (in order).
+ */
+
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+
+class WiFiUDP : public Stream {
+  public:
+    WiFiUDP() : _fd(-1), _groupFd(-1), _port(0), _rxPos(0), _remotePort(0), _txPort(0) {}
+    ~WiFiUDP() { stop(); }
+
+    uint8_t begin(uint16_t port);
+    uint8_t beginMulticast(IPAddress group, uint16_t port);
+    void    stop();
+
+    int    beginPacket(IPAddress ip, uint16_t port);
+    int    beginPacket(const char *host, uint16_t port) { IPAddress ip; return ip.fromString(host) && beginPacket(ip, port); }
+    int    endPacket();
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) { _tx.insert(_tx.end(), buf, buf + size); return size; }
+
+    int       parsePacket();
+    int       available() { return _rx.size() - _rxPos; }
+    int       read() { return available() > 0 ? _rx[_rxPos++] : -1; }
+    int       read(uint8_t *buf, size_t len);
+    int       read(char *buf, size_t len) { return read((uint8_t *)buf, len); }
+    int       peek() { return available() > 0 ? _rx[_rxPos] : -1; }
+    void      flush() { _rx.clear(); _rxPos = 0; }
+    IPAddress remoteIP() const { return _remoteIP; }
+    uint16_t  remotePort() const { return _remotePort; }
+
+  private:
+    int       _fd;      // unicast, bound to node address
+    int       _groupFd; // broadcasts and multicast groups joined by the node
+    uint16_t  _port;
+    std::vector<uint8_t> _rx;
+    size_t    _rxPos;
+    IPAddress _remoteIP;
+    uint16_t  _remotePort;
+    std::vector<uint8_t> _tx;
+    IPAddress _txIP;
+    uint16_t  _txPort;
+
+    struct Packet {
+      std::vector<uint8_t> data;
+      IPAddress ip;
+      uint16_t  port;
+      int64_t   due; // host us the packet is delivered at
+    };
+    std::deque<Packet> _queue; // received, not yet delivered
+};
+
+#endif
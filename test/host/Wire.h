@@ -0,0 +1 @@
+// I2C: not used by firmware modules built for the host
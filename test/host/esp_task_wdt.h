@@ -0,0 +1 @@
+// task watchdog: not used by firmware modules built for the host
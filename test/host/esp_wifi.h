@@ -0,0 +1 @@
+// ESP-IDF WiFi driver: not used by firmware modules built for the host (see WiFi.h)
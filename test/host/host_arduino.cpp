@@ -0,0 +1,74 @@
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/*
+ * Arduino core functions for host builds (see Arduino.h)
+ */
+
+static const auto hostStart = std::chrono::steady_clock::now();
+static std::atomic<bool>     hostFrozen(false);
+static std::atomic<uint32_t> hostFrozenMs(0);
+static std::atomic<int64_t>  hostOffsetUs(0); // real time continues from frozen time (never goes back)
+
+static uint64_t hostMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count() + hostOffsetUs;
+}
+
+uint32_t millis() {
+  return hostFrozen ? hostFrozenMs.load() : (uint32_t)(hostMicros() / 1000);
+}
+
+uint32_t micros() {
+  return hostFrozen ? hostFrozenMs.load() * 1000 : (uint32_t)hostMicros();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+void hostSetMillis(uint32_t ms) {
+  hostFrozenMs = ms;
+  hostFrozen = true;
+}
+
+void hostRealTime() {
+  if (!hostFrozen) return;
+  int64_t behind = (int64_t)hostFrozenMs.load() * 1000 - (int64_t)hostMicros();
+  if (behind > 0) hostOffsetUs += behind;
+  hostFrozen = false;
+}
+
+static uint32_t hostRandomState = 1;
+
+void randomSeed(unsigned long seed) {
+  if (seed) hostRandomState = seed;
+}
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  hostRandomState = hostRandomState * 1103515245 + 12345;
+  return (hostRandomState >> 1) % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+
+int64_t esp_timer_get_time() {
+  return hostFrozen ? (int64_t)hostFrozenMs.load() * 1000 : (int64_t)hostMicros();
+}
+
+EspClass       ESP;
+HardwareSerial Serial;
+const IPAddress INADDR_NONE(0, 0, 0, 0);
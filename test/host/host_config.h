@@ -0,0 +1,28 @@
+#ifndef WLED_HOST_CONFIG_H
+#define WLED_HOST_CONFIG_H
+
+/*
+ * Build configuration of firmware modules for the host (force included with -include host_config.h, see wled_host.h):
+ * a dual core ESP32 without the features that need hardware or libraries the host does not have
+ */
+
+#define WLED_HOST
+#define ARDUINO 10816
+#define ESP32
+#define ARDUINO_ARCH_ESP32
+#define WLED_USE_REAL_MATH
+#define WLED_DISABLE_ALEXA
+#define WLED_DISABLE_MQTT
+#define WLED_DISABLE_OTA
+#define WLED_DISABLE_INFRARED
+#define WLED_DISABLE_ESPNOW
+#define WLED_DISABLE_HUESYNC
+#define WLED_DISABLE_ADALIGHT
+#define WLED_DISABLE_LOXONE
+#define WLED_DISABLE_JSON_CACHE
+#define JSON_BUFFER_SIZE (2*24576) // ArduinoJson slots (64 bit pointers) are twice the size of those on ESP32
+
+#undef unix  // predefined by GNU C++ on Linux
+#undef linux
+
+#endif
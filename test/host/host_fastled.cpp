@@ -0,0 +1,281 @@
+#include <FastLED.h>
+
+/*
+ * FastLED functions for host builds (see FastLED.h)
+ */
+
+uint16_t rand16seed = 1337;
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb) {
+  uint8_t hue = hsv.hue, sat = hsv.sat, val = hsv.val;
+  uint8_t offset8 = (hue & 0x1F) << 3;
+  uint8_t third = scale8(offset8, 256 / 3);
+  uint8_t twothirds = scale8(offset8, (256 * 2) / 3);
+  uint8_t r, g, b;
+  switch (hue >> 5) {
+    case 0:  r = 255 - third;     g = third;            b = 0;                break;
+    case 1:  r = 171;             g = 85 + third;       b = 0;                break;
+    case 2:  r = 171 - twothirds; g = 170 + third;      b = 0;                break;
+    case 3:  r = 0;               g = 255 - third;      b = third;            break;
+    case 4:  r = 0;               g = 171 - twothirds;  b = 85 + twothirds;   break;
+    case 5:  r = third;           g = 0;                b = 255 - third;      break;
+    case 6:  r = 85 + third;      g = 0;                b = 171 - third;      break;
+    default: r = 170 + third;     g = 0;                b = 85 - third;       break;
+  }
+  if (sat != 255) {
+    if (sat == 0) r = g = b = 255;
+    else {
+      uint8_t desat = 255 - sat;
+      desat = scale8_video(desat, desat);
+      uint8_t satscale = 255 - desat;
+      r = scale8(r, satscale) + desat;
+      g = scale8(g, satscale) + desat;
+      b = scale8(b, satscale) + desat;
+    }
+  }
+  if (val != 255) {
+    val = scale8_video(val, val);
+    if (val == 0) r = g = b = 0;
+    else { r = scale8(r, val); g = scale8(g, val); b = scale8(b, val); }
+  }
+  rgb = CRGB(r, g, b);
+}
+
+void hsv2rgb_spectrum(const CHSV &hsv, CRGB &rgb) {
+  hsv2rgb_rainbow(hsv, rgb);
+}
+
+CHSV rgb2hsv_approximate(const CRGB &rgb) {
+  uint8_t mx = std::max(rgb.r, std::max(rgb.g, rgb.b));
+  uint8_t mn = std::min(rgb.r, std::min(rgb.g, rgb.b));
+  if (mx == 0) return CHSV(0, 0, 0);
+  uint8_t delta = mx - mn;
+  uint8_t s = (delta * 255) / mx;
+  if (!delta) return CHSV(0, 0, mx);
+  int h;
+  if (mx == rgb.r)      h = ((int)(rgb.g - rgb.b) * 43) / delta;
+  else if (mx == rgb.g) h = 85 + ((int)(rgb.b - rgb.r) * 43) / delta;
+  else                  h = 171 + ((int)(rgb.r - rgb.g) * 43) / delta;
+  return CHSV(h & 0xFF, s, mx);
+}
+
+static uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+  uint16_t partial = (a << 8) | b;
+  partial += (b * amountOfB);
+  partial -= (a * amountOfB);
+  return partial >> 8;
+}
+
+CRGB &nblend(CRGB &existing, const CRGB &overlay, fract8 amountOfOverlay) {
+  if (amountOfOverlay == 0) return existing;
+  if (amountOfOverlay == 255) return existing = overlay;
+  existing.r = blend8(existing.r, overlay.r, amountOfOverlay);
+  existing.g = blend8(existing.g, overlay.g, amountOfOverlay);
+  existing.b = blend8(existing.b, overlay.b, amountOfOverlay);
+  return existing;
+}
+
+CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2) {
+  CRGB nu(p1);
+  return nblend(nu, p2, amountOfP2);
+}
+
+CHSV blend(const CHSV &p1, const CHSV &p2, fract8 amountOfP2) {
+  return CHSV(blend8(p1.h, p2.h, amountOfP2), blend8(p1.s, p2.s, amountOfP2), blend8(p1.v, p2.v, amountOfP2));
+}
+
+void fill_solid(CRGB *leds, int numToFill, const CRGB &color) {
+  for (int i = 0; i < numToFill; i++) leds[i] = color;
+}
+
+void fill_rainbow(CRGB *leds, int numToFill, uint8_t initialhue, uint8_t deltahue) {
+  CHSV hsv(initialhue, 240, 255);
+  for (int i = 0; i < numToFill; i++) {
+    leds[i] = hsv;
+    hsv.hue += deltahue;
+  }
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t startpos, CRGB startcolor, uint16_t endpos, CRGB endcolor) {
+  if (endpos < startpos) {
+    std::swap(startpos, endpos);
+    std::swap(startcolor, endcolor);
+  }
+  int16_t rdistance87 = (endcolor.r - startcolor.r) << 7;
+  int16_t gdistance87 = (endcolor.g - startcolor.g) << 7;
+  int16_t bdistance87 = (endcolor.b - startcolor.b) << 7;
+  uint16_t pixeldistance = endpos - startpos;
+  int16_t divisor = pixeldistance ? pixeldistance : 1;
+  int16_t rdelta87 = (rdistance87 / divisor) * 2;
+  int16_t gdelta87 = (gdistance87 / divisor) * 2;
+  int16_t bdelta87 = (bdistance87 / divisor) * 2;
+  uint16_t r88 = startcolor.r << 8, g88 = startcolor.g << 8, b88 = startcolor.b << 8;
+  for (uint16_t i = startpos; i <= endpos; ++i) {
+    leds[i] = CRGB(r88 >> 8, g88 >> 8, b88 >> 8);
+    r88 += rdelta87; g88 += gdelta87; b88 += bdelta87;
+  }
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2) {
+  fill_gradient_RGB(leds, 0, c1, numLeds - 1, c2);
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2, const CRGB &c3) {
+  uint16_t half = numLeds / 2, last = numLeds - 1;
+  fill_gradient_RGB(leds, 0, c1, half, c2);
+  fill_gradient_RGB(leds, half, c2, last, c3);
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2, const CRGB &c3, const CRGB &c4) {
+  uint16_t onethird = numLeds / 3, twothirds = (numLeds * 2) / 3, last = numLeds - 1;
+  fill_gradient_RGB(leds, 0, c1, onethird, c2);
+  fill_gradient_RGB(leds, onethird, c2, twothirds, c3);
+  fill_gradient_RGB(leds, twothirds, c3, last, c4);
+}
+
+void fadeToBlackBy(CRGB *leds, uint16_t numLeds, uint8_t fadeBy) {
+  nscale8(leds, numLeds, 255 - fadeBy);
+}
+
+void nscale8(CRGB *leds, uint16_t numLeds, uint8_t scale) {
+  for (uint16_t i = 0; i < numLeds; i++) leds[i].nscale8(scale);
+}
+
+CRGB HeatColor(uint8_t temperature) {
+  CRGB heatcolor;
+  uint8_t t192 = scale8_video(temperature, 191);
+  uint8_t heatramp = (t192 & 0x3F) << 2;
+  if (t192 & 0x80)      heatcolor = CRGB(255, 255, heatramp);
+  else if (t192 & 0x40) heatcolor = CRGB(255, heatramp, 0);
+  else                  heatcolor = CRGB(heatramp, 0, 0);
+  return heatcolor;
+}
+
+CRGBPalette16 &CRGBPalette16::operator=(TProgmemRGBGradientPalette_bytes progpal) {
+  uint16_t count = 0;
+  while (progpal[count*4] != 255) count++;
+  count++;
+  int lastSlotUsed = -1;
+  CRGB rgbstart(progpal[1], progpal[2], progpal[3]);
+  int indexstart = 0;
+  const uint8_t *p = progpal;
+  while (indexstart < 255) {
+    p += 4;
+    int indexend = p[0];
+    CRGB rgbend(p[1], p[2], p[3]);
+    int istart8 = indexstart / 16;
+    int iend8   = indexend / 16;
+    if (count < 16) {
+      if (istart8 <= lastSlotUsed && lastSlotUsed < 15) {
+        istart8 = lastSlotUsed + 1;
+        if (iend8 < istart8) iend8 = istart8;
+      }
+      lastSlotUsed = iend8;
+    }
+    fill_gradient_RGB(entries, istart8, rgbstart, iend8, rgbend);
+    indexstart = indexend;
+    rgbstart = rgbend;
+  }
+  return *this;
+}
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness, TBlendType blendType) {
+  if (blendType == LINEARBLEND_NOWRAP) index = map8(index, 0, 239);
+  uint8_t hi4 = index >> 4, lo4 = index & 0x0F;
+  const CRGB *entry = &pal[hi4];
+  uint8_t red1 = entry->r, green1 = entry->g, blue1 = entry->b;
+  if (lo4 && blendType != NOBLEND) {
+    entry = hi4 == 15 ? &pal[0] : entry + 1;
+    uint8_t f2 = lo4 << 4, f1 = 255 - f2;
+    red1   = scale8(red1, f1)   + scale8(entry->r, f2);
+    green1 = scale8(green1, f1) + scale8(entry->g, f2);
+    blue1  = scale8(blue1, f1)  + scale8(entry->b, f2);
+  }
+  if (brightness != 255) {
+    if (brightness) {
+      ++brightness;
+      red1 = scale8(red1, brightness); green1 = scale8(green1, brightness); blue1 = scale8(blue1, brightness);
+    } else red1 = green1 = blue1 = 0;
+  }
+  return CRGB(red1, green1, blue1);
+}
+
+void nblendPaletteTowardPalette(CRGBPalette16 &current, CRGBPalette16 &target, uint8_t maxChanges) {
+  uint8_t *p1 = (uint8_t *)current.entries;
+  uint8_t *p2 = (uint8_t *)target.entries;
+  uint8_t changes = 0;
+  for (size_t i = 0; i < sizeof(current.entries); ++i) {
+    if (p1[i] == p2[i]) continue;
+    if (p1[i] < p2[i]) { ++p1[i]; ++changes; }
+    if (p1[i] > p2[i]) { --p1[i]; ++changes; if (p1[i] > p2[i]) --p1[i]; }
+    if (changes >= maxChanges) break;
+  }
+}
+
+// value noise on an integer lattice with smoothstep interpolation
+static uint8_t noiseLattice(int32_t x, int32_t y, int32_t z) {
+  uint32_t h = (uint32_t)x * 73856093u ^ (uint32_t)y * 19349663u ^ (uint32_t)z * 83492791u;
+  h ^= h >> 13; h *= 0x5bd1e995u; h ^= h >> 15;
+  return h >> 24;
+}
+
+static uint32_t noiseFade(uint32_t f) { // f: 0..65535, smoothstep
+  return (f * f / 65536) * (3 * 65536 - 2 * f) / 65536;
+}
+
+static int32_t noiseLerp(int32_t a, int32_t b, uint32_t f) {
+  return a + (((b - a) * (int32_t)f) >> 16);
+}
+
+uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z) {
+  int32_t ix = x >> 16, iy = y >> 16, iz = z >> 16;
+  uint32_t fx = noiseFade(x & 0xFFFF), fy = noiseFade(y & 0xFFFF), fz = noiseFade(z & 0xFFFF);
+  int32_t v[2][2];
+  for (int dz = 0; dz < 2; dz++) for (int dy = 0; dy < 2; dy++)
+    v[dz][dy] = noiseLerp(noiseLattice(ix, iy+dy, iz+dz) << 8, noiseLattice(ix+1, iy+dy, iz+dz) << 8, fx);
+  int32_t n = noiseLerp(noiseLerp(v[0][0], v[0][1], fy), noiseLerp(v[1][0], v[1][1], fy), fz);
+  return n;
+}
+uint16_t inoise16(uint32_t x, uint32_t y) { return inoise16(x, y, 0); }
+uint16_t inoise16(uint32_t x)             { return inoise16(x, 0, 0); }
+int16_t  inoise16_raw(uint32_t x, uint32_t y, uint32_t z) { return (int32_t)inoise16(x, y, z) - 32768; }
+
+uint8_t inoise8(uint16_t x, uint16_t y, uint16_t z) { return inoise16((uint32_t)x << 8, (uint32_t)y << 8, (uint32_t)z << 8) >> 8; }
+uint8_t inoise8(uint16_t x, uint16_t y)             { return inoise8(x, y, 0); }
+uint8_t inoise8(uint16_t x)                         { return inoise8(x, 0, 0); }
+int8_t  inoise8_raw(uint16_t x, uint16_t y, uint16_t z) { return (int)inoise8(x, y, z) - 128; }
+int8_t  inoise8_raw(uint16_t x, uint16_t y)             { return inoise8_raw(x, y, 0); }
+int8_t  inoise8_raw(uint16_t x)                         { return inoise8_raw(x, 0, 0); }
+
+const TProgmemRGBPalette16 CloudColors_p = {
+  CRGB::Blue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue,
+  CRGB::Blue, CRGB::DarkBlue, CRGB::SkyBlue, CRGB::SkyBlue, CRGB::LightBlue, CRGB::White, CRGB::LightBlue, CRGB::SkyBlue
+};
+const TProgmemRGBPalette16 LavaColors_p = {
+  CRGB::Black, CRGB::Maroon, CRGB::Black, CRGB::Maroon, CRGB::DarkRed, CRGB::DarkRed, CRGB::Maroon, CRGB::DarkRed,
+  CRGB::DarkRed, CRGB::DarkRed, CRGB::Red, CRGB::Orange, CRGB::White, CRGB::Orange, CRGB::Red, CRGB::DarkRed
+};
+const TProgmemRGBPalette16 OceanColors_p = {
+  CRGB::MidnightBlue, CRGB::DarkBlue, CRGB::MidnightBlue, CRGB::Navy, CRGB::DarkBlue, CRGB::MediumBlue, CRGB::SeaGreen, CRGB::Teal,
+  CRGB::CadetBlue, CRGB::Blue, CRGB::DarkCyan, CRGB::CornflowerBlue, CRGB::Aquamarine, CRGB::SeaGreen, CRGB::Aqua, CRGB::LightSkyBlue
+};
+const TProgmemRGBPalette16 ForestColors_p = {
+  CRGB::DarkGreen, CRGB::DarkGreen, CRGB::DarkOliveGreen, CRGB::DarkGreen, CRGB::Green, CRGB::ForestGreen, CRGB::OliveDrab, CRGB::Green,
+  CRGB::SeaGreen, CRGB::MediumAquamarine, CRGB::LimeGreen, CRGB::YellowGreen, CRGB::LightGreen, CRGB::LawnGreen, CRGB::MediumAquamarine, CRGB::ForestGreen
+};
+const TProgmemRGBPalette16 RainbowColors_p = {
+  0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+  0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B
+};
+const TProgmemRGBPalette16 RainbowStripeColors_p = {
+  0xFF0000, 0x000000, 0xAB5500, 0x000000, 0xABAB00, 0x000000, 0x00FF00, 0x000000,
+  0x00AB55, 0x000000, 0x0000FF, 0x000000, 0x5500AB, 0x000000, 0xAB0055, 0x000000
+};
+const TProgmemRGBPalette16 PartyColors_p = {
+  0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+  0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9
+};
+const TProgmemRGBPalette16 HeatColors_p = {
+  0x000000, 0x330000, 0x660000, 0x990000, 0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600,
+  0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33, 0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF
+};
@@ -0,0 +1,59 @@
+#include <Arduino.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*
+ * FreeRTOS task notifications for host builds (see Arduino.h), threads not created by
+ * xTaskCreatePinnedToCore() (main, render task) get a task on core 0 when first used
+ */
+
+struct HostTask {
+  std::mutex              mutex;
+  std::condition_variable cv;
+  uint32_t                notifications = 0;
+  BaseType_t              core = 0;
+};
+
+static thread_local HostTask  *hostCurrentTask = nullptr;
+static thread_local BaseType_t hostCoreId = 0;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio, TaskHandle_t *task, BaseType_t core) {
+  HostTask *t = new HostTask; // tasks are never deleted (like render workers)
+  t->core = core;
+  if (task) *task = t;
+  std::thread([fn, arg, t]() {
+    hostCurrentTask = t;
+    hostCoreId = t->core;
+    fn(arg);
+  }).detach();
+  return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  if (!hostCurrentTask) hostCurrentTask = new HostTask;
+  return hostCurrentTask;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  {
+    std::lock_guard<std::mutex> lock(task->mutex);
+    task->notifications++;
+  }
+  task->cv.notify_one();
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+  HostTask *t = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(t->mutex);
+  if (ticks == portMAX_DELAY) t->cv.wait(lock, [t]() { return t->notifications > 0; });
+  else t->cv.wait_for(lock, std::chrono::milliseconds(ticks), [t]() { return t->notifications > 0; });
+  uint32_t n = t->notifications;
+  if (n) t->notifications = clearOnExit ? 0 : n - 1;
+  return n;
+}
+
+BaseType_t xPortGetCoreID() {
+  return hostCoreId;
+}
@@ -0,0 +1,225 @@
+#include <wled_host.h>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <random>
+#include <set>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/*
+ * Network and filesystem libraries for host builds (see WiFi.h, WiFiUdp.h, lwip/igmp.h, LittleFS.h)
+ */
+
+WiFiClass WiFi;
+ETHClass  ETH;
+HostFS    LittleFS;
+
+// node address, loopback network 127.0.0.0/8 (broadcast 127.255.255.255)
+static IPAddress hostIP(127, 0, 0, 1);
+
+void hostSetNetwork(IPAddress ip) {
+  hostIP = ip;
+}
+
+// injected network latency (receiving side), random jitter per packet
+static uint32_t hostLatencyUs = 0, hostJitterUs = 0;
+static std::minstd_rand hostJitterRandom;
+
+void hostSetLatency(uint32_t us, uint32_t jitterUs) {
+  hostLatencyUs = us;
+  hostJitterUs = jitterUs;
+  hostJitterRandom.seed(uint32_t(hostIP)); // nodes differ
+}
+
+// real time, also if millis() is frozen
+static int64_t hostNetMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+IPAddress WiFiClass::localIP()    { return hostIP; }
+IPAddress WiFiClass::subnetMask() { return IPAddress(255, 0, 0, 0); }
+IPAddress WiFiClass::gatewayIP()  { return IPAddress(127, 0, 0, 1); }
+
+// IGMP: groups joined by this node, every group socket (bound to the port on any address) is a member
+// (IP_MULTICAST_ALL off: sockets of other nodes on the same port do not receive them)
+static std::mutex         hostNetMutex;
+static std::set<uint32_t> hostGroups;
+static std::vector<int>   hostGroupSockets;
+
+static void setMembership(int fd, uint32_t group, bool join) {
+  struct ip_mreq mreq;
+  mreq.imr_multiaddr.s_addr = group;
+  mreq.imr_interface.s_addr = uint32_t(hostIP);
+  setsockopt(fd, IPPROTO_IP, join ? IP_ADD_MEMBERSHIP : IP_DROP_MEMBERSHIP, &mreq, sizeof(mreq));
+}
+
+err_t igmp_joingroup(const ip4_addr_t *ifaddr, const ip4_addr_t *groupaddr) {
+  std::lock_guard<std::mutex> lock(hostNetMutex);
+  if (!hostGroups.insert(groupaddr->addr).second) return ERR_OK;
+  for (int fd : hostGroupSockets) setMembership(fd, groupaddr->addr, true);
+  return ERR_OK;
+}
+
+err_t igmp_leavegroup(const ip4_addr_t *ifaddr, const ip4_addr_t *groupaddr) {
+  std::lock_guard<std::mutex> lock(hostNetMutex);
+  if (!hostGroups.erase(groupaddr->addr)) return ERR_VAL;
+  for (int fd : hostGroupSockets) setMembership(fd, groupaddr->addr, false);
+  return ERR_OK;
+}
+
+static int openSocket(uint32_t addr, uint16_t port) {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) return -1;
+  int on = 1, off = 0;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+  setsockopt(fd, IPPROTO_IP, IP_MULTICAST_ALL, &off, sizeof(off));
+  setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &on, sizeof(on));
+  struct in_addr ifaddr;
+  ifaddr.s_addr = uint32_t(hostIP);
+  setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &ifaddr, sizeof(ifaddr));
+  fcntl(fd, F_SETFL, O_NONBLOCK);
+  struct sockaddr_in sa = {};
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = addr;
+  sa.sin_port = htons(port);
+  if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0) { close(fd); return -1; }
+  return fd;
+}
+
+// unicast socket bound to node address, group socket for broadcasts and multicast
+uint8_t WiFiUDP::begin(uint16_t port) {
+  stop();
+  _fd = openSocket(uint32_t(hostIP), port);
+  _groupFd = openSocket(INADDR_ANY, port);
+  if (_fd < 0 || _groupFd < 0) { stop(); return 0; }
+  _port = port;
+  std::lock_guard<std::mutex> lock(hostNetMutex);
+  for (uint32_t group : hostGroups) setMembership(_groupFd, group, true);
+  hostGroupSockets.push_back(_groupFd);
+  return 1;
+}
+
+// joins the group on the interface (like ESP32 WiFiUDP)
+uint8_t WiFiUDP::beginMulticast(IPAddress group, uint16_t port) {
+  if (!begin(port)) return 0;
+  ip4_addr_t ifaddr, groupaddr;
+  ifaddr.addr = uint32_t(hostIP);
+  groupaddr.addr = uint32_t(group);
+  igmp_joingroup(&ifaddr, &groupaddr);
+  return 1;
+}
+
+void WiFiUDP::stop() {
+  if (_groupFd >= 0) {
+    std::lock_guard<std::mutex> lock(hostNetMutex);
+    hostGroupSockets.erase(std::remove(hostGroupSockets.begin(), hostGroupSockets.end(), _groupFd), hostGroupSockets.end());
+    close(_groupFd);
+  }
+  if (_fd >= 0) close(_fd);
+  _fd = _groupFd = -1;
+  _queue.clear();
+  _port = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+  if (_fd < 0) _fd = openSocket(uint32_t(hostIP), 0); // send only
+  if (_fd < 0) return 0;
+  _txIP = ip;
+  _txPort = port;
+  _tx.clear();
+  return 1;
+}
+
+int WiFiUDP::endPacket() {
+  if (_fd < 0 || !_txPort) return 0;
+  struct sockaddr_in sa = {};
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = uint32_t(_txIP);
+  sa.sin_port = htons(_txPort);
+  ssize_t sent = sendto(_fd, _tx.data(), _tx.size(), 0, (struct sockaddr *)&sa, sizeof(sa));
+  _tx.clear();
+  _txPort = 0;
+  return sent >= 0;
+}
+
+int WiFiUDP::parsePacket() {
+  _rx.clear();
+  _rxPos = 0;
+  uint8_t buf[1500];
+  int64_t now = hostNetMicros();
+  for (int fd : {_fd, _groupFd}) {
+    if (fd < 0 || !_port) continue;
+    struct sockaddr_in sa;
+    socklen_t saLen = sizeof(sa);
+    for (ssize_t len; (len = recvfrom(fd, buf, sizeof(buf), 0, (struct sockaddr *)&sa, &saLen)) >= 0; saLen = sizeof(sa)) {
+      int64_t due = now + hostLatencyUs + (hostJitterUs ? hostJitterRandom() % (hostJitterUs + 1) : 0);
+      _queue.push_back({std::vector<uint8_t>(buf, buf + len), IPAddress(uint32_t(sa.sin_addr.s_addr)), ntohs(sa.sin_port), due});
+    }
+  }
+  if (_queue.empty() || _queue.front().due > now) return 0;
+  Packet &p = _queue.front();
+  _rx.swap(p.data);
+  _remoteIP = p.ip;
+  _remotePort = p.port;
+  _queue.pop_front();
+  return _rx.size();
+}
+
+int WiFiUDP::read(uint8_t *buf, size_t len) {
+  size_t n = std::min(len, (size_t)available());
+  memcpy(buf, _rx.data() + _rxPos, n);
+  _rxPos += n;
+  return n;
+}
+
+// filesystem in a temporary directory, removed on exit
+static std::filesystem::path hostFsRoot() {
+  static std::filesystem::path root;
+  if (root.empty()) {
+    char dir[] = "/tmp/wled_host_fs_XXXXXX";
+    root = mkdtemp(dir);
+    atexit([]() { std::error_code ec; std::filesystem::remove_all(hostFsRoot(), ec); });
+  }
+  return root;
+}
+
+String HostFS::path(const char *path) {
+  return String((hostFsRoot() / (path[0] == '/' ? path + 1 : path)).string());
+}
+
+bool HostFS::format() {
+  std::error_code ec;
+  for (auto &e : std::filesystem::directory_iterator(hostFsRoot(), ec)) std::filesystem::remove_all(e.path(), ec);
+  return true;
+}
+
+bool HostFS::exists(const char *p) {
+  std::error_code ec;
+  return std::filesystem::exists(path(p).c_str(), ec);
+}
+
+File HostFS::open(const char *p, const char *mode) {
+  FILE *f = fopen(path(p).c_str(), mode);
+  return f ? File(f, p) : File();
+}
+
+bool HostFS::remove(const char *p) {
+  return ::remove(path(p).c_str()) == 0;
+}
+
+bool HostFS::rename(const char *from, const char *to) {
+  return ::rename(path(from).c_str(), path(to).c_str()) == 0;
+}
+
+size_t HostFS::usedBytes() {
+  size_t used = 0;
+  std::error_code ec;
+  for (auto &e : std::filesystem::recursive_directory_iterator(hostFsRoot(), ec)) if (e.is_regular_file(ec)) used += e.file_size(ec);
+  return used;
+}
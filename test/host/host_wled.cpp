@@ -0,0 +1,159 @@
+#define WLED_DEFINE_GLOBAL_VARS
+#include <wled_host.h>
+
+/*
+ * Globals (defined by wled.h) and the firmware functions of modules that are not built for the host (see wled_host.h)
+ */
+
+// set.cpp, wled_server.cpp: no HTTP server on host
+bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply) { return false; }
+void createEditHandler(bool enable) {}
+
+// bus_manager.cpp without the hardware busses, every bus is a HostBus
+HostBus::HostBus(BusConfig &bc)
+: Bus(bc.type, bc.start, bc.autoWhite, bc.count, bc.reversed, (bc.refreshReq || bc.type == TYPE_TM1814))
+, _transmitUs(0)
+, _transmitEnd(0)
+, _shows(0)
+{
+  _pixels = (uint32_t*)calloc(_len, sizeof(uint32_t));
+  _frame  = (uint32_t*)calloc(_len, sizeof(uint32_t));
+  _valid  = _pixels && _frame;
+}
+
+void HostBus::setPixelColor(uint16_t pix, uint32_t c) {
+  if (!_valid || pix >= _len) return;
+  if (Bus::hasWhite(_type)) c = autoWhiteCalc(c);
+  _pixels[pix] = c;
+}
+
+uint32_t HostBus::getPixelColor(uint16_t pix) {
+  if (!_valid || pix >= _len) return 0;
+  return _pixels[pix];
+}
+
+bool HostBus::canShow() {
+  return (int32_t)(micros() - _transmitEnd) >= 0;
+}
+
+void HostBus::show() {
+  if (!_valid) return;
+  while (!canShow()) yield(); // previous frame is still being sent
+  for (unsigned i = 0; i < _len; i++) _frame[i] = color_fade(_pixels[i], _bri);
+  _shows++;
+  _transmitEnd = micros() + _transmitUs;
+}
+
+void HostBus::cleanup() {
+  _valid = false;
+  free(_pixels); _pixels = nullptr;
+  free(_frame);  _frame  = nullptr;
+}
+
+uint32_t BusManager::memUsage(BusConfig &bc) {
+  return bc.count * sizeof(uint32_t) * 2;
+}
+
+int BusManager::add(BusConfig &bc) {
+  if (getNumBusses() >= WLED_MAX_BUSSES) return -1;
+  busses[numBusses] = new HostBus(bc);
+  return numBusses++;
+}
+
+void BusManager::removeAll() {
+  while (!canAllShow()) yield();
+  for (uint8_t i = 0; i < numBusses; i++) delete busses[i];
+  numBusses = 0;
+}
+
+void BusManager::show() {
+  for (uint8_t i = 0; i < numBusses; i++) busses[i]->show();
+}
+
+void BusManager::setStatusPixel(uint32_t c) {}
+
+void BusManager::setPixelColor(uint16_t pix, uint32_t c) {
+  for (uint8_t i = 0; i < numBusses; i++) {
+    Bus* b = busses[i];
+    uint16_t bstart = b->getStart();
+    if (pix < bstart || pix >= bstart + b->getLength()) continue;
+    busses[i]->setPixelColor(pix - bstart, c);
+  }
+}
+
+void BusManager::setBrightness(uint8_t b) {
+  for (uint8_t i = 0; i < numBusses; i++) busses[i]->setBrightness(b);
+}
+
+void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
+  if (cct > 255) cct = 255;
+  if (cct >= 0) {
+    if (allowWBCorrection) cct = 1900 + (cct << 5);
+  } else cct = -1;
+  Bus::setCCT(cct);
+}
+
+uint32_t BusManager::getPixelColor(uint16_t pix) {
+  for (uint8_t i = 0; i < numBusses; i++) {
+    Bus* b = busses[i];
+    uint16_t bstart = b->getStart();
+    if (pix < bstart || pix >= bstart + b->getLength()) continue;
+    return b->getPixelColor(pix - bstart);
+  }
+  return 0;
+}
+
+bool BusManager::canAllShow() {
+  for (uint8_t i = 0; i < numBusses; i++) if (!busses[i]->canShow()) return false;
+  return true;
+}
+
+Bus* BusManager::getBus(uint8_t busNr) {
+  if (busNr >= numBusses) return nullptr;
+  return busses[busNr];
+}
+
+uint16_t BusManager::getTotalLength() {
+  uint16_t len = 0;
+  for (uint8_t i=0; i<numBusses; i++) len += busses[i]->getLength();
+  return len;
+}
+
+uint32_t Bus::autoWhiteCalc(uint32_t c) {
+  uint8_t aWM = _autoWhiteMode;
+  if (_gAWM != AW_GLOBAL_DISABLED) aWM = _gAWM;
+  if (aWM == RGBW_MODE_MANUAL_ONLY) return c;
+  uint8_t w = W(c);
+  if (w > 0 && aWM == RGBW_MODE_DUAL) return c;
+  uint8_t r = R(c);
+  uint8_t g = G(c);
+  uint8_t b = B(c);
+  if (aWM == RGBW_MODE_MAX) return RGBW32(r, g, b, r > g ? (r > b ? r : b) : (g > b ? g : b));
+  w = r < g ? (r < b ? r : b) : (g < b ? g : b);
+  if (aWM == RGBW_MODE_AUTO_ACCURATE) { r -= w; g -= w; b -= w; }
+  return RGBW32(r, g, b, w);
+}
+
+int16_t Bus::_cct = -1;
+uint8_t Bus::_cctBlend = 0;
+uint8_t Bus::_gAWM = 255;
+
+// sets up strip with one bus of given length (or several of len pixels each)
+void hostInitStrip(uint16_t len, uint8_t numBusses, uint8_t type) {
+  mainTaskHandle = xTaskGetCurrentTaskHandle(); // test thread is the main loop, other threads are network callbacks
+  strip.suspend();
+  strip.waitUntilIdle();
+  busses.removeAll();
+  for (uint8_t i = 0; i < numBusses; i++) {
+    uint8_t pins[] = {(uint8_t)(2+i)};
+    BusConfig bc(type, pins, i*len, len, COL_ORDER_RGB);
+    busses.add(bc);
+  }
+  strip.finalizeInit();
+  strip.makeAutoSegments(true);
+  strip.resume();
+}
+
+HostBus *hostBus(uint8_t n) {
+  return static_cast<HostBus*>(busses.getBus(n));
+}
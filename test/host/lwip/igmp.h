@@ -0,0 +1,18 @@
+#ifndef WLED_HOST_LWIP_IGMP_H
+#define WLED_HOST_LWIP_IGMP_H
+
+/*
+ * lwIP IGMP for host builds: memberships are joined on the loopback interface for all host sockets
+ * (see WiFiUdp.h), like lwIP joins them on the netif
+ */
+
+#include "ip_addr.h"
+
+typedef int8_t err_t;
+#define ERR_OK   0
+#define ERR_VAL -6
+
+err_t igmp_joingroup(const ip4_addr_t *ifaddr, const ip4_addr_t *groupaddr);
+err_t igmp_leavegroup(const ip4_addr_t *ifaddr, const ip4_addr_t *groupaddr);
+
+#endif
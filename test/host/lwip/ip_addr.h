@@ -0,0 +1,17 @@
+#ifndef WLED_HOST_LWIP_IP_ADDR_H
+#define WLED_HOST_LWIP_IP_ADDR_H
+
+/*
+ * lwIP address types for host builds
+ */
+
+#include <stdint.h>
+
+#define LWIP_VERSION_MAJOR 2
+
+typedef struct ip4_addr {
+  uint32_t addr; // network byte order
+} ip4_addr_t;
+typedef ip4_addr_t ip_addr_t;
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef WLED_HOST_LWIP_TCPIP_H
+#define WLED_HOST_LWIP_TCPIP_H
+
+/*
+ * lwIP TCP/IP task API for host builds: the host network stack is thread safe, callbacks are run directly
+ */
+
+#include "igmp.h"
+
+typedef void (*tcpip_callback_fn)(void *ctx);
+
+inline err_t tcpip_callback(tcpip_callback_fn function, void *ctx) {
+  function(ctx);
+  return ERR_OK;
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef WLED_HOST_H
+#define WLED_HOST_H
+
+/*
+ * Host (Linux) build of firmware modules for unit tests. wled.h is used as is: the host is a dual core ESP32
+ * (see host_config.h) whose libraries are the headers in test/host (Arduino core, FastLED, network,
+ * async web server and filesystem). The globals are defined by wled.h in host_wled.cpp, busses are
+ * RAM buffers (see HostBus), std::thread stands in for the FreeRTOS tasks.
+ * Firmware modules that are not built for the host are replaced by stubs in host_wled.cpp.
+ */
+
+#include "host_config.h"
+#include <Arduino.h>
+#include <atomic>
+#include <thread>
+
+#include "wled.h"
+
+// bus writing to RAM: pixels as set, frame as sent (scaled by brightness) on show()
+// transmit time emulates asynchronous output (canShow() is false until the frame is sent)
+class HostBus : public Bus {
+  public:
+    HostBus(BusConfig &bc);
+    ~HostBus() { cleanup(); }
+
+    void     show();
+    bool     canShow();
+    void     setPixelColor(uint16_t pix, uint32_t c);
+    uint32_t getPixelColor(uint16_t pix);
+    void     cleanup();
+
+    inline uint32_t getFrameColor(uint16_t pix) { return pix < _len ? _frame[pix] : 0; }
+    inline uint32_t getShowCount()              { return _shows; }
+    inline void     setTransmitTime(uint32_t us) { _transmitUs = us; }
+    inline uint8_t  getBrightness()             { return _bri; }
+
+  private:
+    uint32_t *_pixels;
+    uint32_t *_frame;
+    uint32_t _transmitUs;
+    uint32_t _transmitEnd;
+    std::atomic<uint32_t> _shows;
+};
+
+// test helpers
+void     hostInitStrip(uint16_t len, uint8_t numBusses = 1, uint8_t type = TYPE_WS2812_RGB);
+HostBus *hostBus(uint8_t n = 0);
+void     hostSetNetwork(IPAddress ip); // node address (default 127.0.0.1), set before sockets are opened
+void     hostSetLatency(uint32_t us, uint32_t jitterUs = 0); // packets received by this node are delayed by us + 0..jitterUs
+
+#endif
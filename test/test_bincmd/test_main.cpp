@@ -0,0 +1,246 @@
+#include <unity.h>
+#include <wled_host.h>
+#include <atomic>
+#include <thread>
+
+/*
+ * Binary control protocol (bincmd.cpp): a packet must result in the same state as the equivalent JSON API request,
+ * WS packets are applied from the main loop in order with deferred JSON requests (handleDeferredJSON()), but not
+ * while another task serializes the state (state lock)
+ */
+
+#define BINCMD_TEST_BASE "{\"on\":true,\"bri\":128,\"transition\":7,\"seg\":[" \
+  "{\"id\":0,\"start\":0,\"stop\":15,\"fx\":0,\"sx\":128,\"ix\":128,\"pal\":0,\"sel\":true,\"col\":[[255,0,0,0],[0,0,0,0],[0,0,0,0]]}," \
+  "{\"id\":1,\"start\":15,\"stop\":30,\"fx\":0,\"sx\":128,\"ix\":128,\"pal\":0,\"sel\":false,\"col\":[[0,0,255,0],[0,0,0,0],[0,0,0,0]]}]}"
+
+static uint32_t testTime = 100000;
+
+// applies queued state updates like loop() (one frame later)
+static void runLoop() {
+  testTime += 1000;
+  hostSetMillis(testTime);
+  handleStateUpdates();
+  handleDeferredJSON();
+  handleStateUpdates();
+}
+
+static void applyJson(const char *json) {
+  TEST_ASSERT_TRUE(requestJSONBufferLock(1));
+  TEST_ASSERT_FALSE(deserializeJson(doc, json));
+  deserializeState(doc.as<JsonObject>());
+  releaseJSONBufferLock();
+  runLoop();
+}
+
+static String stateJson() {
+  TEST_ASSERT_TRUE(requestJSONBufferLock(1));
+  doc.clear();
+  serializeState(doc.to<JsonObject>());
+  String s;
+  serializeJson(doc, s);
+  releaseJSONBufferLock();
+  return s;
+}
+
+static void reset() {
+  hostInitStrip(30);
+  applyJson(BINCMD_TEST_BASE);
+}
+
+class Packet {
+  public:
+    Packet() { _data[0] = BINCMD_MAGIC; _data[1] = BINCMD_VERSION; _len = 2; }
+    Packet &add(uint8_t op, uint8_t id, uint8_t field, uint32_t value) {
+      uint8_t cmd[7] = {op, id, field, uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24)};
+      memcpy(_data + _len, cmd, sizeof(cmd));
+      _len += sizeof(cmd);
+      return *this;
+    }
+    Packet &global(uint8_t field, uint32_t value)              { return add(BINCMD_OP_GLOBAL, 0, field, value); }
+    Packet &seg(uint8_t id, uint8_t field, uint32_t value)     { return add(BINCMD_OP_SEGMENT, id, field, value); }
+    int apply() { int r = handleBinaryCommand(_data, _len); runLoop(); return r; }
+    const uint8_t *data() const { return _data; }
+    size_t len() const          { return _len; }
+  private:
+    uint8_t _data[2 + 16*7];
+    size_t  _len;
+};
+
+// state after packet equals state after JSON request, both applied to the base state
+static void assertSameAsJson(Packet &packet, int commands, const char *json) {
+  reset();
+  TEST_ASSERT_EQUAL_INT(commands, packet.apply());
+  String binState = stateJson();
+  reset();
+  applyJson(json);
+  String jsonState = stateJson();
+  TEST_ASSERT_EQUAL_STRING(jsonState.c_str(), binState.c_str());
+}
+
+void setUp(void) {
+  modeBlending = false;
+}
+
+void tearDown(void) {
+  hostRealTime();
+  testTime = millis();
+}
+
+void test_global_fields(void) {
+  Packet p;
+  p.global(BINCMD_GLOBAL_BRI, 200).global(BINCMD_GLOBAL_TRANSITION, 12);
+  assertSameAsJson(p, 2, "{\"bri\":200,\"transition\":12}");
+}
+
+void test_off_and_toggle(void) {
+  Packet off;
+  off.global(BINCMD_GLOBAL_ON, 0);
+  assertSameAsJson(off, 1, "{\"on\":false}");
+  Packet toggle;
+  toggle.global(BINCMD_GLOBAL_ON, 2);
+  assertSameAsJson(toggle, 1, "{\"on\":\"t\"}");
+}
+
+void test_segment_fields(void) {
+  Packet p;
+  p.seg(1, BINCMD_SEG_MODE, FX_MODE_RAINBOW).seg(1, BINCMD_SEG_SPEED, 10).seg(1, BINCMD_SEG_INTENSITY, 20)
+   .seg(1, BINCMD_SEG_PALETTE, 6).seg(1, BINCMD_SEG_OPACITY, 99).seg(1, BINCMD_SEG_CCT, 127)
+   .seg(1, BINCMD_SEG_CUSTOM1, 1).seg(1, BINCMD_SEG_CUSTOM2, 2).seg(1, BINCMD_SEG_CUSTOM3, 3)
+   .seg(1, BINCMD_SEG_FREEZE, 1).seg(1, BINCMD_SEG_SELECTED, 1);
+  assertSameAsJson(p, 11, "{\"seg\":[{\"id\":1,\"fx\":8,\"sx\":10,\"ix\":20,\"pal\":6,\"bri\":99,\"cct\":127,"
+                          "\"c1\":1,\"c2\":2,\"c3\":3,\"frz\":true,\"sel\":true}]}");
+}
+
+void test_segment_colors(void) {
+  Packet p;
+  p.seg(0, BINCMD_SEG_COLOR0, 0x10FF8000).seg(0, BINCMD_SEG_COLOR1, 0x00000080).seg(0, BINCMD_SEG_COLOR2, 0x00010203);
+  assertSameAsJson(p, 3, "{\"seg\":[{\"id\":0,\"col\":[[255,128,0,16],[0,0,128,0],[1,2,3,0]]}]}");
+}
+
+// segment ID 255 applies to selected segments, like a JSON "seg" object without ID
+void test_selected_segments(void) {
+  Packet p;
+  p.seg(255, BINCMD_SEG_SPEED, 33).seg(255, BINCMD_SEG_ON, 0);
+  assertSameAsJson(p, 2, "{\"seg\":{\"sx\":33,\"on\":false}}");
+}
+
+// unknown opcodes, fields and segments are skipped, the other commands are applied
+void test_unknown_commands_skipped(void) {
+  Packet p;
+  p.add(9, 0, 0, 0).global(99, 1).seg(7, BINCMD_SEG_SPEED, 1).seg(0, BINCMD_SEG_SPEED, 44);
+  assertSameAsJson(p, 1, "{\"seg\":[{\"id\":0,\"sx\":44}]}");
+}
+
+void test_invalid_packet(void) {
+  reset();
+  String before = stateJson();
+  const uint8_t badMagic[]   = {0x00, BINCMD_VERSION, BINCMD_OP_GLOBAL, 0, BINCMD_GLOBAL_BRI, 1, 0, 0, 0};
+  const uint8_t badVersion[] = {BINCMD_MAGIC, 99, BINCMD_OP_GLOBAL, 0, BINCMD_GLOBAL_BRI, 1, 0, 0, 0};
+  const uint8_t truncated[]  = {BINCMD_MAGIC, BINCMD_VERSION, BINCMD_OP_GLOBAL, 0, BINCMD_GLOBAL_BRI, 1};
+  TEST_ASSERT_EQUAL_INT(-BINCMD_ACK_INVALID, handleBinaryCommand(badMagic, sizeof(badMagic)));
+  TEST_ASSERT_EQUAL_INT(-BINCMD_ACK_INVALID, handleBinaryCommand(badVersion, sizeof(badVersion)));
+  TEST_ASSERT_EQUAL_INT(-BINCMD_ACK_INVALID, handleBinaryCommand(truncated, sizeof(truncated)));
+  TEST_ASSERT_EQUAL_INT(-BINCMD_ACK_INVALID, handleBinaryCommand(badMagic, 1));
+  runLoop();
+  TEST_ASSERT_EQUAL_STRING(before.c_str(), stateJson().c_str());
+}
+
+// WS packets are queued (without JSON buffer) and applied from loop in order with deferred JSON requests
+void test_deferred_in_order(void) {
+  reset();
+  Packet p;
+  p.seg(0, BINCMD_SEG_SPEED, 20);
+  const char *json = "{\"seg\":[{\"id\":0,\"sx\":10}]}";
+
+  TEST_ASSERT_TRUE(requestJSONBufferLock(1)); // JSON request has to wait for buffer
+  TEST_ASSERT_TRUE(deferJSONRequest(11, json, strlen(json)));
+  TEST_ASSERT_TRUE(deferJSONRequest(24, (const char*)p.data(), p.len()));
+  handleDeferredJSON();
+  TEST_ASSERT_EQUAL_UINT8(128, strip.getSegment(0).speed); // binary packet does not overtake JSON request
+  releaseJSONBufferLock();
+
+  handleDeferredJSON();
+  TEST_ASSERT_EQUAL_UINT8(10, strip.getSegment(0).speed);
+  handleDeferredJSON();
+  TEST_ASSERT_EQUAL_UINT8(20, strip.getSegment(0).speed);
+}
+
+// binary packets are applied while the JSON buffer is in use
+void test_deferred_without_json_buffer(void) {
+  reset();
+  Packet p;
+  p.seg(0, BINCMD_SEG_INTENSITY, 5);
+  TEST_ASSERT_TRUE(requestJSONBufferLock(1));
+  TEST_ASSERT_TRUE(deferJSONRequest(24, (const char*)p.data(), p.len()));
+  handleDeferredJSON();
+  releaseJSONBufferLock();
+  TEST_ASSERT_EQUAL_UINT8(5, strip.getSegment(0).intensity);
+}
+
+// another task (e.g. a streamed HTTP response in the async TCP task) holds the state lock until released
+class StateReader {
+  public:
+    StateReader() : _step(0), _thread([this]() {
+      _locked = tryStateLock(17);
+      _step = 1;
+      while (_step != 2) delay(1);
+      if (_locked) releaseStateLock();
+    }) { while (_step != 1) delay(1); }
+    ~StateReader() { release(); }
+    bool locked() const { return _locked; }
+    void release() { if (_thread.joinable()) { _step = 2; _thread.join(); } }
+  private:
+    std::atomic<int> _step;
+    bool _locked = false;
+    std::thread _thread;
+};
+
+// binary packets stay queued while state is serialized by another task
+void test_deferred_while_state_serialized(void) {
+  reset();
+  Packet p;
+  p.seg(0, BINCMD_SEG_SPEED, 30);
+  StateReader reader;
+  TEST_ASSERT_TRUE(reader.locked());
+  TEST_ASSERT_TRUE(deferJSONRequest(24, (const char*)p.data(), p.len()));
+  handleDeferredJSON();
+  TEST_ASSERT_EQUAL_UINT8(128, strip.getSegment(0).speed);
+  reader.release();
+  handleDeferredJSON();
+  TEST_ASSERT_EQUAL_UINT8(30, strip.getSegment(0).speed);
+}
+
+// JSON requests are not applied while state is serialized by another task, the lock is reentrant for its owner
+void test_json_while_state_serialized(void) {
+  reset();
+  {
+    StateReader reader;
+    errorFlag = ERR_NONE;
+    hostRealTime(); // waits for the lock until it times out
+    applyJson("{\"seg\":[{\"id\":0,\"sx\":40}]}");
+    TEST_ASSERT_EQUAL_UINT8(ERR_BUSY, errorFlag);
+    TEST_ASSERT_EQUAL_UINT8(128, strip.getSegment(0).speed);
+  }
+  TEST_ASSERT_TRUE(tryStateLock(1));
+  applyJson("{\"seg\":[{\"id\":0,\"sx\":40}]}"); // e.g. preset saved while state is applied
+  releaseStateLock();
+  TEST_ASSERT_EQUAL_UINT8(40, strip.getSegment(0).speed);
+  StateReader reader; // lock was released completely
+  TEST_ASSERT_TRUE(reader.locked());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_global_fields);
+  RUN_TEST(test_off_and_toggle);
+  RUN_TEST(test_segment_fields);
+  RUN_TEST(test_segment_colors);
+  RUN_TEST(test_selected_segments);
+  RUN_TEST(test_unknown_commands_skipped);
+  RUN_TEST(test_invalid_packet);
+  RUN_TEST(test_deferred_in_order);
+  RUN_TEST(test_deferred_without_json_buffer);
+  RUN_TEST(test_deferred_while_state_serialized);
+  RUN_TEST(test_json_while_state_serialized);
+  return UNITY_END();
+}
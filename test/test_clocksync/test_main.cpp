@@ -0,0 +1,209 @@
+#include <unity.h>
+#include <wled_host.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+ * Cluster clock sync (clocksync.cpp) and frame lock (framelock.cpp) of several nodes: nodes are separate processes
+ * on the loopback interface (127.0.0.x) with injected network latency (hostSetLatency()), the test process is the
+ * leader (lowest IP address). Nodes may have different uptimes (clocks ahead of the leader), so their timebases differ.
+ * Followers report how well they follow the leader's effect time when the simulation ends.
+ */
+
+#define CS_TEST_PORT    29326 // udpPort, udpPort2 is the next one
+#define CS_TEST_FPS     20
+#define CS_TEST_TIME    5000  // ms simulated
+#define CS_TEST_JITTER  2000  // us, random part of latency
+#define CS_LEADER_LATENCY 5000  // us, packets received by the leader
+
+// follower node in a child process
+struct NodeConfig {
+  uint8_t  unit;    // 127.0.0.unit
+  uint32_t latency; // us, packets received by the node
+  uint32_t ahead;   // ms uptime of node is ahead of leader
+};
+
+// sent by the follower to the test process at the end of the simulation
+struct NodeReport {
+  bool     reported;  // false if the node did not report (crashed or hung)
+  bool     locked;    // clockSyncLocked()
+  uint8_t  leader;    // getClockLeader(), unit ID
+  bool     leaderIp;  // getClockLeader() is the full address of the leader
+  int32_t  tbError;   // ms, timebase minus the one expected from the leader's timebase and uptime difference
+  int32_t  clkOffset; // us, offset of leader effect time measured by the node (see NodeStruct)
+  bool     frameLock; // frameLockActive()
+  int32_t  phase;     // us, see framelock.cpp
+};
+
+struct Node {
+  pid_t pid;
+  int   pipe; // read end: ready byte, then NodeReport
+  NodeConfig cfg;
+};
+
+static uint32_t leaderTimebase = 0; // of the test, set before nodes are started
+
+static void initNode(IPAddress ip, uint32_t latency) {
+  hostSetNetwork(ip);
+  hostSetLatency(latency, CS_TEST_JITTER);
+  hostInitStrip(10);
+  strip.setTargetFps(CS_TEST_FPS);
+  strip.getSegment(0).setMode(FX_MODE_RAINBOW);
+  udpPort  = CS_TEST_PORT;
+  udpPort2 = CS_TEST_PORT + 1;
+  udpMulticast = true;
+  nodeListEnabled = clockSyncEnabled = frameLockEnabled = true;
+  Nodes.setCapacity(nodeListSize); // as set up by WLED::setup()
+  udpConnected  = notifierUdp.begin(udpPort);
+  udp2Connected = notifier2Udp.begin(udpPort2);
+  updateMulticastGroups(true);
+  handleNotifications(); // joins groups
+}
+
+// loop() of a node (parts used by clock sync and frame lock), node info is broadcast more often than by WLED
+static void runNode(uint32_t ms) {
+  uint32_t lastInfo = millis() - 1000;
+  for (uint32_t start = millis(); millis() - start < ms; delay(1)) {
+    if (millis() - lastInfo >= 500) {
+      lastInfo = millis();
+      sendSysInfoUDP();
+    }
+    handleNotifications();
+    handleClockSync();
+    strip.service();
+    handleFrameLock();
+  }
+}
+
+static int runFollower(const NodeConfig &cfg, int pipe) {
+  if (cfg.ahead) { // uptime ahead of leader (real time continues from there)
+    hostSetMillis(millis() + cfg.ahead);
+    hostRealTime();
+  }
+  initNode(IPAddress(127, 0, 0, cfg.unit), cfg.latency);
+  strip.timebase = leaderTimebase + 12345; // not in sync
+  char c = 1;
+  if (write(pipe, &c, 1) != 1) return 1;
+  runNode(CS_TEST_TIME + 500); // leader stops first
+
+  NodeReport r = {};
+  r.reported = true;
+  r.locked = clockSyncLocked();
+  r.leader = getClockLeader()[3];
+  r.leaderIp = uint32_t(getClockLeader()) == uint32_t(IPAddress(127, 0, 0, 2));
+  r.tbError = (int32_t)(strip.timebase - (leaderTimebase - cfg.ahead));
+  NodeStruct *leader = Nodes.find(getClockLeader());
+  r.clkOffset = leader ? leader->clkOffset : INT32_MAX;
+  r.frameLock = frameLockActive();
+  if (!requestJSONBufferLock(1)) return 1;
+  JsonObject flk = doc.to<JsonObject>();
+  serializeFrameLock(flk);
+  r.phase = flk[F("flk")][F("ph")] | INT32_MAX;
+  releaseJSONBufferLock();
+  return write(pipe, &r, sizeof(r)) == sizeof(r) ? 0 : 1;
+}
+
+// runs the follower in a child process, returns after it is ready
+static Node startNode(const NodeConfig &cfg) {
+  int fds[2];
+  TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    _exit(runFollower(cfg, fds[1])); // no atexit handlers of the test process
+  }
+  close(fds[1]);
+  char c;
+  TEST_ASSERT_EQUAL_INT(1, read(fds[0], &c, 1));
+  return {pid, fds[0], cfg};
+}
+
+static NodeReport nodeReport(Node &n) {
+  int status = 0;
+  bool exited = false;
+  for (int i = 0; i < 300 && !exited; i++) {
+    exited = waitpid(n.pid, &status, WNOHANG) == n.pid;
+    if (!exited) delay(10);
+  }
+  if (!exited) {
+    kill(n.pid, SIGKILL);
+    waitpid(n.pid, &status, 0);
+  }
+  NodeReport r = {};
+  ssize_t len = read(n.pipe, &r, sizeof(r));
+  close(n.pipe);
+  if (!exited || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || len != sizeof(r)) r.reported = false;
+  return r;
+}
+
+// followers must follow the leader's effect time within half the latency asymmetry (NTP assumes symmetric paths)
+static void checkFollower(const Node &n, const NodeReport &r) {
+  char msg[48];
+  snprintf(msg, sizeof(msg), "follower %u", n.cfg.unit);
+  int32_t asym = ((int32_t)n.cfg.latency - CS_LEADER_LATENCY) / 2;
+  int32_t tol = (asym < 0 ? -asym : asym) + CS_TEST_JITTER + 1000; // jitter of the best sample, timebase is in ms
+  TEST_ASSERT_TRUE_MESSAGE(r.reported, msg);
+  TEST_ASSERT_TRUE_MESSAGE(r.locked, msg);
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(2, r.leader, msg);
+  TEST_ASSERT_TRUE_MESSAGE(r.leaderIp, msg);
+  TEST_ASSERT_INT32_WITHIN_MESSAGE(tol / 1000 + 1, 0, r.tbError, msg);
+  TEST_ASSERT_INT32_WITHIN_MESSAGE(tol, 0, r.clkOffset, msg);
+  // ticks of the leader arrive after the latency (plus loop delays of both nodes)
+  TEST_ASSERT_TRUE_MESSAGE(r.frameLock, msg);
+  TEST_ASSERT_INT32_WITHIN_MESSAGE(tol + 3000, n.cfg.latency, r.phase, msg);
+}
+
+static void runLeader(Node *nodes, size_t count) {
+  initNode(IPAddress(127, 0, 0, 2), CS_LEADER_LATENCY);
+  strip.timebase = leaderTimebase;
+  runNode(CS_TEST_TIME);
+  bool leader = clockSyncLeader(), frameLock = frameLockActive();
+  size_t nodeCount = Nodes.size();
+  NodeReport reports[count];
+  for (size_t i = 0; i < count; i++) reports[i] = nodeReport(nodes[i]); // all followers have exited
+  TEST_ASSERT_TRUE(leader);
+  TEST_ASSERT_TRUE(frameLock);
+  TEST_ASSERT_EQUAL_UINT32(count, nodeCount);
+  for (size_t i = 0; i < count; i++) checkFollower(nodes[i], reports[i]);
+}
+
+void setUp(void) {
+  hostSetNetwork(IPAddress(127, 0, 0, 2));
+}
+
+void tearDown(void) {
+  notifierUdp.stop();
+  notifier2Udp.stop();
+  udpConnected = udp2Connected = false;
+  nodeListEnabled = clockSyncEnabled = frameLockEnabled = false;
+  Nodes.clear();
+  hostSetLatency(0);
+}
+
+// effect time passes the 2^32 ms wrap during the simulation
+void test_followers_across_effect_time_wrap(void) {
+  leaderTimebase = 0U - (millis() + CS_TEST_TIME / 2);
+  Node nodes[] = {
+    startNode({3, CS_LEADER_LATENCY, 0}),
+    startNode({4, 2 * CS_LEADER_LATENCY, 0}),    // asymmetric path
+    startNode({5, CS_LEADER_LATENCY / 2, 3000}), // asymmetric path, different uptime
+  };
+  runLeader(nodes, 3);
+}
+
+// the timebase of a node with more uptime than the leader wraps (effect times agree in the 32 bit ms part only)
+void test_follower_timebase_wrapped(void) {
+  leaderTimebase = 1000;
+  Node nodes[] = {
+    startNode({3, CS_LEADER_LATENCY, 20000}),
+  };
+  runLeader(nodes, 1);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_followers_across_effect_time_wrap);
+  RUN_TEST(test_follower_timebase_wrapped);
+  return UNITY_END();
+}
@@ -0,0 +1,123 @@
+#include <unity.h>
+#include <wled_host.h>
+
+/*
+ * Delta sync (udp.cpp): the notifications of this node are captured by a probe socket of another node address
+ * (joined to the multicast group of sync group 1), which also sends the keyframe requests of a receiver.
+ */
+
+#define DS_TEST_PORT 29328
+#define DS_SEGS      4
+#define DS_SEG_SIZE  36
+#define DS_PROBE_IP  IPAddress(127, 0, 0, 9)
+
+static WiFiUDP probe;
+static uint8_t packet[1500];
+static size_t  packetLen;
+
+// sync packet layout (version 13)
+static uint8_t segCount()  { return packet[39]; }
+static uint8_t seq()       { return packet[41 + segCount()*DS_SEG_SIZE]; }
+static uint8_t keySeq()    { return packet[42 + segCount()*DS_SEG_SIZE]; }
+static bool    isDelta()   { return packet[43 + segCount()*DS_SEG_SIZE] & 0x01; }
+static uint8_t segId(int n) { return packet[41 + n*DS_SEG_SIZE]; }
+static uint32_t segColor(int n) { const uint8_t *p = packet + 41 + n*DS_SEG_SIZE + 15; return RGBW32(p[0], p[1], p[2], p[3]); }
+
+// next notification of this node, false if none arrives within 100ms
+static bool receive() {
+  for (uint32_t start = millis(); millis() - start < 100; delay(1)) {
+    int len = probe.parsePacket();
+    if (!len) continue;
+    packetLen = probe.read(packet, sizeof(packet));
+    if (packetLen > 43 && packet[0] == 0) return true;
+  }
+  return false;
+}
+
+static void sendNotify() {
+  notify(CALL_MODE_DIRECT_CHANGE);
+  TEST_ASSERT_TRUE(receive());
+}
+
+void setUp(void) {
+  hostSetNetwork(DS_PROBE_IP); // probe is another node
+  TEST_ASSERT_TRUE(probe.begin(DS_TEST_PORT));
+  hostSetNetwork(IPAddress(127, 0, 0, 2));
+  hostInitStrip(DS_SEGS * 10);
+  for (int i = 0; i < DS_SEGS; i++) strip.setSegment(i, i * 10, (i + 1) * 10);
+  for (int i = 0; i < DS_SEGS; i++) strip.getSegment(i).setColor(0, RGBW32(10*i, 0, 0, 0));
+  udpPort = DS_TEST_PORT;
+  udpMulticast = true;
+  udpNumRetries = 0;
+  syncGroups = receiveGroups = 0x01;
+  notifyDirect = true;
+  udpConnected = notifierUdp.begin(udpPort);
+  updateMulticastGroups(true);
+  handleNotifications(); // joins group 1, probe socket is a member too
+  sendNotify(); // full packet, keyframe of previous test is outdated
+  udpDeltaSync = true;
+  sendNotify(); // keyframe
+  TEST_ASSERT_FALSE(isDelta());
+  TEST_ASSERT_EQUAL_UINT8(DS_SEGS, segCount());
+}
+
+void tearDown(void) {
+  probe.stop();
+  notifierUdp.stop();
+  udpConnected = false;
+  udpDeltaSync = false;
+}
+
+void test_delta_contains_changed_segment(void) {
+  strip.getSegment(2).setColor(0, RGBW32(1, 2, 3, 0));
+  sendNotify();
+  TEST_ASSERT_TRUE(isDelta());
+  TEST_ASSERT_EQUAL_UINT8(1, segCount());
+  TEST_ASSERT_EQUAL_UINT8(2, segId(0));
+  TEST_ASSERT_EQUAL_HEX32(RGBW32(1, 2, 3, 0), segColor(0));
+}
+
+// receivers applied the changed value, it has to be sent again when it is back at the keyframe value
+void test_segment_returned_to_keyframe_value(void) {
+  uint32_t keyColor = strip.getSegment(2).colors[0];
+  strip.getSegment(2).setColor(0, RGBW32(1, 2, 3, 0));
+  sendNotify();
+  strip.getSegment(2).setColor(0, keyColor);
+  sendNotify();
+  TEST_ASSERT_TRUE(isDelta());
+  TEST_ASSERT_EQUAL_UINT8(1, segCount());
+  TEST_ASSERT_EQUAL_UINT8(2, segId(0));
+  TEST_ASSERT_EQUAL_HEX32(keyColor, segColor(0));
+}
+
+// a receiver that missed the keyframe gets a new one right away (not with the next change)
+void test_keyframe_request_answered(void) {
+  strip.getSegment(1).setColor(0, RGBW32(1, 2, 3, 0));
+  sendNotify();
+  TEST_ASSERT_TRUE(isDelta());
+  uint8_t key = keySeq();
+  uint8_t request[3] = {0, 250, key};
+  probe.beginPacket(IPAddress(127, 0, 0, 2), DS_TEST_PORT);
+  probe.write(request, sizeof(request));
+  probe.endPacket();
+  for (int i = 0; i < 20; i++) { handleNotifications(); delay(1); }
+  TEST_ASSERT_TRUE(receive());
+  TEST_ASSERT_FALSE(isDelta());
+  TEST_ASSERT_EQUAL_UINT8(DS_SEGS, segCount());
+  TEST_ASSERT_NOT_EQUAL(key, seq());
+
+  // another receiver requesting the same (old) keyframe gets the new one already sent
+  probe.beginPacket(IPAddress(127, 0, 0, 2), DS_TEST_PORT);
+  probe.write(request, sizeof(request));
+  probe.endPacket();
+  for (int i = 0; i < 20; i++) { handleNotifications(); delay(1); }
+  TEST_ASSERT_FALSE(receive());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_delta_contains_changed_segment);
+  RUN_TEST(test_segment_returned_to_keyframe_value);
+  RUN_TEST(test_keyframe_request_answered);
+  return UNITY_END();
+}
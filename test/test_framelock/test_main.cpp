@@ -0,0 +1,105 @@
+#include <unity.h>
+#include <wled_host.h>
+
+/*
+ * Frame lock (framelock.cpp) on the clock sync leader: frames are shown on the grid of the effect time,
+ * between render and show the strip is idle, so the render task does not hold up loop() (waitUntilIdle())
+ */
+
+#define FLK_TEST_FPS 10 // 100ms period, much longer than rendering
+
+static std::thread       renderThread;
+static std::atomic<bool> rendering(false);
+static std::atomic<int64_t>  maxShowErrorUs(0);
+
+// render task: also measures how far shows are off the grid
+static void renderTask() {
+  uint32_t shows = hostBus()->getShowCount();
+  while (rendering) {
+    strip.service();
+    int64_t end = localMicros();
+    if (hostBus()->getShowCount() != shows) {
+      shows = hostBus()->getShowCount();
+      int64_t period = frameLockPeriod();
+      int64_t phase = (clusterMicros(end) + period / 2) % period - period / 2; // show time (approx.) relative to grid
+      maxShowErrorUs = MAX(maxShowErrorUs.load(), phase < 0 ? -phase : phase);
+    }
+    delay(1);
+  }
+}
+
+// renders one frame slowly (spikeDelay ms)
+static std::atomic<uint32_t> spikeDelay(0);
+
+static uint16_t mode_spike(void) {
+  delay(spikeDelay);
+  spikeDelay = 0;
+  SEGMENT.fill(SEGCOLOR(0));
+  return FRAMETIME;
+}
+static const char _data_FX_MODE_SPIKE[] PROGMEM = "Spike";
+
+void setUp(void) {
+  hostInitStrip(60);
+  strip.setTargetFps(FLK_TEST_FPS);
+  strip.getSegment(0).setMode(FX_MODE_RAINBOW); // renders every frame
+  // this node is clock sync leader (no other nodes)
+  nodeListEnabled = clockSyncEnabled = frameLockEnabled = true;
+  udp2Connected = true;
+  maxShowErrorUs = 0;
+  rendering = true;
+  renderThread = std::thread(renderTask);
+}
+
+void tearDown(void) {
+  rendering = false;
+  if (renderThread.joinable()) renderThread.join();
+  nodeListEnabled = clockSyncEnabled = frameLockEnabled = false;
+  udp2Connected = false;
+  while (strip.isSuspended()) strip.resume();
+}
+
+void test_frames_on_grid(void) {
+  TEST_ASSERT_TRUE(frameLockActive());
+  uint32_t shows = hostBus()->getShowCount();
+  delay(1000);
+  TEST_ASSERT_UINT32_WITHIN(1, FLK_TEST_FPS, hostBus()->getShowCount() - shows);
+  TEST_ASSERT_LESS_THAN(10000, maxShowErrorUs.load()); // render thread checks every ms (host scheduling adds jitter)
+}
+
+// loop() can change segments between render and show of a frame: after a slow frame the render time estimate
+// (the lead frames are rendered with) is high, waitUntilIdle() must not wait for the idle time before show
+void test_wait_until_idle(void) {
+  strip.suspend();
+  TEST_ASSERT_TRUE(strip.waitUntilIdle());
+  strip.addEffect(255, &mode_spike, _data_FX_MODE_SPIKE);
+  uint8_t spike = 0;
+  while (spike < strip.getModeCount() && strip.getModeData(spike) != _data_FX_MODE_SPIKE) spike++;
+  TEST_ASSERT_LESS_THAN(strip.getModeCount(), spike);
+  spikeDelay = 60;
+  strip.getSegment(0).setMode(spike);
+  strip.resume();
+  while (spikeDelay) delay(1); // slow frame rendered
+  delay(20);
+
+  uint32_t maxWaitUs = 0;
+  for (int i = 0; i < 40; i++) {
+    int64_t start = localMicros();
+    strip.suspend();
+    TEST_ASSERT_TRUE(strip.waitUntilIdle());
+    maxWaitUs = MAX(maxWaitUs, (uint32_t)(localMicros() - start));
+    strip.resume();
+    delay(7);
+  }
+  TEST_ASSERT_LESS_THAN(10000, maxWaitUs); // rendering takes about 1ms
+  uint32_t shows = hostBus()->getShowCount();
+  delay(300);
+  TEST_ASSERT_GREATER_THAN(shows, hostBus()->getShowCount());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_frames_on_grid);
+  RUN_TEST(test_wait_until_idle);
+  return UNITY_END();
+}
@@ -0,0 +1,82 @@
+#include <unity.h>
+#include <wled_host.h>
+
+/*
+ * Effects render from the segment frame time and the segment PRNG (seeded by Segment::beginFrame()) only,
+ * so the same segment rendered at the same strip time gives the same frames, whatever the global PRNG state is
+ * (this is what lets synced nodes show identical random effects); audio reactive effects use simulated sound
+ */
+
+#define FX_TEST_LEN    60
+#define FX_TEST_FRAMES 24
+#define FX_TEST_START  100000 // strip time of first frame
+#define FX_TEST_STEP   20     // ms between frames
+
+static uint32_t frames[2][FX_TEST_FRAMES][FX_TEST_LEN];
+
+// renders frames of a freshly set up segment at strip time start + n * FX_TEST_STEP, the global PRNGs are seeded with globalSeed
+// millis() keeps counting between runs, strip time is set through timebase (like on a synced node)
+static void renderFrames(uint8_t mode, uint32_t start, uint16_t globalSeed, uint32_t out[FX_TEST_FRAMES][FX_TEST_LEN]) {
+  uint32_t uptime = millis() + 1000; // busses are done sending
+  hostSetMillis(uptime);
+  hostInitStrip(FX_TEST_LEN); // new segment, no effect data from previous run
+  Segment &seg = strip.getSegment(0);
+  seg.setMode(mode, true);
+  if (seg.palette == 1) seg.setPalette(6); // random palette is shared and changed by the global PRNG
+  random16_set_seed(globalSeed);
+  randomSeed(globalSeed);
+  strip.timebase = start - uptime;
+  for (int f = 0; f < FX_TEST_FRAMES; f++) {
+    hostSetMillis(uptime + f * FX_TEST_STEP);
+    strip.service();
+    for (int i = 0; i < FX_TEST_LEN; i++) out[f][i] = hostBus()->getFrameColor(i);
+  }
+}
+
+static bool isReserved(uint8_t mode) {
+  return !strncmp_P("RSVD", strip.getModeData(mode), 4);
+}
+
+void setUp(void) {
+  modeBlending = false; // no transition from previous effect
+  strip.setTransition(0);
+}
+
+void tearDown(void) {
+  strip.timebase = 0;
+  hostRealTime();
+}
+
+void test_same_time_same_frames(void) {
+  for (uint8_t mode = 0; mode < strip.getModeCount(); mode++) {
+    if (isReserved(mode)) continue;
+    renderFrames(mode, FX_TEST_START, 1,     frames[0]);
+    renderFrames(mode, FX_TEST_START, 54321, frames[1]);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Effect %u (%.24s) is not deterministic", mode, strip.getModeData(mode));
+    TEST_ASSERT_EQUAL_HEX32_ARRAY_MESSAGE(frames[0], frames[1], FX_TEST_FRAMES * FX_TEST_LEN, msg);
+  }
+}
+
+// seed depends on frame time: random effects do not repeat the same frames at another time
+void test_other_time_other_frames(void) {
+  renderFrames(FX_MODE_FIREWORKS, FX_TEST_START,     1, frames[0]);
+  renderFrames(FX_MODE_FIREWORKS, FX_TEST_START + 1, 1, frames[1]);
+  TEST_ASSERT_TRUE(memcmp(frames[0], frames[1], sizeof(frames[0])) != 0);
+}
+
+// segment is lit, so equal frames above are not just black
+void test_frames_are_rendered(void) {
+  renderFrames(FX_MODE_FIREWORKS, FX_TEST_START, 1, frames[0]);
+  uint32_t lit = 0;
+  for (int f = 0; f < FX_TEST_FRAMES; f++) for (int i = 0; i < FX_TEST_LEN; i++) if (frames[0][f][i]) lit++;
+  TEST_ASSERT_GREATER_THAN(0, lit);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_same_time_same_frames);
+  RUN_TEST(test_other_time_other_frames);
+  RUN_TEST(test_frames_are_rendered);
+  return UNITY_END();
+}
@@ -0,0 +1,182 @@
+// generated by test_golden_frames (WLED_GOLDEN_UPDATE=1): effect ID, hash of its recording
+static const GoldenFrames goldenFrames[] = {
+  {  0, 0x6566D26D}, // Solid
+  {  1, 0x155084B0}, // Blink
+  {  2, 0x9AE7DC0A}, // Breathe
+  {  3, 0x926E0B2A}, // Wipe
+  {  4, 0x88FF65FB}, // Wipe Random
+  {  5, 0x1850449B}, // Random Colors
+  {  6, 0x0BC2047A}, // Sweep
+  {  7, 0xBF08BA88}, // Dynamic
+  {  8, 0xED20382B}, // Colorloop
+  {  9, 0xEA813880}, // Rainbow
+  { 10, 0x5F317AC4}, // Scan
+  { 11, 0xE92C89DA}, // Scan Dual
+  { 12, 0xAE02B0A6}, // Fade
+  { 13, 0x9407B174}, // Theater
+  { 14, 0x2CC70B62}, // Theater Rainbow
+  { 15, 0x405E5EC8}, // Running
+  { 16, 0xBB11F1F6}, // Saw
+  { 17, 0x95E0E2B1}, // Twinkle
+  { 18, 0xE26BB624}, // Dissolve
+  { 19, 0x165A9D2E}, // Dissolve Rnd
+  { 20, 0xD9EA9165}, // Sparkle
+  { 21, 0x2915CE5A}, // Sparkle Dark
+  { 22, 0xA68EE720}, // Sparkle+
+  { 23, 0x26BDC84E}, // Strobe
+  { 24, 0x8B826BE9}, // Strobe Rainbow
+  { 25, 0x123984FC}, // Strobe Mega
+  { 26, 0x567BB666}, // Blink Rainbow
+  { 27, 0x2289CFD0}, // Android
+  { 28, 0x3118C56F}, // Chase
+  { 29, 0xDC2127D6}, // Chase Random
+  { 30, 0xD8BF9380}, // Chase Rainbow
+  { 31, 0x01786F45}, // Chase Flash
+  { 32, 0xEC0C7E4B}, // Chase Flash Rnd
+  { 33, 0x264446E4}, // Rainbow Runner
+  { 34, 0xA35B5CF4}, // Colorful
+  { 35, 0x32B62941}, // Traffic Light
+  { 36, 0xA06D6CF2}, // Sweep Random
+  { 37, 0xED690C33}, // Chase 2
+  { 38, 0x81A23144}, // Aurora
+  { 39, 0x82D37ABD}, // Stream
+  { 40, 0xBF037E3D}, // Scanner
+  { 41, 0x5C37F744}, // Lighthouse
+  { 42, 0xBE9A374F}, // Fireworks
+  { 43, 0x6B941367}, // Rain
+  { 44, 0x1F46AA33}, // Tetrix
+  { 45, 0x229A7C1B}, // Fire Flicker
+  { 46, 0x64141C0E}, // Gradient
+  { 47, 0xFECF3A67}, // Loading
+  { 48, 0xFA920BB6}, // Rolling Balls
+  { 49, 0xE5CA2D68}, // Fairy
+  { 50, 0xDC3B6ECF}, // Two Dots
+  { 51, 0xF077AA12}, // Fairytwinkle
+  { 52, 0x8BE1740F}, // Running Dual
+  { 54, 0xCBC188E0}, // Chase 3
+  { 55, 0x05889E80}, // Tri Wipe
+  { 56, 0xB299B431}, // Tri Fade
+  { 57, 0x8CD14F1F}, // Lightning
+  { 58, 0x5779C99E}, // ICU
+  { 59, 0x6BB5A6DB}, // Multi Comet
+  { 60, 0x304EC192}, // Scanner Dual
+  { 61, 0x064DE288}, // Stream 2
+  { 62, 0x76FBBF97}, // Oscillate
+  { 63, 0xC6E2FD6B}, // Pride 2015
+  { 64, 0xB5FBECC3}, // Juggle
+  { 65, 0x3D1181A9}, // Palette
+  { 66, 0xBE7DFBEF}, // Fire 2012
+  { 67, 0xD23B1A29}, // Colorwaves
+  { 68, 0xD448DED2}, // Bpm
+  { 69, 0x5CD1AD57}, // Fill Noise
+  { 70, 0xF3247600}, // Noise 1
+  { 71, 0x952871E3}, // Noise 2
+  { 72, 0xE914E09D}, // Noise 3
+  { 73, 0x2FCECDEC}, // Noise 4
+  { 74, 0x5E363698}, // Colortwinkles
+  { 75, 0xA5B511FA}, // Lake
+  { 76, 0xE6018714}, // Meteor
+  { 77, 0x6C913512}, // Meteor Smooth
+  { 78, 0x537E4890}, // Railway
+  { 79, 0x6B626E44}, // Ripple
+  { 80, 0x5848A4E6}, // Twinklefox
+  { 81, 0x50ACBBD6}, // Twinklecat
+  { 82, 0xD574D48B}, // Halloween Eyes
+  { 83, 0xB1D95461}, // Solid Pattern
+  { 84, 0x07B5D3E6}, // Solid Pattern Tri
+  { 85, 0x19848686}, // Spots
+  { 86, 0x48015DBF}, // Spots Fade
+  { 87, 0xA25806D4}, // Glitter
+  { 88, 0x1CA745EA}, // Candle
+  { 89, 0xD1D7EC9C}, // Fireworks Starburst
+  { 90, 0xCCCBFEB8}, // Fireworks 1D
+  { 91, 0xC6DB2E10}, // Bouncing Balls
+  { 92, 0xB99A3491}, // Sinelon
+  { 93, 0x00BDFB53}, // Sinelon Dual
+  { 94, 0xFCAA786D}, // Sinelon Rainbow
+  { 95, 0xC21AB1B4}, // Popcorn
+  { 96, 0xB0B011DD}, // Drip
+  { 97, 0x7E6003B9}, // Plasma
+  { 98, 0xFACC2FF2}, // Percent
+  { 99, 0x98541AFD}, // Ripple Rainbow
+  {100, 0x680AC49D}, // Heartbeat
+  {101, 0xABFB7AAD}, // Pacifica
+  {102, 0x2C63433C}, // Candle Multi
+  {103, 0x6AFCF628}, // Solid Glitter
+  {104, 0x6B7C82DE}, // Sunrise
+  {105, 0x7AA18ADE}, // Phased
+  {106, 0xCFA99450}, // Twinkleup
+  {107, 0xC113ED01}, // Noise Pal
+  {108, 0xCF175C5B}, // Sine
+  {109, 0x1FE8A743}, // Phased Noise
+  {110, 0xE58EB0AE}, // Flow
+  {111, 0x3D2E3A20}, // Chunchun
+  {112, 0x4DA3EDB0}, // Dancing Shadows
+  {113, 0x8033610B}, // Washing Machine
+  {115, 0xB231D22C}, // Blends
+  {116, 0xA1870A0A}, // TV Simulator
+  {117, 0x527A46E0}, // Dynamic Smooth
+  {118, 0xD3D8AF92}, // Spaceships
+  {119, 0x3CD3F2DA}, // Crazy Bees
+  {120, 0x8DFCDBEF}, // Ghost Rider
+  {121, 0x92BA5F8F}, // Blobs
+  {122, 0x0281ED0C}, // Scrolling Text
+  {123, 0xE66AEFC0}, // Drift Rose
+  {124, 0x2C78FA46}, // Distortion Waves
+  {125, 0x3E3630F6}, // Soap
+  {126, 0x547CC028}, // Octopus
+  {127, 0x2234D441}, // Waving Cell
+  {128, 0x32AF07D3}, // Pixels
+  {129, 0xDCF27913}, // Pixelwave
+  {130, 0xA39A1397}, // Juggles
+  {131, 0xF800E3B0}, // Matripix
+  {132, 0x8A6A1C31}, // Gravimeter
+  {133, 0xFBB7FD9D}, // Plasmoid
+  {134, 0xB7FFB402}, // Puddles
+  {135, 0xFAB801FE}, // Midnoise
+  {136, 0x3ED38602}, // Noisemeter
+  {137, 0x64D9303D}, // Freqwave
+  {138, 0xB947844E}, // Freqmatrix
+  {139, 0xFB3F61BD}, // GEQ
+  {140, 0xB4618D30}, // Waterfall
+  {141, 0x0D9C066E}, // Freqpixels
+  {143, 0x8A303DA6}, // Noisefire
+  {144, 0x8F8C58F4}, // Puddlepeak
+  {145, 0xFFEDA1EC}, // Noisemove
+  {146, 0x0D9A99DB}, // Noise2D
+  {147, 0x61065851}, // Perlin Move
+  {148, 0x52C67B6A}, // Ripple Peak
+  {149, 0xF26559E2}, // Firenoise
+  {150, 0x27F3676C}, // Squared Swirl
+  {152, 0x2A274F4D}, // DNA
+  {153, 0xE57A3550}, // Matrix
+  {154, 0xB6E607A4}, // Metaballs
+  {155, 0xA888921E}, // Freqmap
+  {156, 0x2A9A789F}, // Gravcenter
+  {157, 0x37AEF233}, // Gravcentric
+  {158, 0x7A3B6E15}, // Gravfreq
+  {159, 0xCBF91764}, // DJ Light
+  {160, 0x3933D1FF}, // Funky Plank
+  {162, 0x6A209889}, // Pulser
+  {163, 0xE8BE41CB}, // Blurz
+  {164, 0x76FD380E}, // Drift
+  {165, 0xB3A8FA8D}, // Waverly
+  {166, 0xD1850FDA}, // Sun Radiation
+  {167, 0xD3201808}, // Colored Bursts
+  {168, 0xF30627ED}, // Julia
+  {172, 0x93766611}, // Game Of Life
+  {173, 0x67D6C10A}, // Tartan
+  {174, 0xA4388663}, // Polar Lights
+  {175, 0x8AA8804D}, // Swirl
+  {176, 0x5255BE5B}, // Lissajous
+  {177, 0x37F33C81}, // Frizzles
+  {178, 0x958FBBF8}, // Plasma Ball
+  {179, 0x133F088D}, // Flow Stripe
+  {180, 0x91253D53}, // Hiphotic
+  {181, 0xE27293E0}, // Sindots
+  {182, 0xD89D639A}, // DNA Spiral
+  {183, 0xB2CEC401}, // Black Hole
+  {184, 0x54C5799C}, // Wavesins
+  {185, 0x737AF638}, // Rocktaves
+  {186, 0xA88A032D}, // Akemi
+};
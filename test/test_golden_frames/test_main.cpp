@@ -0,0 +1,233 @@
+#include <unity.h>
+#include <wled_host.h>
+
+/*
+ * Golden frames: every effect is recorded by the frame recorder (recorder.cpp) at fixed strip times with fixed PRNG
+ * seeds, the recording must match the one in golden_frames.h (hash of the WLED frame file). A recording must have lit
+ * pixels that change over time and differ from the recordings of other effects, or it would not test the effect.
+ * After an intended change of effect output, regenerate golden_frames.h with WLED_GOLDEN_UPDATE=1 in the environment.
+ * Recordings are replayed by frame playback (fseq.cpp) to the same output as the effect, white included.
+ */
+
+#define GOLDEN_LEN     60
+#define GOLDEN_WIDTH   6      // of matrix (2D effects), tall enough for effects that draw from the bottom up
+#define GOLDEN_FRAMES  100
+#define GOLDEN_START   100000 // strip time of first frame
+#define GOLDEN_STEP    50     // ms between frames (5s, effects that start after a pause show something)
+#define GOLDEN_PALETTE 6      // instead of default or random palette (a single color or changed by the global PRNG)
+#define GOLDEN_FILE    "/golden.wfr"
+
+struct GoldenFrames {
+  uint8_t  mode;
+  uint32_t hash;
+};
+#include "golden_frames.h"
+
+// effects that show nothing (or a single color, or the same as another effect) with their default settings within the
+// recorded time
+static const struct {
+  uint8_t mode, speed, intensity;
+} goldenSettings[] = {
+  {FX_MODE_SUNRISE,            130, 128}, // quick sunrise and sunset (default is a 60 minute sunrise)
+  {FX_MODE_STATIC_PATTERN,       3,   2}, // pattern shorter than the strip
+  {FX_MODE_COLOR_SWEEP,        240, 128}, // turns back within the recorded time (is the same as Wipe before)
+  {FX_MODE_COLOR_SWEEP_RANDOM, 240, 128},
+};
+
+// effects without animation, their recordings do not change over time
+static const uint8_t goldenStatic[] = { FX_MODE_STATIC, FX_MODE_STATIC_PATTERN, FX_MODE_TRI_STATIC_PATTERN, FX_MODE_SPOTS };
+
+static uint32_t live[GOLDEN_FRAMES][GOLDEN_LEN];
+
+static bool isReserved(uint8_t mode) {
+  return !strncmp_P("RSVD", strip.getModeData(mode), 4);
+}
+
+// effect flags (4th field of effect data): '1'/'2' dimensions, 'v'/'f' volume/frequency reactive
+static bool hasFlag(uint8_t mode, char flag) {
+  char data[256];
+  strncpy_P(data, strip.getModeData(mode), sizeof(data)-1);
+  data[sizeof(data)-1] = '\0';
+  char *flags = data;
+  for (int i = 0; i < 3 && flags; i++) if ((flags = strchr(flags, ';'))) flags++;
+  if (!flags) return false;
+  char *end = strchr(flags, ';');
+  if (end) *end = '\0';
+  return strchr(flags, flag);
+}
+
+static void setRecording(bool on) {
+  TEST_ASSERT_TRUE(requestJSONBufferLock(1));
+  char json[96];
+  snprintf(json, sizeof(json), "{\"rec\":{\"on\":%s,\"f\":\"" GOLDEN_FILE "\",\"step\":%d,\"n\":%d}}", on ? "true" : "false", GOLDEN_STEP, GOLDEN_FRAMES);
+  TEST_ASSERT_FALSE(deserializeJson(doc, json));
+  deserializeState(doc.as<JsonObject>());
+  releaseJSONBufferLock();
+  handleRecorder();
+}
+
+// records GOLDEN_FRAMES frames of a freshly set up segment at strip time GOLDEN_START + n * GOLDEN_STEP into GOLDEN_FILE
+// the bus output of each frame is kept in live
+static void recordEffect(uint8_t mode, uint8_t type = TYPE_WS2812_RGB, uint32_t color = 0, uint8_t brightness = 128) {
+  uint32_t uptime = millis() + 1000; // busses are done sending
+  hostSetMillis(uptime);
+  strip.isMatrix = hasFlag(mode, '2') && !hasFlag(mode, '1'); // 2D only effects on a matrix of GOLDEN_LEN pixels
+  strip.panel.clear();
+  if (strip.isMatrix) {
+    Segment::maxWidth = GOLDEN_WIDTH; // default segment (created before matrix is set up)
+    Segment::maxHeight = GOLDEN_LEN / GOLDEN_WIDTH;
+    WS2812FX::Panel p;
+    p.width  = Segment::maxWidth;
+    p.height = Segment::maxHeight;
+    strip.panel.push_back(p);
+  }
+  hostInitStrip(GOLDEN_LEN, 1, type); // new segment, no effect data from previous run
+  strip.setBrightness(brightness, true);
+  Segment &seg = strip.getSegment(0);
+  seg.setMode(mode, true);
+  if (seg.palette <= 1) seg.setPalette(GOLDEN_PALETTE);
+  for (const auto &s : goldenSettings) if (s.mode == mode) {
+    seg.speed = s.speed;
+    seg.intensity = s.intensity;
+  }
+  if (color) seg.setColor(0, color);
+  random16_set_seed(1);
+  randomSeed(1);
+  strip.timebase = GOLDEN_START - uptime;
+  setRecording(true);
+  for (int f = 0; f < GOLDEN_FRAMES; f++) {
+    hostSetMillis(uptime + f * GOLDEN_STEP);
+    strip.service();
+    handleRecorder();
+    for (int i = 0; i < GOLDEN_LEN; i++) live[f][i] = hostBus()->getFrameColor(i);
+  }
+  setRecording(false); // effects that do not show a frame in every slot are recorded up to their last frame
+}
+
+// recording (in live) has lit pixels that change over time (unless the effect is static)
+static bool isRendered(uint8_t mode) {
+  bool lit = false, changed = false;
+  for (uint8_t m : goldenStatic) changed |= m == mode;
+  for (int f = 0; f < GOLDEN_FRAMES; f++) for (int i = 0; i < GOLDEN_LEN; i++) {
+    lit     |= live[f][i] != 0;
+    changed |= live[f][i] != live[0][i];
+  }
+  return lit && changed;
+}
+
+// FNV-1a of the recording
+static uint32_t recordingHash() {
+  File f = WLED_FS.open(GOLDEN_FILE, "r");
+  TEST_ASSERT_TRUE(f);
+  uint32_t hash = 2166136261UL;
+  uint8_t buf[256];
+  for (size_t n; (n = f.read(buf, sizeof(buf))) > 0; ) {
+    for (size_t i = 0; i < n; i++) hash = (hash ^ buf[i]) * 16777619UL;
+  }
+  f.close();
+  return hash;
+}
+
+static const GoldenFrames *findGolden(uint8_t mode) {
+  for (const GoldenFrames &g : goldenFrames) if (g.mode == mode) return &g;
+  return nullptr;
+}
+
+// golden_frames.h next to this file
+static void writeGolden(const uint32_t *hashes) {
+  String path = __FILE__;
+  path = path.substring(0, path.lastIndexOf('/') + 1) + "golden_frames.h";
+  FILE *f = fopen(path.c_str(), "w");
+  TEST_ASSERT_NOT_NULL(f);
+  fprintf(f, "// generated by test_golden_frames (WLED_GOLDEN_UPDATE=1): effect ID, hash of its recording\n");
+  fprintf(f, "static const GoldenFrames goldenFrames[] = {\n");
+  for (unsigned mode = 0; mode < strip.getModeCount(); mode++) {
+    if (!hashes[mode]) continue;
+    char name[32];
+    strncpy_P(name, strip.getModeData(mode), sizeof(name)-1);
+    name[sizeof(name)-1] = '\0';
+    if (char *end = strchr(name, '@')) *end = '\0';
+    fprintf(f, "  {%3u, 0x%08X}, // %s\n", mode, hashes[mode], name);
+  }
+  fprintf(f, "};\n");
+  fclose(f);
+}
+
+void setUp(void) {
+  modeBlending = false; // no transition from previous effect
+  strip.setTransition(0);
+  strip.setShowCallback(handleOverlayDraw); // as set up by WLED::beginStrip()
+  WLED_FS.format();
+  updateFSInfo();
+}
+
+void tearDown(void) {
+  setRecording(false);
+  stopFseq();
+  strip.setShowCallback(nullptr);
+  strip.isMatrix = false;
+  strip.panel.clear();
+  strip.timebase = 0;
+  hostRealTime();
+}
+
+void test_golden_frames(void) {
+  static uint32_t hashes[256];
+  String failed, blank;
+  for (uint8_t mode = 0; mode < strip.getModeCount(); mode++) {
+    if (isReserved(mode)) continue;
+    recordEffect(mode);
+    if (!isRendered(mode)) blank += String(mode) + " ";
+    hashes[mode] = recordingHash();
+    for (uint8_t m = 0; m < mode; m++) if (hashes[m] == hashes[mode]) blank += String(mode) + "=" + String(m) + " "; // same (e.g. constant) output
+    const GoldenFrames *golden = findGolden(mode);
+    if (!golden || golden->hash != hashes[mode]) failed += String(mode) + " ";
+  }
+  TEST_ASSERT_EQUAL_STRING_MESSAGE("", blank.c_str(), "Effects recorded without (changing) output (IDs)");
+  if (getenv("WLED_GOLDEN_UPDATE")) {
+    writeGolden(hashes);
+    TEST_IGNORE_MESSAGE("golden_frames.h written");
+  }
+  TEST_ASSERT_EQUAL_STRING_MESSAGE("", failed.c_str(), "Effects with changed output (IDs)");
+}
+
+// colors are recorded as set, not scaled by bus brightness
+void test_recording_independent_of_brightness(void) {
+  recordEffect(FX_MODE_RAINBOW, TYPE_WS2812_RGB, 0, 255);
+  uint32_t full = recordingHash();
+  recordEffect(FX_MODE_RAINBOW, TYPE_WS2812_RGB, 0, 7);
+  TEST_ASSERT_EQUAL_HEX32(full, recordingHash());
+}
+
+// replayed frames are shown as rendered, on an RGBW strip with white
+void test_replay_matches_live(void) {
+  bool white = false;
+  for (uint8_t mode : {(uint8_t)FX_MODE_STATIC, (uint8_t)FX_MODE_BLINK, (uint8_t)FX_MODE_RAINBOW_CYCLE, (uint8_t)FX_MODE_FIREWORKS}) {
+    recordEffect(mode, TYPE_SK6812_RGBW, RGBW32(200, 40, 10, 180));
+    uint32_t start = millis() + 1000;
+    hostSetMillis(start);
+    briT = bri = 128; // realtime mode keeps brightness
+    TEST_ASSERT_TRUE(startFseq(GOLDEN_FILE, toki.getTime(), false, false));
+    for (int f = 0; f < GOLDEN_FRAMES; f++) {
+      hostSetMillis(start + f * GOLDEN_STEP);
+      handleFseq(); // reads ahead if the frame is not yet decoded
+      handleFseq();
+      char msg[48];
+      snprintf(msg, sizeof(msg), "Effect %u, frame %d", mode, f);
+      for (int i = 0; i < GOLDEN_LEN; i++) {
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(live[f][i], hostBus()->getFrameColor(i), msg);
+        white |= W(live[f][i]) > 0;
+      }
+    }
+    stopFseq();
+  }
+  TEST_ASSERT_TRUE(white);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_golden_frames);
+  RUN_TEST(test_recording_independent_of_brightness);
+  RUN_TEST(test_replay_matches_live);
+  return UNITY_END();
+}
@@ -0,0 +1,158 @@
+#include <unity.h>
+#include <wled_host.h>
+#include <atomic>
+#include <thread>
+
+/*
+ * Streamed JSON responses (JsonStreamer in json.cpp): pieces are serialized in the async TCP task while the main loop
+ * may change segments, each piece takes the state lock without waiting for it (response is retried instead).
+ * WS clients get the stream as a text frame followed by continuation frames.
+ */
+
+// another task (here: the main loop applying a request) holds the state lock until released
+class StateWriter {
+  public:
+    StateWriter() : _step(0), _thread([this]() {
+      _locked = tryStateLock(1);
+      _step = 1;
+      while (_step != 2) delay(1);
+      if (_locked) releaseStateLock();
+    }) { while (_step != 1) delay(1); }
+    ~StateWriter() { release(); }
+    bool locked() const { return _locked; }
+    void release() { if (_thread.joinable()) { _step = 2; _thread.join(); } }
+  private:
+    std::atomic<int> _step;
+    bool _locked = false;
+    std::thread _thread;
+};
+
+static AsyncAbstractResponse *serve(AsyncWebServerRequest &request) {
+  serveJson(&request);
+  return static_cast<AsyncAbstractResponse*>(request.response());
+}
+
+static String stateJson() {
+  TEST_ASSERT_TRUE(requestJSONBufferLock(1));
+  serializeState(doc.to<JsonObject>());
+  String s;
+  serializeJson(doc, s);
+  releaseJSONBufferLock();
+  return s;
+}
+
+void setUp(void) {
+  hostInitStrip(40);
+  for (int i = 0; i < 4; i++) strip.setSegment(i, i * 10, (i + 1) * 10);
+}
+
+void tearDown(void) {
+  ws.closeAll();
+}
+
+void test_stream_equals_state(void) {
+  AsyncWebServerRequest request("/json/state");
+  TEST_ASSERT_EQUAL_STRING(stateJson().c_str(), serve(request)->body().c_str());
+}
+
+// no piece of state is serialized while it is locked, response continues once it is released
+void test_stream_waits_for_state_lock(void) {
+  String expected = stateJson();
+  AsyncWebServerRequest request("/json/state");
+  AsyncAbstractResponse *response = serve(request);
+  uint8_t buf[64];
+  StateWriter writer;
+  TEST_ASSERT_TRUE(writer.locked());
+  TEST_ASSERT_EQUAL_UINT32(RESPONSE_TRY_AGAIN, response->_fillBuffer(buf, sizeof(buf)));
+  writer.release();
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), response->body().c_str());
+}
+
+// segments removed between pieces are skipped (not read from freed memory)
+void test_segments_removed_between_pieces(void) {
+  AsyncWebServerRequest request("/json/state");
+  AsyncAbstractResponse *response = serve(request);
+  uint8_t buf[16];
+  size_t len = response->_fillBuffer(buf, sizeof(buf)); // first piece (top level state)
+  TEST_ASSERT_TRUE(len > 0 && len != RESPONSE_TRY_AGAIN);
+  String json;
+  json.concat((const char*)buf, len);
+  for (int i = 1; i < 4; i++) strip.getSegment(i).stop = 0; // deleted
+  strip.purgeSegments(true);
+  json += response->body();
+  DynamicJsonDocument d(4096);
+  TEST_ASSERT_FALSE(deserializeJson(d, json));
+  TEST_ASSERT_EQUAL_UINT32(1, d["seg"].size());
+}
+
+static AsyncWebSocketClient *connectWs() {
+  AsyncWebSocketClient *client = ws.hostAddClient();
+  wsEvent(&ws, client, WS_EVT_CONNECT, nullptr, nullptr, 0);
+  return client;
+}
+
+// message with state in several chunks (frames) and info
+void test_ws_state_in_frames(void) {
+  hostInitStrip(320);
+  for (int i = 0; i < 32; i++) strip.setSegment(i, i * 10, (i + 1) * 10);
+  AsyncWebServerRequest request("/json/state"); // 32 segments do not fit the JSON buffer, state is streamed
+  String expected = serve(request)->body();
+  AsyncWebSocketClient *client = connectWs();
+  TEST_ASSERT_TRUE(client->framesValid());
+  TEST_ASSERT_EQUAL_UINT32(1, client->texts().size());
+  DynamicJsonDocument d(65536);
+  TEST_ASSERT_FALSE(deserializeJson(d, client->texts()[0]));
+  String state;
+  serializeJson(d["state"], state);
+  TEST_ASSERT_EQUAL_UINT32(32, d["state"]["seg"].size());
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), state.c_str());
+  TEST_ASSERT_TRUE(d["info"].is<JsonObject>());
+}
+
+// the oldest client is closed when a new one does not get a slot (every client receives state updates)
+void test_ws_clients_limited(void) {
+  AsyncWebSocketClient *clients[WS_MAX_DELTA_CLIENTS + 1];
+  for (auto &c : clients) c = connectWs();
+  TEST_ASSERT_EQUAL_UINT32(WS_MAX_DELTA_CLIENTS, ws.count());
+  TEST_ASSERT_NULL(ws.client(clients[0]->id()));
+  for (auto &c : clients) c->texts().clear();
+  sendDataWs();
+  for (int i = 1; i <= WS_MAX_DELTA_CLIENTS; i++) TEST_ASSERT_EQUAL_UINT32(1, clients[i]->texts().size());
+}
+
+// render priority is in state if it is not the default, in presets only if requested when saving ("sp")
+void test_priority_only_if_set(void) {
+  Segment &seg = strip.getSegment(1);
+  seg.priority = DEFAULT_PRIORITY;
+  seg.minFps = 0;
+  DynamicJsonDocument d(2048);
+  JsonObject o = d.to<JsonObject>();
+  serializeSegment(o, seg, 1);
+  TEST_ASSERT_FALSE(o.containsKey("pri") || o.containsKey("mfps"));
+  seg.priority = 50;
+  seg.minFps = 10;
+  o = d.to<JsonObject>();
+  serializeSegment(o, seg, 1);
+  TEST_ASSERT_EQUAL_UINT8(50, o["pri"]);
+  TEST_ASSERT_EQUAL_UINT8(10, o["mfps"]);
+  o = d.to<JsonObject>();
+  serializeSegment(o, seg, 1, true);
+  TEST_ASSERT_FALSE(o.containsKey("pri") || o.containsKey("mfps"));
+  seg.priority = DEFAULT_PRIORITY;
+  seg.minFps = 0;
+  o = d.to<JsonObject>();
+  serializeSegment(o, seg, 1, true, true, true);
+  TEST_ASSERT_EQUAL_UINT8(DEFAULT_PRIORITY, o["pri"]); // preset sets the default again
+  TEST_ASSERT_EQUAL_UINT8(0, o["mfps"]);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_stream_equals_state);
+  RUN_TEST(test_stream_waits_for_state_lock);
+  RUN_TEST(test_segments_removed_between_pieces);
+  RUN_TEST(test_ws_state_in_frames);
+  RUN_TEST(test_ws_clients_limited);
+  RUN_TEST(test_priority_only_if_set);
+  return UNITY_END();
+}
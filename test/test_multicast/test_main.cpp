@@ -0,0 +1,161 @@
+#include <unity.h>
+#include <wled_host.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+ * Multicast sync (udpMulticast): nodes are separate processes on the loopback interface (127.0.0.x),
+ * a sync notification is sent to the group of each sync group and only received by nodes that joined it
+ */
+
+#define MC_TEST_PORT 29324
+#define MC_TEST_BRI  200
+
+// receiver node in a child process, result is its exit code (test assertions only run in the test process)
+enum { MC_NODE_OK = 0, MC_NODE_NOT_RECEIVED, MC_NODE_UNEXPECTED, MC_NODE_TIMEOUT = 99 };
+
+struct Node {
+  pid_t pid;
+  int   ready; // read end of pipe, node writes a byte when it has joined its groups
+};
+
+static void initNode(IPAddress ip, uint8_t groups) {
+  hostSetNetwork(ip);
+  hostInitStrip(10);
+  bri = 128;
+  udpPort = MC_TEST_PORT;
+  udpMulticast = true;
+  receiveGroups = groups;
+  udpConnected = notifierUdp.begin(udpPort);
+  updateMulticastGroups(true);
+  handleNotifications(); // joins groups
+}
+
+// runs node(ip) in a child process, returns after it is ready
+static Node startNode(int (*node)(int ready)) {
+  int fds[2];
+  TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    _exit(node(fds[1])); // no atexit handlers of the test process
+  }
+  close(fds[1]);
+  char c;
+  TEST_ASSERT_EQUAL_INT(1, read(fds[0], &c, 1));
+  return {pid, fds[0]};
+}
+
+static int nodeResult(Node &n) {
+  int status = 0;
+  for (int i = 0; i < 300; i++) {
+    if (waitpid(n.pid, &status, WNOHANG) == n.pid) {
+      close(n.ready);
+      return WIFEXITED(status) ? WEXITSTATUS(status) : MC_NODE_TIMEOUT;
+    }
+    delay(10);
+  }
+  kill(n.pid, SIGKILL);
+  waitpid(n.pid, &status, 0);
+  close(n.ready);
+  return MC_NODE_TIMEOUT;
+}
+
+static void signalReady(int ready) {
+  while (millis() < 1100) delay(10); // notifications are ignored within 1s of sending one (notificationSentTime)
+  char c = 1;
+  write(ready, &c, 1);
+}
+
+// sync group 1 member: applies the notification
+static int nodeGroup1(int ready) {
+  initNode(IPAddress(127, 0, 0, 3), 0x01);
+  signalReady(ready);
+  for (uint32_t start = millis(); millis() - start < 1000; delay(1)) {
+    handleNotifications();
+    if (bri == MC_TEST_BRI) return MC_NODE_OK;
+  }
+  return MC_NODE_NOT_RECEIVED;
+}
+
+// sync group 2 member: the packets to group 1 don't reach its socket at all
+static int nodeGroup2(int ready) {
+  initNode(IPAddress(127, 0, 0, 4), 0x02);
+  signalReady(ready);
+  bool received = false;
+  for (uint32_t start = millis(); millis() - start < 1000; delay(1)) {
+    if (!notifierUdp.parsePacket()) continue;
+    uint8_t packet[64] = {0};
+    notifierUdp.read(packet, sizeof(packet));
+    if (packet[36] & 0x01) return MC_NODE_UNEXPECTED; // sync groups of the notification
+    received = true;
+  }
+  return received ? MC_NODE_OK : MC_NODE_NOT_RECEIVED;
+}
+
+// member of group 1 that leaves it again (sync settings changed), membership is changed from loop
+static int nodeLeft(int ready) {
+  initNode(IPAddress(127, 0, 0, 5), 0x01);
+  receiveGroups = 0;
+  updateMulticastGroups();
+  handleNotifications();
+  signalReady(ready);
+  for (uint32_t start = millis(); millis() - start < 500; delay(1)) {
+    if (notifierUdp.parsePacket()) return MC_NODE_UNEXPECTED;
+  }
+  return MC_NODE_OK;
+}
+
+// sender node in the test process
+static void sendNotification(uint8_t groups) {
+  syncGroups = groups;
+  notify(CALL_MODE_DIRECT_CHANGE);
+}
+
+void setUp(void) {
+  hostSetNetwork(IPAddress(127, 0, 0, 2));
+  hostInitStrip(10);
+  udpPort = MC_TEST_PORT;
+  udpMulticast = true;
+  receiveGroups = 0;
+  notifyDirect = true;
+}
+
+void tearDown(void) {
+  notifierUdp.stop();
+  udpConnected = false;
+}
+
+void test_sync_groups_are_multicast_groups(void) {
+  Node group1 = startNode(nodeGroup1);
+  Node group2 = startNode(nodeGroup2);
+  udpConnected = notifierUdp.begin(udpPort);
+  TEST_ASSERT_TRUE(udpConnected);
+
+  bri = MC_TEST_BRI;
+  sendNotification(0x01);
+  delay(100);
+  bri = 50;
+  sendNotification(0x02);
+
+  TEST_ASSERT_EQUAL_INT_MESSAGE(MC_NODE_OK, nodeResult(group1), "group 1 node");
+  TEST_ASSERT_EQUAL_INT_MESSAGE(MC_NODE_OK, nodeResult(group2), "group 2 node");
+}
+
+void test_left_group_not_received(void) {
+  Node left = startNode(nodeLeft);
+  udpConnected = notifierUdp.begin(udpPort);
+  TEST_ASSERT_TRUE(udpConnected);
+
+  bri = MC_TEST_BRI;
+  sendNotification(0x01);
+  TEST_ASSERT_EQUAL_INT(MC_NODE_OK, nodeResult(left));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sync_groups_are_multicast_groups);
+  RUN_TEST(test_left_group_not_received);
+  return UNITY_END();
+}
@@ -0,0 +1,142 @@
+#include <unity.h>
+#include <wled_host.h>
+
+/*
+ * Parallel rendering (WLED_ENABLE_PARALLEL_RENDER, built with WLED_RENDER_WORKERS threads by env:native_parallel):
+ * segments not overlapping any other due segment are rendered by helper tasks, the frame must be the same
+ * as if every segment was rendered on its own
+ */
+
+#ifndef WLED_ENABLE_PARALLEL_RENDER
+  #error "Build with -D WLED_ENABLE_PARALLEL_RENDER (pio test -e native_parallel)"
+#endif
+
+#define PR_SEGMENTS 8
+#define PR_SEG_LEN  16
+#define PR_LEN      (PR_SEGMENTS * PR_SEG_LEN)
+#define PR_FRAMES   16
+#define PR_START    200000 // strip time of first frame
+#define PR_STEP     25     // ms between frames
+
+// audio reactive effects use simulated sound (per render worker)
+static const uint8_t prModes[PR_SEGMENTS] = {
+  FX_MODE_RAINBOW, FX_MODE_FIREWORKS, FX_MODE_TWINKLE, FX_MODE_CHASE_RANDOM,
+  FX_MODE_FIRE_2012, FX_MODE_GRAVCENTER, FX_MODE_FREQWAVE, FX_MODE_DISSOLVE_RANDOM
+};
+
+static uint32_t parallelFrames[PR_FRAMES][PR_LEN];
+static uint32_t singleFrames[PR_FRAMES][PR_LEN];
+
+// records which workers rendered the segment
+static std::atomic<uint32_t> workersUsed(0);
+
+static uint16_t mode_worker(void) {
+  workersUsed |= 1U << RENDER_WORKER_ID;
+  SEGMENT.fill(SEGCOLOR(0));
+  return FRAMETIME;
+}
+static const char _data_FX_MODE_WORKER[] PROGMEM = "Worker";
+static uint8_t workerMode = 0;
+
+// frames at strip time PR_START + n * PR_STEP, millis() keeps counting between runs (strip time is set through timebase)
+static void renderFrames(uint32_t out[PR_FRAMES][PR_LEN]) {
+  uint32_t uptime = millis() + 1000; // busses are done sending
+  strip.timebase = PR_START - uptime;
+  for (int f = 0; f < PR_FRAMES; f++) {
+    hostSetMillis(uptime + f * PR_STEP);
+    strip.service();
+    if (out) for (int i = 0; i < PR_LEN; i++) out[f][i] = hostBus()->getFrameColor(i);
+  }
+}
+
+static void setUpSegment(uint8_t n, uint8_t s) {
+  strip.setSegment(n, s * PR_SEG_LEN, (s + 1) * PR_SEG_LEN);
+  strip.getSegment(n).setMode(prModes[s], true);
+  if (strip.getSegment(n).palette == 1) strip.getSegment(n).setPalette(6); // random palette is shared
+}
+
+void setUp(void) {
+  modeBlending = false;
+  strip.setTransition(0);
+  strip.ablMilliampsMax = 0; // brightness limit depends on all segments
+  hostInitStrip(PR_LEN);
+  if (!workerMode) {
+    strip.addEffect(255, &mode_worker, _data_FX_MODE_WORKER);
+    while (workerMode < strip.getModeCount() && strip.getModeData(workerMode) != _data_FX_MODE_WORKER) workerMode++;
+  }
+  workersUsed = 0;
+}
+
+void tearDown(void) {
+  strip.timebase = 0;
+  strip.isMatrix = false;
+  strip.panel.clear();
+  hostRealTime();
+}
+
+void test_parallel_frames_match_single_segments(void) {
+  for (uint8_t s = 0; s < PR_SEGMENTS; s++) setUpSegment(s, s);
+  renderFrames(parallelFrames);
+
+  for (uint8_t s = 0; s < PR_SEGMENTS; s++) {
+    hostInitStrip(PR_LEN);
+    setUpSegment(0, s); // only segment, rendered by service() itself
+    renderFrames(singleFrames);
+    for (int f = 0; f < PR_FRAMES; f++) {
+      char msg[64];
+      snprintf(msg, sizeof(msg), "Segment %u (%.16s) frame %d differs", s, strip.getModeData(prModes[s]), f);
+      TEST_ASSERT_EQUAL_HEX32_ARRAY_MESSAGE(&singleFrames[f][s * PR_SEG_LEN], &parallelFrames[f][s * PR_SEG_LEN], PR_SEG_LEN, msg);
+    }
+  }
+}
+
+void test_all_workers_render(void) {
+  for (uint8_t s = 0; s < PR_SEGMENTS; s++) {
+    strip.setSegment(s, s * PR_SEG_LEN, (s + 1) * PR_SEG_LEN);
+    strip.getSegment(s).setMode(workerMode);
+  }
+  renderFrames(nullptr);
+  TEST_ASSERT_EQUAL_HEX32((1U << WLED_RENDER_WORKERS) - 1, workersUsed.load());
+}
+
+// segments using overlapping pixels are rendered in order by service() itself
+void test_overlapping_segments_are_not_split(void) {
+  for (uint8_t s = 0; s < PR_SEGMENTS; s++) {
+    strip.setSegment(s, s * PR_SEG_LEN, (s + 2) * PR_SEG_LEN > PR_LEN ? PR_LEN : (s + 2) * PR_SEG_LEN);
+    strip.getSegment(s).setMode(workerMode);
+  }
+  renderFrames(nullptr);
+  TEST_ASSERT_EQUAL_HEX32(1U << 0, workersUsed.load()); // service() is called from worker 0 (core 0)
+}
+
+// side by side segments on a matrix share rows but not pixels
+void test_matrix_columns_are_independent(void) {
+  strip.isMatrix = true;
+  WS2812FX::Panel p;
+  p.width  = 16;
+  p.height = 8;
+  strip.panel.push_back(p);
+  hostInitStrip(16 * 8);
+  TEST_ASSERT_TRUE(strip.isMatrix);
+
+  strip.setSegment(0, 0, 8, 1, 0, 0, 0, 8);
+  strip.setSegment(1, 8, 16, 1, 0, 0, 0, 8);
+  strip.getSegment(0).setMode(workerMode);
+  strip.getSegment(1).setMode(workerMode);
+  renderFrames(nullptr);
+  TEST_ASSERT_EQUAL_HEX32(0x3, workersUsed.load());
+
+  workersUsed = 0;
+  strip.setSegment(1, 6, 16, 1, 0, 0, 2, 6); // overlaps columns 6 and 7 of segment 0
+  renderFrames(nullptr);
+  TEST_ASSERT_EQUAL_HEX32(0x1, workersUsed.load());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_parallel_frames_match_single_segments);
+  RUN_TEST(test_all_workers_render);
+  RUN_TEST(test_overlapping_segments_are_not_split);
+  RUN_TEST(test_matrix_columns_are_independent);
+  return UNITY_END();
+}
@@ -0,0 +1,205 @@
+#include <unity.h>
+#include <wled_host.h>
+
+/*
+ * Indexed preset storage (presetstore.cpp): records survive overwrites, deletes, compaction and import,
+ * GET /presets.json exports them in the standard format. The benchmark compares it with editing presets.json
+ * in place (writeObjectToFileUsingId(), used before) for 10, 100 and 250 presets.
+ */
+
+#define PSTORE_TEST_TMP "/presets.tmp" // same as PSTORE_TMP_FILE
+
+static DynamicJsonDocument content(JSON_BUFFER_SIZE);
+
+// preset as saved from UI: state of a strip with segments, fields vary with the preset ID
+static void makePreset(uint8_t id, uint8_t numSegments = 3) {
+  hostInitStrip(30 * numSegments, numSegments);
+  for (uint8_t s = 0; s < strip.getSegmentsNum(); s++) {
+    Segment &seg = strip.getSegment(s);
+    seg.setMode(1 + (id + s) % 100, true);
+    seg.speed = id;
+    seg.setColor(0, RGBW32(id, s, 255 - id, 0));
+  }
+  content.clear();
+  JsonObject obj = content.to<JsonObject>();
+  serializeState(obj, true);
+  char name[16];
+  sprintf(name, "Preset %u", id);
+  obj["n"] = name;
+}
+
+static uint8_t readSpeed(uint8_t id) {
+  if (!presetStoreRead(id, &content)) return 0;
+  return content["seg"][0]["sx"] | 0;
+}
+
+static size_t storeSize() {
+  File f = WLED_FS.open(PRESETS_STORE_FILE, "r");
+  size_t size = f ? f.size() : 0;
+  f.close();
+  return size;
+}
+
+static String exportPresets() {
+  AsyncWebServerRequest request("/presets.json");
+  servePresetsJson(&request);
+  TEST_ASSERT_NOT_NULL(request.response());
+  TEST_ASSERT_EQUAL_INT(200, request.response()->code());
+  return request.response()->body();
+}
+
+void setUp(void) {
+  WLED_FS.format();
+  TEST_ASSERT_TRUE(initPresetStore());
+}
+
+void tearDown(void) {}
+
+void test_save_and_read(void) {
+  for (int id = 1; id <= 250; id += 83) {
+    makePreset(id);
+    TEST_ASSERT_TRUE(presetStoreWrite(id, &content));
+  }
+  TEST_ASSERT_EQUAL_UINT8(1, readSpeed(1));
+  TEST_ASSERT_EQUAL_UINT8(84, readSpeed(84));
+  TEST_ASSERT_EQUAL_UINT8(167, readSpeed(167));
+  TEST_ASSERT_TRUE(presetStoreRead(250, &content));
+  TEST_ASSERT_EQUAL_STRING("Preset 250", content["n"].as<const char*>());
+  TEST_ASSERT_FALSE(presetStoreRead(2, &content));
+  TEST_ASSERT_FALSE(presetStoreRead(0, &content));
+}
+
+void test_overwrite_and_delete(void) {
+  makePreset(5);
+  TEST_ASSERT_TRUE(presetStoreWrite(7, &content));
+  makePreset(9);
+  TEST_ASSERT_TRUE(presetStoreWrite(7, &content));
+  TEST_ASSERT_EQUAL_UINT8(9, readSpeed(7));
+  content.clear();
+  TEST_ASSERT_TRUE(presetStoreWrite(7, &content)); // null document deletes
+  TEST_ASSERT_FALSE(presetStoreRead(7, &content));
+}
+
+// old records are dropped once more space is wasted than used, the presets are kept
+void test_compaction(void) {
+  for (uint8_t id = 1; id <= 10; id++) {
+    makePreset(id);
+    TEST_ASSERT_TRUE(presetStoreWrite(id, &content));
+  }
+  size_t compactSize = storeSize();
+  size_t maxSize = 0;
+  for (int round = 0; round < 10; round++) {
+    for (uint8_t id = 1; id <= 10; id++) {
+      makePreset(id);
+      TEST_ASSERT_TRUE(presetStoreWrite(id, &content));
+      maxSize = MAX(maxSize, storeSize());
+    }
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(3 * compactSize, maxSize); // would be 11x without compaction
+  TEST_ASSERT_FALSE(WLED_FS.exists(PSTORE_TEST_TMP));
+  for (uint8_t id = 1; id <= 10; id++) TEST_ASSERT_EQUAL_UINT8(id, readSpeed(id));
+}
+
+// export is a standard presets.json with the "0" dummy object, the size is known in advance (FS editor list)
+void test_export(void) {
+  for (uint8_t id : {3, 12, 250}) {
+    makePreset(id);
+    TEST_ASSERT_TRUE(presetStoreWrite(id, &content));
+  }
+  String exported = exportPresets();
+  TEST_ASSERT_EQUAL_UINT32(exported.length(), presetsJsonSize());
+  DynamicJsonDocument parsed(4 * JSON_BUFFER_SIZE);
+  TEST_ASSERT_FALSE(deserializeJson(parsed, exported.c_str()));
+  JsonObject root = parsed.as<JsonObject>();
+  TEST_ASSERT_EQUAL_UINT32(4, root.size());
+  TEST_ASSERT_TRUE(root["0"].is<JsonObject>());
+  TEST_ASSERT_EQUAL_UINT8(12, root["12"]["seg"][0]["sx"].as<uint8_t>());
+  TEST_ASSERT_EQUAL_STRING("Preset 250", root["250"]["n"].as<const char*>());
+}
+
+// an exported presets.json imports to the same presets (backup restore)
+void test_import_export_round_trip(void) {
+  for (uint8_t id = 1; id <= 20; id++) {
+    makePreset(id, 1 + id % 3);
+    TEST_ASSERT_TRUE(presetStoreWrite(id, &content));
+  }
+  String exported = exportPresets();
+  File f = WLED_FS.open("/presets.json", "w");
+  f.print(exported);
+  f.close();
+
+  WLED_FS.remove(PRESETS_STORE_FILE);
+  TEST_ASSERT_TRUE(initPresetStore());
+  TEST_ASSERT_TRUE(presetStoreImport("/presets.json", &doc));
+  TEST_ASSERT_EQUAL_STRING(exported.c_str(), exportPresets().c_str());
+}
+
+// compaction/import writes the new store to a temporary file and renames it, boot resolves an interrupted one
+void test_interrupted_replace(void) {
+  makePreset(1);
+  TEST_ASSERT_TRUE(presetStoreWrite(1, &content));
+  TEST_ASSERT_TRUE(WLED_FS.rename(PRESETS_STORE_FILE, PSTORE_TEST_TMP)); // power loss after old store was removed
+  TEST_ASSERT_TRUE(initPresetStore());
+  TEST_ASSERT_FALSE(WLED_FS.exists(PSTORE_TEST_TMP));
+  TEST_ASSERT_EQUAL_UINT8(1, readSpeed(1));
+
+  File tmp = WLED_FS.open(PSTORE_TEST_TMP, "w"); // power loss while new store was written
+  tmp.print("WPS");
+  tmp.close();
+  TEST_ASSERT_TRUE(initPresetStore());
+  TEST_ASSERT_FALSE(WLED_FS.exists(PSTORE_TEST_TMP));
+  TEST_ASSERT_EQUAL_UINT8(1, readSpeed(1));
+}
+
+// save, save again (edit) and load n presets with the preset store and with presets.json edited in place
+static void benchmark(uint8_t n) {
+  uint32_t t[2][3];
+  for (int legacy = 0; legacy < 2; legacy++) {
+    WLED_FS.format();
+    if (legacy) {
+      File f = WLED_FS.open("/presets.json", "w");
+      f.print("{\"0\":{}}");
+      f.close();
+    } else {
+      initPresetStore();
+    }
+    for (int pass = 0; pass < 3; pass++) {
+      uint32_t us = 0;
+      for (uint8_t id = 1; id <= n; id++) {
+        if (pass < 2) makePreset(id, pass ? 1 + id % 4 : 3); // second pass changes the size of every preset
+        uint32_t s = micros();
+        bool ok;
+        if (pass == 2) ok = legacy ? readObjectFromFileUsingId("/presets.json", id, &content) : presetStoreRead(id, &content);
+        else {
+          ok = legacy ? writeObjectToFileUsingId("/presets.json", id, &content) : presetStoreWrite(id, &content);
+          if (doCloseFile) closeFile(); // done by loop()
+        }
+        us += micros() - s;
+        TEST_ASSERT_TRUE(ok);
+      }
+      t[legacy][pass] = us;
+    }
+  }
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%3u presets, us per preset (store/presets.json): save %u/%u, edit %u/%u, load %u/%u", n,
+           t[0][0]/n, t[1][0]/n, t[0][1]/n, t[1][1]/n, t[0][2]/n, t[1][2]/n);
+  TEST_MESSAGE(msg);
+}
+
+void test_benchmark(void) {
+  benchmark(10);
+  benchmark(100);
+  benchmark(250);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_save_and_read);
+  RUN_TEST(test_overwrite_and_delete);
+  RUN_TEST(test_compaction);
+  RUN_TEST(test_export);
+  RUN_TEST(test_import_export_round_trip);
+  RUN_TEST(test_interrupted_replace);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,192 @@
+#include <unity.h>
+#include <wled_host.h>
+
+/*
+ * Render task (WLED_ENABLE_RENDER_TASK): strip.service() runs in its own thread like WLED::renderTask(),
+ * the test thread changes segments and busses like loop() does, guarded by suspend()/waitUntilIdle()/resume()
+ */
+
+static std::thread       renderThread;
+static std::atomic<bool> rendering(false);
+
+static void renderTask() {
+  while (rendering) {
+    strip.service();
+    delay(1);
+  }
+}
+
+static std::atomic<uint32_t> renderDelay(0);
+
+static uint16_t mode_slow(void) {
+  delay(renderDelay);
+  SEGMENT.fill(SEGCOLOR(0));
+  return FRAMETIME;
+}
+static const char _data_FX_MODE_SLOW[] PROGMEM = "Slow";
+
+static std::atomic<uint32_t> callbackDelay(0);
+static std::atomic<bool>     inCallback(false);
+
+static void slowShowCallback() {
+  inCallback = true;
+  delay(callbackDelay);
+  inCallback = false;
+}
+
+void setUp(void) {
+  hostInitStrip(60);
+  strip.setTargetFps(WLED_FPS);
+  strip.getSegment(0).setMode(FX_MODE_RAINBOW); // renders every frame
+  rendering = true;
+  renderThread = std::thread(renderTask);
+}
+
+void tearDown(void) {
+  rendering = false;
+  if (renderThread.joinable()) renderThread.join();
+  strip.setShowCallback(nullptr);
+  callbackDelay = 0;
+  renderDelay = 0;
+  while (strip.isSuspended()) strip.resume();
+}
+
+// strip is changed like in loop(): only while render task is suspended and idle
+static void suspendRendering() {
+  strip.suspend();
+  TEST_ASSERT_TRUE(strip.waitUntilIdle());
+}
+
+static uint32_t showsDuring(uint32_t ms) {
+  uint32_t shows = hostBus()->getShowCount();
+  delay(ms);
+  return hostBus()->getShowCount() - shows;
+}
+
+void test_frames_are_rendered(void) {
+  TEST_ASSERT_GREATER_THAN(5, showsDuring(500));
+}
+
+void test_suspend_stops_rendering(void) {
+  strip.suspend();
+  TEST_ASSERT_TRUE(strip.waitUntilIdle());
+  TEST_ASSERT_FALSE(strip.isServicing());
+  TEST_ASSERT_EQUAL(0, showsDuring(100));
+  strip.resume();
+  TEST_ASSERT_GREATER_THAN(0, showsDuring(200));
+}
+
+void test_suspend_nests(void) {
+  strip.suspend();
+  strip.suspend();
+  TEST_ASSERT_TRUE(strip.waitUntilIdle());
+  strip.resume();
+  TEST_ASSERT_TRUE(strip.isSuspended());
+  TEST_ASSERT_EQUAL(0, showsDuring(100));
+  strip.resume();
+  TEST_ASSERT_FALSE(strip.isSuspended());
+  TEST_ASSERT_GREATER_THAN(0, showsDuring(200));
+  strip.resume(); // unbalanced resume() does not underflow
+  TEST_ASSERT_FALSE(strip.isSuspended());
+}
+
+void test_wait_fails_on_timeout(void) {
+  callbackDelay = 400; // frame takes longer than waitUntilIdle() waits
+  suspendRendering();
+  strip.setShowCallback(slowShowCallback);
+  strip.resume();
+  unsigned long start = millis();
+  while (!inCallback && millis() - start < 1000) delay(1);
+  TEST_ASSERT_TRUE(inCallback);
+  strip.suspend();
+  TEST_ASSERT_FALSE(strip.waitUntilIdle());
+  TEST_ASSERT_TRUE(strip.isServicing()); // show() is part of the frame
+  callbackDelay = 0;
+  TEST_ASSERT_TRUE(strip.waitUntilIdle());
+  strip.resume();
+}
+
+// network callbacks (other threads than the main loop) do not wait for a long frame, the request fails instead
+void test_callback_wait_is_short(void) {
+  callbackDelay = 200; // main loop would wait for the frame
+  strip.setShowCallback(slowShowCallback);
+  unsigned long start = millis();
+  while (!inCallback && millis() - start < 1000) delay(1);
+  TEST_ASSERT_TRUE(inCallback);
+  unsigned long waited = 0;
+  bool idle = true;
+  byte error = ERR_NONE;
+  std::thread callback([&]() {
+    unsigned long t = millis();
+    strip.suspend();
+    idle = strip.waitUntilIdle();
+    strip.resume();
+    waited = millis() - t;
+    DynamicJsonDocument d(256);
+    deserializeJson(d, "{\"bri\":10}");
+    errorFlag = ERR_NONE;
+    deserializeState(d.as<JsonObject>());
+    error = errorFlag;
+  });
+  callback.join();
+  TEST_ASSERT_FALSE(idle);
+  TEST_ASSERT_GREATER_OR_EQUAL(STRIP_IDLE_TIMEOUT_ASYNC, waited);
+  TEST_ASSERT_LESS_THAN(STRIP_IDLE_TIMEOUT_ASYNC + 20, waited);
+  TEST_ASSERT_EQUAL_UINT8(ERR_BUSY, error);
+  TEST_ASSERT_TRUE(strip.isServicing());
+  strip.suspend();
+  TEST_ASSERT_TRUE(strip.waitUntilIdle());
+  strip.resume();
+  errorFlag = ERR_NONE;
+}
+
+// segments and busses are changed while render task is suspended, it must never be servicing then
+void test_changes_exclude_rendering(void) {
+  for (int i = 0; i < 200; i++) {
+    suspendRendering();
+    if (i % 25 == 0) hostInitStrip(30 + i, 1 + i % 3); // busses are recreated
+    uint32_t shows = hostBus()->getShowCount();
+    strip.setSegment(0, 0, strip.getLengthTotal() / 2);
+    strip.setSegment(1, strip.getLengthTotal() / 2, strip.getLengthTotal());
+    strip.getSegment(0).setMode(i % strip.getModeCount());
+    strip.getSegment(1).setColor(0, RGBW32(i, 255 - i, 0, 0));
+    delayMicroseconds(500);
+    TEST_ASSERT_FALSE(strip.isServicing());
+    TEST_ASSERT_EQUAL(shows, hostBus()->getShowCount());
+    strip.resume();
+    delay(i % 3);
+  }
+  TEST_ASSERT_GREATER_THAN(0, showsDuring(200));
+}
+
+// next frame is rendered while bus sends previous one: frame time is render time + MIN_SHOW_DELAY,
+// it would be render + transmit + MIN_SHOW_DELAY if show() waited until the frame is sent
+void test_render_overlaps_transmit(void) {
+  suspendRendering();
+  strip.addEffect(255, &mode_slow, _data_FX_MODE_SLOW);
+  uint8_t slow = 0;
+  while (slow < strip.getModeCount() && strip.getModeData(slow) != _data_FX_MODE_SLOW) slow++;
+  TEST_ASSERT_LESS_THAN(strip.getModeCount(), slow);
+
+  strip.setTargetFps(100);           // 10ms frame time, 8ms MIN_SHOW_DELAY
+  renderDelay = 6;                   // 6ms rendering
+  hostBus()->setTransmitTime(8000);  // 8ms to send a frame
+  strip.getSegment(0).setMode(slow);
+  strip.resume();
+  delay(100);
+  uint32_t shows = showsDuring(1000);
+  TEST_ASSERT_GREATER_THAN(1000/(6+8+8) + 10, shows); // not serialized (about 1000/(6+8) frames)
+  TEST_ASSERT_LESS_OR_EQUAL(1000/10 + 1, shows);      // frame rate limit
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_frames_are_rendered);
+  RUN_TEST(test_suspend_stops_rendering);
+  RUN_TEST(test_suspend_nests);
+  RUN_TEST(test_wait_fails_on_timeout);
+  RUN_TEST(test_callback_wait_is_short);
+  RUN_TEST(test_changes_exclude_rendering);
+  RUN_TEST(test_render_overlaps_transmit);
+  return UNITY_END();
+}
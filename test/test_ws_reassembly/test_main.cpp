@@ -0,0 +1,219 @@
+#include <unity.h>
+#include <wled_host.h>
+
+/*
+ * WebSocket JSON messages arriving in fragments (several frames, frames split into several TCP packets)
+ * are reassembled per client (ws_reassembly.cpp) into exactly the message that was sent and applied
+ */
+
+static std::string payload;
+
+// effect ID used for segment n (reserved IDs are not applied)
+static uint8_t segmentFx(uint8_t n) {
+  uint8_t fx = n % 100;
+  while (!strncmp_P("RSVD", strip.getModeData(fx), 4)) fx++;
+  return fx;
+}
+
+// JSON API request setting n segments (about 150 bytes each, like a state pushed by a controller, 32 segments
+// with all fields would not fit the JSON buffer),
+// values differ by variant (a message that was not applied leaves the values of the previous one)
+static void makePayload(uint8_t segments, uint8_t variant = 0) {
+  DynamicJsonDocument d(1024 + 2048 * segments);
+  d["on"] = true;
+  d["bri"] = 128;
+  JsonArray seg = d.createNestedArray("seg");
+  for (uint8_t i = 0; i < segments; i++) {
+    JsonObject s = seg.createNestedObject();
+    s["id"] = i; s["start"] = i * 10; s["stop"] = i * 10 + 10 - variant % 2; s["on"] = true;
+    char name[24];
+    snprintf(name, sizeof(name), "Segment \"%u\" %u", i, variant);
+    s["n"] = name;
+    JsonArray col = s.createNestedArray("col");
+    for (uint8_t c = 0; c < 3; c++) {
+      JsonArray rgb = col.createNestedArray();
+      rgb.add(i * 7 + variant); rgb.add(255 - c * 64); rgb.add(c * 32);
+    }
+    s["fx"] = segmentFx(i + variant); s["sx"] = 128 + variant; s["ix"] = 200 - variant; s["pal"] = (i + variant) % 50;
+    s["sel"] = i == 0;
+  }
+  TEST_ASSERT_FALSE(d.overflowed());
+  payload.clear();
+  serializeJson(d, payload);
+}
+
+// segments as set by makePayload()
+static void checkSegments(uint8_t segments, uint8_t variant) {
+  for (uint8_t i = 0; i < segments; i++) {
+    Segment &seg = strip.getSegment(i);
+    char name[24];
+    snprintf(name, sizeof(name), "Segment \"%u\" %u", i, variant);
+    TEST_ASSERT_EQUAL_UINT16(i * 10, seg.start);
+    TEST_ASSERT_EQUAL_UINT16(i * 10 + 10 - variant % 2, seg.stop);
+    for (uint8_t c = 0; c < 3; c++) TEST_ASSERT_EQUAL_HEX32(RGBW32(i * 7 + variant, 255 - c * 64, c * 32, 0), seg.colors[c]);
+    TEST_ASSERT_EQUAL_UINT8(segmentFx(i + variant), seg.mode);
+    TEST_ASSERT_EQUAL_UINT8(128 + variant, seg.speed);
+    TEST_ASSERT_EQUAL_UINT8(200 - variant, seg.intensity);
+    TEST_ASSERT_EQUAL_UINT8((i + variant) % 50, seg.palette);
+    TEST_ASSERT_NOT_NULL(seg.name);
+    TEST_ASSERT_EQUAL_STRING(name, seg.name);
+  }
+}
+
+// sends payload in frames of frameSize bytes, each split into packets of up to packetSize bytes
+// (same frame info as AsyncWebSocket passes to wsEvent()), returns the message once it is complete
+static WsReassembly *sendFragmented(uint32_t client, size_t frameSize, size_t packetSize, byte &error) {
+  WsReassembly *r = nullptr;
+  uint32_t frame = 0;
+  for (size_t start = 0; start < payload.size(); start += frameSize, frame++) {
+    size_t frameLen = MIN(frameSize, payload.size() - start);
+    bool final = start + frameLen == payload.size();
+    for (size_t index = 0; index < frameLen; index += packetSize) {
+      size_t len = MIN(packetSize, frameLen - index);
+      TEST_ASSERT_NULL_MESSAGE(r, "message complete before last packet");
+      r = reassembleWs(client, frame, index, frameLen, final, (const uint8_t*)payload.data() + start + index, len, error);
+      if (error) return nullptr;
+    }
+  }
+  return r;
+}
+
+static void checkMessage(WsReassembly *r, uint8_t segments) {
+  TEST_ASSERT_NOT_NULL(r);
+  TEST_ASSERT_EQUAL(payload.size(), r->len);
+  TEST_ASSERT_EQUAL_MEMORY(payload.data(), r->data, payload.size());
+  DynamicJsonDocument d(1024 + 2048 * segments);
+  TEST_ASSERT_FALSE(deserializeJson(d, r->data, r->len));
+  TEST_ASSERT_EQUAL(segments, d["seg"].size());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {
+  for (uint32_t client = 1; client <= 3; client++) freeWsReassembly(client);
+  hostRealTime();
+}
+
+// sends payload to the client in frames of frameSize bytes, each split into packets of up to packetSize bytes,
+// with the frame info AsyncWebSocket passes to wsEvent()
+static void sendWsFrames(AsyncWebSocketClient *client, size_t frameSize, size_t packetSize) {
+  uint32_t frame = 0;
+  for (size_t start = 0; start < payload.size(); start += frameSize, frame++) {
+    AwsFrameInfo info = {};
+    info.message_opcode = WS_TEXT;
+    info.num = frame;
+    info.opcode = frame ? WS_CONTINUATION : WS_TEXT;
+    info.len = MIN(frameSize, payload.size() - start);
+    info.final = start + info.len == payload.size();
+    for (info.index = 0; info.index < info.len; info.index += packetSize) {
+      size_t len = MIN(packetSize, info.len - info.index);
+      wsEvent(&ws, client, WS_EVT_DATA, &info, (uint8_t*)payload.data() + start + info.index, len);
+    }
+  }
+}
+
+// messages are applied to the segments (through the WS event handler, as received from the async TCP task)
+void test_segment_payloads_in_fragments(void) {
+  static const uint8_t segments[] = {1, 8, 32};
+  static const size_t  fragments[][2] = { // frame size, packet size
+    {SIZE_MAX, 1436}, // one frame in TCP packets
+    {1024, 1024},     // frames of 1kB
+    {1000, 1436},
+    {4096, 536},      // large frames in small packets
+    {97, 13},
+  };
+  hostInitStrip(320);
+  AsyncWebSocketClient *client = ws.hostAddClient();
+  wsEvent(&ws, client, WS_EVT_CONNECT, nullptr, nullptr, 0);
+  uint8_t variant = 0;
+  for (uint8_t n : segments) {
+    for (auto &f : fragments) {
+      makePayload(n, ++variant);
+      TEST_ASSERT_LESS_OR_EQUAL(WS_MAX_JSON_SIZE, payload.size());
+      client->texts().clear();
+      sendWsFrames(client, f[0], f[1]);
+      for (auto &t : client->texts()) TEST_ASSERT_NULL_MESSAGE(strstr(t.c_str(), "\"error\""), t.c_str());
+      TEST_ASSERT_TRUE(strip.getSegmentsNum() >= n);
+      checkSegments(n, variant);
+    }
+  }
+  wsEvent(&ws, client, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+  ws.closeAll();
+}
+
+// fragments of two clients arrive interleaved, a third client has no free slot
+void test_clients_are_separate(void) {
+  makePayload(8);
+  size_t half = payload.size() / 2;
+  byte error;
+  const uint8_t *p = (const uint8_t*)payload.data();
+  TEST_ASSERT_NULL(reassembleWs(1, 0, 0, half, false, p, half, error));
+  TEST_ASSERT_NULL(reassembleWs(2, 0, 0, half, false, p, half, error));
+  TEST_ASSERT_NULL(reassembleWs(3, 0, 0, half, false, p, half, error));
+  TEST_ASSERT_EQUAL(ERR_NOBUF, error);
+  WsReassembly *r2 = reassembleWs(2, 1, 0, payload.size() - half, true, p + half, payload.size() - half, error);
+  WsReassembly *r1 = reassembleWs(1, 1, 0, payload.size() - half, true, p + half, payload.size() - half, error);
+  checkMessage(r1, 8);
+  checkMessage(r2, 8);
+  TEST_ASSERT_NOT_EQUAL(r1, r2);
+  freeWsReassembly(*r1);
+  TEST_ASSERT_NULL(reassembleWs(3, 1, 0, payload.size() - half, true, p + half, payload.size() - half, error)); // start was dropped
+  TEST_ASSERT_EQUAL(ERR_NONE, error);
+}
+
+void test_too_large_message_is_dropped(void) {
+  payload.assign(WS_MAX_JSON_SIZE + 1, ' ');
+  byte error;
+  TEST_ASSERT_NULL(sendFragmented(1, 1024, 1024, error));
+  TEST_ASSERT_EQUAL(ERR_JSON, error);
+  makePayload(1); // slot was freed
+  checkMessage(sendFragmented(1, 64, 64, error), 1);
+}
+
+// a new message replaces an incomplete one of the same client
+void test_new_message_restarts(void) {
+  makePayload(8);
+  byte error;
+  const uint8_t *p = (const uint8_t*)payload.data();
+  TEST_ASSERT_NULL(reassembleWs(1, 0, 0, 100, false, p, 100, error));
+  makePayload(1);
+  checkMessage(sendFragmented(1, 50, 50, error), 1);
+}
+
+void test_incomplete_message_times_out(void) {
+  makePayload(8);
+  byte error;
+  const uint8_t *p = (const uint8_t*)payload.data();
+  uint32_t now = millis();
+  hostSetMillis(now);
+  TEST_ASSERT_NULL(reassembleWs(1, 0, 0, 100, false, p, 100, error));
+  hostSetMillis(now + WS_REASSEMBLY_TIMEOUT + 1);
+  TEST_ASSERT_NULL(reassembleWs(1, 1, 0, payload.size() - 100, true, p + 100, payload.size() - 100, error));
+  TEST_ASSERT_EQUAL(ERR_NONE, error);
+  // both slots are free again
+  TEST_ASSERT_NULL(reassembleWs(2, 0, 0, 100, false, p, 100, error));
+  TEST_ASSERT_NULL(reassembleWs(3, 0, 0, 100, false, p, 100, error));
+  TEST_ASSERT_EQUAL(ERR_NONE, error);
+}
+
+void test_disconnect_frees_slot(void) {
+  makePayload(1);
+  byte error;
+  const uint8_t *p = (const uint8_t*)payload.data();
+  TEST_ASSERT_NULL(reassembleWs(1, 0, 0, 10, false, p, 10, error));
+  TEST_ASSERT_NULL(reassembleWs(2, 0, 0, 10, false, p, 10, error));
+  freeWsReassembly(1);
+  TEST_ASSERT_NULL(reassembleWs(3, 0, 0, 10, false, p, 10, error));
+  TEST_ASSERT_EQUAL(ERR_NONE, error);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_segment_payloads_in_fragments);
+  RUN_TEST(test_clients_are_separate);
+  RUN_TEST(test_too_large_message_is_dropped);
+  RUN_TEST(test_new_message_restarts);
+  RUN_TEST(test_incomplete_message_times_out);
+  RUN_TEST(test_disconnect_frees_slot);
+  return UNITY_END();
+}
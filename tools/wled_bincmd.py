@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""
+Encoder/decoder for the WLED binary control protocol (see wled00/bincmd.cpp).
+
+Usage as module:
+    pkt = encode([("seg", 3, "sx", 120), ("bri", 128)])
+    cmds = decode(pkt)
+    to_json(cmds)  # equivalent JSON API request
+    decode_ack(ack)  # ("ok", number of applied commands) for a packet sent over WebSocket
+    show = encode_cues([(0, [("seg", 0, "fx", 9)]), (1500, [("bri", 64)])], length=3000)  # cue list file
+
+Upload a cue list file with /edit and play it with {"cue":{"f":"/show.cue","at":0,"loop":true}}.
+
+Usage from command line (sends one UDP packet to the notifier port):
+    wled_bincmd.py <host> bri=128 seg3.sx=120 seg255.col0=0x00FF0000
+"""
+import json
+import socket
+import struct
+import sys
+
+MAGIC = 0xBC
+VERSION = 1
+CUE_VERSION = 1
+OP_GLOBAL = 1
+OP_SEGMENT = 2
+
+# field IDs (must match BINCMD_* in wled00/const.h), keys are the JSON API names
+GLOBAL_FIELDS = {"on": 0, "bri": 1, "transition": 2, "ps": 3}
+SEGMENT_FIELDS = {"on": 0, "bri": 1, "fx": 2, "sx": 3, "ix": 4, "pal": 5, "col0": 6, "col1": 7, "col2": 8,
+                  "cct": 9, "c1": 10, "c2": 11, "c3": 12, "sel": 13, "frz": 14}
+_GLOBAL_NAMES = {v: k for k, v in GLOBAL_FIELDS.items()}
+_SEGMENT_NAMES = {v: k for k, v in SEGMENT_FIELDS.items()}
+
+
+def encode(commands):
+    """commands: list of (field, value) for global fields or ("seg", id, field, value)"""
+    pkt = bytearray([MAGIC, VERSION])
+    for c in commands:
+        if c[0] == "seg":
+            _, seg, field, value = c
+            pkt += struct.pack("<BBBI", OP_SEGMENT, seg, SEGMENT_FIELDS[field], int(value) & 0xFFFFFFFF)
+        else:
+            field, value = c
+            pkt += struct.pack("<BBBI", OP_GLOBAL, 0, GLOBAL_FIELDS[field], int(value) & 0xFFFFFFFF)
+    return bytes(pkt)
+
+
+def decode(pkt):
+    """returns list of commands in the same form as accepted by encode()"""
+    if len(pkt) < 2 or pkt[0] != MAGIC or pkt[1] != VERSION or (len(pkt) - 2) % 7:
+        raise ValueError("not a binary command packet")
+    commands = []
+    for i in range(2, len(pkt), 7):
+        op, seg, field, value = struct.unpack_from("<BBBI", pkt, i)
+        if op == OP_SEGMENT:
+            commands.append(("seg", seg, _SEGMENT_NAMES[field], value))
+        elif op == OP_GLOBAL:
+            commands.append((_GLOBAL_NAMES[field], value))
+        else:
+            raise ValueError("unknown opcode %d" % op)
+    return commands
+
+
+ACK_STATUS = {0: "ok", 1: "invalid", 2: "busy"}  # BINCMD_ACK_* (busy: not applied, can be sent again)
+
+
+def decode_ack(pkt):
+    """WebSocket acknowledgement: returns (status, number of applied commands)"""
+    if len(pkt) != 4 or pkt[0] != MAGIC or pkt[1] != VERSION:
+        raise ValueError("not a binary command acknowledgement")
+    return ACK_STATUS.get(pkt[2], pkt[2]), pkt[3]
+
+
+def encode_cues(cues, length=0):
+    """cue list file (see wled00/cuelist.cpp): cues is a list of (show time in ms, commands),
+    length is the loop point in ms (0 = time of last cue)"""
+    data = bytearray(b"WCQ") + struct.pack("<BI", CUE_VERSION, length)
+    for time, commands in sorted(cues, key=lambda c: c[0]):
+        pkt = encode(commands)
+        data += struct.pack("<IH", time, len(pkt)) + pkt
+    return bytes(data)
+
+
+def to_json(commands):
+    """JSON API request with the same effect (segment ID 255 = all selected segments)"""
+    state, segs = {}, {}
+    for c in commands:
+        if c[0] != "seg":
+            field, value = c
+            state[field] = (value if value < 2 else "t") if field == "on" else value
+            continue
+        _, seg, field, value = c
+        s = segs.setdefault(seg, {} if seg == 255 else {"id": seg})
+        if field.startswith("col"):
+            col = s.setdefault("col", [[], [], []])
+            col[int(field[3])] = [(value >> 16) & 255, (value >> 8) & 255, value & 255, (value >> 24) & 255]
+        elif field in ("on", "sel", "frz"):
+            s[field] = bool(value)
+        else:
+            s[field] = value
+    if 255 in segs and len(segs) > 1:
+        raise ValueError("selected segments (255) and segment IDs can't be mixed in one JSON request")
+    if segs:
+        state["seg"] = segs[255] if 255 in segs else list(segs.values())
+    return state
+
+
+def _parse_arg(arg):
+    key, value = arg.split("=", 1)
+    value = int(value, 0)
+    if key.startswith("seg"):
+        seg, field = key[3:].split(".", 1)
+        return ("seg", int(seg), field, value)
+    return (key, value)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 3:
+        print(__doc__)
+        sys.exit(1)
+    cmds = [_parse_arg(a) for a in sys.argv[2:]]
+    pkt = encode(cmds)
+    assert decode(pkt) == cmds
+    print(json.dumps(to_json(cmds)))
+    socket.socket(socket.AF_INET, socket.SOCK_DGRAM).sendto(pkt, (sys.argv[1], 21324))
@@ -95,8 +95,8 @@ uint16_t blink(uint32_t color1, uint32_t color2, bool strobe, bool do_palette) {
   uint32_t onTime = FRAMETIME;
   if (!strobe) onTime += ((cycleTime * SEGMENT.intensity) >> 8);
   cycleTime += FRAMETIME*2;
-  uint32_t it = strip.now / cycleTime;
-  uint32_t rem = strip.now % cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
+  uint32_t rem = SEGMENT.frameNow() % cycleTime;
 
   bool on = false;
   if (it != SEGENV.step //new iteration, force on state for one frame, even if set time is too brief
@@ -161,7 +161,7 @@ static const char _data_FX_MODE_STROBE_RAINBOW[] PROGMEM = "Strobe Rainbow@!;,!;
  */
 uint16_t color_wipe(bool rev, bool useRandomColors) {
   uint32_t cycleTime = 750 + (255 - SEGMENT.speed)*150;
-  uint32_t perc = strip.now % cycleTime;
+  uint32_t perc = SEGMENT.frameNow() % cycleTime;
   uint16_t prog = (perc * 65535) / cycleTime;
   bool back = (prog > 32767);
   if (back) {
@@ -173,15 +173,15 @@ uint16_t color_wipe(bool rev, bool useRandomColors) {
 
   if (useRandomColors) {
     if (SEGENV.call == 0) {
-      SEGENV.aux0 = random8();
+      SEGENV.aux0 = SEGMENT.random8();
       SEGENV.step = 3;
     }
     if (SEGENV.step == 1) { //if flag set, change to new random color
-      SEGENV.aux1 = get_random_wheel_index(SEGENV.aux0);
+      SEGENV.aux1 = SEGMENT.randomWheelIndex(SEGENV.aux0);
       SEGENV.step = 2;
     }
     if (SEGENV.step == 3) {
-      SEGENV.aux0 = get_random_wheel_index(SEGENV.aux1);
+      SEGENV.aux0 = SEGMENT.randomWheelIndex(SEGENV.aux1);
       SEGENV.step = 0;
     }
   }
@@ -254,8 +254,8 @@ static const char _data_FX_MODE_COLOR_SWEEP_RANDOM[] PROGMEM = "Sweep Random@!;;
  */
 uint16_t mode_random_color(void) {
   uint32_t cycleTime = 200 + (255 - SEGMENT.speed)*50;
-  uint32_t it = strip.now / cycleTime;
-  uint32_t rem = strip.now % cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
+  uint32_t rem = SEGMENT.frameNow() % cycleTime;
   uint16_t fadedur = (cycleTime * SEGMENT.intensity) >> 8;
 
   uint32_t fade = 255;
@@ -265,13 +265,13 @@ uint16_t mode_random_color(void) {
   }
 
   if (SEGENV.call == 0) {
-    SEGENV.aux0 = random8();
+    SEGENV.aux0 = SEGMENT.random8();
     SEGENV.step = 2;
   }
   if (it != SEGENV.step) //new color
   {
     SEGENV.aux1 = SEGENV.aux0;
-    SEGENV.aux0 = get_random_wheel_index(SEGENV.aux0); //aux0 will store our random color wheel index
+    SEGENV.aux0 = SEGMENT.randomWheelIndex(SEGENV.aux0); //aux0 will store our random color wheel index
     SEGENV.step = it;
   }
 
@@ -290,15 +290,15 @@ uint16_t mode_dynamic(void) {
 
   if(SEGENV.call == 0) {
     //SEGMENT.fill(BLACK);
-    for (int i = 0; i < SEGLEN; i++) SEGENV.data[i] = random8();
+    for (int i = 0; i < SEGLEN; i++) SEGENV.data[i] = SEGMENT.random8();
   }
 
   uint32_t cycleTime = 50 + (255 - SEGMENT.speed)*15;
-  uint32_t it = strip.now / cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
   if (it != SEGENV.step && SEGMENT.speed != 0) //new color
   {
     for (int i = 0; i < SEGLEN; i++) {
-      if (random8() <= SEGMENT.intensity) SEGENV.data[i] = random8(); // random color index
+      if (SEGMENT.random8() <= SEGMENT.intensity) SEGENV.data[i] = SEGMENT.random8(); // random color index
     }
     SEGENV.step = it;
   }
@@ -335,7 +335,7 @@ static const char _data_FX_MODE_DYNAMIC_SMOOTH[] PROGMEM = "Dynamic Smooth@!,!;;
  */
 uint16_t mode_breath(void) {
   uint16_t var = 0;
-  uint16_t counter = (strip.now * ((SEGMENT.speed >> 3) +10));
+  uint16_t counter = (SEGMENT.frameNow() * ((SEGMENT.speed >> 3) +10));
   counter = (counter >> 2) + (counter >> 4); //0-16384 + 0-2048
   if (counter < 16384) {
     if (counter > 8192) counter = 8192 - (counter - 8192);
@@ -356,7 +356,7 @@ static const char _data_FX_MODE_BREATH[] PROGMEM = "Breathe@!;!,!;!;01";
  * Fades the LEDs between two colors
  */
 uint16_t mode_fade(void) {
-  uint16_t counter = (strip.now * ((SEGMENT.speed >> 3) +10));
+  uint16_t counter = (SEGMENT.frameNow() * ((SEGMENT.speed >> 3) +10));
   uint8_t lum = triwave16(counter) >> 8;
 
   for (int i = 0; i < SEGLEN; i++) {
@@ -374,7 +374,7 @@ static const char _data_FX_MODE_FADE[] PROGMEM = "Fade@!;!,!;!;01";
 uint16_t scan(bool dual)
 {
   uint32_t cycleTime = 750 + (255 - SEGMENT.speed)*150;
-  uint32_t perc = strip.now % cycleTime;
+  uint32_t perc = SEGMENT.frameNow() % cycleTime;
   uint16_t prog = (perc * 65535) / cycleTime;
   uint16_t size = 1 + ((SEGMENT.intensity * SEGLEN) >> 9);
   uint16_t ledIndex = (prog * ((SEGLEN *2) - size *2)) >> 16;
@@ -421,7 +421,7 @@ static const char _data_FX_MODE_DUAL_SCAN[] PROGMEM = "Scan Dual@!,# of dots,,,,
  * Cycles all LEDs at once through a rainbow.
  */
 uint16_t mode_rainbow(void) {
-  uint16_t counter = (strip.now * ((SEGMENT.speed >> 2) +2)) & 0xFFFF;
+  uint16_t counter = (SEGMENT.frameNow() * ((SEGMENT.speed >> 2) +2)) & 0xFFFF;
   counter = counter >> 8;
 
   if (SEGMENT.intensity < 128){
@@ -439,7 +439,7 @@ static const char _data_FX_MODE_RAINBOW[] PROGMEM = "Colorloop@!,Saturation;;!;0
  * Cycles a rainbow over the entire string of LEDs.
  */
 uint16_t mode_rainbow_cycle(void) {
-  uint16_t counter = (strip.now * ((SEGMENT.speed >> 2) +2)) & 0xFFFF;
+  uint16_t counter = (SEGMENT.frameNow() * ((SEGMENT.speed >> 2) +2)) & 0xFFFF;
   counter = counter >> 8;
 
   for (int i = 0; i < SEGLEN; i++) {
@@ -459,7 +459,7 @@ static const char _data_FX_MODE_RAINBOW_CYCLE[] PROGMEM = "Rainbow@!,Size;;!";
 uint16_t running(uint32_t color1, uint32_t color2, bool theatre = false) {
   uint8_t width = (theatre ? 3 : 1) + (SEGMENT.intensity >> 4);  // window
   uint32_t cycleTime = 50 + (255 - SEGMENT.speed);
-  uint32_t it = strip.now / cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
   bool usePalette = color1 == SEGCOLOR(0);
 
   for (int i = 0; i < SEGLEN; i++) {
@@ -507,7 +507,7 @@ static const char _data_FX_MODE_THEATER_CHASE_RAINBOW[] PROGMEM = "Theater Rainb
  */
 uint16_t running_base(bool saw, bool dual=false) {
   uint8_t x_scale = SEGMENT.intensity >> 2;
-  uint32_t counter = (strip.now * SEGMENT.speed) >> 9;
+  uint32_t counter = (SEGMENT.frameNow() * SEGMENT.speed) >> 9;
 
   for (int i = 0; i < SEGLEN; i++) {
     uint16_t a = i*x_scale - counter;
@@ -572,14 +572,14 @@ uint16_t mode_twinkle(void) {
   SEGMENT.fade_out(224);
 
   uint32_t cycleTime = 20 + (255 - SEGMENT.speed)*5;
-  uint32_t it = strip.now / cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
   if (it != SEGENV.step)
   {
     uint16_t maxOn = map(SEGMENT.intensity, 0, 255, 1, SEGLEN); // make sure at least one LED is on
     if (SEGENV.aux0 >= maxOn)
     {
       SEGENV.aux0 = 0;
-      SEGENV.aux1 = random16(); //new seed for our PRNG
+      SEGENV.aux1 = SEGMENT.random16(); //new seed for our PRNG
     }
     SEGENV.aux0++;
     SEGENV.step = it;
@@ -613,9 +613,9 @@ uint16_t dissolve(uint32_t color) {
   }
 
   for (int j = 0; j <= SEGLEN / 15; j++) {
-    if (random8() <= SEGMENT.intensity) {
+    if (SEGMENT.random8() <= SEGMENT.intensity) {
       for (size_t times = 0; times < 10; times++) { //attempt to spawn a new pixel 10 times
-        unsigned i = random16(SEGLEN);
+        unsigned i = SEGMENT.random16(SEGLEN);
         unsigned index = i >> 3;
         unsigned bitNum = i & 0x07;
         bool fadeUp = bitRead(SEGENV.data[index], bitNum);
@@ -655,7 +655,7 @@ uint16_t dissolve(uint32_t color) {
  * Blink several LEDs on and then off
  */
 uint16_t mode_dissolve(void) {
-  return dissolve(SEGMENT.check1 ? SEGMENT.color_wheel(random8()) : SEGCOLOR(0));
+  return dissolve(SEGMENT.check1 ? SEGMENT.color_wheel(SEGMENT.random8()) : SEGCOLOR(0));
 }
 static const char _data_FX_MODE_DISSOLVE[] PROGMEM = "Dissolve@Repeat speed,Dissolve speed,,,,Random;!,!;!";
 
@@ -664,7 +664,7 @@ static const char _data_FX_MODE_DISSOLVE[] PROGMEM = "Dissolve@Repeat speed,Diss
  * Blink several LEDs on and then off in random colors
  */
 uint16_t mode_dissolve_random(void) {
-  return dissolve(SEGMENT.color_wheel(random8()));
+  return dissolve(SEGMENT.color_wheel(SEGMENT.random8()));
 }
 static const char _data_FX_MODE_DISSOLVE_RANDOM[] PROGMEM = "Dissolve Rnd@Repeat speed,Dissolve speed;,!;!";
 
@@ -678,10 +678,10 @@ uint16_t mode_sparkle(void) {
     SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(i, true, PALETTE_SOLID_WRAP, 1));
   }
   uint32_t cycleTime = 10 + (255 - SEGMENT.speed)*2;
-  uint32_t it = strip.now / cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
   if (it != SEGENV.step)
   {
-    SEGENV.aux0 = random16(SEGLEN); // aux0 stores the random led index
+    SEGENV.aux0 = SEGMENT.random16(SEGLEN); // aux0 stores the random led index
     SEGENV.step = it;
   }
 
@@ -700,11 +700,11 @@ uint16_t mode_flash_sparkle(void) {
     SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(i, true, PALETTE_SOLID_WRAP, 0));
   }
 
-  if (strip.now - SEGENV.aux0 > SEGENV.step) {
-    if(random8((255-SEGMENT.intensity) >> 4) == 0) {
-      SEGMENT.setPixelColor(random16(SEGLEN), SEGCOLOR(1)); //flash
+  if (SEGMENT.frameNow() - SEGENV.aux0 > SEGENV.step) {
+    if(SEGMENT.random8((255-SEGMENT.intensity) >> 4) == 0) {
+      SEGMENT.setPixelColor(SEGMENT.random16(SEGLEN), SEGCOLOR(1)); //flash
     }
-    SEGENV.step = strip.now;
+    SEGENV.step = SEGMENT.frameNow();
     SEGENV.aux0 = 255-SEGMENT.speed;
   }
   return FRAMETIME;
@@ -721,13 +721,13 @@ uint16_t mode_hyper_sparkle(void) {
     SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(i, true, PALETTE_SOLID_WRAP, 0));
   }
 
-  if (strip.now - SEGENV.aux0 > SEGENV.step) {
-    if (random8((255-SEGMENT.intensity) >> 4) == 0) {
+  if (SEGMENT.frameNow() - SEGENV.aux0 > SEGENV.step) {
+    if (SEGMENT.random8((255-SEGMENT.intensity) >> 4) == 0) {
       for (int i = 0; i < max(1, SEGLEN/3); i++) {
-        SEGMENT.setPixelColor(random16(SEGLEN), SEGCOLOR(1));
+        SEGMENT.setPixelColor(SEGMENT.random16(SEGLEN), SEGCOLOR(1));
       }
     }
-    SEGENV.step = strip.now;
+    SEGENV.step = SEGMENT.frameNow();
     SEGENV.aux0 = 255-SEGMENT.speed;
   }
   return FRAMETIME;
@@ -754,10 +754,10 @@ uint16_t mode_multi_strobe(void) {
     }
   }
 
-  if (strip.now - SEGENV.aux0 > SEGENV.step) {
+  if (SEGMENT.frameNow() - SEGENV.aux0 > SEGENV.step) {
     SEGENV.aux1++;
     if (SEGENV.aux1 > count) SEGENV.aux1 = 0;
-    SEGENV.step = strip.now;
+    SEGENV.step = SEGMENT.frameNow();
   }
 
   return FRAMETIME;
@@ -823,7 +823,7 @@ static const char _data_FX_MODE_ANDROID[] PROGMEM = "Android@!,Width;!,!;!;;m12=
  * color2 and color3 = colors of two adjacent leds
  */
 uint16_t chase(uint32_t color1, uint32_t color2, uint32_t color3, bool do_palette) {
-  uint16_t counter = strip.now * ((SEGMENT.speed >> 2) + 1);
+  uint16_t counter = SEGMENT.frameNow() * ((SEGMENT.speed >> 2) + 1);
   uint16_t a = (counter * SEGLEN) >> 16;
 
   bool chase_random = (SEGMENT.mode == FX_MODE_CHASE_RANDOM);
@@ -831,7 +831,7 @@ uint16_t chase(uint32_t color1, uint32_t color2, uint32_t color3, bool do_palett
     if (a < SEGENV.step) //we hit the start again, choose new color for Chase random
     {
       SEGENV.aux1 = SEGENV.aux0; //store previous random color
-      SEGENV.aux0 = get_random_wheel_index(SEGENV.aux0);
+      SEGENV.aux0 = SEGMENT.randomWheelIndex(SEGENV.aux0);
     }
     color1 = SEGMENT.color_wheel(SEGENV.aux0);
   }
@@ -962,7 +962,7 @@ uint16_t mode_colorful(void) {
   for (size_t i = numColors; i < numColors*2 -1U; i++) cols[i] = cols[i-numColors];
 
   uint32_t cycleTime = 50 + (8 * (uint32_t)(255 - SEGMENT.speed));
-  uint32_t it = strip.now / cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
   if (it != SEGENV.step)
   {
     if (SEGMENT.speed > 0) SEGENV.aux0++;
@@ -999,12 +999,12 @@ uint16_t mode_traffic_light(void) {
     }
   }
 
-  if (strip.now - SEGENV.step > mdelay)
+  if (SEGMENT.frameNow() - SEGENV.step > mdelay)
   {
     SEGENV.aux0++;
     if (SEGENV.aux0 == 1 && SEGMENT.intensity > 140) SEGENV.aux0 = 2; //skip Red + Amber, to get US-style sequence
     if (SEGENV.aux0 > 3) SEGENV.aux0 = 0;
-    SEGENV.step = strip.now;
+    SEGENV.step = SEGMENT.frameNow();
   }
 
   return FRAMETIME;
@@ -1071,7 +1071,7 @@ uint16_t mode_chase_flash_random(void) {
     SEGENV.aux1 = (SEGENV.aux1 + 1) % SEGLEN;
 
     if (SEGENV.aux1 == 0) {
-      SEGENV.aux0 = get_random_wheel_index(SEGENV.aux0);
+      SEGENV.aux0 = SEGMENT.randomWheelIndex(SEGENV.aux0);
     }
   }
   return delay;
@@ -1093,8 +1093,8 @@ static const char _data_FX_MODE_RUNNING_COLOR[] PROGMEM = "Chase 2@!,Width;!,!;!
  */
 uint16_t mode_running_random(void) {
   uint32_t cycleTime = 25 + (3 * (uint32_t)(255 - SEGMENT.speed));
-  uint32_t it = strip.now / cycleTime;
-  if (SEGENV.call == 0) SEGENV.aux0 = random16(); // random seed for PRNG on start
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
+  if (SEGENV.call == 0) SEGENV.aux0 = SEGMENT.random16(); // random seed for PRNG on start
 
   uint8_t zoneSize = ((255-SEGMENT.intensity) >> 4) +1;
   uint16_t PRNG16 = SEGENV.aux0;
@@ -1127,7 +1127,7 @@ static const char _data_FX_MODE_RUNNING_RANDOM[] PROGMEM = "Stream@!,Zone size;;
 
 uint16_t larson_scanner(bool dual) {
   if (SEGLEN == 1) return mode_static();
-  uint16_t counter = strip.now * ((SEGMENT.speed >> 2) +8);
+  uint16_t counter = SEGMENT.frameNow() * ((SEGMENT.speed >> 2) +8);
   uint16_t index = (counter * SEGLEN)  >> 16;
 
   SEGMENT.fade_out(SEGMENT.intensity);
@@ -1183,7 +1183,7 @@ static const char _data_FX_MODE_DUAL_LARSON_SCANNER[] PROGMEM = "Scanner Dual@!,
  */
 uint16_t mode_comet(void) {
   if (SEGLEN == 1) return mode_static();
-  uint16_t counter = strip.now * ((SEGMENT.speed >>2) +1);
+  uint16_t counter = SEGMENT.frameNow() * ((SEGMENT.speed >>2) +1);
   uint16_t index = (counter * SEGLEN) >> 16;
   if (SEGENV.call == 0) SEGENV.aux0 = index;
 
@@ -1231,11 +1231,11 @@ uint16_t mode_fireworks() {
   if (valid2) { if (SEGMENT.is2D()) SEGMENT.setPixelColorXY(x, y, sv2); else SEGMENT.setPixelColor(SEGENV.aux1, sv2); } // restore old spark color after blur
 
   for (int i=0; i<max(1, width/20); i++) {
-    if (random8(129 - (SEGMENT.intensity >> 1)) == 0) {
-      uint16_t index = random16(width*height);
+    if (SEGMENT.random8(129 - (SEGMENT.intensity >> 1)) == 0) {
+      uint16_t index = SEGMENT.random16(width*height);
       x = index % width;
       y = index / width;
-      uint32_t col = SEGMENT.color_from_palette(random8(), false, false, 0);
+      uint32_t col = SEGMENT.color_from_palette(SEGMENT.random8(), false, false, 0);
       if (SEGMENT.is2D()) SEGMENT.setPixelColorXY(x, y, col);
       else                SEGMENT.setPixelColor(index, col);
       SEGENV.aux1 = SEGENV.aux0;  // old spark
@@ -1287,7 +1287,7 @@ static const char _data_FX_MODE_RAIN[] PROGMEM = "Rain@!,Spawning rate;!,!;!;12;
  */
 uint16_t mode_fire_flicker(void) {
   uint32_t cycleTime = 40 + (255 - SEGMENT.speed);
-  uint32_t it = strip.now / cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
   if (SEGENV.step == it) return FRAMETIME;
 
   byte w = (SEGCOLOR(0) >> 24);
@@ -1297,7 +1297,7 @@ uint16_t mode_fire_flicker(void) {
   byte lum = (SEGMENT.palette == 0) ? MAX(w, MAX(r, MAX(g, b))) : 255;
   lum /= (((256-SEGMENT.intensity)/16)+1);
   for (int i = 0; i < SEGLEN; i++) {
-    byte flicker = random8(lum);
+    byte flicker = SEGMENT.random8(lum);
     if (SEGMENT.palette == 0) {
       SEGMENT.setPixelColor(i, MAX(r - flicker, 0), MAX(g - flicker, 0), MAX(b - flicker, 0), MAX(w - flicker, 0));
     } else {
@@ -1316,7 +1316,7 @@ static const char _data_FX_MODE_FIRE_FLICKER[] PROGMEM = "Fire Flicker@!,!;!;!;0
  */
 uint16_t gradient_base(bool loading) {
   if (SEGLEN == 1) return mode_static();
-  uint16_t counter = strip.now * ((SEGMENT.speed >> 2) + 1);
+  uint16_t counter = SEGMENT.frameNow() * ((SEGMENT.speed >> 2) + 1);
   uint16_t pp = (counter * SEGLEN) >> 16;
   if (SEGENV.call == 0) pp = 0;
   int val; //0 = sec 1 = pri
@@ -1361,7 +1361,7 @@ static const char _data_FX_MODE_LOADING[] PROGMEM = "Loading@!,Fade;!,!;!;;ix=16
 uint16_t police_base(uint32_t color1, uint32_t color2) {
   if (SEGLEN == 1) return mode_static();
   uint16_t delay = 1 + (FRAMETIME<<3) / SEGLEN;  // longer segments should change faster
-  uint32_t it = strip.now / map(SEGMENT.speed, 0, 255, delay<<4, delay);
+  uint32_t it = SEGMENT.frameNow() / map(SEGMENT.speed, 0, 255, delay<<4, delay);
   uint16_t offset = it % SEGLEN;
 
   uint16_t width = ((SEGLEN*(SEGMENT.intensity+1))>>9); //max width is half the strip
@@ -1424,7 +1424,7 @@ uint16_t mode_fairy() {
   uint16_t dataSize = sizeof(flasher) * numFlashers;
   if (!SEGENV.allocateData(dataSize)) return FRAMETIME; //allocation failed
   Flasher* flashers = reinterpret_cast<Flasher*>(SEGENV.data);
-  uint16_t now16 = strip.now & 0xFFFF;
+  uint16_t now16 = SEGMENT.frameNow() & 0xFFFF;
 
   //Up to 11 flashers in one brightness zone, afterwards a new zone for every 6 flashers
   uint16_t zones = numFlashers/FLASHERS_PER_ZONE;
@@ -1443,11 +1443,11 @@ uint16_t mode_fairy() {
       if (stateTime > flashers[f].stateDur * 10) {
         flashers[f].stateOn = !flashers[f].stateOn;
         if (flashers[f].stateOn) {
-          flashers[f].stateDur = 12 + random8(12 + ((255 - SEGMENT.speed) >> 2)); //*10, 250ms to 1250ms
+          flashers[f].stateDur = 12 + SEGMENT.random8(12 + ((255 - SEGMENT.speed) >> 2)); //*10, 250ms to 1250ms
         } else {
-          flashers[f].stateDur = 20 + random8(6 + ((255 - SEGMENT.speed) >> 2)); //*10, 250ms to 1250ms
+          flashers[f].stateDur = 20 + SEGMENT.random8(6 + ((255 - SEGMENT.speed) >> 2)); //*10, 250ms to 1250ms
         }
-        //flashers[f].stateDur = 51 + random8(2 + ((255 - SEGMENT.speed) >> 1));
+        //flashers[f].stateDur = 51 + SEGMENT.random8(2 + ((255 - SEGMENT.speed) >> 1));
         flashers[f].stateStart = now16;
         if (stateTime < 255) {
           flashers[f].stateStart -= 255 -stateTime; //start early to get correct bri
@@ -1490,7 +1490,7 @@ uint16_t mode_fairytwinkle() {
   uint16_t dataSize = sizeof(flasher) * SEGLEN;
   if (!SEGENV.allocateData(dataSize)) return mode_static(); //allocation failed
   Flasher* flashers = reinterpret_cast<Flasher*>(SEGENV.data);
-  uint16_t now16 = strip.now & 0xFFFF;
+  uint16_t now16 = SEGMENT.frameNow() & 0xFFFF;
   uint16_t PRNG16 = 5100 + strip.getCurrSegmentId();
 
   uint16_t riseFallTime = 400 + (255-SEGMENT.speed)*3;
@@ -1503,15 +1503,15 @@ uint16_t mode_fairytwinkle() {
       flashers[f].stateOn = !flashers[f].stateOn;
       bool init = !flashers[f].stateDur;
       if (flashers[f].stateOn) {
-        flashers[f].stateDur = riseFallTime/100 + ((255 - SEGMENT.intensity) >> 2) + random8(12 + ((255 - SEGMENT.intensity) >> 1)) +1;
+        flashers[f].stateDur = riseFallTime/100 + ((255 - SEGMENT.intensity) >> 2) + SEGMENT.random8(12 + ((255 - SEGMENT.intensity) >> 1)) +1;
       } else {
-        flashers[f].stateDur = riseFallTime/100 + random8(3 + ((255 - SEGMENT.speed) >> 6)) +1;
+        flashers[f].stateDur = riseFallTime/100 + SEGMENT.random8(3 + ((255 - SEGMENT.speed) >> 6)) +1;
       }
       flashers[f].stateStart = now16;
       stateTime = 0;
       if (init) {
         flashers[f].stateStart -= riseFallTime; //start lit
-        flashers[f].stateDur = riseFallTime/100 + random8(12 + ((255 - SEGMENT.intensity) >> 1)) +5; //fire up a little quicker
+        flashers[f].stateDur = riseFallTime/100 + SEGMENT.random8(12 + ((255 - SEGMENT.intensity) >> 1)) +5; //fire up a little quicker
         stateTime = riseFallTime;
       }
     }
@@ -1537,7 +1537,7 @@ static const char _data_FX_MODE_FAIRYTWINKLE[] PROGMEM = "Fairytwinkle@!,!;!,!;!
  */
 uint16_t tricolor_chase(uint32_t color1, uint32_t color2) {
   uint32_t cycleTime = 50 + ((255 - SEGMENT.speed)<<1);
-  uint32_t it = strip.now / cycleTime;  // iterator
+  uint32_t it = SEGMENT.frameNow() / cycleTime;  // iterator
   uint8_t width = (1 + (SEGMENT.intensity>>4)); // value of 1-16 for each colour
   uint8_t index = it % (width*3);
 
@@ -1579,13 +1579,13 @@ uint16_t mode_icu(void) {
   SEGMENT.setPixelColor(dest + SEGLEN/space, col);
 
   if(SEGENV.aux0 == dest) { // pause between eye movements
-    if(random8(6) == 0) { // blink once in a while
+    if(SEGMENT.random8(6) == 0) { // blink once in a while
       SEGMENT.setPixelColor(dest, SEGCOLOR(1));
       SEGMENT.setPixelColor(dest + SEGLEN/space, SEGCOLOR(1));
       return 200;
     }
-    SEGENV.aux0 = random16(SEGLEN-SEGLEN/space);
-    return 1000 + random16(2000);
+    SEGENV.aux0 = SEGMENT.random16(SEGLEN-SEGLEN/space);
+    return 1000 + SEGMENT.random16(2000);
   }
 
   if(SEGENV.aux0 > SEGENV.step) {
@@ -1609,7 +1609,7 @@ static const char _data_FX_MODE_ICU[] PROGMEM = "ICU@!,!,,,,,Overlay;!,!;!";
  */
 uint16_t mode_tricolor_wipe(void) {
   uint32_t cycleTime = 1000 + (255 - SEGMENT.speed)*200;
-  uint32_t perc = strip.now % cycleTime;
+  uint32_t perc = SEGMENT.frameNow() % cycleTime;
   uint16_t prog = (perc * 65535) / cycleTime;
   uint16_t ledIndex = (prog * SEGLEN * 3) >> 16;
   uint16_t ledOffset = ledIndex;
@@ -1650,7 +1650,7 @@ static const char _data_FX_MODE_TRICOLOR_WIPE[] PROGMEM = "Tri Wipe@!;1,2,3;!";
  * Modified by Aircoookie
  */
 uint16_t mode_tricolor_fade(void) {
-  uint16_t counter = strip.now * ((SEGMENT.speed >> 3) +1);
+  uint16_t counter = SEGMENT.frameNow() * ((SEGMENT.speed >> 3) +1);
   uint32_t prog = (counter * 768) >> 16;
 
   uint32_t color1 = 0, color2 = 0;
@@ -1694,7 +1694,7 @@ static const char _data_FX_MODE_TRICOLOR_FADE[] PROGMEM = "Tri Fade@!;1,2,3;!";
  */
 uint16_t mode_multi_comet(void) {
   uint32_t cycleTime = 10 + (uint32_t)(255 - SEGMENT.speed);
-  uint32_t it = strip.now / cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
   if (SEGENV.step == it) return FRAMETIME;
   if (!SEGENV.allocateData(sizeof(uint16_t) * 8)) return mode_static(); //allocation failed
 
@@ -1714,7 +1714,7 @@ uint16_t mode_multi_comet(void) {
       }
       comets[i]++;
     } else {
-      if(!random(SEGLEN)) {
+      if(!SEGMENT.random16(SEGLEN)) {
         comets[i] = 0;
       }
     }
@@ -1732,30 +1732,28 @@ static const char _data_FX_MODE_MULTI_COMET[] PROGMEM = "Multi Comet";
  */
 uint16_t mode_random_chase(void) {
   if (SEGENV.call == 0) {
-    SEGENV.step = RGBW32(random8(), random8(), random8(), 0);
-    SEGENV.aux0 = random16();
+    SEGENV.step = RGBW32(SEGMENT.random8(), SEGMENT.random8(), SEGMENT.random8(), 0);
+    SEGENV.aux0 = SEGMENT.random16();
   }
-  uint16_t prevSeed = random16_get_seed(); // save seed so we can restore it at the end of the function
   uint32_t cycleTime = 25 + (3 * (uint32_t)(255 - SEGMENT.speed));
-  uint32_t it = strip.now / cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
   uint32_t color = SEGENV.step;
-  random16_set_seed(SEGENV.aux0);
+  SEGMENT.setRandomSeed(SEGENV.aux0);
 
   for (int i = SEGLEN -1; i > 0; i--) {
-    uint8_t r = random8(6) != 0 ? (color >> 16 & 0xFF) : random8();
-    uint8_t g = random8(6) != 0 ? (color >> 8  & 0xFF) : random8();
-    uint8_t b = random8(6) != 0 ? (color       & 0xFF) : random8();
+    uint8_t r = SEGMENT.random8(6) != 0 ? (color >> 16 & 0xFF) : SEGMENT.random8();
+    uint8_t g = SEGMENT.random8(6) != 0 ? (color >> 8  & 0xFF) : SEGMENT.random8();
+    uint8_t b = SEGMENT.random8(6) != 0 ? (color       & 0xFF) : SEGMENT.random8();
     color = RGBW32(r, g, b, 0);
     SEGMENT.setPixelColor(i, r, g, b);
     if (i == SEGLEN -1 && SEGENV.aux1 != (it & 0xFFFF)) { //new first color in next frame
       SEGENV.step = color;
-      SEGENV.aux0 = random16_get_seed();
+      SEGENV.aux0 = SEGMENT.getRandomSeed();
     }
   }
 
   SEGENV.aux1 = it & 0xFFFF;
 
-  random16_set_seed(prevSeed); // restore original seed so other effects can use "random" PRNG
   return FRAMETIME;
 }
 static const char _data_FX_MODE_RANDOM_CHASE[] PROGMEM = "Stream 2@!;;";
@@ -1788,7 +1786,7 @@ uint16_t mode_oscillate(void) {
   }
 
   uint32_t cycleTime = 20 + (2 * (uint32_t)(255 - SEGMENT.speed));
-  uint32_t it = strip.now / cycleTime;
+  uint32_t it = SEGMENT.frameNow() / cycleTime;
 
   for (int i = 0; i < numOscillators; i++) {
     // if the counter has increased, move the oscillator by the random step
@@ -1798,12 +1796,12 @@ uint16_t mode_oscillate(void) {
       oscillators[i].pos = 0;
       oscillators[i].dir = 1;
       // make bigger steps for faster speeds
-      oscillators[i].speed = SEGMENT.speed > 100 ? random8(2, 4):random8(1, 3);
+      oscillators[i].speed = SEGMENT.speed > 100 ? SEGMENT.random8(2, 4):SEGMENT.random8(1, 3);
     }
     if((oscillators[i].dir == 1) && (oscillators[i].pos >= (SEGLEN - 1))) {
       oscillators[i].pos = SEGLEN - 1;
       oscillators[i].dir = -1;
-      oscillators[i].speed = SEGMENT.speed > 100 ? random8(2, 4):random8(1, 3);
+      oscillators[i].speed = SEGMENT.speed > 100 ? SEGMENT.random8(2, 4):SEGMENT.random8(1, 3);
     }
   }
 
@@ -1826,13 +1824,13 @@ static const char _data_FX_MODE_OSCILLATE[] PROGMEM = "Oscillate";
 //TODO
 uint16_t mode_lightning(void) {
   if (SEGLEN == 1) return mode_static();
-  uint16_t ledstart = random16(SEGLEN);               // Determine starting location of flash
-  uint16_t ledlen = 1 + random16(SEGLEN -ledstart);   // Determine length of flash (not to go beyond NUM_LEDS-1)
-  uint8_t bri = 255/random8(1, 3);
+  uint16_t ledstart = SEGMENT.random16(SEGLEN);               // Determine starting location of flash
+  uint16_t ledlen = 1 + SEGMENT.random16(SEGLEN -ledstart);   // Determine length of flash (not to go beyond NUM_LEDS-1)
+  uint8_t bri = 255/SEGMENT.random8(1, 3);
 
   if (SEGENV.aux1 == 0) //init, leader flash
   {
-    SEGENV.aux1 = random8(4, 4 + SEGMENT.intensity/20); //number of flashes
+    SEGENV.aux1 = SEGMENT.random8(4, 4 + SEGMENT.intensity/20); //number of flashes
     SEGENV.aux1 *= 2;
 
     bri = 52; //leader has lower brightness
@@ -1848,18 +1846,18 @@ uint16_t mode_lightning(void) {
     }
     SEGENV.aux1--;
 
-    SEGENV.step = millis();
-    //return random8(4, 10); // each flash only lasts one frame/every 24ms... originally 4-10 milliseconds
+    SEGENV.step = SEGMENT.frameNow();
+    //return SEGMENT.random8(4, 10); // each flash only lasts one frame/every 24ms... originally 4-10 milliseconds
   } else {
-    if (millis() - SEGENV.step > SEGENV.aux0) {
+    if (SEGMENT.frameNow() - SEGENV.step > SEGENV.aux0) {
       SEGENV.aux1--;
       if (SEGENV.aux1 < 2) SEGENV.aux1 = 0;
 
-      SEGENV.aux0 = (50 + random8(100)); //delay between flashes
+      SEGENV.aux0 = (50 + SEGMENT.random8(100)); //delay between flashes
       if (SEGENV.aux1 == 2) {
-        SEGENV.aux0 = (random8(255 - SEGMENT.speed) * 100); // delay between strikes
+        SEGENV.aux0 = (SEGMENT.random8(255 - SEGMENT.speed) * 100); // delay between strikes
       }
-      SEGENV.step = millis();
+      SEGENV.step = SEGMENT.frameNow();
     }
   }
   return FRAMETIME;
@@ -1932,7 +1930,7 @@ uint16_t mode_palette() {
   uint16_t counter = 0;
   if (SEGMENT.speed != 0)
   {
-    counter = (strip.now * ((SEGMENT.speed >> 3) +1)) & 0xFFFF;
+    counter = (SEGMENT.frameNow() * ((SEGMENT.speed >> 3) +1)) & 0xFFFF;
     counter = counter >> 8;
   }
 
@@ -1981,7 +1979,7 @@ uint16_t mode_fire_2012() {
   if (!SEGENV.allocateData(strips * SEGLEN)) return mode_static(); //allocation failed
   byte* heat = SEGENV.data;
 
-  const uint32_t it = strip.now >> 5; //div 32
+  const uint32_t it = SEGMENT.frameNow() >> 5; //div 32
 
   struct virtualStrip {
     static void runStrip(uint16_t stripNr, byte* heat, uint32_t it) {
@@ -1990,7 +1988,7 @@ uint16_t mode_fire_2012() {
 
       // Step 1.  Cool down every cell a little
       for (int i = 0; i < SEGLEN; i++) {
-        uint8_t cool = (it != SEGENV.step) ? random8((((20 + SEGMENT.speed/3) * 16) / SEGLEN)+2) : random(4);
+        uint8_t cool = (it != SEGENV.step) ? SEGMENT.random8((((20 + SEGMENT.speed/3) * 16) / SEGLEN)+2) : SEGMENT.random8(4);
         uint8_t minTemp = (i<ignition) ? (ignition-i)/4 + 16 : 0;  // should not become black in ignition area
         uint8_t temp = qsub8(heat[i], cool);
         heat[i] = temp<minTemp ? minTemp : temp;
@@ -2003,10 +2001,10 @@ uint16_t mode_fire_2012() {
         }
 
         // Step 3.  Randomly ignite new 'sparks' of heat near the bottom
-        if (random8() <= SEGMENT.intensity) {
-          uint8_t y = random8(ignition);
+        if (SEGMENT.random8() <= SEGMENT.intensity) {
+          uint8_t y = SEGMENT.random8(ignition);
           uint8_t boost = (17+SEGMENT.custom3) * (ignition - y/2) / ignition; // integer math!
-          heat[y] = qadd8(heat[y], random8(96+2*boost,207+boost));
+          heat[y] = qadd8(heat[y], SEGMENT.random8(96+2*boost,207+boost));
         }
       }
 
@@ -2078,7 +2076,7 @@ static const char _data_FX_MODE_COLORWAVES[] PROGMEM = "Colorwaves@!,Hue;!;!";
 
 // colored stripes pulsing at a defined Beats-Per-Minute (BPM)
 uint16_t mode_bpm() {
-  uint32_t stp = (strip.now / 20) & 0xFF;
+  uint32_t stp = (SEGMENT.frameNow() / 20) & 0xFF;
   uint8_t beat = beatsin8(SEGMENT.speed, 64, 255);
   for (int i = 0; i < SEGLEN; i++) {
     SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(stp + (i * 2), false, PALETTE_SOLID_WRAP, 0, beat - stp + (i * 10)));
@@ -2090,7 +2088,7 @@ static const char _data_FX_MODE_BPM[] PROGMEM = "Bpm@!;!;!;;sx=64";
 
 
 uint16_t mode_fillnoise8() {
-  if (SEGENV.call == 0) SEGENV.step = random16(12345);
+  if (SEGENV.call == 0) SEGENV.step = SEGMENT.random16(12345);
   //CRGB fastled_col;
   for (int i = 0; i < SEGLEN; i++) {
     uint8_t index = inoise8(i * SEGLEN, SEGENV.step + i * SEGLEN);
@@ -2177,7 +2175,7 @@ static const char _data_FX_MODE_NOISE16_3[] PROGMEM = "Noise 3@!;!;!";
 //https://github.com/aykevl/ledstrip-spark/blob/master/ledstrip.ino
 uint16_t mode_noise16_4() {
   //CRGB fastled_col;
-  uint32_t stp = (strip.now * SEGMENT.speed) >> 7;
+  uint32_t stp = (SEGMENT.frameNow() * SEGMENT.speed) >> 7;
   for (int i = 0; i < SEGLEN; i++) {
     int16_t index = inoise16(uint32_t(i) << 12, stp);
     //fastled_col = ColorFromPalette(SEGPALETTE, index);
@@ -2225,11 +2223,11 @@ uint16_t mode_colortwinkle() {
   }
 
   for (uint16_t j = 0; j <= SEGLEN / 50; j++) {
-    if (random8() <= SEGMENT.intensity) {
+    if (SEGMENT.random8() <= SEGMENT.intensity) {
       for (uint8_t times = 0; times < 5; times++) { //attempt to spawn a new pixel 5 times
-        int i = random16(SEGLEN);
+        int i = SEGMENT.random16(SEGLEN);
         if (SEGMENT.getPixelColor(i) == 0) {
-          fastled_col = ColorFromPalette(SEGPALETTE, random8(), 64, NOBLEND);
+          fastled_col = ColorFromPalette(SEGPALETTE, SEGMENT.random8(), 64, NOBLEND);
           uint16_t index = i >> 3;
           uint8_t  bitNum = i & 0x07;
           bitWrite(SEGENV.data[index], bitNum, true);
@@ -2276,14 +2274,14 @@ uint16_t mode_meteor() {
   byte* trail = SEGENV.data;
 
   const unsigned meteorSize= 1 + SEGLEN / 20; // 5%
-  uint16_t counter = strip.now * ((SEGMENT.speed >> 2) +8);
+  uint16_t counter = SEGMENT.frameNow() * ((SEGMENT.speed >> 2) +8);
   uint16_t in = counter * SEGLEN >> 16;
 
   const int max = SEGMENT.palette==5 || !SEGMENT.check1 ? 240 : 255;
   // fade all leds to colors[1] in LEDs one step
   for (int i = 0; i < SEGLEN; i++) {
-    if (random8() <= 255 - SEGMENT.intensity) {
-      byte meteorTrailDecay = 162 + random8(92);
+    if (SEGMENT.random8() <= 255 - SEGMENT.intensity) {
+      byte meteorTrailDecay = 162 + SEGMENT.random8(92);
       trail[i] = scale8(trail[i], meteorTrailDecay);
       uint32_t col = SEGMENT.check1 ? SEGMENT.color_from_palette(i, true, false, 0, trail[i]) : SEGMENT.color_from_palette(trail[i], false, true, 255);
       SEGMENT.setPixelColor(i, col);
@@ -2321,8 +2319,8 @@ uint16_t mode_meteor_smooth() {
   const int max = SEGMENT.palette==5 || !SEGMENT.check1 ? 240 : 255;
   // fade all leds to colors[1] in LEDs one step
   for (int i = 0; i < SEGLEN; i++) {
-    if (/*trail[i] != 0 &&*/ random8() <= 255 - SEGMENT.intensity) {
-      int change = trail[i] + 4 - random8(24); //change each time between -20 and +4
+    if (/*trail[i] != 0 &&*/ SEGMENT.random8() <= 255 - SEGMENT.intensity) {
+      int change = trail[i] + 4 - SEGMENT.random8(24); //change each time between -20 and +4
       trail[i] = constrain(change, 0, max);
       uint32_t col = SEGMENT.check1 ? SEGMENT.color_from_palette(i, true, false, 0, trail[i]) : SEGMENT.color_from_palette(trail[i], false, true, 255);
       SEGMENT.setPixelColor(i, col);
@@ -2436,10 +2434,10 @@ uint16_t ripple_base()
       ripplestate += rippledecay;
       ripples[i].state = (ripplestate > 254) ? 0 : ripplestate;
     } else {//randomly create new wave
-      if (random16(IBN + 10000) <= (SEGMENT.intensity >> (SEGMENT.is2D()*3))) {
+      if (SEGMENT.random16(IBN + 10000) <= (SEGMENT.intensity >> (SEGMENT.is2D()*3))) {
         ripples[i].state = 1;
-        ripples[i].pos = SEGMENT.is2D() ? ((random8(SEGENV.virtualWidth())<<8) | (random8(SEGENV.virtualHeight()))) : random16(SEGLEN);
-        ripples[i].color = random8(); //color
+        ripples[i].pos = SEGMENT.is2D() ? ((SEGMENT.random8(SEGENV.virtualWidth())<<8) | (SEGMENT.random8(SEGENV.virtualHeight()))) : SEGMENT.random16(SEGLEN);
+        ripples[i].color = SEGMENT.random8(); //color
       }
     }
   }
@@ -2461,11 +2459,11 @@ static const char _data_FX_MODE_RIPPLE[] PROGMEM = "Ripple@!,Wave #,,,,,Overlay;
 uint16_t mode_ripple_rainbow(void) {
   if (SEGLEN == 1) return mode_static();
   if (SEGENV.call ==0) {
-    SEGENV.aux0 = random8();
-    SEGENV.aux1 = random8();
+    SEGENV.aux0 = SEGMENT.random8();
+    SEGENV.aux1 = SEGMENT.random8();
   }
   if (SEGENV.aux0 == SEGENV.aux1) {
-    SEGENV.aux1 = random8();
+    SEGENV.aux1 = SEGMENT.random8();
   } else if (SEGENV.aux1 > SEGENV.aux0) {
     SEGENV.aux0++;
   } else {
@@ -2573,7 +2571,7 @@ uint16_t twinklefox_base(bool cat)
     PRNG16 = (uint16_t)(PRNG16 * 2053) + 1384; // next 'random' number
     // use that number as clock speed adjustment factor (in 8ths, from 8/8ths to 23/8ths)
     uint8_t myspeedmultiplierQ5_3 =  ((((PRNG16 & 0xFF)>>4) + (PRNG16 & 0x0F)) & 0x0F) + 0x08;
-    uint32_t myclock30 = (uint32_t)((strip.now * myspeedmultiplierQ5_3) >> 3) + myclockoffset16;
+    uint32_t myclock30 = (uint32_t)((SEGMENT.frameNow() * myspeedmultiplierQ5_3) >> 3) + myclockoffset16;
     uint8_t  myunique8 = PRNG16 >> 8; // get 'salt' value for this pixel
 
     // We now have the adjusted 'clock' for this pixel, now we call
@@ -2632,9 +2630,9 @@ uint16_t mode_halloween_eyes()
   if (stateTime == 0) stateTime = 2000;
 
   if (state == 0) { //spawn eyes
-    SEGENV.aux0 = random16(0, maxWidth - eyeLength - 1); //start pos
-    SEGENV.aux1 = random8(); //color
-    if (strip.isMatrix) SEGMENT.offset = random16(SEGMENT.virtualHeight()-1); // a hack: reuse offset since it is not used in matrices
+    SEGENV.aux0 = SEGMENT.random16(0, maxWidth - eyeLength - 1); //start pos
+    SEGENV.aux1 = SEGMENT.random8(); //color
+    if (strip.isMatrix) SEGMENT.offset = SEGMENT.random16(SEGMENT.virtualHeight()-1); // a hack: reuse offset since it is not used in matrices
     state = 1;
   }
 
@@ -2642,7 +2640,7 @@ uint16_t mode_halloween_eyes()
     uint16_t startPos    = SEGENV.aux0;
     uint16_t start2ndEye = startPos + HALLOWEEN_EYE_WIDTH + HALLOWEEN_EYE_SPACE;
 
-    uint32_t fadestage = (strip.now - SEGENV.step)*255 / stateTime;
+    uint32_t fadestage = (SEGMENT.frameNow() - SEGENV.step)*255 / stateTime;
     if (fadestage > 255) fadestage = 255;
     uint32_t c = color_blend(SEGMENT.color_from_palette(SEGENV.aux1 & 0xFF, false, false, 0), SEGCOLOR(1), fadestage);
 
@@ -2657,7 +2655,7 @@ uint16_t mode_halloween_eyes()
     }
   }
 
-  if (strip.now - SEGENV.step > stateTime) {
+  if (SEGMENT.frameNow() - SEGENV.step > stateTime) {
     state++;
     if (state > 2) state = 0;
 
@@ -2665,9 +2663,9 @@ uint16_t mode_halloween_eyes()
       stateTime = 100 + SEGMENT.intensity*10; //eye fade time
     } else {
       uint16_t eyeOffTimeBase = (256 - SEGMENT.speed)*10;
-      stateTime = eyeOffTimeBase + random16(eyeOffTimeBase);
+      stateTime = eyeOffTimeBase + SEGMENT.random16(eyeOffTimeBase);
     }
-    SEGENV.step = strip.now;
+    SEGENV.step = SEGMENT.frameNow();
     SEGENV.call = stateTime;
   }
 
@@ -2765,7 +2763,7 @@ static const char _data_FX_MODE_SPOTS[] PROGMEM = "Spots@Spread,Width,,,,,Overla
 //Intensity slider sets number of "lights", LEDs per light fade in and out
 uint16_t mode_spots_fade()
 {
-  uint16_t counter = strip.now * ((SEGMENT.speed >> 2) +8);
+  uint16_t counter = SEGMENT.frameNow() * ((SEGMENT.speed >> 2) +8);
   uint16_t t = triwave16(counter);
   uint16_t tr = (t >> 1) + (t >> 2);
   return spots_base(tr);
@@ -2805,7 +2803,7 @@ uint16_t mode_bouncing_balls(void) {
       uint16_t numBalls = (SEGMENT.intensity * (maxNumBalls - 1)) / 255 + 1; // minimum 1 ball
       const float gravity = -9.81f; // standard value of gravity
       const bool hasCol2 = SEGCOLOR(2);
-      const unsigned long time = millis();
+      const unsigned long time = SEGMENT.frameNow();
 
       if (SEGENV.call == 0) {
         for (size_t i = 0; i < maxNumBalls; i++) balls[i].lastBounceTime = time;
@@ -2824,7 +2822,7 @@ uint16_t mode_bouncing_balls(void) {
           balls[i].lastBounceTime = time;
 
           if (balls[i].impactVelocity < 0.015f) {
-            float impactVelocityStart = sqrtf(-2.0f * gravity) * random8(5,11)/10.0f; // randomize impact velocity
+            float impactVelocityStart = sqrtf(-2.0f * gravity) * SEGMENT.random8(5,11)/10.0f; // randomize impact velocity
             balls[i].impactVelocity = impactVelocityStart;
           }
         } else if (balls[i].height > 1.0f) {
@@ -2882,11 +2880,11 @@ static uint16_t rolling_balls(void) {
   if (SEGENV.call == 0) {
     SEGMENT.fill(hasCol2 ? BLACK : SEGCOLOR(1));                    // start clean
     for (int i = 0; i < maxNumBalls; i++) {
-      balls[i].lastBounceUpdate = strip.now;
-      balls[i].velocity = 20.0f * float(random16(1000, 10000))/10000.0f;  // number from 1 to 10
-      if (random8()<128) balls[i].velocity = -balls[i].velocity;    // 50% chance of reverse direction
-      balls[i].height = (float(random16(0, 10000)) / 10000.0f);     // from 0. to 1.
-      balls[i].mass   = (float(random16(1000, 10000)) / 10000.0f);  // from .1 to 1.
+      balls[i].lastBounceUpdate = SEGMENT.frameNow();
+      balls[i].velocity = 20.0f * float(SEGMENT.random16(1000, 10000))/10000.0f;  // number from 1 to 10
+      if (SEGMENT.random8()<128) balls[i].velocity = -balls[i].velocity;    // 50% chance of reverse direction
+      balls[i].height = (float(SEGMENT.random16(0, 10000)) / 10000.0f);     // from 0. to 1.
+      balls[i].mass   = (float(SEGMENT.random16(1000, 10000)) / 10000.0f);  // from .1 to 1.
     }
   }
 
@@ -2898,17 +2896,17 @@ static uint16_t rolling_balls(void) {
   }
 
   for (int i = 0; i < numBalls; i++) {
-    float timeSinceLastUpdate = float((strip.now - balls[i].lastBounceUpdate))/cfac;
+    float timeSinceLastUpdate = float((SEGMENT.frameNow() - balls[i].lastBounceUpdate))/cfac;
     float thisHeight = balls[i].height + balls[i].velocity * timeSinceLastUpdate; // this method keeps higher resolution
     // test if intensity level was increased and some balls are way off the track then put them back
     if (thisHeight < -0.5f || thisHeight > 1.5f) {
-      thisHeight = balls[i].height = (float(random16(0, 10000)) / 10000.0f); // from 0. to 1.
-      balls[i].lastBounceUpdate = strip.now;
+      thisHeight = balls[i].height = (float(SEGMENT.random16(0, 10000)) / 10000.0f); // from 0. to 1.
+      balls[i].lastBounceUpdate = SEGMENT.frameNow();
     }
     // check if reached ends of the strip
     if ((thisHeight <= 0.0f && balls[i].velocity < 0.0f) || (thisHeight >= 1.0f && balls[i].velocity > 0.0f)) {
       balls[i].velocity = -balls[i].velocity; // reverse velocity
-      balls[i].lastBounceUpdate = strip.now;
+      balls[i].lastBounceUpdate = SEGMENT.frameNow();
       balls[i].height = thisHeight;
     }
     // check for collisions
@@ -2919,7 +2917,7 @@ static uint16_t rolling_balls(void) {
           float tcollided = (cfac*(balls[i].height - balls[j].height) +
                 balls[i].velocity*float(balls[j].lastBounceUpdate - balls[i].lastBounceUpdate))/(balls[j].velocity - balls[i].velocity);
 
-          if ((tcollided > 2.0f) && (tcollided < float(strip.now - balls[j].lastBounceUpdate))) { // 2ms minimum to avoid duplicate bounces
+          if ((tcollided > 2.0f) && (tcollided < float(SEGMENT.frameNow() - balls[j].lastBounceUpdate))) { // 2ms minimum to avoid duplicate bounces
             balls[i].height = balls[i].height + balls[i].velocity*(tcollided + float(balls[j].lastBounceUpdate - balls[i].lastBounceUpdate))/cfac;
             balls[j].height = balls[i].height;
             balls[i].lastBounceUpdate = (unsigned long)(tcollided + 0.5f) + balls[j].lastBounceUpdate;
@@ -2927,7 +2925,7 @@ static uint16_t rolling_balls(void) {
             float vtmp = balls[i].velocity;
             balls[i].velocity = ((balls[i].mass - balls[j].mass)*vtmp              + 2.0f*balls[j].mass*balls[j].velocity)/(balls[i].mass + balls[j].mass);
             balls[j].velocity = ((balls[j].mass - balls[i].mass)*balls[j].velocity + 2.0f*balls[i].mass*vtmp)             /(balls[i].mass + balls[j].mass);
-            thisHeight = balls[i].height + balls[i].velocity*(strip.now - balls[i].lastBounceUpdate)/cfac;
+            thisHeight = balls[i].height + balls[i].velocity*(SEGMENT.frameNow() - balls[i].lastBounceUpdate)/cfac;
           }
         }
       }
@@ -2945,7 +2943,7 @@ static uint16_t rolling_balls(void) {
     if (thisHeight > 1.0f) thisHeight = 1.0f;
     uint16_t pos = round(thisHeight * (SEGLEN - 1));
     SEGMENT.setPixelColor(pos, color);
-    balls[i].lastBounceUpdate = strip.now;
+    balls[i].lastBounceUpdate = SEGMENT.frameNow();
     balls[i].height = thisHeight;
   }
 
@@ -3012,11 +3010,11 @@ static const char _data_FX_MODE_SINELON_RAINBOW[] PROGMEM = "Sinelon Rainbow@!,T
 
 // utility function that will add random glitter to SEGMENT
 void glitter_base(uint8_t intensity, uint32_t col = ULTRAWHITE) {
-  if (intensity > random8()) {
+  if (intensity > SEGMENT.random8()) {
     if (SEGMENT.is2D()) {
-      SEGMENT.setPixelColorXY(random16(SEGMENT.virtualWidth()),random16(SEGMENT.virtualHeight()), col);
+      SEGMENT.setPixelColorXY(SEGMENT.random16(SEGMENT.virtualWidth()),SEGMENT.random16(SEGMENT.virtualHeight()), col);
     } else {
-      SEGMENT.setPixelColor(random16(SEGLEN), col);
+      SEGMENT.setPixelColor(SEGMENT.random16(SEGLEN), col);
     }
   }
 }
@@ -3080,18 +3078,18 @@ uint16_t mode_popcorn(void) {
           popcorn[i].pos += popcorn[i].vel;
           popcorn[i].vel += gravity;
         } else { // if kernel is inactive, randomly pop it
-          if (random8() < 2) { // POP!!!
+          if (SEGMENT.random8() < 2) { // POP!!!
             popcorn[i].pos = 0.01f;
 
-            uint16_t peakHeight = 128 + random8(128); //0-255
+            uint16_t peakHeight = 128 + SEGMENT.random8(128); //0-255
             peakHeight = (peakHeight * (SEGLEN -1)) >> 8;
             popcorn[i].vel = sqrtf(-2.0f * gravity * peakHeight);
 
             if (SEGMENT.palette)
             {
-              popcorn[i].colIndex = random8();
+              popcorn[i].colIndex = SEGMENT.random8();
             } else {
-              byte col = random8(0, NUM_COLORS);
+              byte col = SEGMENT.random8(0, NUM_COLORS);
               if (!SEGCOLOR(2) || !SEGCOLOR(col)) col = 0;
               popcorn[i].colIndex = col;
             }
@@ -3153,7 +3151,7 @@ uint16_t candle(bool multi)
       s = SEGENV.data[d]; s_target = SEGENV.data[d+1]; fadeStep = SEGENV.data[d+2];
     }
     if (fadeStep == 0) { //init vals
-      s = 128; s_target = 130 + random8(4); fadeStep = 1;
+      s = 128; s_target = 130 + SEGMENT.random8(4); fadeStep = 1;
     }
 
     bool newTarget = false;
@@ -3166,8 +3164,8 @@ uint16_t candle(bool multi)
     }
 
     if (newTarget) {
-      s_target = random8(rndval) + random8(rndval); //between 0 and rndval*2 -2 = 252
-      if (s_target < (rndval >> 1)) s_target = (rndval >> 1) + random8(rndval);
+      s_target = SEGMENT.random8(rndval) + SEGMENT.random8(rndval); //between 0 and rndval*2 -2 = 252
+      if (s_target < (rndval >> 1)) s_target = (rndval >> 1) + SEGMENT.random8(rndval);
       uint8_t offset = (255 - valrange);
       s_target += offset;
 
@@ -3242,7 +3240,7 @@ uint16_t mode_starburst(void) {
 
   if (!SEGENV.allocateData(dataSize)) return mode_static(); //allocation failed
 
-  uint32_t it = millis();
+  uint32_t it = SEGMENT.frameNow();
 
   star* stars = reinterpret_cast<star*>(SEGENV.data);
 
@@ -3253,19 +3251,19 @@ uint16_t mode_starburst(void) {
   for (int j = 0; j < numStars; j++)
   {
     // speed to adjust chance of a burst, max is nearly always.
-    if (random8((144-(SEGMENT.speed >> 1))) == 0 && stars[j].birth == 0)
+    if (SEGMENT.random8((144-(SEGMENT.speed >> 1))) == 0 && stars[j].birth == 0)
     {
       // Pick a random color and location.
-      uint16_t startPos = (SEGLEN > 1) ? random16(SEGLEN-1) : 0;
-      float multiplier = (float)(random8())/255.0 * 1.0;
+      uint16_t startPos = (SEGLEN > 1) ? SEGMENT.random16(SEGLEN-1) : 0;
+      float multiplier = (float)(SEGMENT.random8())/255.0 * 1.0;
 
-      stars[j].color = CRGB(SEGMENT.color_wheel(random8()));
+      stars[j].color = CRGB(SEGMENT.color_wheel(SEGMENT.random8()));
       stars[j].pos = startPos;
-      stars[j].vel = maxSpeed * (float)(random8())/255.0 * multiplier;
+      stars[j].vel = maxSpeed * (float)(SEGMENT.random8())/255.0 * multiplier;
       stars[j].birth = it;
       stars[j].last = it;
       // more fragments means larger burst effect
-      int num = random8(3,6 + (SEGMENT.intensity >> 5));
+      int num = SEGMENT.random8(3,6 + (SEGMENT.intensity >> 5));
 
       for (int i=0; i < STARBURST_MAX_FRAG; i++) {
         if (i < num) stars[j].fragment[i] = startPos;
@@ -3382,11 +3380,11 @@ uint16_t mode_exploding_fireworks(void)
   if (SEGENV.aux0 < 2) { //FLARE
     if (SEGENV.aux0 == 0) { //init flare
       flare->pos = 0;
-      flare->posX = strip.isMatrix ? random16(2,cols-3) : (SEGMENT.intensity > random8()); // will enable random firing side on 1D
-      uint16_t peakHeight = 75 + random8(180); //0-255
+      flare->posX = strip.isMatrix ? SEGMENT.random16(2,cols-3) : (SEGMENT.intensity > SEGMENT.random8()); // will enable random firing side on 1D
+      uint16_t peakHeight = 75 + SEGMENT.random8(180); //0-255
       peakHeight = (peakHeight * (rows -1)) >> 8;
       flare->vel = sqrtf(-2.0f * gravity * peakHeight);
-      flare->velX = strip.isMatrix ? (random8(9)-4)/32.f : 0; // no X velocity on 1D
+      flare->velX = strip.isMatrix ? (SEGMENT.random8(9)-4)/32.f : 0; // no X velocity on 1D
       flare->col = 255; //brightness
       SEGENV.aux0 = 1;
     }
@@ -3412,7 +3410,7 @@ uint16_t mode_exploding_fireworks(void)
      * Explosion happens where the flare ended.
      * Size is proportional to the height.
      */
-    int nSparks = flare->pos + random8(4);
+    int nSparks = flare->pos + SEGMENT.random8(4);
     nSparks = constrain(nSparks, 4, numSparks);
 
     // initialize sparks
@@ -3420,12 +3418,12 @@ uint16_t mode_exploding_fireworks(void)
       for (int i = 1; i < nSparks; i++) {
         sparks[i].pos  = flare->pos;
         sparks[i].posX = flare->posX;
-        sparks[i].vel  = (float(random16(20001)) / 10000.0f) - 0.9f; // from -0.9 to 1.1
+        sparks[i].vel  = (float(SEGMENT.random16(20001)) / 10000.0f) - 0.9f; // from -0.9 to 1.1
         sparks[i].vel *= rows<32 ? 0.5f : 1; // reduce velocity for smaller strips
-        sparks[i].velX = strip.isMatrix ? (float(random16(10001)) / 10000.0f) - 0.5f : 0; // from -0.5 to 0.5
+        sparks[i].velX = strip.isMatrix ? (float(SEGMENT.random16(10001)) / 10000.0f) - 0.5f : 0; // from -0.5 to 0.5
         sparks[i].col  = 345;//abs(sparks[i].vel * 750.0); // set colors before scaling velocity to keep them bright
         //sparks[i].col = constrain(sparks[i].col, 0, 345);
-        sparks[i].colIndex = random8();
+        sparks[i].colIndex = SEGMENT.random8();
         sparks[i].vel  *= flare->pos/rows; // proportional to height
         sparks[i].velX *= strip.isMatrix ? flare->posX/cols : 0; // proportional to width
         sparks[i].vel  *= -gravity *50;
@@ -3463,7 +3461,7 @@ uint16_t mode_exploding_fireworks(void)
       SEGMENT.blur(16);
       *dying_gravity *= .8f; // as sparks burn out they fall slower
     } else {
-      SEGENV.aux0 = 6 + random8(10); //wait for this many frames
+      SEGENV.aux0 = 6 + SEGMENT.random8(10); //wait for this many frames
     }
   } else {
     SEGENV.aux0--;
@@ -3518,7 +3516,7 @@ uint16_t mode_drip(void)
 
           drops[j].col += map(SEGMENT.speed, 0, 255, 1, 6); // swelling
 
-          if (random8() < drops[j].col/10) {               // random drop
+          if (SEGMENT.random8() < drops[j].col/10) {               // random drop
             drops[j].colIndex=2;               //fall
             drops[j].col=255;
           }
@@ -3596,7 +3594,7 @@ uint16_t mode_tetrix(void) {
       // initialize dropping on first call or segment full
       if (SEGENV.call == 0) {
         drop->stack = 0;                  // reset brick stack size
-        drop->step = millis() + 2000;     // start by fading out strip
+        drop->step = SEGMENT.frameNow() + 2000;     // start by fading out strip
         if (SEGMENT.check1) drop->col = 0;// use only one color from palette
       }
 
@@ -3604,17 +3602,17 @@ uint16_t mode_tetrix(void) {
         // speed calculation: a single brick should reach bottom of strip in X seconds
         // if the speed is set to 1 this should take 5s and at 255 it should take 0.25s
         // as this is dependant on SEGLEN it should be taken into account and the fact that effect runs every FRAMETIME s
-        int speed = SEGMENT.speed ? SEGMENT.speed : random8(1,255);
+        int speed = SEGMENT.speed ? SEGMENT.speed : SEGMENT.random8(1,255);
         speed = map(speed, 1, 255, 5000, 250); // time taken for full (SEGLEN) drop
         drop->speed = float(SEGLEN * FRAMETIME) / float(speed); // set speed
         drop->pos   = SEGLEN;             // start at end of segment (no need to subtract 1)
-        if (!SEGMENT.check1) drop->col = random8(0,15)<<4;   // limit color choices so there is enough HUE gap
+        if (!SEGMENT.check1) drop->col = SEGMENT.random8(0,15)<<4;   // limit color choices so there is enough HUE gap
         drop->step  = 1;                  // drop state (0 init, 1 forming, 2 falling)
-        drop->brick = (SEGMENT.intensity ? (SEGMENT.intensity>>5)+1 : random8(1,5)) * (1+(SEGLEN>>6));  // size of brick
+        drop->brick = (SEGMENT.intensity ? (SEGMENT.intensity>>5)+1 : SEGMENT.random8(1,5)) * (1+(SEGLEN>>6));  // size of brick
       }
 
       if (drop->step == 1) {              // forming
-        if (random8()>>6) {               // random drop
+        if (SEGMENT.random8()>>6) {               // random drop
           drop->step = 2;                 // fall
         }
       }
@@ -3630,13 +3628,13 @@ uint16_t mode_tetrix(void) {
         } else {                          // we hit bottom
           drop->step = 0;                 // proceed with next brick, go back to init
           drop->stack += drop->brick;     // increase the stack size
-          if (drop->stack >= SEGLEN) drop->step = millis() + 2000; // fade out stack
+          if (drop->stack >= SEGLEN) drop->step = SEGMENT.frameNow() + 2000; // fade out stack
         }
       }
 
       if (drop->step > 2) {               // fade strip
         drop->brick = 0;                  // reset brick size (no more growing)
-        if (drop->step > millis()) {
+        if (drop->step > SEGMENT.frameNow()) {
           // allow fading of virtual strip
           for (int i = 0; i < SEGLEN; i++) SEGMENT.blendPixelColor(indexToVStrip(i, stripNr), SEGCOLOR(1), 25); // 10% blend
         } else {
@@ -3663,7 +3661,7 @@ static const char _data_FX_MODE_TETRIX[] PROGMEM = "Tetrix@!,Width,,,,One color;
 uint16_t mode_plasma(void) {
   // initialize phases on start
   if (SEGENV.call == 0) {
-    SEGENV.aux0 = random8(0,2);  // add a bit of randomness
+    SEGENV.aux0 = SEGMENT.random8(0,2);  // add a bit of randomness
   }
   uint8_t thisPhase = beatsin8(6+SEGENV.aux0,-64,64);
   uint8_t thatPhase = beatsin8(7+SEGENV.aux0,-64,64);
@@ -3744,7 +3742,7 @@ uint16_t mode_heartbeat(void) {
   uint32_t msPerBeat = (60000L / bpm);
   uint32_t secondBeat = (msPerBeat / 3);
   uint32_t bri_lower = SEGENV.aux1;
-  unsigned long beatTimer = strip.now - SEGENV.step;
+  unsigned long beatTimer = SEGMENT.frameNow() - SEGENV.step;
 
   bri_lower = bri_lower * 2042 / (2048 + SEGMENT.intensity);
   SEGENV.aux1 = bri_lower;
@@ -3756,7 +3754,7 @@ uint16_t mode_heartbeat(void) {
   if (beatTimer > msPerBeat) { // time to reset the beat timer?
     SEGENV.aux1 = UINT16_MAX; //full bri
     SEGENV.aux0 = 0;
-    SEGENV.step = strip.now;
+    SEGENV.step = SEGMENT.frameNow();
   }
 
   for (int i = 0; i < SEGLEN; i++) {
@@ -3810,7 +3808,7 @@ CRGB pacifica_one_layer(uint16_t i, CRGBPalette16& p, uint16_t cistart, uint16_t
 
 uint16_t mode_pacifica()
 {
-  uint32_t nowOld = strip.now;
+  uint32_t nowOld = SEGMENT.frameNow();
 
   CRGBPalette16 pacifica_palette_1 =
     { 0x000507, 0x000409, 0x00030B, 0x00030D, 0x000210, 0x000212, 0x000114, 0x000117,
@@ -3832,8 +3830,8 @@ uint16_t mode_pacifica()
   // Each is incremented at a different speed, and the speeds vary over time.
   uint16_t sCIStart1 = SEGENV.aux0, sCIStart2 = SEGENV.aux1, sCIStart3 = SEGENV.step, sCIStart4 = SEGENV.step >> 16;
   uint32_t deltams = (FRAMETIME >> 2) + ((FRAMETIME * SEGMENT.speed) >> 7);
-  uint64_t deltat = (strip.now >> 2) + ((strip.now * SEGMENT.speed) >> 7);
-  strip.now = deltat;
+  uint64_t deltat = (SEGMENT.frameNow() >> 2) + ((SEGMENT.frameNow() * SEGMENT.speed) >> 7);
+  SEGMENT.setFrameNow(deltat); // FastLED beat functions use frame time (get_millisecond_timer())
 
   uint16_t speedfactor1 = beatsin16(3, 179, 269);
   uint16_t speedfactor2 = beatsin16(4, 179, 269);
@@ -3879,7 +3877,7 @@ uint16_t mode_pacifica()
     SEGMENT.setPixelColor(i, c.red, c.green, c.blue);
   }
 
-  strip.now = nowOld;
+  SEGMENT.setFrameNow(nowOld);
   return FRAMETIME;
 }
 static const char _data_FX_MODE_PACIFICA[] PROGMEM = "Pacifica@!,Angle;;!;;pal=51";
@@ -3895,7 +3893,7 @@ uint16_t mode_sunrise() {
   //speed 60 - 120 : sunset time in minutes - 60;
   //speed above: "breathing" rise and set
   if (SEGENV.call == 0 || SEGMENT.speed != SEGENV.aux0) {
-    SEGENV.step = millis(); //save starting time, millis() because now can change from sync
+    SEGENV.step = millis(); //save starting time, millis() because strip time can change from sync (minutes long, not frame exact)
     SEGENV.aux0 = SEGMENT.speed;
   }
 
@@ -3905,7 +3903,7 @@ uint16_t mode_sunrise() {
   uint32_t s10SinceStart = (millis() - SEGENV.step) /100; //tenths of seconds
 
   if (SEGMENT.speed > 120) { //quick sunrise and sunset
-    uint16_t counter = (strip.now >> 1) * (((SEGMENT.speed -120) >> 1) +1);
+    uint16_t counter = (SEGMENT.frameNow() >> 1) * (((SEGMENT.speed -120) >> 1) +1);
     stage = triwave16(counter);
   } else if (SEGMENT.speed) { //sunrise
     uint8_t durMins = SEGMENT.speed;
@@ -3949,7 +3947,7 @@ uint16_t phased_base(uint8_t moder) {                  // We're making sine wave
   uint8_t cutOff = (255-SEGMENT.intensity);                      // You can change the number of pixels.  AKA INTENSITY (was 192).
   uint8_t modVal = 5;//SEGMENT.fft1/8+1;                         // You can change the modulus. AKA FFT1 (was 5).
 
-  uint8_t index = strip.now/64;                                  // Set color rotation speed
+  uint8_t index = SEGMENT.frameNow()/64;                                  // Set color rotation speed
   *phase += SEGMENT.speed/32.0;                                  // You can change the speed of the wave. AKA SPEED (was .4)
 
   for (int i = 0; i < SEGLEN; i++) {
@@ -3981,13 +3979,13 @@ static const char _data_FX_MODE_PHASEDNOISE[] PROGMEM = "Phased Noise@!,!;!,!;!"
 
 
 uint16_t mode_twinkleup(void) {                 // A very short twinkle routine with fade-in and dual controls. By Andrew Tuline.
-  random16_set_seed(535);                       // The randomizer needs to be re-set each time through the loop in order for the same 'random' numbers to be the same each time through.
+  SEGMENT.setRandomSeed(535);                   // The randomizer needs to be re-set each time through the loop in order for the same 'random' numbers to be the same each time through.
 
   for (int i = 0; i < SEGLEN; i++) {
-    uint8_t ranstart = random8();               // The starting value (aka brightness) for each pixel. Must be consistent each time through the loop for this to work.
-    uint8_t pixBri = sin8(ranstart + 16 * strip.now/(256-SEGMENT.speed));
-    if (random8() > SEGMENT.intensity) pixBri = 0;
-    SEGMENT.setPixelColor(i, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(random8()+strip.now/100, false, PALETTE_SOLID_WRAP, 0), pixBri));
+    uint8_t ranstart = SEGMENT.random8();               // The starting value (aka brightness) for each pixel. Must be consistent each time through the loop for this to work.
+    uint8_t pixBri = sin8(ranstart + 16 * SEGMENT.frameNow()/(256-SEGMENT.speed));
+    if (SEGMENT.random8() > SEGMENT.intensity) pixBri = 0;
+    SEGMENT.setPixelColor(i, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(SEGMENT.random8()+SEGMENT.frameNow()/100, false, PALETTE_SOLID_WRAP, 0), pixBri));
   }
 
   return FRAMETIME;
@@ -4006,12 +4004,12 @@ uint16_t mode_noisepal(void) {                                    // Slow noise
   CRGBPalette16* palettes = reinterpret_cast<CRGBPalette16*>(SEGENV.data);
 
   uint16_t changePaletteMs = 4000 + SEGMENT.speed *10; //between 4 - 6.5sec
-  if (millis() - SEGENV.step > changePaletteMs)
+  if (SEGMENT.frameNow() - SEGENV.step > changePaletteMs)
   {
-    SEGENV.step = millis();
+    SEGENV.step = SEGMENT.frameNow();
 
-    uint8_t baseI = random8();
-    palettes[1] = CRGBPalette16(CHSV(baseI+random8(64), 255, random8(128,255)), CHSV(baseI+128, 255, random8(128,255)), CHSV(baseI+random8(92), 192, random8(128,255)), CHSV(baseI+random8(92), 255, random8(128,255)));
+    uint8_t baseI = SEGMENT.random8();
+    palettes[1] = CRGBPalette16(CHSV(baseI+SEGMENT.random8(64), 255, SEGMENT.random8(128,255)), CHSV(baseI+128, 255, SEGMENT.random8(128,255)), CHSV(baseI+SEGMENT.random8(92), 192, SEGMENT.random8(128,255)), CHSV(baseI+SEGMENT.random8(92), 255, SEGMENT.random8(128,255)));
   }
 
   CRGB color;
@@ -4040,7 +4038,7 @@ static const char _data_FX_MODE_NOISEPAL[] PROGMEM = "Noise Pal@!,Scale;;!";
 uint16_t mode_sinewave(void) {             // Adjustable sinewave. By Andrew Tuline
   //#define qsuba(x, b)  ((x>b)?x-b:0)               // Analog Unsigned subtraction macro. if result <0, then => 0
 
-  uint16_t colorIndex = strip.now /32;//(256 - SEGMENT.fft1);  // Amount of colour change.
+  uint16_t colorIndex = SEGMENT.frameNow() /32;//(256 - SEGMENT.fft1);  // Amount of colour change.
 
   SEGENV.step += SEGMENT.speed/16;                   // Speed of animation.
   uint16_t freq = SEGMENT.intensity/4;//SEGMENT.fft2/8;                       // Frequency of the signal.
@@ -4064,7 +4062,7 @@ uint16_t mode_flow(void)
   uint16_t counter = 0;
   if (SEGMENT.speed != 0)
   {
-    counter = strip.now * ((SEGMENT.speed >> 2) +1);
+    counter = SEGMENT.frameNow() * ((SEGMENT.speed >> 2) +1);
     counter = counter >> 8;
   }
 
@@ -4102,7 +4100,7 @@ uint16_t mode_chunchun(void)
 {
   if (SEGLEN == 1) return mode_static();
   SEGMENT.fade_out(254); // add a bit of trail
-  uint16_t counter = strip.now * (6 + (SEGMENT.speed >> 4));
+  uint16_t counter = SEGMENT.frameNow() * (6 + (SEGMENT.speed >> 4));
   uint16_t numBirds = 2 + (SEGLEN >> 3);  // 2 + 1/8 of a segment
   uint16_t span = (SEGMENT.intensity << 8) / numBirds;
 
@@ -4163,7 +4161,7 @@ uint16_t mode_dancing_shadows(void)
 
   SEGMENT.fill(BLACK);
 
-  unsigned long time = millis();
+  unsigned long time = SEGMENT.frameNow();
   bool respawn = false;
 
   for (size_t i = 0; i < numSpotlights; i++) {
@@ -4182,16 +4180,16 @@ uint16_t mode_dancing_shadows(void)
     }
 
     if (initialize || respawn) {
-      spotlights[i].colorIdx = random8();
-      spotlights[i].width = random8(1, 10);
+      spotlights[i].colorIdx = SEGMENT.random8();
+      spotlights[i].width = SEGMENT.random8(1, 10);
 
-      spotlights[i].speed = 1.0/random8(4, 50);
+      spotlights[i].speed = 1.0/SEGMENT.random8(4, 50);
 
       if (initialize) {
-        spotlights[i].position = random16(SEGLEN);
-        spotlights[i].speed *= random8(2) ? 1.0 : -1.0;
+        spotlights[i].position = SEGMENT.random16(SEGLEN);
+        spotlights[i].speed *= SEGMENT.random8(2) ? 1.0 : -1.0;
       } else {
-        if (random8(2)) {
+        if (SEGMENT.random8(2)) {
           spotlights[i].position = SEGLEN + spotlights[i].width;
           spotlights[i].speed *= -1.0;
         }else {
@@ -4200,7 +4198,7 @@ uint16_t mode_dancing_shadows(void)
       }
 
       spotlights[i].lastUpdateTime = time;
-      spotlights[i].type = random8(SPOT_TYPES_COUNT);
+      spotlights[i].type = SEGMENT.random8(SPOT_TYPES_COUNT);
     }
 
     uint32_t color = SEGMENT.color_from_palette(spotlights[i].colorIdx, false, false, 255);
@@ -4273,7 +4271,7 @@ static const char _data_FX_MODE_DANCING_SHADOWS[] PROGMEM = "Dancing Shadows@!,#
   By Stefan Seegel
 */
 uint16_t mode_washing_machine(void) {
-  int speed = tristate_square8(strip.now >> 7, 90, 15);
+  int speed = tristate_square8(SEGMENT.frameNow() >> 7, 90, 15);
 
   SEGENV.step += (speed * 2048) / (512 - SEGMENT.speed);
 
@@ -4297,7 +4295,7 @@ uint16_t mode_blends(void) {
   if (!SEGENV.allocateData(dataSize)) return mode_static(); //allocation failed
   uint32_t* pixels = reinterpret_cast<uint32_t*>(SEGENV.data);
   uint8_t blendSpeed = map(SEGMENT.intensity, 0, UINT8_MAX, 10, 128);
-  uint8_t shift = (strip.now * ((SEGMENT.speed >> 3) +1)) >> 8;
+  uint8_t shift = (SEGMENT.frameNow() * ((SEGMENT.speed >> 3) +1)) >> 8;
 
   for (int i = 0; i < pixelLen; i++) {
     pixels[i] = color_blend(pixels[i], SEGMENT.color_from_palette(shift + quadwave8((i + 1) * 16), false, PALETTE_SOLID_WRAP, 255), blendSpeed);
@@ -4357,12 +4355,12 @@ uint16_t mode_tv_simulator(void) {
   }
 
     // create a new sceene
-    if (((millis() - tvSimulator->sceeneStart) >= tvSimulator->sceeneDuration) || SEGENV.aux1 == 0) {
-      tvSimulator->sceeneStart    = millis();                                               // remember the start of the new sceene
-      tvSimulator->sceeneDuration = random16(60* 250* colorSpeed, 60* 750 * colorSpeed);    // duration of a "movie sceene" which has similar colors (5 to 15 minutes with max speed slider)
-      tvSimulator->sceeneColorHue = random16(   0, 768);                                    // random start color-tone for the sceene
-      tvSimulator->sceeneColorSat = random8 ( 100, 130 + colorIntensity);                   // random start color-saturation for the sceene
-      tvSimulator->sceeneColorBri = random8 ( 200, 240);                                    // random start color-brightness for the sceene
+    if (((SEGMENT.frameNow() - tvSimulator->sceeneStart) >= tvSimulator->sceeneDuration) || SEGENV.aux1 == 0) {
+      tvSimulator->sceeneStart    = SEGMENT.frameNow();                                               // remember the start of the new sceene
+      tvSimulator->sceeneDuration = SEGMENT.random16(60* 250* colorSpeed, 60* 750 * colorSpeed);    // duration of a "movie sceene" which has similar colors (5 to 15 minutes with max speed slider)
+      tvSimulator->sceeneColorHue = SEGMENT.random16(   0, 768);                                    // random start color-tone for the sceene
+      tvSimulator->sceeneColorSat = SEGMENT.random8(100, 130 + colorIntensity);                   // random start color-saturation for the sceene
+      tvSimulator->sceeneColorBri = SEGMENT.random8(200, 240);                                  // random start color-brightness for the sceene
       SEGENV.aux1 = 1;
       SEGENV.aux0 = 0;
     }
@@ -4370,16 +4368,16 @@ uint16_t mode_tv_simulator(void) {
     // slightly change the color-tone in this sceene
     if ( SEGENV.aux0 == 0) {
       // hue change in both directions
-      j = random8(4 * colorIntensity);
-      hue = (random8() < 128) ? ((j < tvSimulator->sceeneColorHue)       ? tvSimulator->sceeneColorHue - j : 767 - tvSimulator->sceeneColorHue - j) :  // negative
+      j = SEGMENT.random8(4 * colorIntensity);
+      hue = (SEGMENT.random8() < 128) ? ((j < tvSimulator->sceeneColorHue)       ? tvSimulator->sceeneColorHue - j : 767 - tvSimulator->sceeneColorHue - j) :  // negative
                                 ((j + tvSimulator->sceeneColorHue) < 767 ? tvSimulator->sceeneColorHue + j : tvSimulator->sceeneColorHue + j - 767) ;  // positive
 
       // saturation
-      j = random8(2 * colorIntensity);
+      j = SEGMENT.random8(2 * colorIntensity);
       sat = (tvSimulator->sceeneColorSat - j) < 0 ? 0 : tvSimulator->sceeneColorSat - j;
 
       // brightness
-      j = random8(100);
+      j = SEGMENT.random8(100);
       bri = (tvSimulator->sceeneColorBri - j) < 0 ? 0 : tvSimulator->sceeneColorBri - j;
 
       // calculate R,G,B from HSV
@@ -4405,15 +4403,15 @@ uint16_t mode_tv_simulator(void) {
     SEGENV.aux0 = 1;
 
     // randomize total duration and fade duration for the actual color
-    tvSimulator->totalTime = random16(250, 2500);                   // Semi-random pixel-to-pixel time
-    tvSimulator->fadeTime  = random16(0, tvSimulator->totalTime);   // Pixel-to-pixel transition time
-    if (random8(10) < 3) tvSimulator->fadeTime = 0;                 // Force scene cut 30% of time
+    tvSimulator->totalTime = SEGMENT.random16(250, 2500);                   // Semi-random pixel-to-pixel time
+    tvSimulator->fadeTime  = SEGMENT.random16(0, tvSimulator->totalTime);   // Pixel-to-pixel transition time
+    if (SEGMENT.random8(10) < 3) tvSimulator->fadeTime = 0;                 // Force scene cut 30% of time
 
-    tvSimulator->startTime = millis();
+    tvSimulator->startTime = SEGMENT.frameNow();
   } // end of initialization
 
   // how much time is elapsed ?
-  tvSimulator->elapsed = millis() - tvSimulator->startTime;
+  tvSimulator->elapsed = SEGMENT.frameNow() - tvSimulator->startTime;
 
   // fade from prev color to next color
   if (tvSimulator->elapsed < tvSimulator->fadeTime) {
@@ -4472,15 +4470,15 @@ class AuroraWave {
 
   public:
     void init(uint32_t segment_length, CRGB color) {
-      ttl = random(500, 1501);
+      ttl = SEGMENT.random16(500, 1501);
       basecolor = color;
-      basealpha = random(60, 101) / (float)100;
+      basealpha = SEGMENT.random8(60, 101) / (float)100;
       age = 0;
-      width = random(segment_length / 20, segment_length / W_WIDTH_FACTOR); //half of width to make math easier
+      width = SEGMENT.random16(segment_length / 20, segment_length / W_WIDTH_FACTOR); //half of width to make math easier
       if (!width) width = 1;
-      center = random(101) / (float)100 * segment_length;
-      goingleft = random(0, 2) == 0;
-      speed_factor = (random(10, 31) / (float)100 * W_MAX_SPEED / 255);
+      center = SEGMENT.random8(101) / (float)100 * segment_length;
+      goingleft = SEGMENT.random8(2) == 0;
+      speed_factor = (SEGMENT.random8(10, 31) / (float)100 * W_MAX_SPEED / 255);
       alive = true;
     }
 
@@ -4565,7 +4563,7 @@ uint16_t mode_aurora(void) {
     waves = reinterpret_cast<AuroraWave*>(SEGENV.data);
 
     for (int i = 0; i < SEGENV.aux1; i++) {
-      waves[i].init(SEGLEN, CRGB(SEGMENT.color_from_palette(random8(), false, false, random(0, 3))));
+      waves[i].init(SEGLEN, CRGB(SEGMENT.color_from_palette(SEGMENT.random8(), false, false, SEGMENT.random8(3))));
     }
   } else {
     waves = reinterpret_cast<AuroraWave*>(SEGENV.data);
@@ -4577,7 +4575,7 @@ uint16_t mode_aurora(void) {
 
     if(!(waves[i].stillAlive())) {
       //If a wave dies, reinitialize it starts over.
-      waves[i].init(SEGLEN, CRGB(SEGMENT.color_from_palette(random8(), false, false, random(0, 3))));
+      waves[i].init(SEGLEN, CRGB(SEGMENT.color_from_palette(SEGMENT.random8(), false, false, SEGMENT.random8(3))));
     }
   }
 
@@ -4617,7 +4615,7 @@ uint16_t mode_perlinmove(void) {
   if (SEGLEN == 1) return mode_static();
   SEGMENT.fade_out(255-SEGMENT.custom1);
   for (int i = 0; i < SEGMENT.intensity/16 + 1; i++) {
-    uint16_t locn = inoise16(millis()*128/(260-SEGMENT.speed)+i*15000, millis()*128/(260-SEGMENT.speed)); // Get a new pixel location from moving noise.
+    uint16_t locn = inoise16(SEGMENT.frameNow()*128/(260-SEGMENT.speed)+i*15000, SEGMENT.frameNow()*128/(260-SEGMENT.speed)); // Get a new pixel location from moving noise.
     uint16_t pixloc = map(locn, 50*256, 192*256, 0, SEGLEN-1);                                            // Map that to the length of the strand, and ensure we don't go over.
     SEGMENT.setPixelColor(pixloc, SEGMENT.color_from_palette(pixloc%255, false, PALETTE_SOLID_WRAP, 0));
   }
@@ -4634,7 +4632,7 @@ static const char _data_FX_MODE_PERLINMOVE[] PROGMEM = "Perlin Move@!,# of pixel
 uint16_t mode_wavesins(void) {
 
   for (int i = 0; i < SEGLEN; i++) {
-    uint8_t bri = sin8(millis()/4 + i * SEGMENT.intensity);
+    uint8_t bri = sin8(SEGMENT.frameNow()/4 + i * SEGMENT.intensity);
     uint8_t index = beatsin8(SEGMENT.speed, SEGMENT.custom1, SEGMENT.custom1+SEGMENT.custom2, 0, i * (SEGMENT.custom3<<3)); // custom3 is reduced resolution slider
     //SEGMENT.setPixelColor(i, ColorFromPalette(SEGPALETTE, index, bri, LINEARBLEND));
     SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0, bri));
@@ -4652,8 +4650,8 @@ static const char _data_FX_MODE_WAVESINS[] PROGMEM = "Wavesins@!,Brightness vari
 uint16_t mode_FlowStripe(void) {
 
   const uint16_t hl = SEGLEN * 10 / 13;
-  uint8_t hue = millis() / (SEGMENT.speed+1);
-  uint32_t t = millis() / (SEGMENT.intensity/8+1);
+  uint8_t hue = SEGMENT.frameNow() / (SEGMENT.speed+1);
+  uint32_t t = SEGMENT.frameNow() / (SEGMENT.intensity/8+1);
 
   for (int i = 0; i < SEGLEN; i++) {
     int c = (abs(i - hl) / hl) * 127;
@@ -4683,7 +4681,7 @@ uint16_t mode_2DBlackHole(void) {            // By: Stepko https://editor.soulma
   uint16_t x, y;
 
   SEGMENT.fadeToBlackBy(16 + (SEGMENT.speed>>3)); // create fading trails
-  unsigned long t = millis()/128;                 // timebase
+  unsigned long t = SEGMENT.frameNow()/128;                 // timebase
   // outer stars
   for (size_t i = 0; i < 8; i++) {
     x = beatsin8(SEGMENT.custom1>>3,   0, cols - 1, 0, ((i % 2) ? 128 : 0) + t * i);
@@ -4769,8 +4767,8 @@ uint16_t mode_2Ddna(void) {         // dna originally by by ldirko at https://pa
 
   SEGMENT.fadeToBlackBy(64);
   for (int i = 0; i < cols; i++) {
-    SEGMENT.setPixelColorXY(i, beatsin8(SEGMENT.speed/8, 0, rows-1, 0, i*4    ), ColorFromPalette(SEGPALETTE, i*5+millis()/17, beatsin8(5, 55, 255, 0, i*10), LINEARBLEND));
-    SEGMENT.setPixelColorXY(i, beatsin8(SEGMENT.speed/8, 0, rows-1, 0, i*4+128), ColorFromPalette(SEGPALETTE, i*5+128+millis()/17, beatsin8(5, 55, 255, 0, i*10+128), LINEARBLEND));
+    SEGMENT.setPixelColorXY(i, beatsin8(SEGMENT.speed/8, 0, rows-1, 0, i*4    ), ColorFromPalette(SEGPALETTE, i*5+SEGMENT.frameNow()/17, beatsin8(5, 55, 255, 0, i*10), LINEARBLEND));
+    SEGMENT.setPixelColorXY(i, beatsin8(SEGMENT.speed/8, 0, rows-1, 0, i*4+128), ColorFromPalette(SEGPALETTE, i*5+128+SEGMENT.frameNow()/17, beatsin8(5, 55, 255, 0, i*10+128), LINEARBLEND));
   }
   SEGMENT.blur(SEGMENT.intensity>>3);
 
@@ -4795,7 +4793,7 @@ uint16_t mode_2DDNASpiral() {               // By: ldirko  https://editor.soulma
   uint8_t speeds = SEGMENT.speed/2 + 1;
   uint8_t freq = SEGMENT.intensity/8;
 
-  uint32_t ms = millis() / 20;
+  uint32_t ms = SEGMENT.frameNow() / 20;
   SEGMENT.fadeToBlackBy(135);
 
   for (int i = 0; i < rows; i++) {
@@ -4835,7 +4833,7 @@ uint16_t mode_2DDrift() {              // By: Stepko   https://editor.soulmateli
 
   SEGMENT.fadeToBlackBy(128);
   const uint16_t maxDim = MAX(cols, rows)/2;
-  unsigned long t = millis() / (32 - (SEGMENT.speed>>3));
+  unsigned long t = SEGMENT.frameNow() / (32 - (SEGMENT.speed>>3));
   unsigned long t_20 = t/20; // softhack007: pre-calculating this gives about 10% speedup
   for (float i = 1; i < maxDim; i += 0.25) {
     float angle = radians(t * (maxDim - i));
@@ -4874,7 +4872,7 @@ uint16_t mode_2Dfirenoise(void) {               // firenoise2d. By Andrew Tuline
 
   for (int j=0; j < cols; j++) {
     for (int i=0; i < rows; i++) {
-      indexx = inoise8(j*yscale*rows/255, i*xscale+strip.now/4);                                               // We're moving along our Perlin map.
+      indexx = inoise8(j*yscale*rows/255, i*xscale+SEGMENT.frameNow()/4);                                               // We're moving along our Perlin map.
       SEGMENT.setPixelColorXY(j, i, ColorFromPalette(pal, min(i*(indexx)>>4, 255U), i*255/cols, LINEARBLEND)); // With that value, look up the 8 bit colour palette value and assign it to the current LED.
     } // for i
   } // for j
@@ -4928,23 +4926,22 @@ uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https:
 
   CRGB backgroundColor = SEGCOLOR(1);
 
-  if (SEGENV.call == 0 || strip.now - SEGMENT.step > 3000) {
-    SEGENV.step = strip.now;
+  if (SEGENV.call == 0 || SEGMENT.frameNow() - SEGMENT.step > 3000) {
+    SEGENV.step = SEGMENT.frameNow();
     SEGENV.aux0 = 0;
-    random16_set_seed(millis()>>2); //seed the random generator
 
     //give the leds random state and colors (based on intensity, colors from palette or all posible colors are chosen)
     for (int x = 0; x < cols; x++) for (int y = 0; y < rows; y++) {
-      uint8_t state = random8()%2;
+      uint8_t state = SEGMENT.random8()%2;
       if (state == 0)
         SEGMENT.setPixelColorXY(x,y, backgroundColor);
       else
-        SEGMENT.setPixelColorXY(x,y, SEGMENT.color_from_palette(random8(), false, PALETTE_SOLID_WRAP, 255));
+        SEGMENT.setPixelColorXY(x,y, SEGMENT.color_from_palette(SEGMENT.random8(), false, PALETTE_SOLID_WRAP, 255));
     }
 
     for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) prevLeds[XY(x,y)] = CRGB::Black;
     memset(crcBuffer, 0, sizeof(uint16_t)*crcBufferLen);
-  } else if (strip.now - SEGENV.step < FRAMETIME_FIXED * (uint32_t)map(SEGMENT.speed,0,255,64,4)) {
+  } else if (SEGMENT.frameNow() - SEGENV.step < FRAMETIME_FIXED * (uint32_t)map(SEGMENT.speed,0,255,64,4)) {
     // update only when appropriate time passes (in 42 FPS slots)
     return FRAMETIME;
   }
@@ -4994,9 +4991,9 @@ uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https:
       for (int i=0; i<9 && colorsCount[i].count != 0; i++)
         if (colorsCount[i].count > dominantColorCount.count) dominantColorCount = colorsCount[i];
       // assign the dominant color w/ a bit of randomness to avoid "gliders"
-      if (dominantColorCount.count > 0 && random8(128)) SEGMENT.setPixelColorXY(x,y, dominantColorCount.color);
-    } else if ((col == bgc) && (neighbors == 2) && !random8(128)) {               // Mutation
-      SEGMENT.setPixelColorXY(x,y, SEGMENT.color_from_palette(random8(), false, PALETTE_SOLID_WRAP, 255));
+      if (dominantColorCount.count > 0 && SEGMENT.random8(128)) SEGMENT.setPixelColorXY(x,y, dominantColorCount.color);
+    } else if ((col == bgc) && (neighbors == 2) && !SEGMENT.random8(128)) {               // Mutation
+      SEGMENT.setPixelColorXY(x,y, SEGMENT.color_from_palette(SEGMENT.random8(), false, PALETTE_SOLID_WRAP, 255));
     }
     // else do nothing!
   } //x,y
@@ -5007,7 +5004,7 @@ uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https:
   bool repetition = false;
   for (int i=0; i<crcBufferLen && !repetition; i++) repetition = (crc == crcBuffer[i]); // (Ewowi)
   // same CRC would mean image did not change or was repeating itself
-  if (!repetition) SEGENV.step = strip.now; //if no repetition avoid reset
+  if (!repetition) SEGENV.step = SEGMENT.frameNow(); //if no repetition avoid reset
   // remember CRCs across frames
   crcBuffer[SEGENV.aux0] = crc;
   ++SEGENV.aux0 %= crcBufferLen;
@@ -5025,7 +5022,7 @@ uint16_t mode_2DHiphotic() {                        //  By: ldirko  https://edit
 
   const uint16_t cols = SEGMENT.virtualWidth();
   const uint16_t rows = SEGMENT.virtualHeight();
-  const uint32_t a = strip.now / ((SEGMENT.custom3>>1)+1);
+  const uint32_t a = SEGMENT.frameNow() / ((SEGMENT.custom3>>1)+1);
 
   for (int x = 0; x < cols; x++) {
     for (int y = 0; y < rows; y++) {
@@ -5105,8 +5102,8 @@ uint16_t mode_2DJulia(void) {                           // An animated Julia set
   reAl = -0.94299f;               // PixelBlaze example
   imAg = 0.3162f;
 
-  reAl += sin_t((float)millis()/305.f)/20.f;
-  imAg += sin_t((float)millis()/405.f)/20.f;
+  reAl += sin_t((float)SEGMENT.frameNow()/305.f)/20.f;
+  imAg += sin_t((float)SEGMENT.frameNow()/405.f)/20.f;
 
   dx = (xmax - xmin) / (cols);     // Scale the delta x and y values to our matrix size.
   dy = (ymax - ymin) / (rows);
@@ -5165,7 +5162,7 @@ uint16_t mode_2DLissajous(void) {            // By: Andrew Tuline
   const uint16_t rows = SEGMENT.virtualHeight();
 
   SEGMENT.fadeToBlackBy(SEGMENT.intensity);
-  uint_fast16_t phase = (millis() * (1 + SEGENV.custom3)) /32;  // allow user to control rotation speed
+  uint_fast16_t phase = (SEGMENT.frameNow() * (1 + SEGENV.custom3)) /32;  // allow user to control rotation speed
 
   //for (int i=0; i < 4*(cols+rows); i ++) {
   for (int i=0; i < 256; i ++) {
@@ -5175,7 +5172,7 @@ uint16_t mode_2DLissajous(void) {            // By: Andrew Tuline
     uint_fast8_t ylocn = cos8(phase/2 + i*2);
     xlocn = (cols < 2) ? 1 : (map(2*xlocn, 0,511, 0,2*(cols-1)) +1) /2;    // softhack007: "(2* ..... +1) /2" for proper rounding
     ylocn = (rows < 2) ? 1 : (map(2*ylocn, 0,511, 0,2*(rows-1)) +1) /2;    // "rows > 1" is needed to avoid div/0 in map()
-    SEGMENT.setPixelColorXY((uint8_t)xlocn, (uint8_t)ylocn, SEGMENT.color_from_palette(millis()/100+i, false, PALETTE_SOLID_WRAP, 0));
+    SEGMENT.setPixelColorXY((uint8_t)xlocn, (uint8_t)ylocn, SEGMENT.color_from_palette(SEGMENT.frameNow()/100+i, false, PALETTE_SOLID_WRAP, 0));
   }
 
   return FRAMETIME;
@@ -5211,8 +5208,8 @@ uint16_t mode_2Dmatrix(void) {                  // Matrix2D. By Jeremy Williams.
     trailColor = CRGB(27,130,39);
   }
 
-  if (strip.now - SEGENV.step >= speed) {
-    SEGENV.step = strip.now;
+  if (SEGMENT.frameNow() - SEGENV.step >= speed) {
+    SEGENV.step = SEGMENT.frameNow();
     // find out what color value is returned by gPC for a "falling code" example pixel
     // the color values returned may differ from the previously set values, due to
     // - auto brightness limiter (dimming)
@@ -5244,8 +5241,8 @@ uint16_t mode_2Dmatrix(void) {                  // Matrix2D. By Jeremy Williams.
     bool emptyScreen = (SEGENV.aux1 >= rows); // empty screen means that the last falling code has moved out of screen area
 
     // spawn new falling code
-    if (random8() <= SEGMENT.intensity || emptyScreen) {
-      uint8_t spawnX = random8(cols);
+    if (SEGMENT.random8() <= SEGMENT.intensity || emptyScreen) {
+      uint8_t spawnX = SEGMENT.random8(cols);
       SEGMENT.setPixelColorXY(spawnX, 0, spawnColor);
       // update hint for next run
       SEGENV.aux0 = spawnX;
@@ -5270,11 +5267,11 @@ uint16_t mode_2Dmetaballs(void) {   // Metaballs by Stefan Petrick. Cannot have
   float speed = 0.25f * (1+(SEGMENT.speed>>6));
 
   // get some 2 random moving points
-  uint8_t x2 = map(inoise8(strip.now * speed, 25355, 685), 0, 255, 0, cols-1);
-  uint8_t y2 = map(inoise8(strip.now * speed, 355, 11685), 0, 255, 0, rows-1);
+  uint8_t x2 = map(inoise8(SEGMENT.frameNow() * speed, 25355, 685), 0, 255, 0, cols-1);
+  uint8_t y2 = map(inoise8(SEGMENT.frameNow() * speed, 355, 11685), 0, 255, 0, rows-1);
 
-  uint8_t x3 = map(inoise8(strip.now * speed, 55355, 6685), 0, 255, 0, cols-1);
-  uint8_t y3 = map(inoise8(strip.now * speed, 25355, 22685), 0, 255, 0, rows-1);
+  uint8_t x3 = map(inoise8(SEGMENT.frameNow() * speed, 55355, 6685), 0, 255, 0, cols-1);
+  uint8_t y3 = map(inoise8(SEGMENT.frameNow() * speed, 25355, 22685), 0, 255, 0, rows-1);
 
   // and one Lissajou function
   uint8_t x1 = beatsin8(23 * speed, 0, cols-1);
@@ -5330,7 +5327,7 @@ uint16_t mode_2Dnoise(void) {                  // By Andrew Tuline
 
   for (int y = 0; y < rows; y++) {
     for (int x = 0; x < cols; x++) {
-      uint8_t pixelHue8 = inoise8(x * scale, y * scale, millis() / (16 - SEGMENT.speed/16));
+      uint8_t pixelHue8 = inoise8(x * scale, y * scale, SEGMENT.frameNow() / (16 - SEGMENT.speed/16));
       SEGMENT.setPixelColorXY(x, y, ColorFromPalette(SEGPALETTE, pixelHue8));
     }
   }
@@ -5350,7 +5347,7 @@ uint16_t mode_2DPlasmaball(void) {                   // By: Stepko https://edito
   const uint16_t rows = SEGMENT.virtualHeight();
 
   SEGMENT.fadeToBlackBy(SEGMENT.custom1>>2);
-  uint_fast32_t t = (millis() * 8) / (256 - SEGMENT.speed);  // optimized to avoid float
+  uint_fast32_t t = (SEGMENT.frameNow() * 8) / (256 - SEGMENT.speed);  // optimized to avoid float
   for (int i = 0; i < cols; i++) {
     uint16_t thisVal = inoise8(i * 30, t, t);
     uint16_t thisMax = map(thisVal, 0, 255, 0, cols-1);
@@ -5441,7 +5438,7 @@ uint16_t mode_2DPulser(void) {                       // By: ldirko   https://edi
   const uint16_t rows = SEGMENT.virtualHeight();
 
   SEGMENT.fadeToBlackBy(8 - (SEGMENT.intensity>>5));
-  uint32_t a = strip.now / (18 - SEGMENT.speed / 16);
+  uint32_t a = SEGMENT.frameNow() / (18 - SEGMENT.speed / 16);
   uint16_t x = (a / 14) % cols;
   uint16_t y = map((sin8(a * 5) + sin8(a * 4) + sin8(a * 2)), 0, 765, rows-1, 0);
   SEGMENT.setPixelColorXY(x, y, ColorFromPalette(SEGPALETTE, map(y, 0, rows-1, 0, 255), 255, LINEARBLEND));
@@ -5468,7 +5465,7 @@ uint16_t mode_2DSindots(void) {                             // By: ldirko   http
 
   SEGMENT.fadeToBlackBy(SEGMENT.custom1>>3);
 
-  byte t1 = millis() / (257 - SEGMENT.speed); // 20;
+  byte t1 = SEGMENT.frameNow() / (257 - SEGMENT.speed); // 20;
   byte t2 = sin8(t1) / 4 * 2;
   for (int i = 0; i < 13; i++) {
     byte x = sin8(t1 + i * SEGMENT.intensity/8)*(cols-1)/255;  // max index now 255x15/255=15!
@@ -5507,7 +5504,7 @@ uint16_t mode_2Dsquaredswirl(void) {            // By: Mark Kriegsman. https://g
   uint8_t n = beatsin8(15, kBorderWidth, rows-kBorderWidth);
   uint8_t p = beatsin8(20, kBorderWidth, rows-kBorderWidth);
 
-  uint16_t ms = millis();
+  uint16_t ms = SEGMENT.frameNow();
 
   SEGMENT.addPixelColorXY(i, m, ColorFromPalette(SEGPALETTE, ms/29, 255, LINEARBLEND));
   SEGMENT.addPixelColorXY(j, n, ColorFromPalette(SEGPALETTE, ms/41, 255, LINEARBLEND));
@@ -5534,7 +5531,7 @@ uint16_t mode_2DSunradiation(void) {                   // By: ldirko https://edi
     SEGMENT.fill(BLACK);
   }
 
-  unsigned long t = millis() / 4;
+  unsigned long t = SEGMENT.frameNow() / 4;
   int index = 0;
   uint8_t someVal = SEGMENT.speed/4;             // Was 25.
   for (int j = 0; j < (rows + 2); j++) {
@@ -5616,14 +5613,14 @@ uint16_t mode_2Dspaceships(void) {    //// Space ships by stepko (c)05.02.21 [ht
   const uint16_t cols = SEGMENT.virtualWidth();
   const uint16_t rows = SEGMENT.virtualHeight();
 
-  uint32_t tb = strip.now >> 12;  // every ~4s
+  uint32_t tb = SEGMENT.frameNow() >> 12;  // every ~4s
   if (tb > SEGENV.step) {
     int8_t dir = ++SEGENV.aux0;
-    dir  += (int)random8(3)-1;
+    dir  += (int)SEGMENT.random8(3)-1;
     if      (dir > 7) SEGENV.aux0 = 0;
     else if (dir < 0) SEGENV.aux0 = 7;
     else              SEGENV.aux0 = dir;
-    SEGENV.step = tb + random8(4);
+    SEGENV.step = tb + SEGMENT.random8(4);
   }
 
   SEGMENT.fadeToBlackBy(map(SEGMENT.speed, 0, 255, 248, 16));
@@ -5665,10 +5662,9 @@ uint16_t mode_2Dcrazybees(void) {
     uint8_t posX, posY, aimX, aimY, hue;
     int8_t deltaX, deltaY, signX, signY, error;
     void aimed(uint16_t w, uint16_t h) {
-      random16_set_seed(millis());
-      aimX = random8(0, w);
-      aimY = random8(0, h);
-      hue = random8();
+      aimX = SEGMENT.random8(0, w);
+      aimY = SEGMENT.random8(0, h);
+      hue = SEGMENT.random8();
       deltaX = abs(aimX - posX);
       deltaY = abs(aimY - posY);
       signX = posX < aimX ? 1 : -1;
@@ -5682,14 +5678,14 @@ uint16_t mode_2Dcrazybees(void) {
 
   if (SEGENV.call == 0) {
     for (size_t i = 0; i < n; i++) {
-      bee[i].posX = random8(0, cols);
-      bee[i].posY = random8(0, rows);
+      bee[i].posX = SEGMENT.random8(0, cols);
+      bee[i].posY = SEGMENT.random8(0, rows);
       bee[i].aimed(cols, rows);
     }
   }
 
-  if (millis() > SEGENV.step) {
-    SEGENV.step = millis() + (FRAMETIME * 16 / ((SEGMENT.speed>>4)+1));
+  if (SEGMENT.frameNow() > SEGENV.step) {
+    SEGENV.step = SEGMENT.frameNow() + (FRAMETIME * 16 / ((SEGMENT.speed>>4)+1));
 
     SEGMENT.fadeToBlackBy(32);
 
@@ -5752,9 +5748,8 @@ uint16_t mode_2Dghostrider(void) {
   if (SEGENV.aux0 != cols || SEGENV.aux1 != rows) {
     SEGENV.aux0 = cols;
     SEGENV.aux1 = rows;
-    random16_set_seed(strip.now);
-    lighter->angleSpeed = random8(0,20) - 10;
-    lighter->gAngle = random16();
+    lighter->angleSpeed = SEGMENT.random8(0,20) - 10;
+    lighter->gAngle = SEGMENT.random16();
     lighter->Vspeed = 5;
     lighter->gPosX = (cols/2) * 10;
     lighter->gPosY = (rows/2) * 10;
@@ -5766,8 +5761,8 @@ uint16_t mode_2Dghostrider(void) {
     }
   }
 
-  if (millis() > SEGENV.step) {
-    SEGENV.step = millis() + 1024 / (cols+rows);
+  if (SEGMENT.frameNow() > SEGENV.step) {
+    SEGENV.step = SEGMENT.frameNow() + 1024 / (cols+rows);
 
     SEGMENT.fadeToBlackBy((SEGMENT.speed>>2)+64);
 
@@ -5782,7 +5777,7 @@ uint16_t mode_2Dghostrider(void) {
     if (lighter->gPosY < 0)               lighter->gPosY = (rows - 1) * 10;
     if (lighter->gPosY > (rows - 1) * 10) lighter->gPosY = 0;
     for (size_t i = 0; i < maxLighters; i++) {
-      lighter->time[i] += random8(5, 20);
+      lighter->time[i] += SEGMENT.random8(5, 20);
       if (lighter->time[i] >= 255 ||
         (lighter->lightersPosX[i] <= 0) ||
           (lighter->lightersPosX[i] >= (cols - 1) * 10) ||
@@ -5793,7 +5788,7 @@ uint16_t mode_2Dghostrider(void) {
       if (lighter->reg[i]) {
         lighter->lightersPosY[i] = lighter->gPosY;
         lighter->lightersPosX[i] = lighter->gPosX;
-        lighter->Angle[i] = lighter->gAngle + random(-10, 10);
+        lighter->Angle[i] = lighter->gAngle + (SEGMENT.random8(20) - 10);
         lighter->time[i] = 0;
         lighter->reg[i] = false;
       } else {
@@ -5839,12 +5834,12 @@ uint16_t mode_2Dfloatingblobs(void) {
     SEGENV.aux1 = rows;
     //SEGMENT.fill(BLACK);
     for (size_t i = 0; i < MAX_BLOBS; i++) {
-      blob->r[i]  = random8(1, cols>8 ? (cols/4) : 2);
-      blob->sX[i] = (float) random8(3, cols) / (float)(256 - SEGMENT.speed); // speed x
-      blob->sY[i] = (float) random8(3, rows) / (float)(256 - SEGMENT.speed); // speed y
-      blob->x[i]  = random8(0, cols-1);
-      blob->y[i]  = random8(0, rows-1);
-      blob->color[i] = random8();
+      blob->r[i]  = SEGMENT.random8(1, cols>8 ? (cols/4) : 2);
+      blob->sX[i] = (float) SEGMENT.random8(3, cols) / (float)(256 - SEGMENT.speed); // speed x
+      blob->sY[i] = (float) SEGMENT.random8(3, rows) / (float)(256 - SEGMENT.speed); // speed y
+      blob->x[i]  = SEGMENT.random8(0, cols-1);
+      blob->y[i]  = SEGMENT.random8(0, rows-1);
+      blob->color[i] = SEGMENT.random8();
       blob->grow[i]  = (blob->r[i] < 1.f);
       if (blob->sX[i] == 0) blob->sX[i] = 1;
       if (blob->sY[i] == 0) blob->sY[i] = 1;
@@ -5855,7 +5850,7 @@ uint16_t mode_2Dfloatingblobs(void) {
 
   // Bounce balls around
   for (size_t i = 0; i < Amount; i++) {
-    if (SEGENV.step < millis()) blob->color[i] = add8(blob->color[i], 4); // slowly change color
+    if (SEGENV.step < SEGMENT.frameNow()) blob->color[i] = add8(blob->color[i], 4); // slowly change color
     // change radius if needed
     if (blob->grow[i]) {
       // enlarge radius until it is >= 4
@@ -5883,26 +5878,26 @@ uint16_t mode_2Dfloatingblobs(void) {
     else                                     blob->y[i] += blob->sY[i];
     // bounce x
     if (blob->x[i] < 0.01f) {
-      blob->sX[i] = (float)random8(3, cols) / (256 - SEGMENT.speed);
+      blob->sX[i] = (float)SEGMENT.random8(3, cols) / (256 - SEGMENT.speed);
       blob->x[i]  = 0.01f;
     } else if (blob->x[i] > (float)cols - 1.01f) {
-      blob->sX[i] = (float)random8(3, cols) / (256 - SEGMENT.speed);
+      blob->sX[i] = (float)SEGMENT.random8(3, cols) / (256 - SEGMENT.speed);
       blob->sX[i] = -blob->sX[i];
       blob->x[i]  = (float)cols - 1.01f;
     }
     // bounce y
     if (blob->y[i] < 0.01f) {
-      blob->sY[i] = (float)random8(3, rows) / (256 - SEGMENT.speed);
+      blob->sY[i] = (float)SEGMENT.random8(3, rows) / (256 - SEGMENT.speed);
       blob->y[i]  = 0.01f;
     } else if (blob->y[i] > (float)rows - 1.01f) {
-      blob->sY[i] = (float)random8(3, rows) / (256 - SEGMENT.speed);
+      blob->sY[i] = (float)SEGMENT.random8(3, rows) / (256 - SEGMENT.speed);
       blob->sY[i] = -blob->sY[i];
       blob->y[i]  = (float)rows - 1.01f;
     }
   }
   SEGMENT.blur(SEGMENT.custom1>>2);
 
-  if (SEGENV.step < millis()) SEGENV.step = millis() + 2000; // change colors every 2 seconds
+  if (SEGENV.step < SEGMENT.frameNow()) SEGENV.step = SEGMENT.frameNow() + 2000; // change colors every 2 seconds
 
   return FRAMETIME;
 }
@@ -5966,7 +5961,7 @@ uint16_t mode_2Dscrollingtext(void) {
   }
 
   const int  numberOfLetters = strlen(text);
-  const unsigned long now = millis(); // reduce millis() calls
+  const unsigned long now = SEGMENT.frameNow(); // reduce SEGMENT.frameNow() calls
   int width = (numberOfLetters * rotLW);
   int yoffset = map(SEGMENT.intensity, 0, 255, -rows/2, rows/2) + (rows-rotLH)/2;
   if (width <= cols) {
@@ -6131,13 +6126,13 @@ uint16_t mode_ripplepeak(void) {                // * Ripple peak. By Andrew Tuli
         break;
 
       case 255:                                           // Initialize ripple variables.
-        ripples[i].pos = random16(SEGLEN);
+        ripples[i].pos = SEGMENT.random16(SEGLEN);
         #ifdef ESP32
           if (FFT_MajorPeak > 1)                          // log10(0) is "forbidden" (throws exception)
           ripples[i].color = (int)(log10f(FFT_MajorPeak)*128);
           else ripples[i].color = 0;
         #else
-          ripples[i].color = random8();
+          ripples[i].color = SEGMENT.random8();
         #endif
         ripples[i].state = 0;
         break;
@@ -6187,7 +6182,7 @@ uint16_t mode_2DSwirl(void) {
   uint8_t  j = beatsin8( 41*SEGMENT.speed/255, borderWidth, rows - borderWidth);
   uint8_t ni = (cols - 1) - i;
   uint8_t nj = (cols - 1) - j;
-  uint16_t ms = millis();
+  uint16_t ms = SEGMENT.frameNow();
 
   um_data_t *um_data;
   if (!usermods.getUMData(&um_data, USERMOD_ID_AUDIOREACTIVE)) {
@@ -6228,7 +6223,7 @@ uint16_t mode_2DWaverly(void) {
 
   SEGMENT.fadeToBlackBy(SEGMENT.speed);
 
-  long t = millis() / 2;
+  long t = SEGMENT.frameNow() / 2;
   for (int i = 0; i < cols; i++) {
     uint16_t thisVal = (1 + SEGMENT.intensity/64) * inoise8(i * 45 , t , t)/2;
     // use audio if available
@@ -6290,7 +6285,7 @@ uint16_t mode_gravcenter(void) {                // Gravcenter. By Andrew Tuline.
   uint8_t gravity = 8 - SEGMENT.speed/32;
 
   for (int i=0; i<tempsamp; i++) {
-    uint8_t index = inoise8(i*segmentSampleAvg+millis(), 5000+i*segmentSampleAvg);
+    uint8_t index = inoise8(i*segmentSampleAvg+SEGMENT.frameNow(), 5000+i*segmentSampleAvg);
     SEGMENT.setPixelColor(i+SEGLEN/2, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0), segmentSampleAvg*8));
     SEGMENT.setPixelColor(SEGLEN/2-i-1, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0), segmentSampleAvg*8));
   }
@@ -6301,8 +6296,8 @@ uint16_t mode_gravcenter(void) {                // Gravcenter. By Andrew Tuline.
     gravcen->topLED--;
 
   if (gravcen->topLED >= 0) {
-    SEGMENT.setPixelColor(gravcen->topLED+SEGLEN/2, SEGMENT.color_from_palette(millis(), false, PALETTE_SOLID_WRAP, 0));
-    SEGMENT.setPixelColor(SEGLEN/2-1-gravcen->topLED, SEGMENT.color_from_palette(millis(), false, PALETTE_SOLID_WRAP, 0));
+    SEGMENT.setPixelColor(gravcen->topLED+SEGLEN/2, SEGMENT.color_from_palette(SEGMENT.frameNow(), false, PALETTE_SOLID_WRAP, 0));
+    SEGMENT.setPixelColor(SEGLEN/2-1-gravcen->topLED, SEGMENT.color_from_palette(SEGMENT.frameNow(), false, PALETTE_SOLID_WRAP, 0));
   }
   gravcen->gravityCounter = (gravcen->gravityCounter + 1) % gravity;
 
@@ -6342,7 +6337,7 @@ uint16_t mode_gravcentric(void) {                     // Gravcentric. By Andrew
   uint8_t gravity = 8 - SEGMENT.speed/32;
 
   for (int i=0; i<tempsamp; i++) {
-    uint8_t index = segmentSampleAvg*24+millis()/200;
+    uint8_t index = segmentSampleAvg*24+SEGMENT.frameNow()/200;
     SEGMENT.setPixelColor(i+SEGLEN/2, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0));
     SEGMENT.setPixelColor(SEGLEN/2-1-i, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0));
   }
@@ -6391,7 +6386,7 @@ uint16_t mode_gravimeter(void) {                // Gravmeter. By Andrew Tuline.
   uint8_t gravity = 8 - SEGMENT.speed/32;
 
   for (int i=0; i<tempsamp; i++) {
-    uint8_t index = inoise8(i*segmentSampleAvg+millis(), 5000+i*segmentSampleAvg);
+    uint8_t index = inoise8(i*segmentSampleAvg+SEGMENT.frameNow(), 5000+i*segmentSampleAvg);
     SEGMENT.setPixelColor(i, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0), segmentSampleAvg*8));
   }
 
@@ -6401,7 +6396,7 @@ uint16_t mode_gravimeter(void) {                // Gravmeter. By Andrew Tuline.
     gravcen->topLED--;
 
   if (gravcen->topLED > 0) {
-    SEGMENT.setPixelColor(gravcen->topLED, SEGMENT.color_from_palette(millis(), false, PALETTE_SOLID_WRAP, 0));
+    SEGMENT.setPixelColor(gravcen->topLED, SEGMENT.color_from_palette(SEGMENT.frameNow(), false, PALETTE_SOLID_WRAP, 0));
   }
   gravcen->gravityCounter = (gravcen->gravityCounter + 1) % gravity;
 
@@ -6426,7 +6421,7 @@ uint16_t mode_juggles(void) {                   // Juggles. By Andrew Tuline.
   uint16_t my_sampleAgc = fmax(fmin(volumeSmth, 255.0), 0);
 
   for (size_t i=0; i<SEGMENT.intensity/32+1U; i++) {
-    SEGMENT.setPixelColor(beatsin16(SEGMENT.speed/4+i*2,0,SEGLEN-1), color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(millis()/4+i*2, false, PALETTE_SOLID_WRAP, 0), my_sampleAgc));
+    SEGMENT.setPixelColor(beatsin16(SEGMENT.speed/4+i*2,0,SEGLEN-1), color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(SEGMENT.frameNow()/4+i*2, false, PALETTE_SOLID_WRAP, 0), my_sampleAgc));
   }
 
   return FRAMETIME;
@@ -6452,13 +6447,13 @@ uint16_t mode_matripix(void) {                  // Matripix. By Andrew Tuline.
     SEGMENT.fill(BLACK);
   }
 
-  uint8_t secondHand = micros()/(256-SEGMENT.speed)/500 % 16;
+  uint8_t secondHand = SEGMENT.frameNow()*2/(256-SEGMENT.speed) % 16;
   if(SEGENV.aux0 != secondHand) {
     SEGENV.aux0 = secondHand;
 
     int pixBri = volumeRaw * SEGMENT.intensity / 64;
     for (int i = 0; i < SEGLEN-1; i++) SEGMENT.setPixelColor(i, SEGMENT.getPixelColor(i+1)); // shift left
-    SEGMENT.setPixelColor(SEGLEN-1, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(millis(), false, PALETTE_SOLID_WRAP, 0), pixBri));
+    SEGMENT.setPixelColor(SEGLEN-1, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(SEGMENT.frameNow(), false, PALETTE_SOLID_WRAP, 0), pixBri));
   }
 
   return FRAMETIME;
@@ -6522,7 +6517,7 @@ uint16_t mode_noisefire(void) {                 // Noisefire. By Andrew Tuline.
   if (SEGENV.call == 0) SEGMENT.fill(BLACK);
 
   for (int i = 0; i < SEGLEN; i++) {
-    uint16_t index = inoise8(i*SEGMENT.speed/64,millis()*SEGMENT.speed/64*SEGLEN/255);  // X location is constant, but we move along the Y at the rate of millis(). By Andrew Tuline.
+    uint16_t index = inoise8(i*SEGMENT.speed/64,SEGMENT.frameNow()*SEGMENT.speed/64*SEGLEN/255);  // X location is constant, but we move along the Y at the rate of SEGMENT.frameNow(). By Andrew Tuline.
     index = (255 - i*256/SEGLEN) * index/(256-SEGMENT.intensity);                       // Now we need to scale index so that it gets blacker as we get close to one of the ends.
                                                                                         // This is a simple y=mx+b equation that's been scaled. index/128 is another scaling.
 
@@ -6588,13 +6583,13 @@ uint16_t mode_pixelwave(void) {                 // Pixelwave. By Andrew Tuline.
   }
   int16_t volumeRaw    = *(int16_t*)um_data->u_data[1];
 
-  uint8_t secondHand = micros()/(256-SEGMENT.speed)/500+1 % 16;
+  uint8_t secondHand = SEGMENT.frameNow()*2/(256-SEGMENT.speed)+1 % 16;
   if (SEGENV.aux0 != secondHand) {
     SEGENV.aux0 = secondHand;
 
     int pixBri = volumeRaw * SEGMENT.intensity / 64;
 
-    SEGMENT.setPixelColor(SEGLEN/2, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(millis(), false, PALETTE_SOLID_WRAP, 0), pixBri));
+    SEGMENT.setPixelColor(SEGLEN/2, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(SEGMENT.frameNow(), false, PALETTE_SOLID_WRAP, 0), pixBri));
     for (int i = SEGLEN - 1; i > SEGLEN/2; i--)   SEGMENT.setPixelColor(i, SEGMENT.getPixelColor(i-1)); //move to the left
     for (int i = 0; i < SEGLEN/2; i++)            SEGMENT.setPixelColor(i, SEGMENT.getPixelColor(i+1)); // move to the right
   }
@@ -6654,7 +6649,7 @@ uint16_t mode_puddlepeak(void) {                // Puddlepeak. By Andrew Tuline.
 
   uint16_t size = 0;
   uint8_t fadeVal = map(SEGMENT.speed,0,255, 224, 254);
-  uint16_t pos = random(SEGLEN);                          // Set a random starting position.
+  uint16_t pos = SEGMENT.random16(SEGLEN);                          // Set a random starting position.
 
   um_data_t *um_data;
   if (!usermods.getUMData(&um_data, USERMOD_ID_AUDIOREACTIVE)) {
@@ -6682,7 +6677,7 @@ uint16_t mode_puddlepeak(void) {                // Puddlepeak. By Andrew Tuline.
   }
 
   for (int i=0; i<size; i++) {                            // Flash the LED's.
-    SEGMENT.setPixelColor(pos+i, SEGMENT.color_from_palette(millis(), false, PALETTE_SOLID_WRAP, 0));
+    SEGMENT.setPixelColor(pos+i, SEGMENT.color_from_palette(SEGMENT.frameNow(), false, PALETTE_SOLID_WRAP, 0));
   }
 
   return FRAMETIME;
@@ -6697,7 +6692,7 @@ uint16_t mode_puddles(void) {                   // Puddles. By Andrew Tuline.
   if (SEGLEN == 1) return mode_static();
   uint16_t size = 0;
   uint8_t fadeVal = map(SEGMENT.speed, 0, 255, 224, 254);
-  uint16_t pos = random16(SEGLEN);                        // Set a random starting position.
+  uint16_t pos = SEGMENT.random16(SEGLEN);                        // Set a random starting position.
 
   SEGMENT.fade_out(fadeVal);
 
@@ -6714,7 +6709,7 @@ uint16_t mode_puddles(void) {                   // Puddles. By Andrew Tuline.
   }
 
   for (int i=0; i<size; i++) {                          // Flash the LED's.
-    SEGMENT.setPixelColor(pos+i, SEGMENT.color_from_palette(millis(), false, PALETTE_SOLID_WRAP, 0));
+    SEGMENT.setPixelColor(pos+i, SEGMENT.color_from_palette(SEGMENT.frameNow(), false, PALETTE_SOLID_WRAP, 0));
   }
 
   return FRAMETIME;
@@ -6737,12 +6732,12 @@ uint16_t mode_pixels(void) {                    // Pixels. By Andrew Tuline.
   }
   float   volumeSmth   = *(float*)  um_data->u_data[0];
 
-  myVals[millis()%32] = volumeSmth;    // filling values semi randomly
+  myVals[SEGMENT.frameNow()%32] = volumeSmth;    // filling values semi randomly
 
   SEGMENT.fade_out(64+(SEGMENT.speed>>1));
 
   for (int i=0; i <SEGMENT.intensity/8; i++) {
-    uint16_t segLoc = random16(SEGLEN);                    // 16 bit for larger strands of LED's.
+    uint16_t segLoc = SEGMENT.random16(SEGLEN);                    // 16 bit for larger strands of LED's.
     SEGMENT.setPixelColor(segLoc, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(myVals[i%32]+i*4, false, PALETTE_SOLID_WRAP, 0), volumeSmth));
   }
 
@@ -6780,7 +6775,7 @@ uint16_t mode_blurz(void) {                    // Blurz. By Andrew Tuline.
 
   SEGENV.step += FRAMETIME;
   if (SEGENV.step > SPEED_FORMULA_L) {
-    uint16_t segLoc = random16(SEGLEN);
+    uint16_t segLoc = SEGMENT.random16(SEGLEN);
     SEGMENT.setPixelColor(segLoc, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(2*fftResult[SEGENV.aux0%16]*240/max(1, SEGLEN-1), false, PALETTE_SOLID_WRAP, 0), 2*fftResult[SEGENV.aux0%16]));
     ++(SEGENV.aux0) %= 16; // make sure it doesn't cross 16
 
@@ -6811,7 +6806,7 @@ uint16_t mode_DJLight(void) {                   // Written by ??? Adapted by Wil
     SEGMENT.fill(BLACK);
   }
 
-  uint8_t secondHand = micros()/(256-SEGMENT.speed)/500+1 % 64;
+  uint8_t secondHand = SEGMENT.frameNow()*2/(256-SEGMENT.speed)+1 % 64;
   if (SEGENV.aux0 != secondHand) {                        // Triggered millis timing.
     SEGENV.aux0 = secondHand;
 
@@ -6881,7 +6876,7 @@ uint16_t mode_freqmatrix(void) {                // Freqmatrix. By Andreas Plesch
     SEGMENT.fill(BLACK);
   }
 
-  uint8_t secondHand = micros()/(256-SEGMENT.speed)/500 % 16;
+  uint8_t secondHand = SEGMENT.frameNow()*2/(256-SEGMENT.speed) % 16;
   if(SEGENV.aux0 != secondHand) {
     SEGENV.aux0 = secondHand;
 
@@ -6948,7 +6943,7 @@ uint16_t mode_freqpixels(void) {                // Freqpixel. By Andrew Tuline.
   uint8_t pixCol = (log10f(FFT_MajorPeak) - 1.78f) * 255.0f/(MAX_FREQ_LOG10 - 1.78f);  // Scale log10 of frequency values to the 255 colour index.
   if (FFT_MajorPeak < 61.0f) pixCol = 0;                                               // handle underflow
   for (int i=0; i < SEGMENT.intensity/32+1; i++) {
-    uint16_t locn = random16(0,SEGLEN);
+    uint16_t locn = SEGMENT.random16(0,SEGLEN);
     SEGMENT.setPixelColor(locn, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(SEGMENT.intensity+pixCol, false, PALETTE_SOLID_WRAP, 0), (int)my_magnitude));
   }
 
@@ -6986,7 +6981,7 @@ uint16_t mode_freqwave(void) {                  // Freqwave. By Andreas Pleschun
     SEGMENT.fill(BLACK);
   }
 
-  uint8_t secondHand = micros()/(256-SEGMENT.speed)/500 % 16;
+  uint8_t secondHand = SEGMENT.frameNow()*2/(256-SEGMENT.speed) % 16;
   if(SEGENV.aux0 != secondHand) {
     SEGENV.aux0 = secondHand;
 
@@ -7095,7 +7090,7 @@ uint16_t mode_noisemove(void) {                 // Noisemove.    By: Andrew Tuli
 
   uint8_t numBins = map(SEGMENT.intensity,0,255,0,16);    // Map slider to fftResult bins.
   for (int i=0; i<numBins; i++) {                         // How many active bins are we using.
-    uint16_t locn = inoise16(millis()*SEGMENT.speed+i*50000, millis()*SEGMENT.speed);   // Get a new pixel location from moving noise.
+    uint16_t locn = inoise16(SEGMENT.frameNow()*SEGMENT.speed+i*50000, SEGMENT.frameNow()*SEGMENT.speed);   // Get a new pixel location from moving noise.
     locn = map(locn, 7500, 58000, 0, SEGLEN-1);           // Map that to the length of the strand, and ensure we don't go over.
     SEGMENT.setPixelColor(locn, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(i*64, false, PALETTE_SOLID_WRAP, 0), fftResult[i % 16]*4));
   }
@@ -7175,7 +7170,7 @@ uint16_t mode_waterfall(void) {                   // Waterfall. By: Andrew Tulin
   *binNum = SEGMENT.custom1;                              // Select a bin.
   *maxVol = SEGMENT.custom2 / 2;                          // Our volume comparator.
 
-  uint8_t secondHand = micros() / (256-SEGMENT.speed)/500 + 1 % 16;
+  uint8_t secondHand = SEGMENT.frameNow()*2/(256-SEGMENT.speed) + 1 % 16;
   if (SEGENV.aux0 != secondHand) {                        // Triggered millis timing.
     SEGENV.aux0 = secondHand;
 
@@ -7220,8 +7215,8 @@ uint16_t mode_2DGEQ(void) { // By Will Tatam. Code reduction by Ewoud Wijma.
   if (SEGENV.call == 0) for (int i=0; i<cols; i++) previousBarHeight[i] = 0;
 
   bool rippleTime = false;
-  if (millis() - SEGENV.step >= (256U - SEGMENT.intensity)) {
-    SEGENV.step = millis();
+  if (SEGMENT.frameNow() - SEGENV.step >= (256U - SEGMENT.intensity)) {
+    SEGENV.step = SEGMENT.frameNow();
     rippleTime = true;
   }
 
@@ -7284,7 +7279,7 @@ uint16_t mode_2DFunkyPlank(void) {              // Written by ??? Adapted by Wil
     SEGMENT.fill(BLACK);
   }
 
-  uint8_t secondHand = micros()/(256-SEGMENT.speed)/500+1 % 64;
+  uint8_t secondHand = SEGMENT.frameNow()*2/(256-SEGMENT.speed)+1 % 64;
   if (SEGENV.aux0 != secondHand) {                        // Triggered millis timing.
     SEGENV.aux0 = secondHand;
 
@@ -7356,7 +7351,7 @@ uint16_t mode_2DAkemi(void) {
   const uint16_t cols = SEGMENT.virtualWidth();
   const uint16_t rows = SEGMENT.virtualHeight();
 
-  uint16_t counter = (strip.now * ((SEGMENT.speed >> 2) +2)) & 0xFFFF;
+  uint16_t counter = (SEGMENT.frameNow() * ((SEGMENT.speed >> 2) +2)) & 0xFFFF;
   counter = counter >> 8;
 
   const float lightFactor  = 0.15f;
@@ -7429,7 +7424,7 @@ uint16_t mode_2Ddistortionwaves() {
 
   uint8_t  w = 2;
 
-  uint16_t a  = millis()/32;
+  uint16_t a  = SEGMENT.frameNow()/32;
   uint16_t a2 = a/2;
   uint16_t a3 = a/3;
 
@@ -7493,9 +7488,9 @@ uint16_t mode_2Dsoap() {
 
   // init
   if (SEGENV.call == 0) {
-    *noise32_x = random16();
-    *noise32_y = random16();
-    *noise32_z = random16();
+    *noise32_x = SEGMENT.random16();
+    *noise32_y = SEGMENT.random16();
+    *noise32_z = SEGMENT.random16();
   } else {
     *noise32_x += mov;
     *noise32_y += mov;
@@ -7647,7 +7642,7 @@ uint16_t mode_2Dwavingcell() {
   const uint16_t cols = SEGMENT.virtualWidth();
   const uint16_t rows = SEGMENT.virtualHeight();
 
-  uint32_t t = millis()/(257-SEGMENT.speed);
+  uint32_t t = SEGMENT.frameNow()/(257-SEGMENT.speed);
   uint8_t aX = SEGMENT.custom1/16 + 9;
   uint8_t aY = SEGMENT.custom2/16 + 1;
   uint8_t aZ = SEGMENT.custom3 + 1;
@@ -28,6 +28,9 @@
 #define WS2812FX_h
 
 #include <vector>
+#ifndef ESP8266
+#include <atomic>
+#endif
 
 #include "const.h"
 
@@ -43,6 +46,7 @@
 #define DEFAULT_C1         (uint8_t)128
 #define DEFAULT_C2         (uint8_t)128
 #define DEFAULT_C3         (uint8_t)16
+#define DEFAULT_PRIORITY   (uint8_t)128
 
 #ifndef MIN
 #define MIN(a,b) ((a)<(b)?(a):(b))
@@ -56,6 +60,31 @@
 #define RGBW32(r,g,b,w) (uint32_t((byte(w) << 24) | (byte(r) << 16) | (byte(g) << 8) | (byte(b))))
 #endif
 
+// flags shared between render task and main loop (see WLED_ENABLE_RENDER_TASK)
+#ifdef ESP8266
+typedef volatile bool sync_flag_t; // single core, no render task
+typedef volatile uint8_t sync_count_t;
+typedef uint16_t sync_mem_t;
+#else
+typedef std::atomic<bool> sync_flag_t;
+typedef std::atomic<uint8_t> sync_count_t;
+typedef std::atomic<uint16_t> sync_mem_t;     // effect data may be allocated by render workers on both cores
+#endif
+
+// effect state accessed through macros (SEGMENT, SEGENV, SEGLEN, SEGCOLOR) is kept per render worker
+#ifdef WLED_ENABLE_PARALLEL_RENDER
+  #ifndef WLED_RENDER_WORKERS
+    #define WLED_RENDER_WORKERS 2               // one worker per core (host builds use more threads, see test/host)
+  #endif
+  #define RENDER_WORKER_ID    xPortGetCoreID()  // helper tasks are pinned to the core matching their worker ID
+  #ifndef WLED_RENDER_WORKER_STACK
+    #define WLED_RENDER_WORKER_STACK 8192
+  #endif
+#else
+  #define WLED_RENDER_WORKERS 1
+  #define RENDER_WORKER_ID    0
+#endif
+
 /* Not used in all effects yet */
 #define WLED_FPS         42
 #define FRAMETIME_FIXED  (1000/WLED_FPS)
@@ -83,6 +112,16 @@
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
 
+/* Effect data of the previous effect (mode blending) is copied into a buffer of this size preallocated for each
+  transition slot, larger data is allocated from the heap within MAX_SEGMENT_DATA */
+#ifndef TRANSITION_DATA_SIZE
+  #ifdef ESP8266
+    #define TRANSITION_DATA_SIZE 128
+  #else
+    #define TRANSITION_DATA_SIZE (MAX_SEGMENT_DATA / MAX_NUM_SEGMENTS)
+  #endif
+#endif
+
 #define MIN_SHOW_DELAY   (_frametime < 16 ? 8 : 15)
 
 #define NUM_COLORS       3 /* number of colors per segment */
@@ -92,7 +131,7 @@
 //#define SEGLEN           strip._segments[strip.getCurrSegmentId()].virtualLength()
 #define SEGCOLOR(x)      strip.segColor(x) /* saves us a few kbytes of code */
 #define SEGPALETTE       Segment::getCurrentPalette()
-#define SEGLEN           strip._virtualSegmentLength /* saves us a few kbytes of code */
+#define SEGLEN           strip._virtualSegmentLength[RENDER_WORKER_ID] /* saves us a few kbytes of code */
 #define SPEED_FORMULA_L  (5U + (50U*(255U - SEGMENT.speed))/SEGLEN)
 
 // some common colors
@@ -364,6 +403,8 @@ typedef struct Segment {
     };
     uint8_t startY;  // start Y coodrinate 2D (top); there should be no more than 255 rows
     uint8_t stopY;   // stop Y coordinate 2D (bottom); there should be no more than 255 rows
+    uint8_t priority; // render priority, lower priority segments skip frames first if effects exceed frame time
+    uint8_t minFps;   // minimum effect refresh rate kept when skipping frames (0 = no minimum)
     char    *name;
 
     // runtime data
@@ -411,10 +452,11 @@ typedef struct Segment {
       };
     };
     uint16_t        _dataLen;
-    static uint16_t _usedSegmentData;
+    uint16_t        _fxCost;   // moving average of effect function run time (us), used by frame budget scheduler
+    static sync_mem_t _usedSegmentData;
 
     // perhaps this should be per segment, not static
-    static CRGBPalette16 _currentPalette;     // palette used for current effect (includes transition, used in color_from_palette())
+    static CRGBPalette16 _currentPalette[WLED_RENDER_WORKERS]; // palette used for current effect (includes transition, used in color_from_palette())
     static CRGBPalette16 _randomPalette;      // actual random palette
     static CRGBPalette16 _newRandomPalette;   // target random palette
     static unsigned long _lastPaletteChange;  // last random palette change time in millis()
@@ -422,11 +464,12 @@ typedef struct Segment {
     static bool          _modeBlend;          // mode/effect blending semaphore
     #endif
 
-    // transition data, valid only if transitional==true, holds values during transition (72 bytes)
+    // transition data, valid only if transitional==true, holds values during transition (72 bytes + TRANSITION_DATA_SIZE)
     struct Transition {
       #ifndef WLED_DISABLE_MODE_BLEND
       tmpsegd_t     _segT;        // previous segment environment
       uint8_t       _modeT;       // previous mode/effect
+      uint8_t       _data[TRANSITION_DATA_SIZE]; // copy of previous effect data (if it fits)
       #else
       uint32_t      _colorT[NUM_COLORS];
       #endif
@@ -436,13 +479,36 @@ typedef struct Segment {
       uint8_t       _prevPaletteBlends; // number of previous palette blends (there are max 255 blends possible)
       unsigned long _start;       // must accommodate millis()
       uint16_t      _dur;
-      Transition(uint16_t dur=750)
+      uint16_t      _progress;    // transition progress (0-65535), updated once per frame in handleTransition()
+      bool          _inUse;       // slot is taken from the transition pool
+      Transition()
         : _palT(CRGBPalette16(CRGB::Black))
         , _prevPaletteBlends(0)
-        , _start(millis())
-        , _dur(dur)
+        , _start(0)
+        , _dur(0)
+        , _progress(0xFFFFU)
+        , _inUse(false)
       {}
     } *_t;
+    static Transition _transitionPool[MAX_NUM_SEGMENTS]; // preallocated transition slots (no heap use when transitions start/stop, unless effect data exceeds TRANSITION_DATA_SIZE)
+
+    // per-frame render context, snapshot taken by beginFrame() before the effect function is run (24 bytes)
+    // pixel functions read these values instead of recalculating them for every pixel
+    struct FrameContext {
+      const CRGBPalette16 *palette; // palette used for this frame
+      uint32_t now;                 // strip time of this frame
+      uint16_t vLength;             // virtualLength()
+      uint16_t vWidth;              // virtualWidth()
+      uint16_t vHeight;             // virtualHeight()
+      uint16_t progress;            // transition progress
+      uint16_t rand;                // PRNG state (see random16())
+      uint8_t  bri;                 // currentBri()
+      bool     valid;               // snapshot is valid (between beginFrame() and endFrame())
+    } _frame;
+
+    uint16_t calcVirtualLength(void) const;
+    uint16_t calcVirtualWidth(void)  const;
+    uint16_t calcVirtualHeight(void) const;
 
   public:
 
@@ -468,6 +534,8 @@ typedef struct Segment {
       check3(false),
       startY(0),
       stopY(1),
+      priority(DEFAULT_PRIORITY),
+      minFps(0),
       name(nullptr),
       next_time(0),
       step(0),
@@ -477,7 +545,9 @@ typedef struct Segment {
       data(nullptr),
       _capabilities(0),
       _dataLen(0),
-      _t(nullptr)
+      _fxCost(0),
+      _t(nullptr),
+      _frame()
     {
       #ifdef WLED_DEBUG
       //Serial.printf("-- Creating segment: %p\n", this);
@@ -508,7 +578,8 @@ typedef struct Segment {
     Segment& operator= (Segment &&orig) noexcept; // move assignment
 
 #ifdef WLED_DEBUG
-    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
+    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0); }
+    static size_t getTransitionPoolSize() { return sizeof(_transitionPool); }
 #endif
 
     inline bool     getOption(uint8_t n) const { return ((options >> n) & 0x01); }
@@ -524,14 +595,16 @@ typedef struct Segment {
     inline uint16_t length(void)         const { return width() * height(); }               // segment length (count) in physical pixels
     inline uint16_t groupLength(void)    const { return grouping + spacing; }
     inline uint8_t  getLightCapabilities(void) const { return _capabilities; }
+    inline uint16_t getEffectCost(void)  const { return _fxCost; }  // average effect run time in us
+    inline void     updateEffectCost(uint32_t us) { _fxCost = (3U * _fxCost + MIN(us, 65535U) + 2) >> 2; }
 
     static uint16_t getUsedSegmentData(void)    { return _usedSegmentData; }
-    static void     addUsedSegmentData(int len) { _usedSegmentData += len; }
+    static uint16_t addUsedSegmentData(int len) { return _usedSegmentData += len; } // returns new amount
     #ifndef WLED_DISABLE_MODE_BLEND
     static void     modeBlend(bool blend)       { _modeBlend = blend; }
     #endif
     static void     handleRandomPalette();
-    inline static const CRGBPalette16 &getCurrentPalette(void) { return Segment::_currentPalette; }
+    inline static const CRGBPalette16 &getCurrentPalette(void) { return Segment::_currentPalette[RENDER_WORKER_ID]; }
 
     void    setUp(uint16_t i1, uint16_t i2, uint8_t grp=1, uint8_t spc=0, uint16_t ofs=UINT16_MAX, uint16_t i1Y=0, uint16_t i2Y=1, uint8_t segId = 255);
     bool    setColor(uint8_t slot, uint32_t c); //returns true if changed
@@ -564,15 +637,34 @@ typedef struct Segment {
     void     swapSegenv(tmpsegd_t &tmpSegD);
     void     restoreSegenv(tmpsegd_t &tmpSegD);
     #endif
-    uint16_t progress(void); //transition progression between 0-65535
+    inline uint16_t progress(void) const { return _frame.valid ? _frame.progress : (isInTransition() ? _t->_progress : 0xFFFFU); } //transition progression between 0-65535 (as of current frame)
     uint8_t  currentBri(bool useCct = false);
     uint8_t  currentMode(void);
     uint32_t currentColor(uint8_t slot);
     CRGBPalette16 &loadPalette(CRGBPalette16 &tgt, uint8_t pal);
     void     setCurrentPalette(void);
 
+    // per-frame render context
+    void beginFrame(uint32_t frameNow);                     // snapshot dimensions, brightness & transition progress
+    inline void endFrame(void)           { _frame.valid = false; }
+    inline bool inFrame(void)      const { return _frame.valid; }
+    uint32_t    frameNow(void) const;                       // strip time of current frame
+    inline void setFrameNow(uint32_t t)  { _frame.now = t; }  // effect time override (also used by FastLED beat functions)
+
+    // per-segment PRNG for effects (FastLED random8()/random16() algorithm), seeded by beginFrame() from frame time
+    // and segment position, so nodes with the same state render the same frame at the same (synced) strip time
+    inline uint16_t random16(void)                 { _frame.rand = _frame.rand * 2053 + 13849; return _frame.rand; }
+    inline uint16_t random16(uint16_t lim)         { return ((uint32_t)random16() * lim) >> 16; }
+    inline uint16_t random16(uint16_t min, uint16_t lim) { return random16(lim - min) + min; }
+    inline uint8_t  random8(void)                  { uint16_t r = random16(); return uint8_t(r) + uint8_t(r >> 8); }
+    inline uint8_t  random8(uint8_t lim)           { return (random8() * lim) >> 8; }
+    inline uint8_t  random8(uint8_t min, uint8_t lim) { return random8(lim - min) + min; }
+    inline void     setRandomSeed(uint16_t seed)   { _frame.rand = seed; } // for repeatable sequences within a frame
+    inline uint16_t getRandomSeed(void)      const { return _frame.rand; }
+    uint8_t         randomWheelIndex(uint8_t pos);           // get_random_wheel_index() using segment PRNG
+
     // 1D strip
-    uint16_t virtualLength(void) const;
+    inline uint16_t virtualLength(void) const { return _frame.valid ? _frame.vLength : calcVirtualLength(); }
     void setPixelColor(int n, uint32_t c); // set relative pixel within segment with color
     void setPixelColor(unsigned n, uint32_t c)                    { setPixelColor(int(n), c); }
     void setPixelColor(int n, byte r, byte g, byte b, byte w = 0) { setPixelColor(n, RGBW32(r,g,b,w)); } // automatically inline
@@ -596,8 +688,8 @@ typedef struct Segment {
     uint32_t color_wheel(uint8_t pos);
 
     // 2D matrix
-    uint16_t virtualWidth(void)  const;
-    uint16_t virtualHeight(void) const;
+    inline uint16_t virtualWidth(void)  const { return _frame.valid ? _frame.vWidth  : calcVirtualWidth(); }
+    inline uint16_t virtualHeight(void) const { return _frame.valid ? _frame.vHeight : calcVirtualHeight(); }
     uint16_t nrOfVStrips(void) const;
   #ifndef WLED_DISABLE_2D
     uint16_t XY(uint16_t x, uint16_t y); // support function to get relative index within segment
@@ -695,8 +787,8 @@ class WS2812FX {  // 96 bytes
       panels(1),
 #endif
       // semi-private (just obscured) used in effect functions through macros
-      _colors_t{0,0,0},
-      _virtualSegmentLength(0),
+      _colors_t{},
+      _virtualSegmentLength{},
       // true private variables
       _length(DEFAULT_LED_COUNT),
       _brightness(DEFAULT_BRIGHTNESS),
@@ -704,16 +796,20 @@ class WS2812FX {  // 96 bytes
       _targetFps(WLED_FPS),
       _frametime(FRAMETIME_FIXED),
       _cumulativeFps(2),
-      _isServicing(false),
       _isOffRefreshRequired(false),
       _hasWhiteChannel(false),
+      _isServicing(false),
+      _suspend(0),
       _triggered(false),
+      _showPending(false),
       _modeCount(MODE_COUNT),
       _callback(nullptr),
+      _captureBuffer(nullptr),
+      _captureLen(0),
       customMappingTable(nullptr),
       customMappingSize(0),
       _lastShow(0),
-      _segment_index(0),
+      _segment_index{},
       _mainSegment(0),
       _queuedChangesSegId(255),
       _qStart(0),
@@ -723,6 +819,13 @@ class WS2812FX {  // 96 bytes
       _qGrouping(0),
       _qSpacing(0),
       _qOffset(0)
+#ifdef WLED_ENABLE_PARALLEL_RENDER
+      ,_renderWorker{}
+      ,_serviceTask(nullptr)
+      ,_workerJobCount{}
+      ,_workersBusy(0)
+      ,_workerNowUp(0)
+#endif
     {
       WS2812FX::instance = this;
       _mode.reserve(_modeCount);     // allocate memory to prevent initial fragmentation (does not increase size())
@@ -777,6 +880,7 @@ class WS2812FX {  // 96 bytes
     inline void setPixelColor(int n, CRGB c) { setPixelColor(n, c.red, c.green, c.blue); }
     inline void trigger(void) { _triggered = true; } // Forces the next frame to be computed on all active segments.
     inline void setShowCallback(show_callback cb) { _callback = cb; }
+    inline void setCaptureBuffer(uint32_t *buf, uint16_t len) { _captureLen = 0; _captureBuffer = buf; _captureLen = buf ? len : 0; } // call while idle (suspend())
     inline void setTransition(uint16_t t) { _transitionDur = t; }
     inline void appendSegment(const Segment &seg = Segment()) { if (_segments.size() < getMaxSegments()) _segments.push_back(seg); }
 
@@ -786,9 +890,13 @@ class WS2812FX {  // 96 bytes
       hasCCTBus(void),
       // return true if the strip is being sent pixel updates
       isUpdating(void),
+      waitUntilIdle(void),
       deserializeMap(uint8_t n=0);
 
     inline bool isServicing(void) { return _isServicing; }
+    inline bool isSuspended(void) { return _suspend > 0; }
+    inline void suspend(void) { _suspend++; }  // service() will not start a new frame until resume(); use waitUntilIdle() to finish current one
+    inline void resume(void)  { if (_suspend) _suspend--; } // suspend() calls nest, each needs its resume()
     inline bool hasWhiteChannel(void) {return _hasWhiteChannel;}
     inline bool isOffRefreshRequired(void) {return _isOffRefreshRequired;}
 
@@ -806,7 +914,7 @@ class WS2812FX {  // 96 bytes
     inline uint8_t getBrightness(void) { return _brightness; }
     inline uint8_t getMaxSegments(void) { return MAX_NUM_SEGMENTS; }  // returns maximum number of supported segments (fixed value)
     inline uint8_t getSegmentsNum(void) { return _segments.size(); }  // returns currently present segments
-    inline uint8_t getCurrSegmentId(void) { return _segment_index; }
+    inline uint8_t getCurrSegmentId(void) { return _segment_index[RENDER_WORKER_ID]; }
     inline uint8_t getMainSegmentId(void) { return _mainSegment; }
     inline uint8_t getPaletteCount() { return 13 + GRADIENT_PALETTE_COUNT; }  // will only return built-in palette count
     inline uint8_t getTargetFps() { return _targetFps; }
@@ -830,7 +938,7 @@ class WS2812FX {  // 96 bytes
       getPixelColor(uint16_t);
 
     inline uint32_t getLastShow(void) { return _lastShow; }
-    inline uint32_t segColor(uint8_t i) { return _colors_t[i]; }
+    inline uint32_t segColor(uint8_t i) { return _colors_t[RENDER_WORKER_ID][i]; }
 
     const char *
       getModeData(uint8_t id = 0) { return (id && id<_modeCount) ? _modeData[id] : PSTR("Solid"); }
@@ -893,8 +1001,9 @@ class WS2812FX {  // 96 bytes
 
     // using public variables to reduce code size increase due to inline function getSegment() (with bounds checking)
     // and color transitions
-    uint32_t _colors_t[3]; // color used for effect (includes transition)
-    uint16_t _virtualSegmentLength;
+    // one set per render worker (segments may be rendered in parallel)
+    uint32_t _colors_t[WLED_RENDER_WORKERS][3]; // color used for effect (includes transition)
+    uint16_t _virtualSegmentLength[WLED_RENDER_WORKERS];
 
     std::vector<segment> _segments;
     friend class Segment;
@@ -910,11 +1019,14 @@ class WS2812FX {  // 96 bytes
 
     // will require only 1 byte
     struct {
-      bool _isServicing          : 1;
       bool _isOffRefreshRequired : 1; //periodic refresh is required for the strip to remain off.
       bool _hasWhiteChannel      : 1;
-      bool _triggered            : 1;
     };
+    // may be accessed from render task and main loop simultaneously, cannot be bit fields
+    sync_flag_t  _isServicing;
+    sync_count_t _suspend;
+    sync_flag_t _triggered;
+    bool _showPending; // frame locked: rendered frame is shown when due (used by service() only)
 
     uint8_t                  _modeCount;
     std::vector<mode_ptr>    _mode;     // SRAM footprint: 4 bytes per element
@@ -922,12 +1034,15 @@ class WS2812FX {  // 96 bytes
 
     show_callback _callback;
 
+    uint32_t* _captureBuffer; // copy of pixels as set (before mapping, bus brightness and white calculation), see recorder.cpp
+    uint16_t  _captureLen;
+
     uint16_t* customMappingTable;
     uint16_t  customMappingSize;
 
     unsigned long _lastShow;
 
-    uint8_t _segment_index;
+    uint8_t _segment_index[WLED_RENDER_WORKERS]; // segment being rendered by each worker
     uint8_t _mainSegment;
     uint8_t _queuedChangesSegId;
     uint16_t _qStart, _qStop, _qStartY, _qStopY;
@@ -935,10 +1050,31 @@ class WS2812FX {  // 96 bytes
     uint16_t _qOffset;
 
     uint8_t
-      estimateCurrentAndLimitBri(void);
+      estimateCurrentAndLimitBri(void),
+      getSkipPriority(unsigned long nowUp);
+
+    // segment may skip this frame if it is due and skipping does not drop it below its minimum FPS
+    inline bool canSkipFrame(const Segment &seg, unsigned long nowUp) {
+      return !seg.freeze && nowUp > seg.next_time && (!seg.minFps || nowUp - seg.next_time + _frametime < 1000U / seg.minFps);
+    }
 
     void
+      renderSegment(segment &seg, uint8_t segId, unsigned long nowUp, bool setCCT = true),
       setUpSegmentFromQueuedChanges(void);
+
+    inline bool isRendering(uint8_t segId) { for (uint8_t id : _segment_index) if (id == segId) return true; return false; }
+
+#ifdef WLED_ENABLE_PARALLEL_RENDER
+    // helper tasks render segments not overlapping any other segment due in the same frame on the other core(s)
+    TaskHandle_t  _renderWorker[WLED_RENDER_WORKERS];  // helper task of each worker ID (none for the one running service())
+    TaskHandle_t  _serviceTask;                        // task running service(), notified when a helper is done
+    uint8_t       _workerJobs[WLED_RENDER_WORKERS][MAX_NUM_SEGMENTS]; // segment IDs assigned to each helper
+    uint8_t       _workerJobCount[WLED_RENDER_WORKERS];
+    uint8_t       _workersBusy;                        // helpers service() waits for
+    unsigned long _workerNowUp;
+    size_t dispatchRenderWorkers(uint8_t *due, size_t nDue, unsigned long nowUp);
+    static void renderWorkerTask(void *);
+#endif
 };
 
 extern const char JSON_mode_names[];
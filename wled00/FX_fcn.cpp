@@ -73,11 +73,11 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Segment class implementation
 ///////////////////////////////////////////////////////////////////////////////
-uint16_t Segment::_usedSegmentData = 0U; // amount of RAM all segments use for their data[]
+sync_mem_t Segment::_usedSegmentData(0U); // amount of RAM all segments use for their data[]
 uint16_t Segment::maxWidth = DEFAULT_LED_COUNT;
 uint16_t Segment::maxHeight = 1;
 
-CRGBPalette16 Segment::_currentPalette    = CRGBPalette16(CRGB::Black);
+CRGBPalette16 Segment::_currentPalette[WLED_RENDER_WORKERS];
 CRGBPalette16 Segment::_randomPalette = CRGBPalette16(DEFAULT_COLOR);
 CRGBPalette16 Segment::_newRandomPalette = CRGBPalette16(DEFAULT_COLOR);
 unsigned long Segment::_lastPaletteChange = 0; // perhaps it should be per segment
@@ -86,11 +86,14 @@ unsigned long Segment::_lastPaletteChange = 0; // perhaps it should be per segme
 bool Segment::_modeBlend = false;
 #endif
 
+Segment::Transition Segment::_transitionPool[MAX_NUM_SEGMENTS];
+
 // copy constructor
 Segment::Segment(const Segment &orig) {
   //DEBUG_PRINTF("-- Copy segment constructor: %p -> %p\n", &orig, this);
   memcpy((void*)this, (void*)&orig, sizeof(Segment));
   _t = nullptr; // copied segment cannot be in transition
+  _frame.valid = false; // copied segment is not being rendered
   name = nullptr;
   data = nullptr;
   _dataLen = 0;
@@ -121,6 +124,8 @@ Segment& Segment::operator= (const Segment &orig) {
     // erase pointers to allocated data
     data = nullptr;
     _dataLen = 0;
+    _t = nullptr; // copied segment cannot be in transition
+    _frame.valid = false; // copied segment is not being rendered
     // copy source data
     if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
     if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
@@ -153,7 +158,9 @@ bool Segment::allocateData(size_t len) {
   //DEBUG_PRINTF("--   Allocating data (%d): %p\n", len, this);
   deallocateData();
   if (len == 0) return false; // nothing to do
-  if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) {
+  // reserve before checking, effects on other render workers may allocate at the same time
+  if (len > MAX_SEGMENT_DATA || Segment::addUsedSegmentData(len) > MAX_SEGMENT_DATA) {
+    if (len <= MAX_SEGMENT_DATA) Segment::addUsedSegmentData(-(int)len);
     // not enough memory
     DEBUG_PRINT(F("!!! Effect RAM depleted: "));
     DEBUG_PRINTF("%d/%d !!!\n", len, Segment::getUsedSegmentData());
@@ -161,8 +168,7 @@ bool Segment::allocateData(size_t len) {
   }
   // do not use SPI RAM on ESP32 since it is slow
   data = (byte*) malloc(len);
-  if (!data) { DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); return false; } //allocation failed
-  Segment::addUsedSegmentData(len);
+  if (!data) { Segment::addUsedSegmentData(-(int)len); DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); return false; } //allocation failed
   //DEBUG_PRINTF("---  Allocated data (%p): %d/%d -> %p\n", this, len, Segment::getUsedSegmentData(), data);
   _dataLen = len;
   memset(data, 0, len);
@@ -171,6 +177,9 @@ bool Segment::allocateData(size_t len) {
 
 void Segment::deallocateData() {
   if (!data) { _dataLen = 0; return; }
+  #ifndef WLED_DISABLE_MODE_BLEND
+  if (_t && data == _t->_data) { data = nullptr; _dataLen = 0; return; } // previous effect's copy in transition slot
+  #endif
   //DEBUG_PRINTF("---  Released data (%p): %d/%d -> %p\n", this, _dataLen, Segment::getUsedSegmentData(), data);
   if ((Segment::getUsedSegmentData() > 0) && (_dataLen > 0)) { // check that we don't have a dangling / inconsistent data pointer
     free(data);
@@ -226,10 +235,10 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
       if (timeSinceLastChange > randomPaletteChangeTime * 1000U) {
         _randomPalette = _newRandomPalette;
         _newRandomPalette = CRGBPalette16(
-                        CHSV(random8(), random8(160, 255), random8(128, 255)),
-                        CHSV(random8(), random8(160, 255), random8(128, 255)),
-                        CHSV(random8(), random8(160, 255), random8(128, 255)),
-                        CHSV(random8(), random8(160, 255), random8(128, 255)));
+                        CHSV(::random8(), ::random8(160, 255), ::random8(128, 255)),
+                        CHSV(::random8(), ::random8(160, 255), ::random8(128, 255)),
+                        CHSV(::random8(), ::random8(160, 255), ::random8(128, 255)),
+                        CHSV(::random8(), ::random8(160, 255), ::random8(128, 255))); // global PRNG, palette is shared by all segments
         _lastPaletteChange = millis();
         handleRandomPalette(); // do a 1st pass of blend
       }
@@ -292,10 +301,18 @@ void Segment::startTransition(uint16_t dur) {
   if (isInTransition()) return; // already in transition no need to store anything
 
   // starting a transition has to occur before change so we get current values 1st
-  _t = new Transition(dur); // no previous transition running
-  if (!_t) return; // failed to allocate data
+  // take a free slot from the preallocated pool (no previous transition running)
+  for (size_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    if (!_transitionPool[i]._inUse) { _t = &_transitionPool[i]; break; }
+  }
+  if (!_t) return; // no free transition slot
 
   //DEBUG_PRINTF("-- Started transition: %p\n", this);
+  _t->_inUse             = true;
+  _t->_start             = millis();
+  _t->_dur               = dur;
+  _t->_progress          = 0;
+  _t->_prevPaletteBlends = 0;
   loadPalette(_t->_palT, palette);
   _t->_briT           = on ? opacity : 0;
   _t->_cctT           = cct;
@@ -306,7 +323,14 @@ void Segment::startTransition(uint16_t dur) {
     _t->_segT._dataLenT = 0;
     _t->_segT._dataT    = nullptr;
     if (_dataLen > 0 && data) {
-      _t->_segT._dataT = (byte *)malloc(_dataLen);
+      if (_dataLen <= sizeof(_t->_data)) {
+        _t->_segT._dataT = _t->_data; // no heap use
+      } else if (Segment::addUsedSegmentData(_dataLen) <= MAX_SEGMENT_DATA) {
+        _t->_segT._dataT = (byte *)malloc(_dataLen);
+        if (!_t->_segT._dataT) Segment::addUsedSegmentData(-(int)_dataLen);
+      } else {
+        Segment::addUsedSegmentData(-(int)_dataLen); // old effect is blended without its data
+      }
       if (_t->_segT._dataT) {
         //DEBUG_PRINTF("--  Allocated duplicate data (%d): %p\n", _dataLen, _t->_segT._dataT);
         memcpy(_t->_segT._dataT, data, _dataLen);
@@ -325,30 +349,26 @@ void Segment::stopTransition() {
   //DEBUG_PRINTF("-- Stopping transition: %p\n", this);
   if (isInTransition()) {
     #ifndef WLED_DISABLE_MODE_BLEND
-    if (_t->_segT._dataT && _t->_segT._dataLenT > 0) {
+    if (_t->_segT._dataT && _t->_segT._dataT != _t->_data && _t->_segT._dataLenT > 0) {
+      // allocated by startTransition() or by the previous effect itself (counted as segment data either way)
       //DEBUG_PRINTF("--  Released duplicate data (%d): %p\n", _t->_segT._dataLenT, _t->_segT._dataT);
       free(_t->_segT._dataT);
-      _t->_segT._dataT = nullptr;
-      _t->_segT._dataLenT = 0;
+      Segment::addUsedSegmentData(-(int)MIN((int)_t->_segT._dataLenT, (int)Segment::getUsedSegmentData()));
     }
+    _t->_segT._dataT = nullptr;
+    _t->_segT._dataLenT = 0;
     #endif
-    delete _t;
+    _t->_inUse = false; // return slot to the pool
     _t = nullptr;
   }
 }
 
+// updates transition progression (0-65535) once per frame, progress() returns this cached value
 void Segment::handleTransition() {
-  uint16_t _progress = progress();
-  if (_progress == 0xFFFFU) stopTransition();
-}
-
-// transition progression between 0-65535
-uint16_t Segment::progress() {
-  if (isInTransition()) {
-    unsigned diff = millis() - _t->_start;
-    if (_t->_dur > 0 && diff < _t->_dur) return diff * 0xFFFFU / _t->_dur;
-  }
-  return 0xFFFFU;
+  if (!isInTransition()) return;
+  unsigned diff = millis() - _t->_start;
+  _t->_progress = (_t->_dur > 0 && diff < _t->_dur) ? diff * 0xFFFFU / _t->_dur : 0xFFFFU;
+  if (_t->_progress == 0xFFFFU) stopTransition();
 }
 
 #ifndef WLED_DISABLE_MODE_BLEND
@@ -425,6 +445,7 @@ void Segment::restoreSegenv(tmpsegd_t &tmpSeg) {
 #endif
 
 uint8_t Segment::currentBri(bool useCct) {
+  if (!useCct && _frame.valid) return _frame.bri; // use per-frame snapshot
   uint32_t prog = progress();
   if (prog < 0xFFFFU) {
     uint32_t curBri = (useCct ? cct : (on ? opacity : 0)) * prog;
@@ -451,18 +472,54 @@ uint32_t Segment::currentColor(uint8_t slot) {
 }
 
 void Segment::setCurrentPalette() {
-  loadPalette(_currentPalette, palette);
+  CRGBPalette16 &currentPalette = _currentPalette[RENDER_WORKER_ID];
+  loadPalette(currentPalette, palette);
   unsigned prog = progress();
   if (strip.paletteFade && prog < 0xFFFFU) {
     // blend palettes
     // there are about 255 blend passes of 48 "blends" to completely blend two palettes (in _dur time)
     // minimum blend time is 100ms maximum is 65535ms
     unsigned noOfBlends = ((255U * prog) / 0xFFFFU) - _t->_prevPaletteBlends;
-    for (unsigned i = 0; i < noOfBlends; i++, _t->_prevPaletteBlends++) nblendPaletteTowardPalette(_t->_palT, _currentPalette, 48);
-    _currentPalette = _t->_palT; // copy transitioning/temporary palette
+    for (unsigned i = 0; i < noOfBlends; i++, _t->_prevPaletteBlends++) nblendPaletteTowardPalette(_t->_palT, currentPalette, 48);
+    currentPalette = _t->_palT; // copy transitioning/temporary palette
   }
 }
 
+// takes a snapshot of values used by pixel functions so they are calculated once per frame
+// (instead of once per pixel) and stay consistent while the effect function runs
+// must be called again if segment environment is swapped (effect blending)
+void Segment::beginFrame(uint32_t frameNow) {
+  _frame.valid    = false; // recalculate everything
+  _frame.palette  = &_currentPalette[RENDER_WORKER_ID];
+  _frame.now      = frameNow;
+  _frame.vWidth   = calcVirtualWidth();
+  _frame.vHeight  = calcVirtualHeight();
+  _frame.vLength  = calcVirtualLength();
+  _frame.progress = progress();
+  _frame.bri      = currentBri();
+  // effect PRNG seed: hash of frame time and segment position (same on all nodes rendering this frame)
+  uint32_t h = frameNow ^ ((uint32_t)start << 16 | startY) * 0x9E3779B1;
+  h = (h ^ (h >> 16)) * 0x45d9f3b;
+  _frame.rand     = h ^ (h >> 16);
+  _frame.valid    = true;
+}
+
+uint32_t Segment::frameNow() const {
+  return _frame.valid ? _frame.now : strip.now;
+}
+
+// random color wheel index at least 42 away from pos
+uint8_t Segment::randomWheelIndex(uint8_t pos) {
+  uint8_t r = 0, x = 0, y = 0, d = 0;
+  while (d < 42) {
+    r = random8();
+    x = abs(pos - r);
+    y = 255 - x;
+    d = MIN(x, y);
+  }
+  return r;
+}
+
 // relies on WS2812FX::service() to call it max every 8ms or more (MIN_SHOW_DELAY)
 void Segment::handleRandomPalette() {
   // just do a blend; if the palettes are identical it will just compare 48 bytes (same as _randomPalette == _newRandomPalette)
@@ -607,14 +664,14 @@ void Segment::setPalette(uint8_t pal) {
 }
 
 // 2D matrix
-uint16_t Segment::virtualWidth() const {
+uint16_t Segment::calcVirtualWidth() const {
   uint16_t groupLen = groupLength();
   uint16_t vWidth = ((transpose ? height() : width()) + groupLen - 1) / groupLen;
   if (mirror) vWidth = (vWidth + 1) /2;  // divide by 2 if mirror, leave at least a single LED
   return vWidth;
 }
 
-uint16_t Segment::virtualHeight() const {
+uint16_t Segment::calcVirtualHeight() const {
   uint16_t groupLen = groupLength();
   uint16_t vHeight = ((transpose ? width() : height()) + groupLen - 1) / groupLen;
   if (mirror_y) vHeight = (vHeight + 1) /2;  // divide by 2 if mirror, leave at least a single LED
@@ -636,7 +693,7 @@ uint16_t Segment::nrOfVStrips() const {
 }
 
 // 1D strip
-uint16_t Segment::virtualLength() const {
+uint16_t Segment::calcVirtualLength() const {
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
     uint16_t vW = virtualWidth();
@@ -864,6 +921,8 @@ uint8_t Segment::differs(Segment& b) const {
   if (custom3 != b.custom3)     d |= SEG_DIFFERS_FX;
   if (startY != b.startY)       d |= SEG_DIFFERS_BOUNDS;
   if (stopY != b.stopY)         d |= SEG_DIFFERS_BOUNDS;
+  if (priority != b.priority)   d |= SEG_DIFFERS_OPT;
+  if (minFps != b.minFps)       d |= SEG_DIFFERS_OPT;
 
   //bit pattern: (msb first)
   // set:2, sound:2, mapping:3, transposed, mirrorY, reverseY, [reset,] paused, mirrored, on, reverse, [selected]
@@ -1079,7 +1138,7 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
   uint8_t paletteIndex = i;
   if (mapping && virtualLength() > 1) paletteIndex = (i*255)/(virtualLength() -1);
   if (!wrap && strip.paletteBlend != 3) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
-  CRGB fastled_col = ColorFromPalette(_currentPalette, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
+  CRGB fastled_col = ColorFromPalette(_frame.valid ? *_frame.palette : _currentPalette[RENDER_WORKER_ID], paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
 
   return RGBW32(fastled_col.r, fastled_col.g, fastled_col.b, 0);
 }
@@ -1157,15 +1216,38 @@ void WS2812FX::finalizeInit(void)
 }
 
 void WS2812FX::service() {
+  if (_showPending) { // frame locked: rendered frame waits for its show time, strip is idle in between
+    _isServicing = true;
+    if (!_suspend && frameLockShowDue()) {
+      show();
+      _showPending = false;
+    }
+    _isServicing = false;
+    return;
+  }
+
   unsigned long nowUp = millis(); // Be aware, millis() rolls over every 49 days
+  unsigned long dueUp = nowUp;    // segments due until this time are rendered
+  bool frameLock = frameLockActive(); // frame is shown at a scheduled time common to all nodes (see framelock.cpp)
+  if (frameLock) {
+    if (!frameLockBegin(nowUp)) return; // next frame not yet to be rendered, nowUp is set to its show time otherwise
+    dueUp = nowUp + frameLockPeriod() / 2000; // segments due within half a frame are rendered for this frame
+  } else if (nowUp - _lastShow < MIN_SHOW_DELAY) return;
   now = nowUp + timebase;
-  if (nowUp - _lastShow < MIN_SHOW_DELAY) return;
   bool doShow = false;
 
   _isServicing = true;
-  _segment_index = 0;
+  if (_suspend) { // set _isServicing before checking _suspend so waitUntilIdle() cannot miss a frame being started
+    _isServicing = false;
+    return;
+  }
   Segment::handleRandomPalette(); // move it into for loop when each segment has individual random palette
-  for (segment &seg : _segments) {
+  uint8_t skipBelow = getSkipPriority(dueUp); // segments with lower priority skip this frame (frame budget exceeded)
+
+  uint8_t due[MAX_NUM_SEGMENTS]; // segments to render in this frame (in render order)
+  size_t  nDue = 0;
+  for (size_t i = 0; i < _segments.size(); i++) {
+    segment &seg = _segments[i];
     // process transition (mode changes in the middle of transition)
     seg.handleTransition();
     // reset the segment runtime data if needed
@@ -1173,70 +1255,216 @@ void WS2812FX::service() {
 
     if (!seg.isActive()) continue;
 
+    // low priority segment skips this frame if effects would not fit into frame time (it stays due for the next frame)
+    bool skipFrame = seg.priority < skipBelow && canSkipFrame(seg, dueUp);
+
     // last condition ensures all solid segments are updated at the same time
-    if (nowUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))
+    if (!skipFrame && (dueUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC)))
     {
       doShow = true;
-      uint16_t delay = FRAMETIME;
-
-      if (!seg.freeze) { //only run effect function if not frozen
-        _virtualSegmentLength = seg.virtualLength();
-        _colors_t[0] = seg.currentColor(0);
-        _colors_t[1] = seg.currentColor(1);
-        _colors_t[2] = seg.currentColor(2);
-        seg.setCurrentPalette();              // load actual palette
-
-        if (!cctFromRgb || correctWB) busses.setSegmentCCT(seg.currentBri(true), correctWB);
-        for (int c = 0; c < NUM_COLORS; c++) _colors_t[c] = gamma32(_colors_t[c]);
-
-        // Effect blending
-        // When two effects are being blended, each may have different segment data, this
-        // data needs to be saved first and then restored before running previous mode.
-        // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
-        // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
-        // would need to be allocated for each effect and then blended together for each pixel.
-        [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
-        delay = (*_mode[seg.mode])();         // run new/current mode
-#ifndef WLED_DISABLE_MODE_BLEND
-        if (modeBlending && seg.mode != tmpMode) {
-          Segment::tmpsegd_t _tmpSegData;
-          Segment::modeBlend(true);           // set semaphore
-          seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
-          _virtualSegmentLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
-          uint16_t d2 = (*_mode[tmpMode])();  // run old mode
-          seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
-          delay = MIN(delay,d2);              // use shortest delay
-          Segment::modeBlend(false);          // unset semaphore
-        }
-#endif
-        if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
-        if (seg.isInTransition() && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
-      }
-
-      seg.next_time = nowUp + delay;
+      if (nDue < MAX_NUM_SEGMENTS) due[nDue++] = i;
     }
-    if (_segment_index == _queuedChangesSegId) setUpSegmentFromQueuedChanges();
-    _segment_index++;
   }
-  _virtualSegmentLength = 0;
+
+#ifdef WLED_ENABLE_PARALLEL_RENDER
+  nDue = dispatchRenderWorkers(due, nDue, nowUp); // independent segments are rendered on the other core(s)
+  const bool setCCT = !_workersBusy;              // otherwise set once by dispatchRenderWorkers()
+#else
+  const bool setCCT = true;
+#endif
+  for (size_t i = 0; i < nDue; i++) renderSegment(_segments[due[i]], due[i], nowUp, setCCT);
+#ifdef WLED_ENABLE_PARALLEL_RENDER
+  for (; _workersBusy; _workersBusy--) ulTaskNotifyTake(pdFALSE, portMAX_DELAY); // wait for helpers to finish their segments (one notification each)
+#endif
+  setUpSegmentFromQueuedChanges();
+  _virtualSegmentLength[RENDER_WORKER_ID] = 0;
   busses.setSegmentCCT(-1);
-  _isServicing = false;
   _triggered = false;
 
   #ifdef WLED_DEBUG
-  if (millis() - nowUp > _frametime) DEBUG_PRINTLN(F("Slow effects."));
+  if ((long)(millis() - nowUp) > (long)_frametime) DEBUG_PRINTLN(F("Slow effects.")); // nowUp may be ahead if frame locked
   #endif
   if (doShow) {
     yield();
-    show();
+    if (frameLock && !frameLockShowDue()) _showPending = true; // shown by a later call at the scheduled time
+    else show();
   }
+  _isServicing = false; // busses are not touched anymore
   #ifdef WLED_DEBUG
-  if (millis() - nowUp > _frametime) DEBUG_PRINTLN(F("Slow strip."));
+  if ((long)(millis() - nowUp) > (long)_frametime) DEBUG_PRINTLN(F("Slow strip."));
   #endif
 }
 
+// runs effect function of a segment, may be called from render worker on another core
+// so only per worker state (_segment_index, _virtualSegmentLength, _colors_t) may be used
+// bus CCT is global, it is set by the caller if segments are rendered in parallel (setCCT false)
+void WS2812FX::renderSegment(segment &seg, uint8_t segId, unsigned long nowUp, bool setCCT) {
+  const unsigned w = RENDER_WORKER_ID;
+  uint16_t delay = FRAMETIME;
+  _segment_index[w] = segId;
+
+  if (!seg.freeze) { //only run effect function if not frozen
+    unsigned long fxStart = micros();
+    seg.beginFrame(now);                  // snapshot segment dimensions, brightness & transition progress
+    _virtualSegmentLength[w] = seg.virtualLength();
+    _colors_t[w][0] = seg.currentColor(0);
+    _colors_t[w][1] = seg.currentColor(1);
+    _colors_t[w][2] = seg.currentColor(2);
+    seg.setCurrentPalette();              // load actual palette
+
+    if (setCCT && (!cctFromRgb || correctWB)) busses.setSegmentCCT(seg.currentBri(true), correctWB);
+    for (int c = 0; c < NUM_COLORS; c++) _colors_t[w][c] = gamma32(_colors_t[w][c]);
+
+    // Effect blending
+    // When two effects are being blended, each may have different segment data, this
+    // data needs to be saved first and then restored before running previous mode.
+    // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
+    // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
+    // would need to be allocated for each effect and then blended together for each pixel.
+    [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
+    delay = (*_mode[seg.mode])();         // run new/current mode
+#ifndef WLED_DISABLE_MODE_BLEND
+    if (modeBlending && seg.mode != tmpMode) {
+      Segment::tmpsegd_t _tmpSegData;
+      Segment::modeBlend(true);           // set semaphore
+      seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
+      seg.beginFrame(now);                // options of old mode may differ (mapping, mirroring)
+      _virtualSegmentLength[w] = seg.virtualLength(); // update SEGLEN (mapping may have changed)
+      uint16_t d2 = (*_mode[tmpMode])();  // run old mode
+      seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
+      delay = MIN(delay,d2);              // use shortest delay
+      Segment::modeBlend(false);          // unset semaphore
+    }
+#endif
+    seg.endFrame();
+    seg.updateEffectCost(micros() - fxStart);
+    if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
+    if (seg.isInTransition() && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
+  }
+
+  seg.next_time = nowUp + delay;
+}
+
+#ifdef WLED_ENABLE_PARALLEL_RENDER
+// segments write to disjoint pixels if their areas (start..stop x startY..stopY) do not intersect
+// (1D segments span row 0 only, those following a matrix start beyond its width)
+static bool segmentsOverlap(const Segment &a, const Segment &b) {
+  return a.start < b.stop && b.start < a.stop && a.startY < b.stopY && b.startY < a.stopY;
+}
+
+// moves segments that do not overlap any other segment due in this frame to the helper tasks on the other core(s)
+// output stays deterministic since such segments write to disjoint parts of the LED buffer, overlapping
+// segments are still rendered in order by the calling task; work is balanced using measured effect cost
+// returns number of segments left for the calling task (remaining in due[])
+size_t WS2812FX::dispatchRenderWorkers(uint8_t *due, size_t nDue, unsigned long nowUp) {
+  _workersBusy = 0;
+  if (nDue < 2) return nDue;
+
+  // shared state that must not change between segments rendered in parallel:
+  // bus CCT is global and effect blending uses a static semaphore
+  const bool useCCT = !cctFromRgb || correctWB;
+  const uint8_t cct = _segments[due[0]].currentBri(true);
+  for (size_t i = 0; i < nDue; i++) {
+    Segment &seg = _segments[due[i]];
+    if (useCCT && seg.currentBri(true) != cct) return nDue;
+    #ifndef WLED_DISABLE_MODE_BLEND
+    if (modeBlending && seg.mode != seg.currentMode()) return nDue;
+    #endif
+  }
+
+  // effect data is allocated during first call which is not thread safe
+  const unsigned self = RENDER_WORKER_ID;
+  uint32_t cost[WLED_RENDER_WORKERS] = {0};
+  bool independent[MAX_NUM_SEGMENTS];
+  for (size_t i = 0; i < nDue; i++) {
+    const Segment &seg = _segments[due[i]];
+    independent[i] = !seg.freeze && seg.call > 0;
+    for (size_t j = 0; independent[i] && j < nDue; j++) if (j != i && segmentsOverlap(seg, _segments[due[j]])) independent[i] = false;
+    if (!independent[i]) cost[self] += seg.getEffectCost() + 1;
+  }
+
+  // each independent segment goes to the least loaded worker
+  for (unsigned w = 0; w < WLED_RENDER_WORKERS; w++) _workerJobCount[w] = 0;
+  size_t n = 0;
+  for (size_t i = 0; i < nDue; i++) {
+    unsigned w = self;
+    if (independent[i]) for (unsigned k = 0; k < WLED_RENDER_WORKERS; k++) if (cost[k] < cost[w]) w = k;
+    if (independent[i]) cost[w] += _segments[due[i]].getEffectCost() + 1;
+    if (w == self) due[n++] = due[i];
+    else _workerJobs[w][_workerJobCount[w]++] = due[i];
+  }
+
+  _workerNowUp = nowUp;
+  _serviceTask = xTaskGetCurrentTaskHandle();
+  if (useCCT) busses.setSegmentCCT(cct, correctWB); // same for all segments of this frame
+  for (unsigned w = 0; w < WLED_RENDER_WORKERS; w++) {
+    if (!_workerJobCount[w]) continue;
+    if (!_renderWorker[w]) {
+      // helper runs on the core matching its worker ID
+      xTaskCreatePinnedToCore(renderWorkerTask, "RenderWorker", WLED_RENDER_WORKER_STACK, this, 1, &_renderWorker[w], w);
+      if (!_renderWorker[w]) {
+        DEBUG_PRINTLN(F("Render worker not started."));
+        for (size_t i = 0; i < _workerJobCount[w]; i++) due[n++] = _workerJobs[w][i]; // independent segments may be rendered in any order
+        _workerJobCount[w] = 0;
+        continue;
+      }
+    }
+    _workersBusy++;
+    xTaskNotifyGive(_renderWorker[w]);
+  }
+  return n;
+}
+
+void WS2812FX::renderWorkerTask(void *arg) {
+  WS2812FX *s = static_cast<WS2812FX*>(arg);
+  const unsigned w = RENDER_WORKER_ID; // task is pinned to its core
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    for (size_t i = 0; i < s->_workerJobCount[w]; i++) s->renderSegment(s->_segments[s->_workerJobs[w][i]], s->_workerJobs[w][i], s->_workerNowUp, false);
+    s->_virtualSegmentLength[w] = 0;
+    xTaskNotifyGive(s->_serviceTask);
+  }
+}
+#endif
+
+// frame budget scheduler
+// sums the average effect cost of all segments that are due in this frame and if that exceeds frame time
+// returns the priority below which segments skip this frame (0 if everything fits)
+// lowest priority levels are dropped first; segments with the highest due priority and segments
+// that would fall below their minimum FPS are never skipped
+uint8_t WS2812FX::getSkipPriority(unsigned long nowUp) {
+  if (_triggered) return 0;
+  struct { uint8_t pri; uint16_t cost; } skippable[MAX_NUM_SEGMENTS];
+  size_t   n = 0;
+  uint32_t total = 0;
+  uint8_t  maxPri = 0;
+  for (segment &seg : _segments) {
+    if (!seg.isActive() || seg.freeze || nowUp <= seg.next_time) continue;
+    total += seg.getEffectCost();
+    if (seg.priority > maxPri) maxPri = seg.priority;
+    if (!canSkipFrame(seg, nowUp) || n >= MAX_NUM_SEGMENTS) continue;
+    skippable[n].pri  = seg.priority;
+    skippable[n].cost = seg.getEffectCost();
+    n++;
+  }
+  const uint32_t budget = _frametime * 1000U; // in us
+  uint8_t skipBelow = 0;
+  while (total > budget) {
+    unsigned lowest = 256;
+    for (size_t i = 0; i < n; i++) if (skippable[i].pri >= skipBelow && skippable[i].pri < lowest) lowest = skippable[i].pri;
+    if (lowest >= maxPri) break; // nothing left to skip
+    for (size_t i = 0; i < n; i++) if (skippable[i].pri == lowest) total -= skippable[i].cost;
+    skipBelow = lowest + 1;
+  }
+  #ifdef WLED_DEBUG
+  if (skipBelow) DEBUG_PRINTF("Frame budget exceeded, skipping priority <%d.\n", (int)skipBelow);
+  #endif
+  return skipBelow;
+}
+
 void IRAM_ATTR WS2812FX::setPixelColor(int i, uint32_t col)
 {
+  if (unsigned(i) < _captureLen) _captureBuffer[i] = col;
   if (i < customMappingSize) i = customMappingTable[i];
   if (i >= _length) return;
   busses.setPixelColor(i, col);
@@ -1355,6 +1583,26 @@ void WS2812FX::show(void) {
   _lastShow = showNow;
 }
 
+// wait until service() finishes the frame currently being rendered and shown (by render task), at most
+// STRIP_IDLE_TIMEOUT (STRIP_IDLE_TIMEOUT_ASYNC if called from a network callback, on ESP8266 they do not interrupt service())
+// call suspend() first or a new frame may start right after this returns
+// returns false on timeout, segments and busses must not be changed then (resume() and retry later)
+bool WS2812FX::waitUntilIdle(void) {
+  unsigned long start = millis();
+  unsigned long timeout = STRIP_IDLE_TIMEOUT;
+  #ifdef ARDUINO_ARCH_ESP32
+  if (mainTaskHandle && xTaskGetCurrentTaskHandle() != mainTaskHandle) timeout = STRIP_IDLE_TIMEOUT_ASYNC;
+  #endif
+  while (_isServicing) {
+    if (millis() - start >= timeout) {
+      DEBUG_PRINTLN(F("Strip busy."));
+      return false;
+    }
+    delay(1);
+  }
+  return true;
+}
+
 /**
  * Returns a true value if any of the strips are still being updated.
  * On some hardware (ESP32), strip updates are done asynchronously.
@@ -1419,7 +1667,9 @@ void WS2812FX::setBrightness(uint8_t b, bool direct) {
   }
   // setting brightness with NeoPixelBusLg has no effect on already painted pixels,
   // so we need to force an update to existing buffer
+  #ifndef WLED_ENABLE_RENDER_TASK
   busses.setBrightness(b);
+  #endif // otherwise busses are only used by render task, show() sets brightness before sending
   if (!direct) {
     unsigned long t = millis();
     if (_segments[0].next_time > t + 22 && t - _lastShow > MIN_SHOW_DELAY) trigger(); //apply brightness change immediately if no refresh soon
@@ -1539,14 +1789,14 @@ void WS2812FX::setSegment(uint8_t segId, uint16_t i1, uint16_t i2, uint8_t group
 
   if (_queuedChangesSegId == segId) _queuedChangesSegId = 255; // cancel queued change if already queued for this segment
 
-  if (segId < getMaxSegments() && segId == getCurrSegmentId() && isServicing()) { // queue change to prevent concurrent access
+  if (segId < getMaxSegments() && isServicing() && isRendering(segId)) { // queue change to prevent concurrent access
     // queuing a change for a second segment will lead to the loss of the first change if not yet applied
-    // however this is not a problem as the queued change is applied immediately after the effect function in that segment returns
+    // however this is not a problem as the queued change is applied by service() as soon as all effects of the frame have returned
     _qStart  = i1; _qStop   = i2; _qStartY = startY; _qStopY  = stopY;
     _qGrouping = grouping; _qSpacing  = spacing; _qOffset   = offset;
     _queuedChangesSegId = segId;
     DEBUG_PRINT(F("Segment queued: ")); DEBUG_PRINTLN(segId);
-    return; // queued changes are applied immediately after effect function returns
+    return; // queued changes are applied at the end of the frame (see setUpSegmentFromQueuedChanges())
   }
   
   _segments[segId].setUp(i1, i2, grouping, spacing, offset, startY, stopY);
@@ -1693,10 +1943,11 @@ bool WS2812FX::checkSegmentAlignment() {
 //Note: If called in an interrupt (e.g. JSON API), original segment must be restored,
 //otherwise it can lead to a crash on ESP32 because _segment_index is modified while in use by the main thread
 uint8_t WS2812FX::setPixelSegment(uint8_t n) {
-  uint8_t prevSegId = _segment_index;
+  const unsigned w = RENDER_WORKER_ID;
+  uint8_t prevSegId = _segment_index[w];
   if (n < _segments.size()) {
-    _segment_index = n;
-    _virtualSegmentLength = _segments[_segment_index].virtualLength();
+    _segment_index[w] = n;
+    _virtualSegmentLength[w] = _segments[n].virtualLength();
   }
   return prevSegId;
 }
@@ -1715,6 +1966,7 @@ void WS2812FX::printSize() {
   size_t size = 0;
   for (const Segment &seg : _segments) size += seg.getSize();
   DEBUG_PRINTF("Segments: %d -> %uB\n", _segments.size(), size);
+  DEBUG_PRINTF("Transitions: %d*%d=%uB\n", Segment::getTransitionPoolSize()/MAX_NUM_SEGMENTS, MAX_NUM_SEGMENTS, Segment::getTransitionPoolSize());
   DEBUG_PRINTF("Modes: %d*%d=%uB\n", sizeof(mode_ptr), _mode.size(), (_mode.capacity()*sizeof(mode_ptr)));
   DEBUG_PRINTF("Data: %d*%d=%uB\n", sizeof(const char *), _modeData.size(), (_modeData.capacity()*sizeof(const char *)));
   DEBUG_PRINTF("Map: %d*%d=%uB\n", sizeof(uint16_t), (int)customMappingSize, customMappingSize*sizeof(uint16_t));
@@ -1770,6 +2022,7 @@ void WS2812FX::loadCustomPalettes() {
       break;
     }
   }
+  invalidateJSONCache(); // palettes JSON needs to be regenerated
 }
 
 //load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
@@ -5,7 +5,6 @@
 * NodeStruct from the ESP Easy project (https://github.com/letscontrolit/ESPEasy)
 \*********************************************************************************************/
 
-#include <map>
 #include <IPAddress.h>
 
 #define NODE_TYPE_ID_UNDEFINED        0
@@ -20,9 +19,10 @@
 \*********************************************************************************************/
 struct NodeStruct
 {
-  String    nodeName;
+  char      nodeName[33];
   IPAddress ip;
-  uint8_t   age;
+  uint32_t  lastSeen;     // millis() of last info packet
+  uint32_t  changed;      // NodeTable version of last change (name, type, state, build)
   union {
     uint8_t nodeType;   // a waste of space as we only have 5 types
     struct {
@@ -30,13 +30,66 @@ struct NodeStruct
       bool    on   : 1;
     };
   };
+  uint16_t  nameHash;     // for lookup by name
   uint32_t  build;
+  uint32_t  rtt;          // network round trip (us), 0 = not measured (see clocksync.cpp)
+  // cluster clock sync (see clocksync.cpp)
+  bool      clockSync;    // node takes part in clock sync (can be leader)
+  uint8_t   clkSamples;   // number of offset measurements, 0 = not measured
+  int32_t   clkOffset;    // effect time of node minus ours (us)
+  uint32_t  clkJitter;    // mean deviation of successive offsets (us)
+  uint32_t  flkLate;      // frame lock statistics reported by node (see framelock.cpp)
+  uint32_t  flkMissed;
 
-  NodeStruct() : age(0), nodeType(0), build(0)
-  {
-    for (uint8_t i = 0; i < 4; ++i) { ip[i] = 0; }
-  }
+  uint8_t age() const { return (millis() - lastSeen) / 30000; } // in node list refresh intervals
+};
+
+/*********************************************************************************************\
+* NodeTable: fixed capacity list of other instances (allocated once, in PSRAM if available)
+* Nodes are stored without gaps (iterate 0 .. size()-1), an open addressing hash index on the
+* IP address is kept next to it. Nodes may be read from web server callbacks while the table
+* is updated from the loop, so capacity must only be changed during setup.
+\*********************************************************************************************/
+#define NODE_REMOVED_LOG 8 // removals remembered for change notifications
+
+class NodeTable
+{
+  public:
+    NodeTable() : _nodes(nullptr), _index(nullptr), _size(0), _capacity(0), _indexMask(0), _version(0), _clearedVersion(0), _removedCount(0) {}
+
+    bool setCapacity(uint16_t capacity);  // (re)allocates table, all nodes are removed
+    void clear();
+
+    NodeStruct* find(IPAddress ip);
+    NodeStruct* findByName(const char *name);
+    NodeStruct* findUnit(uint8_t unit);   // by last IP byte (unit ID)
+    NodeStruct* add(IPAddress ip);        // existing or new node, nullptr if table is full
+    void remove(NodeStruct *node);
+    void setName(NodeStruct *node, const char *name);
+    void changed(NodeStruct *node) { node->changed = ++_version; }
+
+    NodeStruct& operator[](size_t i) { return _nodes[i]; }
+    NodeStruct* begin() { return _nodes; }
+    NodeStruct* end()   { return _nodes + _size; }
+    size_t size() const     { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool   empty() const    { return _size == 0; }
+
+    // change tracking: version is incremented on every change, removed nodes are logged
+    uint32_t version() const { return _version; }
+    bool removedSince(uint32_t version, IPAddress *ips, size_t &count); // false if log does not reach back far enough
+
+  private:
+    NodeStruct *_nodes;
+    uint16_t   *_index;                   // slot -> node position, NODE_INDEX_EMPTY if unused
+    uint16_t    _size, _capacity, _indexMask;
+    uint32_t    _version, _clearedVersion;
+    IPAddress   _removedIp[NODE_REMOVED_LOG];
+    uint32_t    _removedVer[NODE_REMOVED_LOG];
+    uint32_t    _removedCount;
+
+    size_t slotOf(uint32_t key) const;
+    int    findSlot(uint32_t key) const;
 };
-typedef std::map<uint8_t, NodeStruct> NodesMap;
 
 #endif // WLED_NODESTRUCT_H
@@ -0,0 +1,107 @@
+#include "wled.h"
+
+/*
+ * Compact binary control protocol, accepted as WebSocket binary message and as UDP packet on the notifier port
+ * (if "Receive direct" is enabled). Saves parsing JSON and locking the JSON buffer for simple changes.
+ *
+ * packet:  BINCMD_MAGIC, BINCMD_VERSION, command, command, ...
+ * command: opcode, segment ID, field ID, value (uint32, little endian) = 7 bytes
+ *   BINCMD_OP_GLOBAL:  set global field (segment ID is ignored)
+ *   BINCMD_OP_SEGMENT: set segment field, segment ID 255 applies to all selected segments
+ * Commands of a packet are applied in order and result in a single (queued) state update like a JSON request.
+ * Packets from WS clients are applied from the main loop (in order with deferred JSON requests, see ws.cpp)
+ * and acknowledged with BINCMD_MAGIC, BINCMD_VERSION, status (BINCMD_ACK_*), number of applied commands.
+ * See tools/wled_bincmd.py for an encoder/decoder.
+ */
+
+#define BINCMD_CMD_SIZE 7
+
+// segment must not be changed while effects are rendered (in a separate task)
+static void applySegmentField(Segment &seg, uint8_t field, uint32_t value)
+{
+  uint8_t v8 = MIN(value, 255); // most fields are 8 bit
+  switch (field) {
+    case BINCMD_SEG_ON:        seg.setOption(SEG_OPTION_ON, value > 0); break; // use transition
+    case BINCMD_SEG_OPACITY:   seg.setOpacity(v8); break;
+    case BINCMD_SEG_MODE:
+      if (value < strip.getModeCount() && v8 != seg.mode) {
+        if (currentPlaylist >= 0) unloadPlaylist();
+        seg.setMode(v8);
+      }
+      break;
+    case BINCMD_SEG_SPEED:     seg.speed = v8; break;
+    case BINCMD_SEG_INTENSITY: seg.intensity = v8; break;
+    case BINCMD_SEG_PALETTE:   seg.setPalette(v8); break;
+    case BINCMD_SEG_COLOR0:
+    case BINCMD_SEG_COLOR1:
+    case BINCMD_SEG_COLOR2:    seg.setColor(field - BINCMD_SEG_COLOR0, value); break;
+    case BINCMD_SEG_CCT:       seg.setCCT(value); break;
+    case BINCMD_SEG_CUSTOM1:   seg.custom1 = v8; break;
+    case BINCMD_SEG_CUSTOM2:   seg.custom2 = v8; break;
+    case BINCMD_SEG_CUSTOM3:   seg.custom3 = MIN(v8, 31); break;
+    case BINCMD_SEG_SELECTED:  seg.selected = value > 0; break;
+    case BINCMD_SEG_FREEZE:    seg.freeze = value > 0; break;
+  }
+}
+
+// applies binary command packet (from main loop), returns number of applied commands or -BINCMD_ACK_INVALID/-BINCMD_ACK_BUSY
+int handleBinaryCommand(const uint8_t *data, size_t len, byte callMode)
+{
+  if (len < 2 || data[0] != BINCMD_MAGIC || data[1] != BINCMD_VERSION || (len - 2) % BINCMD_CMD_SIZE) return -BINCMD_ACK_INVALID;
+
+  bool onBefore = bri;
+  int applied = 0;
+  int16_t preset = -1;
+  strip.suspend(); // segments must not change while effects are rendered in a separate task
+  if (!strip.waitUntilIdle()) {
+    strip.resume();
+    errorFlag = ERR_BUSY;
+    return -BINCMD_ACK_BUSY; // nothing applied
+  }
+  for (size_t i = 2; i < len; i += BINCMD_CMD_SIZE) {
+    uint8_t  op    = data[i];
+    uint8_t  id    = data[i+1];
+    uint8_t  field = data[i+2];
+    uint32_t value = data[i+3] | data[i+4] << 8 | data[i+5] << 16 | (uint32_t)data[i+6] << 24;
+
+    if (op == BINCMD_OP_GLOBAL) {
+      switch (field) {
+        case BINCMD_GLOBAL_ON:
+          if (value > 1 || !value != !bri) toggleOnOff(); // 2 = toggle
+          break;
+        case BINCMD_GLOBAL_BRI:
+          bri = MIN(value, 255);
+          break;
+        case BINCMD_GLOBAL_TRANSITION:
+          transitionDelay = MIN(value, 65535/100) * 100;
+          if (fadeTransition) strip.setTransition(transitionDelay);
+          break;
+        case BINCMD_GLOBAL_PRESET:
+          preset = MIN(value, 250);
+          break;
+        default: continue;
+      }
+      if (bri && !onBefore) { // unfreeze all segments when turning on (same as JSON API)
+        for (size_t s = 0; s < strip.getSegmentsNum(); s++) strip.getSegment(s).freeze = false;
+        if (realtimeMode && !realtimeOverride && useMainSegmentOnly) strip.getMainSegment().freeze = true; // keep live segment frozen if live
+        onBefore = true;
+      }
+    } else if (op == BINCMD_OP_SEGMENT) {
+      if (id == 255) {
+        for (size_t s = 0; s < strip.getSegmentsNum(); s++) {
+          Segment &sg = strip.getSegment(s);
+          if (sg.isActive() && sg.isSelected()) applySegmentField(sg, field, value);
+        }
+      } else if (id < strip.getSegmentsNum() && strip.getSegment(id).isActive()) {
+        applySegmentField(strip.getSegment(id), field, value);
+      } else continue;
+    } else continue;
+    applied++;
+  }
+  strip.resume();
+
+  queueStateUpdate(callMode); // merged with other API requests, applied once per frame
+  if (preset > 0) applyPreset(preset, callMode);
+  DEBUG_PRINTF("Binary command: %d of %u applied.\n", applied, (len-2)/BINCMD_CMD_SIZE);
+  return applied;
+}
@@ -90,6 +90,9 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   Bus::setCCTBlend(strip.cctBlending);
   strip.setTargetFps(hw_led["fps"]); //NOP if 0, default 42 FPS
   CJSON(useGlobalLedBuffer, hw_led[F("ld")]);
+  #ifdef WLED_ENABLE_RENDER_TASK
+  useGlobalLedBuffer = true; // back buffer of render task (see WLED::renderTask())
+  #endif
 
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
@@ -384,6 +387,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_sync = interfaces["sync"];
   CJSON(udpPort, if_sync[F("port0")]); // 21324
   CJSON(udpPort2, if_sync[F("port1")]); // 65506
+  CJSON(udpMulticast, if_sync[F("mc")]);
 
   JsonObject if_sync_recv = if_sync["recv"];
   CJSON(receiveNotificationBrightness, if_sync_recv["bri"]);
@@ -406,10 +410,15 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(syncGroups, if_sync_send["grp"]);
   if (if_sync_send[F("twice")]) udpNumRetries = 1; // import setting from 0.13 and earlier
   CJSON(udpNumRetries, if_sync_send["ret"]);
+  CJSON(udpDeltaSync, if_sync_send[F("delta")]);
 
   JsonObject if_nodes = interfaces["nodes"];
   CJSON(nodeListEnabled, if_nodes[F("list")]);
+  CJSON(nodeListSize, if_nodes[F("max")]);
+  nodeListSize = constrain(nodeListSize, 1, WLED_NODES_LIMIT);
   CJSON(nodeBroadcastEnabled, if_nodes[F("bcast")]);
+  CJSON(clockSyncEnabled, if_nodes[F("clk")]);
+  CJSON(frameLockEnabled, if_nodes[F("flk")]);
 
   JsonObject if_live = interfaces["live"];
   CJSON(receiveDirect, if_live["en"]);
@@ -851,6 +860,7 @@ void serializeConfig() {
   JsonObject if_sync = interfaces.createNestedObject("sync");
   if_sync[F("port0")] = udpPort;
   if_sync[F("port1")] = udpPort2;
+  if_sync[F("mc")] = udpMulticast;
 
   JsonObject if_sync_recv = if_sync.createNestedObject("recv");
   if_sync_recv["bri"] = receiveNotificationBrightness;
@@ -868,10 +878,14 @@ void serializeConfig() {
   if_sync_send["macro"] = notifyMacro;
   if_sync_send["grp"] = syncGroups;
   if_sync_send["ret"] = udpNumRetries;
+  if_sync_send[F("delta")] = udpDeltaSync;
 
   JsonObject if_nodes = interfaces.createNestedObject("nodes");
   if_nodes[F("list")] = nodeListEnabled;
+  if_nodes[F("max")] = nodeListSize;
   if_nodes[F("bcast")] = nodeBroadcastEnabled;
+  if_nodes[F("clk")] = clockSyncEnabled;
+  if_nodes[F("flk")] = frameLockEnabled;
 
   JsonObject if_live = interfaces.createNestedObject("live");
   if_live["en"] = receiveDirect;
@@ -0,0 +1,236 @@
+#include "wled.h"
+
+/*
+ * Cluster clock sync: NTP-style request/response between WLED nodes on the supplemental UDP port (udpPort2)
+ * that locks strip.timebase of all participating nodes to the one of a leader, so effects stay frame aligned.
+ * The leader is the node with the lowest IP address in the node list that has clock sync enabled (for nodes of a
+ * /24 subnet the one with the lowest unit ID).
+ *
+ * request  (node -> peer): 255, 2, t1 (local us of requesting node), late frames, missed frames (see framelock.cpp)
+ * response (peer -> node): 255, 3, t1 (echoed), t2 (peer effect time in us at receive), t3 (at send)
+ * int64 little endian. Effect time is millis() + strip.timebase (in us with sub-millisecond part).
+ * offset = ((t2-t1) + (t3-t4)) / 2, round trip = (t4-t1) - (t3-t2), t4 = local us at receive
+ *
+ * Of the last CLOCK_SYNC_SAMPLES leader samples the one with the lowest round trip is used (least affected by
+ * queuing in the network stack and loop latency), extrapolated with the drift estimated from all samples.
+ * Other peers are measured round-robin for information (round trip, offset, jitter in /json/nodes), this is
+ * also done without clock sync enabled (requests are answered by all nodes with the node list enabled).
+ */
+
+#define CLOCK_SYNC_REQ_SIZE  18 // 10 + frame lock statistics (late, missed frames)
+#define CLOCK_SYNC_RESP_SIZE 26
+#define CLOCK_WRAP_US        (0x100000000LL * 1000) // effect time in us wraps with its 32 bit ms part
+
+struct ClockSample {
+  int64_t local;  // local us at receive
+  int64_t offset; // peer effect time minus local us
+  int32_t delay;  // round trip us
+};
+
+static ClockSample clockSamples[CLOCK_SYNC_SAMPLES];
+static uint8_t  clockSampleCount = 0, clockSampleIdx = 0;
+static IPAddress clockLeader((uint32_t)0); // leader, 0.0.0.0 if we are leader (or no peers)
+static size_t   clockNextPeer = 0;      // round-robin measurement of other peers (node list position)
+static uint32_t clockLastRequest = 0;
+static uint32_t clockLastLeaderSample = 0;
+static float    clockDrift = 0.0f;      // local oscillator vs. leader (ppm)
+
+// local time in us, millis() is this / 1000 (mod 2^32)
+int64_t localMicros() {
+  #ifdef ARDUINO_ARCH_ESP32
+  return esp_timer_get_time();
+  #else
+  return micros64();
+  #endif
+}
+
+static int64_t effectMicros(int64_t local) {
+  return local + (int64_t)strip.timebase * 1000; // ms part equals millis() + strip.timebase (mod 2^32)
+}
+
+// effect time in us, same on all nodes once synced (wraps with the 32 bit ms effect time)
+int64_t clusterMicros(int64_t local) {
+  return effectMicros(local) % CLOCK_WRAP_US;
+}
+
+// difference a - b of effect times in us modulo the wrap (-2^31 ms .. 2^31 ms)
+int64_t clusterMicrosDiff(int64_t a, int64_t b) {
+  int64_t d = (a - b) % CLOCK_WRAP_US;
+  if (d >= CLOCK_WRAP_US / 2) d -= CLOCK_WRAP_US;
+  else if (d < -CLOCK_WRAP_US / 2) d += CLOCK_WRAP_US;
+  return d;
+}
+
+static void putI64(uint8_t *p, int64_t v) {
+  for (size_t i = 0; i < 8; i++) p[i] = (uint64_t)v >> (8*i);
+}
+
+static int64_t getI64(const uint8_t *p) {
+  uint64_t v = 0;
+  for (size_t i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8*i);
+  return v;
+}
+
+static void sendClockRequest(IPAddress ip) {
+  uint8_t data[CLOCK_SYNC_REQ_SIZE] = {255, 2};
+  for (size_t i = 0; i < 4; i++) {
+    data[10+i] = frameLockLate   >> (8*i);
+    data[14+i] = frameLockMissed >> (8*i);
+  }
+  putI64(data + 2, localMicros());
+  notifier2Udp.beginPacket(ip, udpPort2);
+  notifier2Udp.write(data, sizeof(data));
+  notifier2Udp.endPacket();
+}
+
+// IP address order (octet by octet, i.e. unit ID order within a /24 subnet)
+static bool ipLess(IPAddress a, IPAddress b) {
+  for (size_t i = 0; i < 4; i++) if (a[i] != b[i]) return a[i] < b[i];
+  return false;
+}
+
+static IPAddress electClockLeader() {
+  IPAddress self = Network.localIP();
+  IPAddress leader = self;
+  for (const NodeStruct &node : Nodes) {
+    if (node.clockSync && millis() - node.lastSeen < 90000 && ipLess(node.ip, leader)) leader = node.ip;
+  }
+  return uint32_t(leader) == uint32_t(self) ? IPAddress((uint32_t)0) : leader;
+}
+
+// floor(us / 1000) for negative values too
+static uint32_t microsToTimebase(int64_t us) {
+  return (uint32_t)(us >= 0 ? us / 1000 : -((-us + 999) / 1000));
+}
+
+static void disciplineTimebase(int64_t now) {
+  // sample with lowest round trip
+  const ClockSample *best = &clockSamples[0];
+  for (size_t i = 1; i < clockSampleCount; i++) if (clockSamples[i].delay < best->delay) best = &clockSamples[i];
+
+  // drift: least squares slope of offset over local time
+  if (clockSampleCount > 2) {
+    double mx = 0, my = 0, sxx = 0, sxy = 0;
+    for (size_t i = 0; i < clockSampleCount; i++) { mx += clockSamples[i].local - best->local; my += clockSamples[i].offset - best->offset; }
+    mx /= clockSampleCount; my /= clockSampleCount;
+    for (size_t i = 0; i < clockSampleCount; i++) {
+      double dx = clockSamples[i].local - best->local - mx, dy = clockSamples[i].offset - best->offset - my;
+      sxx += dx*dx; sxy += dx*dy;
+    }
+    if (sxx > 0) clockDrift = constrain(sxy / sxx * 1e6, -CLOCK_SYNC_MAX_DRIFT, CLOCK_SYNC_MAX_DRIFT);
+  }
+
+  int64_t offset = best->offset + (int64_t)(clockDrift * (now - best->local) / 1e6);
+  uint32_t tb = microsToTimebase(offset);
+  if (tb != strip.timebase) {
+    DEBUG_PRINTF("Clock sync: timebase %+d ms\n", (int32_t)(tb - strip.timebase));
+    strip.timebase = tb;
+  }
+}
+
+// handles clock sync request or response on supplemental UDP port
+void handleClockSyncPacket(const uint8_t *data, size_t len, IPAddress ip, uint16_t port) {
+  int64_t rx = localMicros();
+  if (!nodeListEnabled) return; // requests are also used to measure round trip times of the node list
+
+  if (data[1] == 2 && len >= 10) {
+    NodeStruct *node = Nodes.find(ip);
+    if (node && len >= CLOCK_SYNC_REQ_SIZE) {
+      node->flkLate   = data[10] | data[11] << 8 | data[12] << 16 | (uint32_t)data[13] << 24;
+      node->flkMissed = data[14] | data[15] << 8 | data[16] << 16 | (uint32_t)data[17] << 24;
+    }
+    uint8_t resp[CLOCK_SYNC_RESP_SIZE] = {255, 3};
+    memcpy(resp + 2, data + 2, 8);
+    putI64(resp + 10, effectMicros(rx));
+    notifier2Udp.beginPacket(ip, port);
+    putI64(resp + 18, effectMicros(localMicros()));
+    notifier2Udp.write(resp, sizeof(resp));
+    notifier2Udp.endPacket();
+    return;
+  }
+  if (data[1] != 3 || len < CLOCK_SYNC_RESP_SIZE) return;
+
+  int64_t t1 = getI64(data + 2), t2 = getI64(data + 10), t3 = getI64(data + 18);
+  int64_t delay = (rx - t1) - (t3 - t2);
+  if (rx - t1 > CLOCK_SYNC_INTERVAL * 2000LL || delay < 0) return; // stale or bogus
+  int64_t offset = ((t2 - t1) + (t3 - rx)) / 2; // peer effect time minus local us
+
+  NodeStruct *node = Nodes.find(ip);
+  if (node) {
+    int64_t ofs = clusterMicrosDiff(offset, (int64_t)strip.timebase * 1000); // relative to our effect time (peer may be across the wrap)
+    ofs = constrain(ofs, (int64_t)INT32_MIN, (int64_t)INT32_MAX);
+    int64_t dev = ofs > node->clkOffset ? ofs - node->clkOffset : node->clkOffset - ofs;
+    if (node->clkSamples) node->clkJitter = MIN((7 * (int64_t)node->clkJitter + dev) / 8, (int64_t)UINT32_MAX);
+    node->clkOffset = ofs;
+    node->rtt = MAX(delay, 1LL);
+    if (node->clkSamples < 255) node->clkSamples++;
+  }
+
+  if (!clockSyncEnabled || uint32_t(clockLeader) == 0 || uint32_t(ip) != uint32_t(clockLeader)) return;
+  if (clockSampleCount) { // leader timebase was changed (e.g. by API), old samples are useless
+    int64_t last = clockSamples[(clockSampleIdx + CLOCK_SYNC_SAMPLES - 1) % CLOCK_SYNC_SAMPLES].offset;
+    if (offset - last > 50000 || last - offset > 50000) clockSampleCount = clockSampleIdx = 0;
+  }
+  clockSamples[clockSampleIdx] = {rx, offset, (int32_t)delay};
+  clockSampleIdx = (clockSampleIdx + 1) % CLOCK_SYNC_SAMPLES;
+  if (clockSampleCount < CLOCK_SYNC_SAMPLES) clockSampleCount++;
+  clockLastLeaderSample = millis();
+  disciplineTimebase(rx);
+}
+
+// IP address of the leader, 0.0.0.0 if this node is leader
+IPAddress getClockLeader() {
+  return clockLeader;
+}
+
+// true if other nodes follow this node's timebase
+bool clockSyncLeader() {
+  return clockSyncEnabled && udp2Connected && nodeListEnabled && uint32_t(clockLeader) == 0;
+}
+
+// true if strip.timebase follows a leader (other timebase sources should be ignored)
+bool clockSyncLocked() {
+  return clockSyncEnabled && uint32_t(clockLeader) && clockSampleCount && millis() - clockLastLeaderSample < CLOCK_SYNC_TIMEOUT;
+}
+
+void handleClockSync() {
+  if (!udp2Connected || !nodeListEnabled) return;
+  if (millis() - clockLastRequest < CLOCK_SYNC_INTERVAL) return;
+  clockLastRequest = millis();
+  if (!clockSyncEnabled) {
+    clockLeader = (uint32_t)0;
+    clockSampleCount = 0;
+  } else {
+    IPAddress leader = electClockLeader();
+    if (uint32_t(leader) != uint32_t(clockLeader)) {
+      DEBUG_PRINT(F("Clock sync leader: ")); DEBUG_PRINTLN(leader);
+      clockLeader = leader;
+      clockSampleCount = clockSampleIdx = 0;
+      clockDrift = 0.0f;
+      clockLastLeaderSample = millis();
+    }
+    if (uint32_t(clockLeader)) {
+      NodeStruct *node = Nodes.find(clockLeader);
+      if (!node) return;
+      if (millis() - clockLastLeaderSample > CLOCK_SYNC_TIMEOUT) {
+        node->clockSync = false; // not responding, elect another leader (set again by its info broadcast)
+        return;
+      }
+      sendClockRequest(node->ip);
+    }
+  }
+
+  // measure one other peer (round trip for node list, offset for clock sync)
+  if (Nodes.empty()) return;
+  if (++clockNextPeer >= Nodes.size()) clockNextPeer = 0;
+  NodeStruct &peer = Nodes[clockNextPeer];
+  if (uint32_t(peer.ip) != uint32_t(clockLeader) && peer.ip[0] != 0) sendClockRequest(peer.ip);
+}
+
+void serializeClockSync(JsonObject root) {
+  JsonObject clk = root.createNestedObject(F("clk"));
+  clk[F("en")] = clockSyncEnabled;
+  clk[F("ldr")] = uint32_t(clockLeader) ? clockLeader[3] : Network.localIP()[3]; // unit ID
+  clk[F("lock")] = clockSyncLocked();
+  clk[F("ppm")] = clockDrift;
+}
@@ -196,6 +196,7 @@
 #define REALTIME_MODE_ARTNET      6
 #define REALTIME_MODE_TPM2NET     7
 #define REALTIME_MODE_DDP         8
+#define REALTIME_MODE_FSEQ        9
 
 //realtime override modes
 #define REALTIME_OVERRIDE_NONE    0
@@ -276,6 +277,37 @@
 #define COL_ORDER_MAX             5
 
 
+// Binary control protocol (see bincmd.cpp)
+#define BINCMD_MAGIC             0xBC
+#define BINCMD_VERSION           1
+#define BINCMD_OP_GLOBAL         1
+#define BINCMD_OP_SEGMENT        2
+// global fields
+#define BINCMD_GLOBAL_ON         0  // 0 off, 1 on, 2 toggle
+#define BINCMD_GLOBAL_BRI        1
+#define BINCMD_GLOBAL_TRANSITION 2  // in 100ms
+#define BINCMD_GLOBAL_PRESET     3  // apply preset
+// segment fields
+#define BINCMD_SEG_ON            0
+#define BINCMD_SEG_OPACITY       1
+#define BINCMD_SEG_MODE          2
+#define BINCMD_SEG_SPEED         3
+#define BINCMD_SEG_INTENSITY     4
+#define BINCMD_SEG_PALETTE       5
+#define BINCMD_SEG_COLOR0        6  // 0xWWRRGGBB
+#define BINCMD_SEG_COLOR1        7
+#define BINCMD_SEG_COLOR2        8
+#define BINCMD_SEG_CCT           9
+#define BINCMD_SEG_CUSTOM1      10
+#define BINCMD_SEG_CUSTOM2      11
+#define BINCMD_SEG_CUSTOM3      12
+#define BINCMD_SEG_SELECTED     13
+#define BINCMD_SEG_FREEZE       14
+// acknowledgement (WS): BINCMD_MAGIC, BINCMD_VERSION, status, number of applied commands
+#define BINCMD_ACK_OK            0
+#define BINCMD_ACK_INVALID       1  // not a valid packet
+#define BINCMD_ACK_BUSY          2  // not applied (render task busy or too many requests queued), can be sent again
+
 //Button type
 #define BTN_TYPE_NONE             0
 #define BTN_TYPE_RESERVED         1
@@ -333,6 +365,42 @@
 
 //Playlist option byte
 #define PL_OPTION_SHUFFLE      0x01
+#define PL_OPTION_SHUFFLED     0x80 // internal: next iteration was shuffled ahead of its start
+
+#define PLAYLIST_MAX_DEPTH        4 // nested playlists (including the loaded one)
+#define PLAYLIST_PREFETCH_TIME 1000 // ms, next preset is parsed this long before it is due
+#define PLAYLIST_SWITCH_WAIT      5 // ms, loop waits for the exact start of an entry due within this time
+#ifdef ESP8266
+  #define PLAYLIST_MAX_ENTRIES  256
+#else
+  #define PLAYLIST_MAX_ENTRIES 1024
+#endif
+
+//Cue list (show file) sequencer
+#define CUE_VERSION               1
+#define CUE_MAX_PACKET    (2+7*64) // binary command packet of a cue, up to 64 commands
+#define CUE_SWITCH_WAIT           5 // ms, loop waits for the exact time of a cue due within this time
+
+//Frame sequence (.fseq, WLED frame file) playback
+#define FSEQ_WFR_VERSION          1
+#define FSEQ_READ_AHEAD           8 // max. frames read ahead
+#define FSEQ_WFR_KEY    0x80000000UL // key frame flag in frame size
+#ifndef FSEQ_BUFFER_SIZE
+  #ifdef ESP8266
+    #define FSEQ_BUFFER_SIZE   6144 // bytes for frames read ahead (at least one frame is buffered)
+  #else
+    #define FSEQ_BUFFER_SIZE  32768
+  #endif
+#endif
+
+//Frame recorder
+#ifndef REC_BUFFER_SIZE
+  #ifdef ESP8266
+    #define REC_BUFFER_SIZE    4096 // encoded frames not yet written to filesystem (at least 2 worst case frames)
+  #else
+    #define REC_BUFFER_SIZE   32768
+  #endif
+#endif
 
 // Segment capability byte
 #define SEG_CAPABILITY_RGB     0x01
@@ -344,6 +412,7 @@
 #define ERR_DENIED       1  // Permission denied
 #define ERR_EEP_COMMIT   2  // Could not commit to EEPROM (wrong flash layout?) OBSOLETE
 #define ERR_NOBUF        3  // JSON buffer was not released in time, request cannot be handled at this time
+#define ERR_BUSY         4  // Render task did not finish its frame in time (or state was in use), request was not applied
 #define ERR_JSON         9  // JSON parsing failed (input too large?)
 #define ERR_FS_BEGIN    10  // Could not init filesystem (no partition?)
 #define ERR_FS_QUOTA    11  // The FS is full or the maximum file size is reached
@@ -445,22 +514,130 @@
 
 #define TOUCH_THRESHOLD 32 // limit to recognize a touch, higher value means more sensitive
 
+// JSON API paths (subJson in serveJson())
+#define JSON_PATH_STATE      1
+#define JSON_PATH_INFO       2
+#define JSON_PATH_STATE_INFO 3
+#define JSON_PATH_NODES      4
+#define JSON_PATH_PALETTES   5
+#define JSON_PATH_FXDATA     6
+#define JSON_PATH_NETWORKS   7
+#define JSON_PATH_EFFECTS    8
+
 // Size of buffer for API JSON object (increase for more segments)
+#ifndef JSON_BUFFER_SIZE
+  #ifdef ESP8266
+    #define JSON_BUFFER_SIZE 10240
+  #else
+    #define JSON_BUFFER_SIZE 24576
+  #endif
+#endif
+
+// Max. time to wait for state lock (held while state is applied or serialized) in ms
+#define STATE_LOCK_TIMEOUT 100
+
+// Max. time to wait for the frame being rendered (WS2812FX::waitUntilIdle()) in ms, from main loop and from
+// network callbacks (async TCP/UDP tasks must not be blocked, the request fails with ERR_BUSY or is retried)
+#define STRIP_IDLE_TIMEOUT       250
+#define STRIP_IDLE_TIMEOUT_ASYNC 25
+
+// Initial size of document used for a single piece (top level state, segment, info) of streamed JSON responses
+// (will be doubled up to JSON_BUFFER_SIZE if it is not enough), a segment needs about 500 bytes (300 bytes of text)
+#define JSON_STREAM_PIECE_SIZE 768
+
+// Number of palettes in a single page of /json/palx response
 #ifdef ESP8266
-  #define JSON_BUFFER_SIZE 10240
+  #define JSON_PALETTES_PER_PAGE 5
 #else
-  #define JSON_BUFFER_SIZE 24576
+  #define JSON_PALETTES_PER_PAGE 8
+#endif
+
+// Cluster clock sync (see clocksync.cpp): request interval (ms), offset filter window, time without
+// response from leader after which another leader is elected (ms), max. assumed oscillator drift (ppm)
+#define CLOCK_SYNC_INTERVAL  1000
+#define CLOCK_SYNC_SAMPLES   8
+#define CLOCK_SYNC_TIMEOUT   5000
+#define CLOCK_SYNC_MAX_DRIFT 200
+
+// Frame-locked rendering (see framelock.cpp): time without frame tick from leader after which a node
+// renders unlocked (ms), lateness counted as late frame (us), render lead time added to measured render time (us)
+#define FRAME_LOCK_TIMEOUT   1000
+#define FRAME_LOCK_LATE_US   1000
+#define FRAME_LOCK_MARGIN_US 1000
+
+// Multicast transport for sync (see udp.cpp): groups are 239.255.87.x (87 = 'W'), sync group n (1-8) uses x = n
+#define MULTICAST_NODES_GROUP 100 // node info, frame ticks
+#define MULTICAST_DDP_GROUP   200 // DDP realtime receive
+
+// Indexed preset storage (see presetstore.cpp), presets.json is only used for import/export
+#define PRESETS_STORE_FILE "/presets.wps"
+
+// Recently applied presets kept in RAM as parsed JSON documents (PRESET_CACHE_ENTRIES must be at least 1),
+// presets that need more than PRESET_CACHE_MAX_SIZE bytes of JSON document memory are not cached
+#ifndef PRESET_CACHE_ENTRIES
+  #ifdef ESP8266
+    #define PRESET_CACHE_ENTRIES 2
+  #else
+    #define PRESET_CACHE_ENTRIES 8
+  #endif
+#endif
+#ifndef PRESET_CACHE_MAX_SIZE
+  #ifdef ESP8266
+    #define PRESET_CACHE_MAX_SIZE 1024
+  #else
+    #define PRESET_CACHE_MAX_SIZE 4096
+  #endif
+#endif
+
+// Websocket clients that are tracked (receive state updates, can receive delta updates with only changed
+// state/info fields, see sendDataWs()), this is also the max. number of connected clients
+// and number of tracked top level state and info fields (fields beyond that are always sent)
+#ifndef WS_MAX_DELTA_CLIENTS
+  #ifdef ESP8266
+    #define WS_MAX_DELTA_CLIENTS 3
+  #else
+    #define WS_MAX_DELTA_CLIENTS 8
+  #endif
+#endif
+#define WS_DELTA_STATE_FIELDS 24
+#define WS_DELTA_INFO_FIELDS  48
+
+// Max. size of a WS JSON message that arrives in multiple frames/packets (reassembled per client),
+// number of messages that can be reassembled at the same time and time allowed for all parts to arrive
+#ifndef WS_MAX_JSON_SIZE
+  #ifdef ESP8266
+    #define WS_MAX_JSON_SIZE 4096
+  #else
+    #define WS_MAX_JSON_SIZE 16384
+  #endif
+#endif
+#define WS_REASSEMBLY_SLOTS   2
+#define WS_REASSEMBLY_TIMEOUT 2000 // ms
+
+// Number of JSON buffers: global doc + additional buffers allocated on first use (in PSRAM if available)
+// used for concurrent serialization of responses (see requestJSONBuffer())
+#ifndef WLED_JSON_POOL_SIZE
+  #ifdef ESP8266
+    #define WLED_JSON_POOL_SIZE 1
+  #elif defined(BOARD_HAS_PSRAM) && defined(WLED_USE_PSRAM)
+    #define WLED_JSON_POOL_SIZE 4
+  #else
+    #define WLED_JSON_POOL_SIZE 2
+  #endif
 #endif
 
 //#define MIN_HEAP_SIZE (8k for AsyncWebServer)
 #define MIN_HEAP_SIZE 8192
 
-// Maximum size of node map (list of other WLED instances)
+// Default and maximum size of node list (list of other WLED instances, see nodes.cpp)
 #ifdef ESP8266
   #define WLED_MAX_NODES 24
+  #define WLED_NODES_LIMIT 64
 #else
   #define WLED_MAX_NODES 150
+  #define WLED_NODES_LIMIT 1024
 #endif
+#define NODE_TIMEOUT 300000 // ms without info packet after which a node is removed
 
 //this is merely a default now and can be changed at runtime
 #ifndef LEDPIN
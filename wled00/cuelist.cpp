@@ -0,0 +1,173 @@
+#include "wled.h"
+
+/*
+ * Cue list sequencer: plays a show file of timestamped binary commands (see bincmd.cpp) against wall clock time (toki).
+ * Controllers with the same file and start time (NTP) play the show in lockstep without a live network feed.
+ *
+ * file: 'W', 'C', 'Q', CUE_VERSION, show length (uint32 ms, loop point, 0 = time of last cue), cue, cue, ...
+ * cue:  show time (uint32 ms, ascending), packet size (uint16), binary command packet (BINCMD_MAGIC, ...)
+ * little endian. See tools/wled_bincmd.py for an encoder.
+ *
+ * JSON API (state): "cue":{"f":"/show.cue","at":start (unix s, default now),"ms":start ms,"loop":bool,"seek":ms,"stop":true}
+ * A looping show started "at":0 plays in lockstep on all controllers with NTP, also after a reboot.
+ * Cues that were due before the current position (start in the past, seek) are applied in order when starting.
+ */
+
+#define CUE_HEADER_SIZE     8
+#define CUE_ENTRY_SIZE      6
+#define CUE_MAX_PER_LOOP   32 // cues applied in one loop when catching up
+
+static File       cueFile;
+static uint8_t   *cueBuffer = nullptr; // packet of the next cue, allocated while playing
+static uint16_t   cueSize = 0;         // size of next cue packet, 0 at end of file
+static uint32_t   cueTime = 0;         // show time of next cue (ms)
+static uint32_t   cueLength = 0;       // loop point (ms)
+static uint32_t   cueIteration = 0;
+static int64_t    cueLastPos = 0;
+static bool       cueLoop = false;
+static Toki::Time cueStart = {0, 0};   // wall clock time of show start
+static char       cueFileName[33] = "";
+
+static uint32_t getU32(const uint8_t *p) {
+  return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// reads next cue, false at end of file
+static bool readCue() {
+  uint8_t entry[CUE_ENTRY_SIZE];
+  cueSize = 0;
+  if (cueFile.read(entry, sizeof(entry)) != sizeof(entry)) return false;
+  uint16_t size = entry[4] | entry[5] << 8;
+  if (size < 2 || size > CUE_MAX_PACKET || cueFile.read(cueBuffer, size) != size) return false;
+  cueTime = getU32(entry);
+  cueSize = size;
+  return true;
+}
+
+static void rewindCues() {
+  cueFile.seek(CUE_HEADER_SIZE);
+  readCue();
+  cueLastPos = 0;
+}
+
+// show time in ms (negative before start)
+static int64_t cuePosition() {
+  Toki::Time now = toki.getTime();
+  return ((int64_t)now.sec - cueStart.sec) * 1000 + now.ms - cueStart.ms;
+}
+
+void stopCueList() {
+  if (!cueBuffer) return;
+  cueFile.close();
+  free(cueBuffer);
+  cueBuffer = nullptr;
+  cueSize = 0;
+  cueFileName[0] = '\0';
+  DEBUG_PRINTLN(F("Cue list stopped."));
+}
+
+bool startCueList(const char *name, Toki::Time start, bool loop) {
+  stopCueList();
+  File f = WLED_FS.open(name, "r");
+  if (!f) return false;
+
+  // check header and that cue times are ascending, the last one is the default loop point
+  uint8_t header[CUE_HEADER_SIZE], entry[CUE_ENTRY_SIZE];
+  bool valid = f.read(header, sizeof(header)) == sizeof(header) && header[0] == 'W' && header[1] == 'C' && header[2] == 'Q' && header[3] == CUE_VERSION;
+  uint32_t last = 0;
+  while (valid && f.read(entry, sizeof(entry)) == sizeof(entry)) {
+    uint32_t t = getU32(entry);
+    uint16_t size = entry[4] | entry[5] << 8;
+    valid = t >= last && size >= 2 && size <= CUE_MAX_PACKET && f.position() + size <= f.size() && f.seek(f.position() + size);
+    last = t;
+  }
+  if (valid) cueBuffer = (uint8_t*)malloc(CUE_MAX_PACKET);
+  if (!cueBuffer) {
+    DEBUG_PRINTLN(F("Cue list invalid."));
+    f.close();
+    return false;
+  }
+
+  if (currentPlaylist >= 0) unloadPlaylist(); // entries would override cues
+  cueFile = f;
+  cueLength = getU32(header + 4);
+  if (!cueLength) cueLength = last;
+  cueLoop = loop && cueLength;
+  cueStart = start;
+  cueIteration = 0;
+  strlcpy(cueFileName, name, sizeof(cueFileName));
+  rewindCues();
+  DEBUG_PRINT(F("Cue list started: ")); DEBUG_PRINTLN(cueFileName);
+  return true;
+}
+
+void seekCueList(uint32_t ms) {
+  if (!cueBuffer) return;
+  cueStart = toki.getTime();
+  toki.adjust(cueStart, -(int32_t)MIN(ms, (uint32_t)INT32_MAX));
+  cueIteration = cueLoop ? ms / cueLength : 0;
+  rewindCues(); // cues up to the new position are applied again
+}
+
+void handleCueList() {
+  if (!cueBuffer) return;
+  int64_t pos = cuePosition();
+  if (pos < 0) return; // show starts later
+
+  if (cueLoop) {
+    uint32_t iteration = pos / cueLength;
+    pos %= cueLength;
+    if (iteration != cueIteration) {
+      cueIteration = iteration;
+      rewindCues();
+    }
+  }
+  if (pos < cueLastPos) rewindCues(); // wall clock was set back
+  cueLastPos = pos;
+
+  if (!cueSize) {
+    if (!cueLoop) stopCueList(); // all cues applied
+    return;
+  }
+  int64_t wait = cueTime - pos;
+  if (wait > CUE_SWITCH_WAIT) return;
+  if (wait > 0) {
+    waitUntilMillis(millis() + wait);
+    pos += wait;
+  }
+
+  // apply all cues that are due (several if the show was started in the past or seeked)
+  // next cue is read right after applying one, so a cue is never applied twice (remaining ones follow in next loop)
+  size_t n = 0;
+  do {
+    handleBinaryCommand(cueBuffer, cueSize, CALL_MODE_NO_NOTIFY); // other controllers play the file themselves
+  } while (readCue() && cueTime <= pos && ++n < CUE_MAX_PER_LOOP);
+}
+
+void deserializeCueList(JsonObject cue) {
+  if (cue[F("stop")]) {
+    stopCueList();
+    return;
+  }
+  const char *name = cue["f"];
+  if (name) {
+    Toki::Time start = toki.getTime();
+    if (!cue["at"].isNull()) start = {cue["at"].as<uint32_t>(), (uint16_t)MIN(cue["ms"] | 0, 999)};
+    if (!startCueList(name, start, cue[F("loop")])) errorFlag = ERR_FS_GENERAL;
+  } else if (!cue[F("loop")].isNull()) {
+    cueLoop = cue[F("loop")] && cueLength;
+  }
+  if (!cue[F("seek")].isNull()) seekCueList(cue[F("seek")]);
+}
+
+void serializeCueList(JsonObject root) {
+  JsonObject cue = root.createNestedObject(F("cue"));
+  cue["on"] = cueBuffer != nullptr;
+  if (!cueBuffer) return;
+  int64_t pos = cuePosition();
+  if (cueLoop && pos > 0) pos %= cueLength;
+  cue["f"] = cueFileName;
+  cue[F("pos")] = (long)pos;
+  cue[F("len")] = cueLength;
+  cue[F("loop")] = cueLoop;
+}
@@ -23,6 +23,8 @@ var pmt = 1, pmtLS = 0, pmtLast = 0;
 var lastinfo = {};
 var isM = false, mw = 0, mh=0;
 var ws, cpick, ranges, wsRpt=0;
+var wsVer = null, wsState = null; // delta updates: version and merged state
+var ndVer = null, ndList = {}; // node list (by IP) and its version, updated by WS pushes
 var cfg = {
 	theme:{base:"dark", bg:{url:""}, alpha:{bg:0.6,tab:0.8}, color:{bg:""}},
 	comp :{colors:{picker: true, rgb: false, quick: true, hex: false},
@@ -1050,6 +1052,19 @@ function populateNodes(i,n)
 	gId('kn').innerHTML = cn;
 }
 
+// applies (incremental) node list, returns false if an update was missed
+function mergeNodes(n)
+{
+	if (n.inc) {
+		if (n.b !== ndVer) return false;
+		for (let ip of n.rm) delete ndList[ip];
+	} else ndList = {};
+	for (let o of n.nodes) ndList[o.ip] = o;
+	ndVer = n.ndv;
+	n.nodes = Object.values(ndList);
+	return true;
+}
+
 function loadNodes()
 {
 	fetch(getURL('/json/nodes'), {
@@ -1061,6 +1076,7 @@ function loadNodes()
 	})
 	.then((json)=>{
 		clearErrorToast(100);
+		mergeNodes(json);
 		populateNodes(lastinfo, json);
 	})
 	.catch((e)=>{
@@ -1320,11 +1336,24 @@ function makeWS() {
 		if (e.data instanceof ArrayBuffer) return; // liveview packet
 		var json = JSON.parse(e.data);
 		if (json.leds) return; // JSON liveview packet
+		if (json.nd) { // node list changed
+			if (!isNodes) ndVer = null; // list is loaded when shown
+			else if (mergeNodes(json.nd)) populateNodes(lastinfo, json.nd);
+			else loadNodes();
+			return;
+		}
 		clearTimeout(jsonTimeout);
 		jsonTimeout = null;
 		lastUpdate = new Date();
 		clearErrorToast();
 		gId('connind').style.backgroundColor = "var(--c-l)";
+		if (json.d !== undefined) { // delta update, contains only changed fields
+			if (wsVer !== null && json.b !== wsVer || !wsState) { ws.send('{"v":true}'); return; } // missed an update, request full state
+			wsVer = json.d;
+			if (json.info) json.info = mergeFields(lastinfo, json.info);
+			json.state = mergeState(wsState, json.state);
+		} else if (json.state) wsVer = null; // full state
+		if (json.state) wsState = json.state;
 		// json object should contain json.info AND json.state (but may not)
 		var i = json.info;
 		if (i) {
@@ -1345,9 +1374,37 @@ function makeWS() {
 		//ws.send("{'v':true}"); // unnecessary (https://github.com/Aircoookie/WLED/blob/master/wled00/ws.cpp#L18)
 		wsRpt = 0;
 		reqsLegal = true;
+		wsVer = wsState = null;
+		ws.send('{"dt":true}'); // only changed fields will be sent from now on
 	}
 }
 
+// merges changed top level fields into last known object (null means removed)
+function mergeFields(s, d)
+{
+	let m = Object.assign({}, s, d);
+	for (let k in d) if (d[k] === null) delete m[k];
+	return m;
+}
+
+// merges delta update into last known state (segments are matched by id, stop 0 means removed)
+function mergeState(s, d)
+{
+	if (!d) return s;
+	let m = mergeFields(s, d);
+	if (d.seg) {
+		let seg = (s.seg||[]).slice();
+		for (let ds of d.seg) {
+			let k = seg.findIndex((e)=>e.id==ds.id);
+			if (ds.stop === 0 && ds.start === undefined) { if (k>=0) seg.splice(k,1); }
+			else if (k>=0) seg[k] = ds;
+			else seg.push(ds);
+		}
+		m.seg = seg.sort((a,b)=>a.id-b.id);
+	}
+	return m;
+}
+
 function readState(s,command=false)
 {
 	if (!s) return false;
@@ -1426,6 +1483,9 @@ function readState(s,command=false)
 	if (s.error && s.error != 0) {
 	  var errstr = "";
 	  switch (s.error) {
+		case 4:
+		  errstr = "Busy, request was not applied.";
+		  break;
 		case 10:
 		  errstr = "Could not mount filesystem!";
 		  break;
@@ -1799,7 +1859,7 @@ function makePlSel(el, incPl=false)
 	for (var a of arr) {
 		var n = a[1].n ? a[1].n : "Preset " + a[0];
 		if (cfg.comp.idsort) n = a[0] + ' ' + n;
-		if (!incPl && a[1].playlist && a[1].playlist.ps) continue; // remove playlists, sub-playlists not yet supported
+		if (!incPl && a[1].playlist && a[1].playlist.ps) continue; // remove playlists (where sub-playlists are not supported)
 		plSelContent += `<option value="${a[0]}" ${a[0]==el?"selected":""}>${n}</option>`
 	}
 	return plSelContent;
@@ -1987,7 +2047,7 @@ function makePlEntry(p,i)
 	<tr>
 		<td width="80%" colspan=2>
 			<div class="sel-p"><select class="sel-pl" onchange="plePs(${p},${i},this)" data-val="${plJson[p].ps[i]}" data-index="${i}">
-			${makePlSel(plJson[p].ps[i])}
+			${makePlSel(plJson[p].ps[i], true)}
 			</select></div>
 		</td>
 		<td class="c"><button class="btn btn-pl-add" onclick="addPl(${p},${i})"><i class="icons btn-icon">&#xe18a;</i></button></td>
@@ -1998,7 +2058,7 @@ function makePlEntry(p,i)
 		<td class="c">#${i+1}</td>
 	</tr>
 	<tr>
-		<td class="c" width="40%"><input class="segn" type="number" placeholder="Duration" max=6553.0 min=0.2 step=0.1 oninput="pleDur(${p},${i},this)" value="${plJson[p].dur[i]/10.0}">s</td>
+		<td class="c" width="40%"><input class="segn" type="number" placeholder="Duration" max=2147483.0 min=0.2 step=0.1 oninput="pleDur(${p},${i},this)" value="${plJson[p].dur[i]/10.0}">s</td>
 		<td class="c" width="40%"><input class="segn" type="number" placeholder="Transition" max=65.0 min=0.0 step=0.1 oninput="pleTr(${p},${i},this)" value="${plJson[p].transition[i]/10.0}">s</td>
 		<td class="c"><button class="btn btn-pl-del" onclick="delPl(${p},${i})"><i class="icons btn-icon">&#xe037;</i></button></div></td>
 	</tr>
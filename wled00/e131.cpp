@@ -34,7 +34,7 @@ void handleDDPPacket(e131_packet_t* p) {
   uint16_t c = 0;
   if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
 
-  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
+  if (!realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP)) return;
 
   if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
     for (uint16_t i = start; i < stop; i++) {
@@ -146,7 +146,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       if (uni != e131Universe) return;
       if (availDMXLen < 3) return;
 
-      realtimeLock(realtimeTimeoutMs, mde);
+      if (!realtimeLock(realtimeTimeoutMs, mde)) return;
 
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
@@ -159,7 +159,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       if (uni != e131Universe) return;
       if (availDMXLen < 4) return;
 
-      realtimeLock(realtimeTimeoutMs, mde);
+      if (!realtimeLock(realtimeTimeoutMs, mde)) return;
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
       wChannel = (availDMXLen > 4) ? e131_data[dataOffset+4] : 0;
 
@@ -294,7 +294,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
           return;
         }
 
-        realtimeLock(realtimeTimeoutMs, mde);
+        if (!realtimeLock(realtimeTimeoutMs, mde)) return;
         if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
         if (ledsTotal > totalLen) {
@@ -13,6 +13,9 @@ void handleAlexa();
 void onAlexaChange(EspalexaDevice* dev);
 #endif
 
+//bincmd.cpp
+int handleBinaryCommand(const uint8_t *data, size_t len, byte callMode = CALL_MODE_DIRECT_CHANGE);
+
 //button.cpp
 void shortPressAction(uint8_t b=0);
 void longPressAction(uint8_t b=0);
@@ -49,6 +52,17 @@ bool getJsonValue(const JsonVariant& element, DestType& destination, const Defau
 }
 
 
+//clocksync.cpp
+int64_t localMicros();
+int64_t clusterMicros(int64_t local);
+int64_t clusterMicrosDiff(int64_t a, int64_t b);
+void handleClockSyncPacket(const uint8_t *data, size_t len, IPAddress ip, uint16_t port);
+IPAddress getClockLeader();
+bool clockSyncLeader();
+bool clockSyncLocked();
+void handleClockSync();
+void serializeClockSync(JsonObject root);
+
 //colors.cpp
 // similar to NeoPixelBus NeoGammaTableMethod but allows dynamic changes (superseded by NPB::NeoGammaDynamicTableMethod)
 class NeoGammaWLEDMethod {
@@ -93,9 +107,20 @@ bool writeObjectToFileUsingId(const char* file, uint16_t id, JsonDocument* conte
 bool writeObjectToFile(const char* file, const char* key, JsonDocument* content);
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest);
 bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest);
+bool readObjectFromFileAtPos(const char* file, uint16_t id, uint32_t pos, JsonDocument* dest);
+bool indexObjectsInFile(const char* file, void (*cb)(uint16_t id, uint32_t pos));
 void updateFSInfo();
 void closeFile();
 
+//framelock.cpp
+uint32_t frameLockPeriod();
+bool frameLockActive();
+bool frameLockBegin(unsigned long &nowUp);
+bool frameLockShowDue();
+void handleFrameLock();
+void handleFrameLockTick(const uint8_t *data, size_t len, IPAddress ip);
+void serializeFrameLock(JsonObject root);
+
 //hue.cpp
 void handleHue();
 void reconnectHue();
@@ -137,6 +162,19 @@ void decodeIRJson(uint32_t code);
 void initIR();
 void handleIR();
 
+//fseq.cpp
+bool startFseq(const char *name, Toki::Time start, bool loop = false, bool clock = false);
+void stopFseq();
+void handleFseq();
+void deserializeFseq(JsonObject fseq);
+void serializeFseq(JsonObject root);
+
+//recorder.cpp
+void recordFrame();
+void handleRecorder();
+void deserializeRecorder(JsonObject rec);
+void serializeRecorder(JsonObject root);
+
 //json.cpp
 #include "ESPAsyncWebServer.h"
 #include "src/dependencies/json/ArduinoJson-v6.h"
@@ -145,12 +183,50 @@ void handleIR();
 
 bool deserializeSegment(JsonObject elem, byte it, byte presetId = 0);
 bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
-void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
-void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool selectedSegmentsOnly = false);
+void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true, bool includePriority = false);
+void serializeStateHead(JsonObject root, bool forPreset = false, bool includeBri = true); // state without segments
+void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool selectedSegmentsOnly = false, bool includePriority = false);
 void serializeInfo(JsonObject root);
 void serializeModeNames(JsonArray root);
 void serializeModeData(JsonArray root);
+void initJSONCache();
+void invalidateJSONCache();
 void serveJson(AsyncWebServerRequest* request);
+
+// Streams state/info JSON responses piece by piece (top level state, each segment, info, ...)
+// each piece is serialized from a temporary document of JSON_STREAM_PIECE_SIZE (twice that for info) which is
+// doubled up to JSON_BUFFER_SIZE while it overflows, only one such document and its text are allocated at a time
+class JsonStreamer {
+  public:
+    JsonStreamer(uint8_t subJson, uint32_t since = 0);
+    ~JsonStreamer() { freePiece(); }
+    JsonStreamer(const JsonStreamer&) = delete;
+    JsonStreamer& operator=(const JsonStreamer&) = delete;
+
+    size_t read(uint8_t *buf, size_t maxLen); // copies next part of response into buf, returns 0 when finished (or busy)
+    bool   failed() const { return _failed; } // response is incomplete (out of memory)
+    bool   busy() const   { return _busy; }   // last read() stopped because state is locked, try again later
+
+  private:
+    const uint8_t *_seq;   // sequence of steps for requested path
+    uint8_t  _step;
+    uint16_t _idx;         // segment or effect index within step
+    uint8_t  _count;       // number of items already written within step (for separators)
+    bool     _failed;
+    bool     _busy;        // state lock was not available for next piece
+    uint32_t _since;       // node list version (only changed nodes are written)
+    char    *_piece;       // serialized piece in RAM (nullptr if _pgm is used)
+    const char *_pgm;      // or PROGMEM text
+    size_t   _len, _pos;
+
+    bool nextPiece();
+    bool lockState();
+    void freePiece();
+    void abort();
+    void setText(const char *pgm);
+    bool setDoc(JsonDocument &d, const char *prefix, const char *suffix, bool dropLast = false);
+    template<typename F> bool serializePiece(size_t capacity, F fill, const char *prefix, const char *suffix, bool dropLast = false);
+};
 #ifdef WLED_ENABLE_JSONLIVE
 bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient = 0);
 #endif
@@ -166,6 +242,8 @@ void applyFinalBri();
 void applyValuesToSelectedSegs();
 void colorUpdated(byte callMode);
 void stateUpdated(byte callMode);
+void queueStateUpdate(byte callMode, byte presetToRestore = 0);
+void handleStateUpdates();
 void updateInterfaces(uint8_t callMode);
 void handleTransitions();
 void handleNightlight();
@@ -200,6 +278,14 @@ void handleOverlayDraw();
 void _overlayAnalogCountdown();
 void _overlayAnalogClock();
 
+//cuelist.cpp
+bool startCueList(const char *name, Toki::Time start, bool loop = false);
+void stopCueList();
+void seekCueList(uint32_t ms);
+void handleCueList();
+void deserializeCueList(JsonObject cue);
+void serializeCueList(JsonObject root);
+
 //playlist.cpp
 void shufflePlaylist();
 void unloadPlaylist();
@@ -217,6 +303,17 @@ void savePreset(byte index, const char* pname = nullptr, JsonObject saveobj = Js
 inline void saveTemporaryPreset() {savePreset(255);};
 void deletePreset(byte index);
 bool getPresetName(byte index, String& name);
+bool prefetchPreset(byte index, JsonDocument *dest);
+void invalidatePresetCache();
+void importPresets();
+
+//presetstore.cpp
+bool initPresetStore();
+bool presetStoreRead(uint8_t id, JsonDocument* dest);
+bool presetStoreWrite(uint8_t id, JsonDocument* content);
+bool presetStoreImport(const char* file, JsonDocument* buf);
+size_t presetsJsonSize();
+void servePresetsJson(AsyncWebServerRequest* request);
 
 //remote.cpp
 void handleRemote();
@@ -229,12 +326,15 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=tru
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
 uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false);
-void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
+bool realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
 void refreshNodeList();
 void sendSysInfoUDP();
+IPAddress multicastAddress(uint8_t group);
+void updateMulticastGroups(bool reconnect = false);
+bool beginMulticastPacket(WiFiUDP &udp, uint8_t group, uint16_t port);
 
 //network.cpp
 int getSignalQuality(int rssi);
@@ -346,12 +446,23 @@ void sappends(char stype, const char* key, char* val);
 void prepareHostname(char* hostname);
 bool isAsterisksOnly(const char* str, byte maxLen);
 bool requestJSONBufferLock(uint8_t module=255);
+bool tryJSONBufferLock(uint8_t module=255);
 void releaseJSONBufferLock();
+JsonDocument* requestJSONBuffer(uint8_t module=255);
+void releaseJSONBuffer(JsonDocument *pDoc);
+uint8_t getJSONBuffersInUse();
+bool tryStateLock(uint8_t module=255);
+bool requestStateLock(uint8_t module=255);
+void releaseStateLock();
+bool tryJSONRequestLock(uint8_t module);
+bool deferJSONRequest(uint8_t module, const char *payload, size_t len, uint32_t client=0);
+void handleDeferredJSON();
 uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLen);
 uint8_t extractModeSlider(uint8_t mode, uint8_t slider, char *dest, uint8_t maxLen, uint8_t *var = nullptr);
 int16_t extractModeDefaults(uint8_t mode, const char *segVar);
 void checkSettingsPIN(const char *pin);
 uint16_t crc16(const unsigned char* data_p, size_t length);
+void waitUntilMillis(unsigned long ms);
 um_data_t* simulateSound(uint8_t simulationId);
 void enumerateLedmaps();
 uint8_t get_random_wheel_index(uint8_t pos);
@@ -372,6 +483,18 @@ class JSONBufferGuard {
     inline void release() { if (holding_lock) releaseJSONBufferLock(); holding_lock = false; }
 };
 
+// RAII guard class for the state lock (waits up to STATE_LOCK_TIMEOUT)
+class StateLockGuard {
+  bool holding_lock;
+  public:
+    inline StateLockGuard(uint8_t module=255) : holding_lock(requestStateLock(module)) {};
+    inline ~StateLockGuard() { if (holding_lock) releaseStateLock(); };
+    inline StateLockGuard(const StateLockGuard&) = delete; // Noncopyable
+    inline StateLockGuard& operator=(const StateLockGuard&) = delete;
+    inline bool owns_lock() const { return holding_lock; }
+    explicit inline operator bool() const { return owns_lock(); };
+};
+
 #ifdef WLED_ADD_EEPROM_SUPPORT
 //wled_eeprom.cpp
 void applyMacro(byte index);
@@ -411,6 +534,8 @@ bool isIp(String str);
 void createEditHandler(bool enable);
 bool captivePortal(AsyncWebServerRequest *request);
 void initServer();
+bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request, uint16_t eTagSuffix = 0);
+void setStaticContentCacheHeaders(AsyncWebServerResponse *response, uint16_t eTagSuffix = 0);
 void serveIndexOrWelcome(AsyncWebServerRequest *request);
 void serveIndex(AsyncWebServerRequest* request);
 String msgProcessor(const String& var);
@@ -423,6 +548,19 @@ void serveSettingsJS(AsyncWebServerRequest* request);
 void handleWs();
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len);
 void sendDataWs(AsyncWebSocketClient * client = nullptr);
+void handleWsJson(uint32_t clientId, const char *data, size_t len);
+void handleWsBinary(uint32_t clientId, const uint8_t *data, size_t len);
+
+//ws_reassembly.cpp
+typedef struct {
+  uint32_t      client;  // WS client ID (0 = free)
+  char         *data;
+  size_t        len;
+  unsigned long started;
+} WsReassembly;
+WsReassembly* reassembleWs(uint32_t client, uint32_t frame, uint64_t index, uint64_t frameLen, bool final, const uint8_t *data, size_t len, byte &error);
+void freeWsReassembly(WsReassembly &r);
+void freeWsReassembly(uint32_t client);
 
 //xml.cpp
 void XML_response(AsyncWebServerRequest *request, char* dest = nullptr);
@@ -358,6 +358,88 @@ bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest)
   return true;
 }
 
+//read object at a known file position (from indexObjectsInFile()) without searching the file
+//fails if the key of the object is not found right before the position (file was modified since indexing)
+bool readObjectFromFileAtPos(const char* file, uint16_t id, uint32_t pos, JsonDocument* dest)
+{
+  if (doCloseFile) closeFile();
+  #ifdef WLED_DEBUG_FS
+    DEBUGFS_PRINTF("Read from %s id %d at pos %u >>>\n", file, id, pos);
+    uint32_t s = millis();
+  #endif
+  char objKey[10];
+  size_t keyLen = sprintf(objKey, "\"%d\":", id);
+  char buf[10];
+
+  dest->clear();
+  if (pos < keyLen) return false;
+  f = WLED_FS.open(file, "r");
+  if (!f) return false;
+
+  bool found = f.seek(pos - keyLen, SeekSet) && f.readBytes(buf, keyLen) == keyLen && !memcmp(buf, objKey, keyLen) && f.peek() == '{';
+  if (found) deserializeJson(*dest, f);
+  else DEBUGFS_PRINTLN(F("Obj not at pos."));
+
+  f.close();
+  DEBUGFS_PRINTF("Read, took %d ms\n", millis() - s);
+  return found;
+}
+
+//scan file once and call cb() with the file position of every root-level object that has a numeric key
+//(same structural requirements as for writeObjectToFile(), strings are skipped so their content can't match)
+bool indexObjectsInFile(const char* file, void (*cb)(uint16_t id, uint32_t pos))
+{
+  if (doCloseFile) closeFile();
+  #ifdef WLED_DEBUG_FS
+    DEBUGFS_PRINTF("Index %s >>>\n", file);
+    uint32_t s = millis();
+  #endif
+  f = WLED_FS.open(file, "r");
+  if (!f) return false;
+
+  byte buf[FS_BUFSIZE];
+  uint16_t depth = 0;         // num of '{'/'[' minus num of '}'/']'
+  bool inString = false, escaped = false;
+  int32_t key = -1;           // numeric value of current root-level key string, -1 if not numeric
+  uint8_t digits = 0;
+  uint8_t keyState = 0;       // 1: numeric key string closed, 2: followed by ':'
+  uint32_t pos = 0;
+  size_t bufsize;
+
+  while ((bufsize = f.read(buf, FS_BUFSIZE)) > 0) {
+    for (size_t count = 0; count < bufsize; count++, pos++) {
+      byte c = buf[count];
+      if (inString) {
+        if (escaped)        escaped = false;
+        else if (c == '\\') escaped = true;
+        else if (c == '"') {
+          inString = false;
+          keyState = (depth == 1 && key >= 0 && digits) ? 1 : 0;
+        } else if (key >= 0) {
+          key = (c >= '0' && c <= '9' && key < 6553) ? key*10 + (c - '0') : -1;
+          digits++;
+        }
+        continue;
+      }
+      if (c == '"') {
+        inString = true;
+        key = depth == 1 ? 0 : -1;
+        digits = 0;
+        continue;
+      }
+      if (c == ':' && keyState == 1) { keyState = 2; continue; }
+      if (c == '{' && keyState == 2 && depth == 1) cb(key, pos);
+      keyState = 0; // there must not be any characters between key and value object
+      if (c == '{' || c == '[') depth++;
+      else if ((c == '}' || c == ']') && depth) depth--;
+    }
+  }
+
+  f.close();
+  DEBUGFS_PRINTF("Indexed, took %d ms\n", millis() - s);
+  return true;
+}
+
 void updateFSInfo() {
   #ifdef ARDUINO_ARCH_ESP32
     #if WLED_FS == LITTLEFS || ESP_IDF_VERSION_MAJOR >= 4
@@ -0,0 +1,164 @@
+#include "wled.h"
+
+/*
+ * Frame-locked rendering across controllers (requires cluster clock sync, see clocksync.cpp).
+ * Frames are shown on a grid of the synced effect time: frame n is shown at n * period (us).
+ * The clock sync leader defines the period (its target frame time) and announces every frame it shows
+ * on the supplemental UDP port (broadcast or MULTICAST_NODES_GROUP):
+ * 255, 4, frame number (uint32), show time (int64, effect us), period (uint32 us).
+ * Each node renders the next frame ahead of time with the effect time set to the show time of that frame
+ * and calls show() at the scheduled instant, so all controllers output the same frame at the same time.
+ * The lead is the (peak-following) average render time plus a margin. Between render and show the strip is idle
+ * (WS2812FX::service() shows the pending frame when frameLockShowDue()), so waitUntilIdle() does not wait for it.
+ *
+ * late:   frame was shown more than FRAME_LOCK_LATE_US after its scheduled time (render took too long)
+ * missed: leader: frame slot of the grid passed without being rendered (loop/render task was busy)
+ *         follower: frame announced by the leader was not rendered
+ * phase:  follower: effect time at reception of a tick minus its show time, minimum of FRAME_LOCK_PHASE_TICKS ticks
+ *         (transit time if the clocks agree, negative if this node shows frames later than the leader)
+ * Counters are sent to other nodes with clock sync requests and listed in /json/nodes.
+ */
+
+#define FRAME_LOCK_TICK_SIZE   18
+#define FRAME_LOCK_PHASE_TICKS 16
+
+static volatile bool     frameTickPending = false; // leader: frame shown, tick to be sent from loop (UDP is not thread safe)
+static volatile uint32_t frameTickNumber = 0;
+static volatile uint32_t frameTickPeriod = 0;
+static uint32_t frameLeaderPeriod = 0;  // follower: period of leader (us)
+static uint32_t frameLastTick = 0;      // follower: millis() of last tick received
+static volatile bool     frameTickReceived = false; // follower: tick to be checked against rendered frames (render task)
+static volatile uint32_t frameTickReceivedNumber = 0;
+static int32_t  framePhase = 0;         // follower: us, see above
+static int32_t  framePhaseMin = INT32_MAX;
+static uint8_t  framePhaseTicks = 0;
+static uint32_t frameNumber = 0;        // last rendered frame
+static uint32_t frameRendered = 0;      // bit n: frame frameNumber - n was rendered
+static int64_t  frameShowAt = 0;        // local us the rendered frame is to be shown at
+static int64_t  frameRenderStart = 0;
+static bool     frameRenderDone = false; // render time of frame measured
+static uint32_t frameRenderTime = 0;    // us, follows peaks immediately, decays slowly
+
+// frame period (us) of the grid frames are shown on
+uint32_t frameLockPeriod() {
+  if (clockSyncLeader()) return strip.getFrameTime() * 1000;
+  return frameLeaderPeriod;
+}
+
+// true if frames are to be shown on the common grid
+bool frameLockActive() {
+  if (!frameLockEnabled) return false;
+  if (clockSyncLeader()) return true;
+  return clockSyncLocked() && frameLeaderPeriod && millis() - frameLastTick < FRAME_LOCK_TIMEOUT;
+}
+
+// selects the next frame to render, returns false if it has been rendered already
+// sets nowUp to the show time of the frame (ms, same time base as millis())
+bool frameLockBegin(unsigned long &nowUp) {
+  uint32_t period = frameLockPeriod();
+  if (!period) return false;
+  int64_t local = localMicros();
+  int64_t eff = clusterMicros(local);
+  uint32_t lead = MIN(frameRenderTime + FRAME_LOCK_MARGIN_US, period);
+  uint32_t n = (eff + lead) / period;
+  if (n == frameNumber) return false;
+
+  // follower: frame announced by leader (and already due here) was not rendered
+  if (frameTickReceived && (int32_t)(frameNumber - frameTickReceivedNumber) >= 0) {
+    uint32_t age = frameNumber - frameTickReceivedNumber;
+    if (age < 32 && !((frameRendered >> age) & 0x01)) frameLockMissed++;
+    frameTickReceived = false;
+  }
+
+  uint32_t step = n - frameNumber;
+  if (clockSyncLeader() && frameNumber && step > 1 && step < 1000) frameLockMissed += step - 1; // larger steps are timebase changes
+  frameRendered = (step < 32 ? frameRendered << step : 0) | 0x01;
+  frameNumber = n;
+  frameShowAt = local + ((int64_t)n * period - eff);
+  frameRenderStart = local;
+  frameRenderDone = false;
+  nowUp = frameShowAt / 1000;
+  return true;
+}
+
+// true if the rendered frame is to be shown now (waits for the last 2ms), called until it returns true
+bool frameLockShowDue() {
+  int64_t local = localMicros();
+  if (!frameRenderDone) {
+    uint32_t render = local - frameRenderStart;
+    frameRenderTime = render > frameRenderTime ? render : (15 * frameRenderTime + render) / 16;
+    frameRenderDone = true;
+  }
+
+  int64_t wait = frameShowAt - local;
+  if (wait > 2000) return false; // strip is idle until then, service() is called at least every ms (delay() may return up to 1 tick late)
+  if (wait > 0) delayMicroseconds(wait);
+  else if (-wait > FRAME_LOCK_LATE_US) frameLockLate++;
+
+  if (clockSyncLeader()) {
+    frameTickNumber = frameNumber;
+    frameTickPeriod = frameLockPeriod();
+    frameTickPending = true;
+  }
+  return true;
+}
+
+// leader: announce shown frame (called from loop)
+void handleFrameLock() {
+  if (!frameTickPending) return;
+  frameTickPending = false;
+  if (!udp2Connected || Nodes.empty()) return;
+
+  uint8_t data[FRAME_LOCK_TICK_SIZE] = {255, 4};
+  uint32_t n = frameTickNumber, period = frameTickPeriod;
+  int64_t showAt = (int64_t)n * period;
+  for (size_t i = 0; i < 4; i++) {
+    data[2+i]  = n >> (8*i);
+    data[14+i] = period >> (8*i);
+  }
+  for (size_t i = 0; i < 8; i++) data[6+i] = (uint64_t)showAt >> (8*i);
+
+  if (udpMulticast) {
+    beginMulticastPacket(notifier2Udp, MULTICAST_NODES_GROUP, udpPort2);
+  } else {
+    IPAddress broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+    notifier2Udp.beginPacket(broadcastIp, udpPort2);
+  }
+  notifier2Udp.write(data, sizeof(data));
+  notifier2Udp.endPacket();
+}
+
+// follower: frame tick from clock sync leader
+void handleFrameLockTick(const uint8_t *data, size_t len, IPAddress ip) {
+  if (!frameLockEnabled || len < FRAME_LOCK_TICK_SIZE || uint32_t(ip) != uint32_t(getClockLeader())) return;
+  uint32_t n      = data[2] | data[3] << 8 | data[4] << 16 | (uint32_t)data[5] << 24;
+  uint32_t period = data[14] | data[15] << 8 | data[16] << 16 | (uint32_t)data[17] << 24;
+  int64_t showAt = 0;
+  for (size_t i = 0; i < 8; i++) showAt |= (int64_t)data[6+i] << (8*i);
+  if (period < 1000 || period > 1000000 || showAt != (int64_t)n * period) return;
+  frameLeaderPeriod = period;
+  frameLastTick = millis();
+
+  int64_t phase = clusterMicrosDiff(clusterMicros(localMicros()), showAt);
+  framePhaseMin = MIN(framePhaseMin, (int32_t)constrain(phase, (int64_t)INT32_MIN, (int64_t)INT32_MAX));
+  if (++framePhaseTicks >= FRAME_LOCK_PHASE_TICKS) {
+    framePhase = framePhaseMin;
+    framePhaseMin = INT32_MAX;
+    framePhaseTicks = 0;
+  }
+  if (!frameTickReceived) { // checked by frameLockBegin()
+    frameTickReceivedNumber = n;
+    frameTickReceived = true;
+  }
+}
+
+void serializeFrameLock(JsonObject root) {
+  JsonObject flk = root.createNestedObject(F("flk"));
+  flk[F("en")]   = frameLockEnabled;
+  flk["on"]      = frameLockActive();
+  flk[F("per")]  = frameLockPeriod();
+  flk[F("lead")] = MIN(frameRenderTime + FRAME_LOCK_MARGIN_US, frameLockPeriod());
+  flk[F("late")] = frameLockLate;
+  flk[F("miss")] = frameLockMissed;
+  if (!clockSyncLeader()) flk[F("ph")] = framePhase;
+}
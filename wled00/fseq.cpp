@@ -0,0 +1,309 @@
+#include "wled.h"
+#if defined(WLED_USE_SD_MMC)
+  #include "SD_MMC.h"
+  #define FSEQ_SD SD_MMC
+#elif defined(WLED_USE_SD_SPI)
+  #include "SD.h"
+  #define FSEQ_SD SD
+#endif
+
+/*
+ * Playback of prerecorded frame sequences from LittleFS or SD card (usermods/sd_card), as realtime mode.
+ * Effects are suspended while playing, frames are shown at the step time of the file.
+ *
+ * .fseq (xLights/FPP) v1 and v2 without compression (v2 sparse ranges supported): channel data is mapped
+ *       to pixels as RGB triplets like E1.31/DDP (gamma correction and offset of realtime settings apply)
+ * WLED frame file: delta/RLE encoded RGB(W) frames of the whole strip, same operations as live view v3 (see ws.cpp)
+ *   header: 'W', 'F', 'R', FSEQ_WFR_VERSION, channels (uint32), frames (uint32), step (uint16 ms),
+ *           bytes per pixel (3: RGB, 4: RGBW, 0 is RGB), 0
+ *   frame:  size (uint32, bit 31: key frame), operations: 0x00|n-1 n literal pixels (RGB(W)), 0x80|n-1 skip n pixels
+ *           (unchanged), 0xC0|n-1 repeat pixel (RGB(W)) n times. The first frame is a key frame (no skips).
+ * Little endian.
+ *
+ * Frames are read ahead into a ring of decoded frames (as many as fit in FSEQ_BUFFER_SIZE, up to FSEQ_READ_AHEAD)
+ * in the loop after a frame was shown, so reading from flash or SD does not delay the next frame.
+ * The frame shown is the one due at the current time: wall clock (toki, NTP) since the start time, or effect time
+ * of the cluster clock ("clk", see clocksync.cpp), so controllers play the same file in lockstep.
+ * Frames that are late are dropped.
+ *
+ * JSON API (state): "fseq":{"f":"/show.fseq","at":start (unix s, default now),"ms":start ms,"loop":bool,"clk":bool,"stop":true}
+ */
+
+#define FSEQ_HEADER_SIZE    32
+#define FSEQ_MAX_RANGES     16
+#define FSEQ_WFR_HEADER_SIZE 16
+#define FSEQ_MAX_CATCHUP    16 // delta frames decoded per loop when skipping ahead
+
+#if defined(FSEQ_SD)
+bool file_onSD(const char *filepath); // usermods/sd_card
+#endif
+
+struct FseqRange {
+  uint32_t start;  // first channel
+  uint32_t count;
+};
+
+static File       fseqFile;
+static uint8_t   *fseqBuffer = nullptr;  // ring of decoded frames
+static uint8_t    fseqSlots = 0;
+static uint8_t    fseqHead = 0, fseqCount = 0;
+static uint8_t    fseqLastSlot = 0;      // slot of last decoded frame (base of delta frames)
+static uint32_t   fseqHeadSeq = 0;       // sequence number (frames since start, not wrapped) of frame in head slot
+static uint32_t   fseqReadSeq = 0;       // next sequence number to read
+static uint32_t   fseqFileFrame = 0;     // WLED frame file: next frame in file
+static uint32_t   fseqShownSeq = UINT32_MAX;
+static uint32_t   fseqChannels = 0;      // per frame (in file)
+static uint8_t    fseqPixelSize = 3;     // channels per pixel
+static uint32_t   fseqFrames = 0;
+static uint32_t   fseqDataOffset = 0;
+static uint16_t   fseqStep = 0;          // ms per frame
+static bool       fseqDelta = false;     // WLED frame file
+static bool       fseqLoop = false;
+static bool       fseqClock = false;     // use cluster effect time
+static Toki::Time fseqStart = {0, 0};
+static uint32_t   fseqLate = 0;          // frames dropped
+static FseqRange  fseqRanges[FSEQ_MAX_RANGES];
+static uint8_t    fseqRangeCount = 0;
+static char       fseqFileName[65] = "";
+
+static uint32_t getU32(const uint8_t *p) {
+  return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint32_t getU24(const uint8_t *p) {
+  return p[0] | p[1] << 8 | (uint32_t)p[2] << 16;
+}
+
+// ms since start of playback (negative before start)
+static int64_t fseqPosition() {
+  if (fseqClock) return clusterMicros(localMicros()) / 1000;
+  Toki::Time now = toki.getTime();
+  return ((int64_t)now.sec - fseqStart.sec) * 1000 + now.ms - fseqStart.ms;
+}
+
+static bool parseHeader(File &f) {
+  uint8_t h[FSEQ_HEADER_SIZE];
+  size_t len = f.read(h, sizeof(h));
+  uint8_t wfrPixelSize = len >= FSEQ_WFR_HEADER_SIZE && h[14] ? h[14] : 3;
+  if (len >= FSEQ_WFR_HEADER_SIZE && h[0] == 'W' && h[1] == 'F' && h[2] == 'R' && h[3] == FSEQ_WFR_VERSION
+      && (wfrPixelSize == 3 || wfrPixelSize == 4) && getU32(h + 4) % wfrPixelSize == 0) {
+    fseqDelta      = true;
+    fseqPixelSize  = wfrPixelSize;
+    fseqChannels   = getU32(h + 4);
+    fseqFrames     = getU32(h + 8);
+    fseqStep       = h[12] | h[13] << 8;
+    fseqDataOffset = FSEQ_WFR_HEADER_SIZE;
+    fseqRanges[0]  = {0, fseqChannels};
+    fseqRangeCount = 1;
+    return true;
+  }
+  if (len < 28 || h[0] != 'P' || h[1] != 'S' || h[2] != 'E' || h[3] != 'Q') return false;
+  fseqDelta      = false;
+  fseqPixelSize  = 3;
+  fseqDataOffset = h[4] | h[5] << 8;
+  fseqChannels   = getU32(h + 10);
+  fseqFrames     = getU32(h + 14);
+  fseqRanges[0]  = {0, fseqChannels};
+  fseqRangeCount = 1;
+  if (h[7] == 1) {
+    fseqStep = h[18] | h[19] << 8;
+    return true;
+  }
+  if (h[7] != 2 || len < FSEQ_HEADER_SIZE) return false;
+  fseqStep = h[18];
+  if (h[20] & 0x0F) {
+    DEBUG_PRINTLN(F("FSEQ: compressed files are not supported."));
+    return false;
+  }
+  uint8_t ranges = h[22];
+  if (ranges) {
+    if (ranges > FSEQ_MAX_RANGES) return false;
+    size_t blocks = h[21] | (h[20] & 0xF0) << 4;
+    f.seek(FSEQ_HEADER_SIZE + blocks * 8);
+    for (size_t i = 0; i < ranges; i++) {
+      uint8_t r[6];
+      if (f.read(r, sizeof(r)) != sizeof(r)) return false;
+      fseqRanges[i] = {getU24(r), getU24(r + 3)};
+    }
+    fseqRangeCount = ranges;
+  }
+  uint32_t total = 0;
+  for (size_t i = 0; i < fseqRangeCount; i++) total += fseqRanges[i].count;
+  return total <= fseqChannels;
+}
+
+// decodes next frame of WLED frame file into slot (holding a copy of the previous frame)
+static bool decodeFrame(uint8_t *dst) {
+  uint8_t hdr[4];
+  if (fseqFile.read(hdr, sizeof(hdr)) != sizeof(hdr)) return false;
+  uint32_t size = getU32(hdr) & ~FSEQ_WFR_KEY;
+  const size_t bpp = fseqPixelSize;
+  uint32_t px = 0, pixels = fseqChannels / bpp;
+  uint8_t buf[129*4];
+  while (size) {
+    uint8_t op;
+    if (fseqFile.read(&op, 1) != 1) return false;
+    size--;
+    size_t n = (op & (op & 0x80 ? 0x3F : 0x7F)) + 1;
+    size_t bytes = (op & 0x80) == 0 ? bpp*n : (op & 0x40) ? bpp : 0;
+    if (bytes > size || px + n > pixels || fseqFile.read(buf, bytes) != bytes) return false;
+    size -= bytes;
+    if ((op & 0x80) == 0)   memcpy(dst + px*bpp, buf, bytes);                         // literal
+    else if (op & 0x40)     for (size_t i = 0; i < n; i++) memcpy(dst + (px+i)*bpp, buf, bpp); // repeat
+    px += n;                                                                         // skip: unchanged
+  }
+  fseqFileFrame++;
+  return true;
+}
+
+// reads frame of sequence number seq into the ring, false if it is not available (yet)
+static bool readFrame(uint32_t seq) {
+  uint32_t frame = seq % fseqFrames;
+  uint8_t slot = (fseqHead + fseqCount) % fseqSlots;
+  uint8_t *dst = fseqBuffer + slot * fseqChannels;
+
+  if (!fseqDelta) {
+    fseqFile.seek(fseqDataOffset + frame * fseqChannels);
+    if (fseqFile.read(dst, fseqChannels) != fseqChannels) return false;
+  } else {
+    uint8_t *last = fseqBuffer + fseqLastSlot * fseqChannels;
+    if (frame < fseqFileFrame) { // start over (loop, or time was set back)
+      fseqFile.seek(fseqDataOffset);
+      fseqFileFrame = 0;
+    }
+    // skip ahead, delta frames have to be decoded in order
+    for (size_t i = 0; fseqFileFrame < frame; i++) {
+      if (i >= FSEQ_MAX_CATCHUP || !decodeFrame(last)) return false;
+    }
+    if (dst != last) memcpy(dst, last, fseqChannels);
+    if (!decodeFrame(dst)) return false;
+  }
+  if (!fseqCount) fseqHeadSeq = seq;
+  fseqLastSlot = slot;
+  fseqCount++;
+  return true;
+}
+
+static void showFrame(const uint8_t *data) {
+  if (!realtimeLock(realtimeTimeoutMs, REALTIME_MODE_FSEQ)) return;
+  if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+  uint16_t totalLen = strip.getLengthTotal();
+  for (size_t r = 0; r < fseqRangeCount; data += fseqRanges[r++].count) {
+    for (uint32_t i = 0; i + fseqPixelSize <= fseqRanges[r].count; i += fseqPixelSize) {
+      uint32_t pix = (fseqRanges[r].start + i) / fseqPixelSize;
+      if (pix >= totalLen) break;
+      const uint8_t *c = data + i;
+      if (fseqDelta) strip.setPixelColor(pix, c[0], c[1], c[2], fseqPixelSize > 3 ? c[3] : 0); // recorded output of the whole strip (gamma already applied)
+      else           setRealtimePixel(pix, c[0], c[1], c[2], 0);
+    }
+  }
+  if (!(realtimeMode && useMainSegmentOnly)) strip.show();
+}
+
+void stopFseq() {
+  if (!fseqBuffer) return;
+  fseqFile.close();
+  free(fseqBuffer);
+  fseqBuffer = nullptr;
+  fseqFileName[0] = '\0';
+  if (realtimeMode == REALTIME_MODE_FSEQ) exitRealtime();
+  DEBUG_PRINTLN(F("FSEQ stopped."));
+}
+
+bool startFseq(const char *name, Toki::Time start, bool loop, bool clock) {
+  stopFseq();
+  #ifdef FSEQ_SD
+  File f = file_onSD(name) ? FSEQ_SD.open(name, "r") : WLED_FS.open(name, "r");
+  #else
+  File f = WLED_FS.open(name, "r");
+  #endif
+  if (!f) return false;
+  if (!parseHeader(f) || !fseqChannels || !fseqFrames || !fseqStep || fseqDataOffset > f.size()) {
+    DEBUG_PRINTLN(F("FSEQ: invalid file."));
+    f.close();
+    return false;
+  }
+
+  // read ahead as many frames as fit in buffer
+  size_t slots = constrain(FSEQ_BUFFER_SIZE / fseqChannels, 1, FSEQ_READ_AHEAD);
+  #ifdef ARDUINO_ARCH_ESP32
+  if (psramFound()) fseqBuffer = (uint8_t*)ps_calloc(slots, fseqChannels);
+  else
+  #endif
+  fseqBuffer = (uint8_t*)calloc(slots, fseqChannels);
+  if (!fseqBuffer) {
+    DEBUG_PRINTLN(F("FSEQ: no memory."));
+    f.close();
+    return false;
+  }
+
+  fseqFile  = f;
+  fseqSlots = slots;
+  fseqHead  = fseqCount = fseqLastSlot = 0;
+  fseqReadSeq = fseqFileFrame = fseqLate = 0;
+  fseqShownSeq = UINT32_MAX;
+  fseqLoop  = loop || clock; // effect time does not start with the file
+  fseqClock = clock;
+  fseqStart = start;
+  fseqFile.seek(fseqDataOffset);
+  strlcpy(fseqFileName, name, sizeof(fseqFileName));
+  DEBUG_PRINTF("FSEQ started: %s, %u channels, %u frames, %u ms, %u buffers\n", fseqFileName, fseqChannels, fseqFrames, fseqStep, slots);
+  return true;
+}
+
+void handleFseq() {
+  if (!fseqBuffer) return;
+  int64_t pos = fseqPosition();
+  if (pos >= 0) {
+    uint32_t seq = pos / fseqStep;
+    if (!fseqLoop && seq >= fseqFrames) {
+      stopFseq(); // all frames shown
+      return;
+    }
+    if (fseqCount && seq < fseqHeadSeq) fseqCount = 0; // time was set back
+
+    // drop frames that are past
+    while (fseqCount && fseqHeadSeq < seq) {
+      if (fseqHeadSeq != fseqShownSeq) fseqLate++;
+      fseqHead = (fseqHead + 1) % fseqSlots;
+      fseqHeadSeq++;
+      fseqCount--;
+    }
+    if (!fseqCount) fseqReadSeq = seq; // fell behind (or just started), continue with the current frame
+    if (fseqCount && fseqHeadSeq == seq && fseqShownSeq != seq) {
+      showFrame(fseqBuffer + fseqHead * fseqChannels);
+      fseqShownSeq = seq;
+    }
+  }
+
+  // read ahead (after showing the frame, so reading does not delay it)
+  while (fseqCount < fseqSlots && (fseqLoop || fseqReadSeq < fseqFrames)) {
+    if (!readFrame(fseqReadSeq)) break;
+    fseqReadSeq++;
+  }
+}
+
+void deserializeFseq(JsonObject fseq) {
+  if (fseq[F("stop")]) {
+    stopFseq();
+    return;
+  }
+  const char *name = fseq["f"];
+  if (!name) return;
+  Toki::Time start = toki.getTime();
+  if (!fseq["at"].isNull()) start = {fseq["at"].as<uint32_t>(), (uint16_t)MIN(fseq["ms"] | 0, 999)};
+  if (!startFseq(name, start, fseq[F("loop")], fseq[F("clk")])) errorFlag = ERR_FS_GENERAL;
+}
+
+void serializeFseq(JsonObject root) {
+  JsonObject fseq = root.createNestedObject(F("fseq"));
+  fseq["on"] = fseqBuffer != nullptr;
+  if (!fseqBuffer) return;
+  fseq["f"] = fseqFileName;
+  fseq[F("fr")] = fseqShownSeq == UINT32_MAX ? -1 : (long)(fseqShownSeq % fseqFrames);
+  fseq["n"] = fseqFrames;
+  fseq[F("step")] = fseqStep;
+  fseq[F("late")] = fseqLate;
+  fseq[F("buf")] = fseqCount;
+  fseq[F("loop")] = fseqLoop;
+}
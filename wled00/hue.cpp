@@ -10,7 +10,7 @@ void handleHue()
 {
   if (hueReceived)
   {
-    colorUpdated(CALL_MODE_HUE); hueReceived = false;
+    applyValuesToSelectedSegs(); queueStateUpdate(CALL_MODE_HUE); hueReceived = false;
     if (hueStoreAllowed && hueNewKey)
     {
       serializeConfigSec(); //save api key
@@ -1,16 +1,8 @@
 #include "wled.h"
+#include <memory>
 
 #include "palettes.h"
 
-#define JSON_PATH_STATE      1
-#define JSON_PATH_INFO       2
-#define JSON_PATH_STATE_INFO 3
-#define JSON_PATH_NODES      4
-#define JSON_PATH_PALETTES   5
-#define JSON_PATH_FXDATA     6
-#define JSON_PATH_NETWORKS   7
-#define JSON_PATH_EFFECTS    8
-
 /*
  * JSON API (De)serialization
  */
@@ -245,6 +237,10 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   seg.check2 = elem["o2"] | seg.check2;
   seg.check3 = elem["o3"] | seg.check3;
 
+  // frame budget scheduling
+  seg.priority = elem[F("pri")]  | seg.priority;
+  seg.minFps   = elem[F("mfps")] | seg.minFps;
+
   JsonArray iarr = elem[F("i")]; //set individual LEDs
   if (!iarr.isNull()) {
     uint8_t oldMap1D2D = seg.map1D2D;
@@ -313,6 +309,18 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   netDebugEnabled = root[F("debug")] | netDebugEnabled;
   #endif
 
+  if (!requestStateLock()) { // state is being serialized with another JSON buffer
+    errorFlag = ERR_BUSY; // nothing applied
+    return stateResponse;
+  }
+  strip.suspend(); // segments must not change while effects are rendered in a separate task
+  if (!strip.waitUntilIdle()) {
+    strip.resume();
+    releaseStateLock();
+    errorFlag = ERR_BUSY; // nothing applied
+    return stateResponse;
+  }
+
   bool onBefore = bri;
   getVal(root["bri"], &bri);
 
@@ -421,7 +429,9 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     if (strip.getSegmentsNum() > 3 && deleted >= strip.getSegmentsNum()/2U) strip.purgeSegments(); // batch deleting more than half segments
   }
 
-  usermods.readFromJsonState(root);
+  usermods.readFromJsonState(root); // may change segments
+  strip.resume();
+  releaseStateLock();
 
   loadLedmap = root[F("ledmap")] | loadLedmap;
 
@@ -458,6 +468,15 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     }
   }
 
+  JsonObject cue = root[F("cue")];
+  if (!cue.isNull()) deserializeCueList(cue);
+
+  JsonObject fseq = root[F("fseq")];
+  if (!fseq.isNull()) deserializeFseq(fseq);
+
+  JsonObject rec = root[F("rec")];
+  if (!rec.isNull()) deserializeRecorder(rec);
+
   JsonObject playlist = root[F("playlist")];
   if (!playlist.isNull() && loadPlaylist(playlist, presetId)) {
     //do not notify here, because the first playlist entry will do
@@ -466,21 +485,26 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   }
 
   if (root.containsKey(F("rmcpal")) && root[F("rmcpal")].as<bool>()) {
-    if (strip.customPalettes.size()) {
+    strip.suspend();
+    if (strip.customPalettes.size() && strip.waitUntilIdle()) {
       char fileName[32];
       sprintf_P(fileName, PSTR("/palette%d.json"), strip.customPalettes.size()-1);
       if (WLED_FS.exists(fileName)) WLED_FS.remove(fileName);
       strip.loadCustomPalettes();
-    }
+    } else if (strip.customPalettes.size()) errorFlag = ERR_BUSY; // palette not removed
+    strip.resume();
   }
 
-  stateUpdated(callMode);
-  if (presetToRestore) currentPreset = presetToRestore;
+  if (presetId) {
+    stateUpdated(callMode);
+    if (presetToRestore) currentPreset = presetToRestore;
+  } else
+    queueStateUpdate(callMode, presetToRestore); // API request, applied with other requests once per frame
 
   return stateResponse;
 }
 
-void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, bool segmentBounds)
+void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, bool segmentBounds, bool includePriority)
 {
   root["id"] = id;
   if (segmentBounds) {
@@ -547,9 +571,13 @@ void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, b
   root["o3"]  = seg.check3;
   root["si"]  = seg.soundSim;
   root["m12"] = seg.map1D2D;
+  // render priority: state has it if not default, presets if it was requested when saving
+  if (forPreset ? includePriority : seg.priority != DEFAULT_PRIORITY) root[F("pri")]  = seg.priority;
+  if (forPreset ? includePriority : seg.minFps != 0)                  root[F("mfps")] = seg.minFps;
 }
 
-void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool selectedSegmentsOnly)
+// top level state (everything except segments)
+void serializeStateHead(JsonObject root, bool forPreset, bool includeBri)
 {
   if (includeBri) {
     root["on"] = (bri > 0);
@@ -586,6 +614,11 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   }
 
   root[F("mainseg")] = strip.getMainSegmentId();
+}
+
+void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool selectedSegmentsOnly, bool includePriority)
+{
+  serializeStateHead(root, forPreset, includeBri);
 
   JsonArray seg = root.createNestedArray("seg");
   for (size_t s = 0; s < strip.getMaxSegments(); s++) {
@@ -601,7 +634,7 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
     if (forPreset && selectedSegmentsOnly && !sg.isSelected()) continue;
     if (sg.isActive()) {
       JsonObject seg0 = seg.createNestedObject();
-      serializeSegment(seg0, sg, s, forPreset, segmentBounds);
+      serializeSegment(seg0, sg, s, forPreset, segmentBounds, includePriority);
     } else if (forPreset && segmentBounds) { //disable segments not part of preset
       JsonObject seg0 = seg.createNestedObject();
       seg0["stop"] = 0;
@@ -634,12 +667,14 @@ void serializeInfo(JsonObject root)
 
   uint8_t totalLC = 0;
   JsonArray lcarr = leds.createNestedArray(F("seglc"));
+  JsonArray fxtarr = leds.createNestedArray(F("fxt")); // average effect run time in us (diagnostics, not part of state)
   size_t nSegs = strip.getSegmentsNum();
   for (size_t s = 0; s < nSegs; s++) {
     if (!strip.getSegment(s).isActive()) continue;
     uint8_t lc = strip.getSegment(s).getLightCapabilities();
     totalLC |= lc;
     lcarr.add(lc);
+    fxtarr.add(strip.getSegment(s).getEffectCost());
   }
 
   leds["lc"] = totalLC;
@@ -675,6 +710,7 @@ void serializeInfo(JsonObject root)
     case REALTIME_MODE_ARTNET:   root["lm"] = F("Art-Net"); break;
     case REALTIME_MODE_TPM2NET:  root["lm"] = F("tpm2.net"); break;
     case REALTIME_MODE_DDP:      root["lm"] = F("DDP"); break;
+    case REALTIME_MODE_FSEQ:     root["lm"] = F("file"); break;
   }
 
   if (realtimeIP[0] == 0)
@@ -752,9 +788,21 @@ void serializeInfo(JsonObject root)
   #endif
   root[F("uptime")] = millis()/1000 + rolloverMillis*4294967;
 
+  JsonObject jbuf = root.createNestedObject(F("jbuf"));
+  jbuf["n"]  = WLED_JSON_POOL_SIZE;    // number of buffers
+  jbuf["u"]  = getJSONBuffersInUse();  // including the one used for this response
+  jbuf[F("pk")] = jsonBufferPeak;
+  jbuf["w"]  = jsonBufferWaits;
+  jbuf["f"]  = jsonBufferFails;
+  jbuf["d"]  = jsonBufferDeferred;
+  root[F("coal")] = stateUpdatesCoalesced; // API state updates merged into one apply
+
   char time[32];
   getTimeString(time);
   root[F("time")] = time;
+  serializeCueList(root);
+  serializeFseq(root);
+  serializeRecorder(root);
 
   usermods.addToJsonInfo(root);
 
@@ -844,11 +892,7 @@ void setPaletteColors(JsonArray json, byte* tcp)
 void serializePalettes(JsonObject root, int page)
 {
   byte tcp[72];
-  #ifdef ESP8266
-  int itemPerPage = 5;
-  #else
-  int itemPerPage = 8;
-  #endif
+  int itemPerPage = JSON_PALETTES_PER_PAGE;
 
   int palettesCount = strip.getPaletteCount();
   int customPalettes = strip.customPalettes.size();
@@ -971,21 +1015,22 @@ void serializeNetworks(JsonObject root)
   }
 }
 
-void serializeNodes(JsonObject root)
+static void serializeNode(JsonObject node, const NodeStruct &n)
 {
-  JsonArray nodes = root.createNestedArray("nodes");
-
-  for (NodesMap::iterator it = Nodes.begin(); it != Nodes.end(); ++it)
-  {
-    if (it->second.ip[0] != 0)
-    {
-      JsonObject node = nodes.createNestedObject();
-      node[F("name")] = it->second.nodeName;
-      node["type"]    = it->second.nodeType;
-      node["ip"]      = it->second.ip.toString();
-      node[F("age")]  = it->second.age;
-      node[F("vid")]  = it->second.build;
-    }
+  node[F("name")] = n.nodeName;
+  node["type"]    = n.nodeType;
+  node["ip"]      = n.ip.toString();
+  node[F("age")]  = n.age();
+  node[F("seen")] = millis() - n.lastSeen;   // ms since last info packet
+  node[F("vid")]  = n.build;
+  if (n.rtt) node[F("rtt")] = n.rtt;         // network round trip (us)
+  if (n.clkSamples && n.clockSync) {         // cluster clock sync: offset to our effect time, jitter (us)
+    node[F("ofs")] = n.clkOffset;
+    node[F("jit")] = n.clkJitter;
+  }
+  if (n.flkLate || n.flkMissed) {            // frame lock statistics reported by node
+    node[F("late")] = n.flkLate;
+    node[F("miss")] = n.flkMissed;
   }
 }
 
@@ -1020,28 +1065,349 @@ void serializeModeNames(JsonArray arr)
   }
 }
 
+// steps of streamed JSON responses
+enum : uint8_t { JS_END, JS_STATE_OPEN, JS_STATE_HEAD, JS_SEGMENTS, JS_STATE_CLOSE, JS_INFO_OPEN, JS_INFO, JS_EFFECTS, JS_PALETTES, JS_PALETTE_DATA, JS_CLOSE,
+                 JS_NODES_HEAD, JS_NODES, JS_NODES_CLOSE };
+static const uint8_t jsSeqState[]     = { JS_STATE_HEAD, JS_SEGMENTS, JS_STATE_CLOSE, JS_END };
+static const uint8_t jsSeqInfo[]      = { JS_INFO, JS_END };
+static const uint8_t jsSeqStateInfo[] = { JS_STATE_OPEN, JS_STATE_HEAD, JS_SEGMENTS, JS_STATE_CLOSE, JS_INFO_OPEN, JS_INFO, JS_CLOSE, JS_END };
+static const uint8_t jsSeqAll[]       = { JS_STATE_OPEN, JS_STATE_HEAD, JS_SEGMENTS, JS_STATE_CLOSE, JS_INFO_OPEN, JS_INFO, JS_EFFECTS, JS_PALETTES, JS_PALETTE_DATA, JS_CLOSE, JS_END };
+static const uint8_t jsSeqNodes[]     = { JS_NODES_HEAD, JS_NODES, JS_NODES_CLOSE, JS_END };
+
+// since: node list version of a previous response, only changes since then are written (0 = all nodes)
+JsonStreamer::JsonStreamer(uint8_t subJson, uint32_t since)
+  : _step(0), _idx(0), _count(0), _failed(false), _busy(false), _since(since), _piece(nullptr), _pgm(nullptr), _len(0), _pos(0)
+{
+  switch (subJson) {
+    case JSON_PATH_STATE:      _seq = jsSeqState;     break;
+    case JSON_PATH_INFO:       _seq = jsSeqInfo;      break;
+    case JSON_PATH_STATE_INFO: _seq = jsSeqStateInfo; break;
+    case JSON_PATH_NODES:      _seq = jsSeqNodes;     break;
+    default:                   _seq = jsSeqAll;       break;
+  }
+}
+
+void JsonStreamer::freePiece()
+{
+  free(_piece);
+  _piece = nullptr;
+  _pgm   = nullptr;
+  _len   = _pos = 0;
+}
+
+void JsonStreamer::setText(const char *pgm)
+{
+  _pgm = pgm;
+  _len = strlen_P(pgm);
+  _pos = 0;
+}
+
+// serializes document (surrounded by prefix and suffix from PROGMEM) into RAM piece, dropLast removes closing brace
+bool JsonStreamer::setDoc(JsonDocument &d, const char *prefix, const char *suffix, bool dropLast)
+{
+  size_t pl = strlen_P(prefix), sl = strlen_P(suffix), dl = measureJson(d);
+  char *p = (char*)malloc(pl + dl + sl + 1);
+  if (!p) return false;
+  memcpy_P(p, prefix, pl);
+  serializeJson(d, p + pl, dl + 1);
+  if (dropLast && dl) dl--;
+  memcpy_P(p + pl + dl, suffix, sl);
+  _piece = p;
+  _len   = pl + dl + sl;
+  _pos   = 0;
+  return true;
+}
+
+// state must not change while a piece of it is serialized, but network callbacks must not wait for it
+// (piece is retried with the next read() if state is locked)
+bool JsonStreamer::lockState()
+{
+  _busy = !tryStateLock(17);
+  return !_busy;
+}
+
+// skips remaining steps (client will get incomplete JSON)
+void JsonStreamer::abort()
+{
+  DEBUG_PRINTLN(F("JSON stream aborted (out of memory)."));
+  while (_seq[_step] != JS_END) _step++;
+  _failed = true;
+}
+
+// fills a temporary document using fill(JsonObject) and makes it the current piece
+// document size is doubled if fill() did not fit; response is aborted if out of memory
+template<typename F> bool JsonStreamer::serializePiece(size_t capacity, F fill, const char *prefix, const char *suffix, bool dropLast)
+{
+  for (;; capacity *= 2) {
+    PSRAMDynamicJsonDocument d(capacity);
+    if (d.capacity() == 0) break;
+    fill(d.to<JsonObject>());
+    if (!d.overflowed() || capacity >= JSON_BUFFER_SIZE) {
+      if (setDoc(d, prefix, suffix, dropLast)) return true;
+      break;
+    }
+  }
+  abort();
+  return false;
+}
+
+bool JsonStreamer::nextPiece()
+{
+  freePiece();
+  for (;;) {
+    switch (_seq[_step]) {
+      case JS_END:
+        return false;
+      case JS_STATE_OPEN:
+        setText(PSTR("{\"state\":"));
+        break;
+      case JS_STATE_HEAD: {
+        if (!lockState()) return false;
+        byte err = errorFlag; // cleared by serializeState() but needed again if document has to be enlarged
+        bool ok = serializePiece(JSON_STREAM_PIECE_SIZE, [err](JsonObject o) { errorFlag = err; serializeStateHead(o, false, true); }, PSTR(""), PSTR(",\"seg\":["), true);
+        releaseStateLock();
+        if (!ok) return false;
+        break;
+      }
+      case JS_SEGMENTS: {
+        // segments may be removed or reallocated between pieces, so each one is looked up again
+        if (!lockState()) return false;
+        bool found = false, ok = true;
+        while (_idx < strip.getSegmentsNum()) {
+          uint8_t id = _idx++;
+          Segment &sg = strip.getSegment(id);
+          if (!sg.isActive()) continue;
+          found = true;
+          ok = serializePiece(JSON_STREAM_PIECE_SIZE, [&sg, id](JsonObject o) { serializeSegment(o, sg, id); }, _count++ ? PSTR(",") : PSTR(""), PSTR(""));
+          break;
+        }
+        releaseStateLock();
+        if (!ok) return false;
+        if (found) return true;
+        _step++; _idx = 0; _count = 0;
+        continue; // all segments written
+      }
+      case JS_STATE_CLOSE:
+        setText(PSTR("]}"));
+        break;
+      case JS_INFO_OPEN:
+        setText(PSTR(",\"info\":"));
+        break;
+      case JS_INFO: {
+        if (!lockState()) return false;
+        bool ok = serializePiece(2*JSON_STREAM_PIECE_SIZE, [](JsonObject o) { serializeInfo(o); }, PSTR(""), PSTR(""));
+        releaseStateLock();
+        if (!ok) return false;
+        break;
+      }
+      case JS_EFFECTS: {
+        // effect names (without slider data) in batches
+        const size_t maxLen = 512;
+        char *p = (char*)malloc(maxLen);
+        if (!p) { abort(); return false; }
+        size_t n = 0;
+        if (_idx == 0) n = strlcpy_P(p, PSTR(",\"effects\":["), maxLen);
+        char lineBuffer[128];
+        while (_idx < strip.getModeCount()) {
+          strncpy_P(lineBuffer, strip.getModeData(_idx), sizeof(lineBuffer)-1);
+          lineBuffer[sizeof(lineBuffer)-1] = '\0';
+          bool empty = lineBuffer[0] == 0; // same as serializeModeNames()
+          char* dataPtr = strchr(lineBuffer,'@');
+          if (dataPtr) *dataPtr = 0; // terminate mode data after name
+          size_t nameLen = strlen(lineBuffer);
+          if (n + 2*nameLen + 4 > maxLen) break; // does not fit, continue in next batch
+          _idx++;
+          if (empty) continue;
+          if (_count++) p[n++] = ',';
+          p[n++] = '"';
+          for (size_t i = 0; i < nameLen; i++) {
+            if (lineBuffer[i] == '"' || lineBuffer[i] == '\\') p[n++] = '\\';
+            p[n++] = lineBuffer[i];
+          }
+          p[n++] = '"';
+        }
+        _piece = p; _len = n; _pos = 0;
+        if (_idx < strip.getModeCount()) return true; // more to come
+        p[_len++] = ']';
+        _idx = 0; _count = 0;
+        break;
+      }
+      case JS_PALETTES:
+        setText(PSTR(",\"palettes\":"));
+        break;
+      case JS_PALETTE_DATA:
+        setText(JSON_palette_names);
+        break;
+      case JS_CLOSE:
+        setText(PSTR("}"));
+        break;
+      case JS_NODES_HEAD: {
+        // version of this response and nodes removed since the requested one (full list if not known)
+        IPAddress removed[NODE_REMOVED_LOG];
+        size_t nRemoved = 0;
+        if (_since && !Nodes.removedSince(_since, removed, nRemoved)) _since = 0;
+        uint32_t since = _since;
+        if (!serializePiece(JSON_STREAM_PIECE_SIZE, [since, &removed, nRemoved](JsonObject o) {
+          o[F("ndv")] = Nodes.version();
+          if (since) {
+            o[F("inc")] = true; // incremental since version b
+            o["b"] = since;
+            JsonArray rm = o.createNestedArray(F("rm"));
+            for (size_t i = 0; i < nRemoved; i++) rm.add(removed[i].toString());
+          }
+          serializeClockSync(o);
+          serializeFrameLock(o);
+        }, PSTR(""), PSTR(",\"nodes\":["), true)) return false;
+        break;
+      }
+      case JS_NODES:
+        // one node per piece, nodes added or removed in between may be missed (or listed twice)
+        while (_idx < Nodes.size()) {
+          NodeStruct node = Nodes[_idx++];
+          if (node.ip[0] == 0 || node.changed <= _since) continue;
+          if (!serializePiece(256, [&node](JsonObject o) { serializeNode(o, node); }, _count++ ? PSTR(",") : PSTR(""), PSTR(""))) return false;
+          return true;
+        }
+        _step++; _idx = 0; _count = 0;
+        continue; // all nodes written
+      case JS_NODES_CLOSE:
+        setText(PSTR("]}"));
+        break;
+    }
+    _step++;
+    return true;
+  }
+}
+
+size_t JsonStreamer::read(uint8_t *buf, size_t maxLen)
+{
+  size_t n = 0;
+  _busy = false;
+  while (n < maxLen) {
+    if (_pos >= _len && !nextPiece()) break;
+    size_t chunk = MIN(_len - _pos, maxLen - n);
+    if (_pgm) memcpy_P(buf + n, _pgm + _pos, chunk);
+    else      memcpy(buf + n, _piece + _pos, chunk);
+    n    += chunk;
+    _pos += chunk;
+  }
+  return n;
+}
+
+#ifdef WLED_ENABLE_JSON_CACHE
+// Responses that only change when effects are added (by usermods during boot) or custom palettes change
+// are serialized once and served from RAM (PSRAM if available) without locking a JSON buffer.
+// Cache is only accessed from web server callbacks (and setup() before server is started);
+// responses hold a reference so a blob stays valid while it is being sent even if cache is invalidated.
+typedef struct {
+  std::shared_ptr<char> data;
+  size_t len;
+} JsonBlob;
+
+static JsonBlob jsonCacheFx, jsonCacheFxData;
+static std::vector<JsonBlob> jsonCachePal;  // one entry per page
+static volatile bool jsonCachePalValid = false;
+static uint16_t jsonCachePalGen = 0;        // incremented when custom palettes change (part of ETag)
+
+// serializes JSON_PATH_EFFECTS, JSON_PATH_FXDATA or a page of JSON_PATH_PALETTES into a blob
+static JsonBlob makeJsonBlob(uint8_t subJson, int page = 0)
+{
+  JsonBlob blob = {nullptr, 0};
+  JsonDocument *pDoc = requestJSONBuffer(19);
+  if (!pDoc) return blob;
+  if (subJson == JSON_PATH_PALETTES) serializePalettes(pDoc->to<JsonObject>(), page);
+  else {
+    JsonArray arr = pDoc->to<JsonArray>();
+    if (subJson == JSON_PATH_EFFECTS) serializeModeNames(arr);
+    else                              serializeModeData(arr);
+  }
+  size_t len = measureJson(*pDoc);
+  char *p = (char*)(psramFound() ? ps_malloc(len+1) : malloc(len+1));
+  if (p) {
+    serializeJson(*pDoc, p, len+1);
+    blob.data = std::shared_ptr<char>(p, free);
+    blob.len  = len;
+  }
+  releaseJSONBuffer(pDoc);
+  DEBUG_PRINTF("JSON cache %d/%d: %u bytes\n", subJson, page, len);
+  return blob;
+}
+
+// generates effect names and data once effects (incl. usermod effects) are registered
+void initJSONCache()
+{
+  jsonCacheFx     = makeJsonBlob(JSON_PATH_EFFECTS);
+  jsonCacheFxData = makeJsonBlob(JSON_PATH_FXDATA);
+}
+
+// serves cached response (generated on first use), no JSON buffer is needed if it already exists
+static void serveCachedJson(AsyncWebServerRequest* request, uint8_t subJson)
+{
+  int page = 0;
+  uint16_t eTagSuffix = strip.getModeCount();
+  if (subJson == JSON_PATH_PALETTES) {
+    if (!jsonCachePalValid) {
+      jsonCachePalValid = true; // set before clearing so changes during regeneration invalidate it again
+      jsonCachePal.clear();
+      jsonCachePalGen++;
+    }
+    int maxPage = (strip.getPaletteCount() + strip.customPalettes.size() -1) / JSON_PALETTES_PER_PAGE;
+    if (request->hasParam(F("page"))) page = constrain((int)request->getParam(F("page"))->value().toInt(), 0, maxPage);
+    if (jsonCachePal.size() != (size_t)maxPage+1) jsonCachePal.resize(maxPage+1, {nullptr, 0});
+    eTagSuffix = jsonCachePalGen;
+  }
+  if (handleIfNoneMatchCacheHeader(request, eTagSuffix)) return;
+
+  JsonBlob &blob = subJson == JSON_PATH_EFFECTS ? jsonCacheFx : subJson == JSON_PATH_FXDATA ? jsonCacheFxData : jsonCachePal[page];
+  if (!blob.data) blob = makeJsonBlob(subJson, page);
+  if (!blob.data) {
+    request->send(503, "application/json", F("{\"error\":3}"));
+    return;
+  }
+
+  std::shared_ptr<char> data = blob.data;
+  size_t len = blob.len;
+  AsyncWebServerResponse *response = request->beginResponse("application/json", len, [data, len](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+    size_t n = MIN(maxLen, len - index);
+    memcpy(buf, data.get() + index, n);
+    return n;
+  });
+  setStaticContentCacheHeaders(response, eTagSuffix);
+  request->send(response);
+}
+#else
+void initJSONCache() {}
+#endif
+
+// custom palettes changed (palette pages are regenerated on next request)
+void invalidateJSONCache()
+{
+  #ifdef WLED_ENABLE_JSON_CACHE
+  jsonCachePalValid = false;
+  #endif
+}
+
 // Global buffer locking response helper class (to make sure lock is released when AsyncJsonResponse is destroyed)
 class LockedJsonResponse: public AsyncJsonResponse {
-  bool _holding_lock;
+  JsonDocument *_pDoc; // pooled buffer, nullptr once released
   public:
-  // WARNING: constructor assumes requestJSONBufferLock() was successfully acquired externally/prior to constructing the instance
+  // WARNING: constructor assumes buffer was successfully acquired with requestJSONBuffer() externally/prior to constructing the instance
   // Not a good practice with C++. Unfortunately AsyncJsonResponse only has 2 constructors - for dynamic buffer or existing buffer,
   // with existing buffer it clears its content during construction
-  // if the lock was not acquired (using JSONBufferGuard class) previous implementation still cleared existing buffer
-  inline LockedJsonResponse(JsonDocument* doc, bool isArray) : AsyncJsonResponse(doc, isArray), _holding_lock(true) {};
+  inline LockedJsonResponse(JsonDocument* doc, bool isArray) : AsyncJsonResponse(doc, isArray), _pDoc(doc) {};
 
   virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) { 
     size_t result = AsyncJsonResponse::_fillBuffer(buf, maxLen);
-    // Release lock as soon as we're done filling content
-    if (((result + _sentLength) >= (_contentLength)) && _holding_lock) {
-      releaseJSONBufferLock();
-      _holding_lock = false;
+    // Release buffer as soon as we're done filling content
+    if (((result + _sentLength) >= (_contentLength)) && _pDoc) {
+      releaseJSONBuffer(_pDoc);
+      _pDoc = nullptr;
     }
     return result;
   }
 
-  // destructor will remove JSON buffer lock when response is destroyed in AsyncWebServer
-  virtual ~LockedJsonResponse() { if (_holding_lock) releaseJSONBufferLock(); };
+  // destructor will return JSON buffer to the pool when response is destroyed in AsyncWebServer
+  virtual ~LockedJsonResponse() { if (_pDoc) releaseJSONBuffer(_pDoc); };
 };
 
 void serveJson(AsyncWebServerRequest* request)
@@ -1074,24 +1440,50 @@ void serveJson(AsyncWebServerRequest* request)
     return;
   }
 
-  if (!requestJSONBufferLock(17)) {
+  #ifdef WLED_ENABLE_JSON_CACHE
+  if (subJson == JSON_PATH_EFFECTS || subJson == JSON_PATH_FXDATA || subJson == JSON_PATH_PALETTES) {
+    serveCachedJson(request, subJson);
+    return;
+  }
+  #endif
+
+  if (subJson <= JSON_PATH_STATE_INFO || subJson == JSON_PATH_NODES) {
+    // state, info or both (with effects & palettes) or node list: streamed in chunks, no JSON buffer needed
+    uint32_t since = 0; // node list changes since version (?v=)
+    if (subJson == JSON_PATH_NODES && request->hasParam(F("v"))) since = request->getParam(F("v"))->value().toInt();
+    std::shared_ptr<JsonStreamer> stream = std::make_shared<JsonStreamer>(subJson, since);
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/json", [stream, request](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+      size_t len = stream->read(buf, maxLen);
+      if (!len && stream->busy()) return RESPONSE_TRY_AGAIN; // state is being applied, next piece is sent later
+      if (stream->failed()) {
+        // status 200 is already sent: drop the connection instead of ending the response, so the client
+        // gets an error rather than truncated JSON (connection is discarded after this callback returns)
+        #ifdef ESP8266
+        request->client()->close(); // deferred until next poll/ack
+        #else
+        request->client()->abort(); // error event is handled by async_tcp task later
+        #endif
+        return RESPONSE_TRY_AGAIN;
+      }
+      return len;
+    });
+    request->send(response);
+    return;
+  }
+
+  JsonDocument *pDoc = requestJSONBuffer(17); // does not wait, all buffers in use is a temporary overload
+  if (!pDoc) {
     request->send(503, "application/json", F("{\"error\":3}"));
     return;
   }
-  // releaseJSONBufferLock() will be called when "response" is destroyed (from AsyncWebServer)
+  // releaseJSONBuffer() will be called when "response" is destroyed (from AsyncWebServer)
   // make sure you delete "response" if no "request->send(response);" is made
-  LockedJsonResponse *response = new LockedJsonResponse(&doc, subJson==JSON_PATH_FXDATA || subJson==JSON_PATH_EFFECTS); // will clear and convert JsonDocument into JsonArray if necessary
+  LockedJsonResponse *response = new LockedJsonResponse(pDoc, subJson==JSON_PATH_FXDATA || subJson==JSON_PATH_EFFECTS); // will clear and convert JsonDocument into JsonArray if necessary
 
   JsonVariant lDoc = response->getRoot();
 
   switch (subJson)
   {
-    case JSON_PATH_STATE:
-      serializeState(lDoc); break;
-    case JSON_PATH_INFO:
-      serializeInfo(lDoc); break;
-    case JSON_PATH_NODES:
-      serializeNodes(lDoc); break;
     case JSON_PATH_PALETTES:
       serializePalettes(lDoc, request->hasParam(F("page")) ? request->getParam(F("page"))->value().toInt() : 0); break;
     case JSON_PATH_EFFECTS:
@@ -1100,18 +1492,6 @@ void serveJson(AsyncWebServerRequest* request)
       serializeModeData(lDoc); break;
     case JSON_PATH_NETWORKS:
       serializeNetworks(lDoc); break;
-    default: //all
-      JsonObject state = lDoc.createNestedObject("state");
-      serializeState(state);
-      JsonObject info = lDoc.createNestedObject("info");
-      serializeInfo(info);
-      if (subJson != JSON_PATH_STATE_INFO)
-      {
-        JsonArray effects = lDoc.createNestedArray(F("effects"));
-        serializeModeNames(effects); // remove WLED-SR extensions from effect names
-        lDoc[F("palettes")] = serialized((const __FlashStringHelper*)JSON_palette_names);
-      }
-      //lDoc["m"] = lDoc.memoryUsage(); // JSON buffer usage, for remote debugging
   }
 
   DEBUG_PRINTF("JSON buffer size: %u for request: %d\n", lDoc.memoryUsage(), subJson);
@@ -1155,7 +1535,16 @@ bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
     r = scale8(qadd8(w, r), strip.getBrightness()); //R, add white channel to RGB channels as a simple RGBW -> RGB map
     g = scale8(qadd8(w, g), strip.getBrightness()); //G
     b = scale8(qadd8(w, b), strip.getBrightness()); //B
-    olen += sprintf(obuf + olen, "\"%06X\",", RGBW32(r,g,b,0));
+    // "RRGGBB", (faster than sprintf)
+    static const char hex[] PROGMEM = "0123456789ABCDEF";
+    uint8_t rgb[3] = {r, g, b};
+    obuf[olen++] = '"';
+    for (size_t j = 0; j < 3; j++) {
+      obuf[olen++] = pgm_read_byte(hex + (rgb[j] >> 4));
+      obuf[olen++] = pgm_read_byte(hex + (rgb[j] & 0x0F));
+    }
+    obuf[olen++] = '"';
+    obuf[olen++] = ',';
   }
   olen -= 1;
   oappend((const char*)F("],\"n\":"));
@@ -28,6 +28,12 @@ void setValuesFromSegment(uint8_t s)
 // problem: if the first selected segment already has the value to be set, other selected segments are not updated
 void applyValuesToSelectedSegs()
 {
+  strip.suspend(); // segments must not change while effects are rendered in a separate task
+  if (!strip.waitUntilIdle()) {
+    strip.resume();
+    errorFlag = ERR_BUSY; // values are not applied
+    return;
+  }
   // copy of first selected segment to tell if value was updated
   uint8_t firstSel = strip.getFirstSelectedSegId();
   Segment selsegPrev = strip.getSegment(firstSel);
@@ -44,6 +50,7 @@ void applyValuesToSelectedSegs()
     if (col0 != selsegPrev.colors[0])            {seg.setColor(0, col0);}
     if (col1 != selsegPrev.colors[1])            {seg.setColor(1, col1);}
   }
+  strip.resume();
 }
 
 
@@ -93,9 +100,7 @@ void applyFinalBri() {
 }
 
 
-//called after every state changes, schedules interface updates, handles brightness transition and nightlight activation
-//unlike colorUpdated(), does NOT apply any colors or FX to segments
-void stateUpdated(byte callMode) {
+static void applyStateUpdate(byte callMode) {
   //call for notifier -> 0: init 1: direct change 2: button 3: notification 4: nightlight 5: other (No notification)
   //                     6: fx changed 7: hue 8: preset cycle 9: blynk 10: alexa 11: ws send only 12: button preset
   setValuesFromFirstSelectedSeg();
@@ -155,6 +160,61 @@ void stateUpdated(byte callMode) {
   }
 }
 
+//called after every state changes, schedules interface updates, handles brightness transition and nightlight activation
+//unlike colorUpdated(), does NOT apply any colors or FX to segments
+void stateUpdated(byte callMode) {
+  strip.suspend(); // segments must not change while effects are rendered in a separate task
+  if (strip.waitUntilIdle()) applyStateUpdate(callMode);
+  else queueStateUpdate(callMode); // retried in next frame
+  strip.resume();
+}
+
+
+// State changes from API requests (JSON, HTTP, MQTT, Hue, binary commands) are merged and applied at most
+// once per frame, so bursts of requests (e.g. slider drags) start only one transition and send one notification.
+// A queued update is applied in the next loop() pass, but not earlier than one frame time after the previous one.
+// Requests are queued from async (network) tasks, pending values are swapped out atomically in handleStateUpdates().
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE stateUpdateMux = portMUX_INITIALIZER_UNLOCKED;
+#define STATE_UPDATE_LOCK   portENTER_CRITICAL(&stateUpdateMux)
+#define STATE_UPDATE_UNLOCK portEXIT_CRITICAL(&stateUpdateMux)
+#else
+#define STATE_UPDATE_LOCK   // async callbacks do not preempt loop() on ESP8266
+#define STATE_UPDATE_UNLOCK
+#endif
+static volatile bool stateUpdatePending = false; // also read outside of lock (fast path)
+static byte          pendingCallMode = 0;
+static byte          pendingPresetRestore = 0;
+static unsigned long lastStateUpdate = 0;
+
+// presetToRestore: preset to set as current after state is updated (if request contained preset data)
+void queueStateUpdate(byte callMode, byte presetToRestore)
+{
+  STATE_UPDATE_LOCK;
+  if (stateUpdatePending) {
+    stateUpdatesCoalesced++;
+    // notify if any of the merged updates requires it
+    if (callMode == CALL_MODE_NOTIFICATION || callMode == CALL_MODE_NO_NOTIFY) callMode = pendingCallMode;
+  }
+  pendingCallMode = callMode;
+  pendingPresetRestore = presetToRestore;
+  stateUpdatePending = true;
+  STATE_UPDATE_UNLOCK;
+}
+
+void handleStateUpdates()
+{
+  if (!stateUpdatePending || millis() - lastStateUpdate < strip.getFrameTime()) return;
+  STATE_UPDATE_LOCK;
+  byte callMode = pendingCallMode;
+  byte presetToRestore = pendingPresetRestore;
+  stateUpdatePending = false;
+  STATE_UPDATE_UNLOCK;
+  lastStateUpdate = millis();
+  stateUpdated(callMode);
+  if (presetToRestore) currentPreset = presetToRestore;
+}
+
 
 void updateInterfaces(uint8_t callMode)
 {
@@ -187,6 +247,11 @@ void handleTransitions()
   if (transitionActive && strip.getTransition() > 0) {
     float tper = (millis() - transitionStartTime)/(float)strip.getTransition();
     if (tper >= 1.0f) {
+      strip.suspend();
+      if (!strip.waitUntilIdle()) { // retried in next loop
+        strip.resume();
+        return;
+      }
       strip.setTransitionMode(false); // stop all transitions
       // restore (global) transition time if not called from UDP notifier or single/temporary transition from JSON (also playlist)
       if (jsonTransitionOnce) strip.setTransition(transitionDelay);
@@ -194,6 +259,7 @@ void handleTransitions()
       jsonTransitionOnce = false;
       tperLast = 0;
       applyFinalBri();
+      strip.resume();
       return;
     }
     if (tper - tperLast < 0.004f) return;
@@ -293,8 +359,8 @@ void handleNightlight()
   }
 }
 
-//utility for FastLED to use our custom timer
+//utility for FastLED to use our custom timer (frame time of the segment being rendered, strip time otherwise)
 uint32_t get_millisecond_timer()
 {
-  return strip.now;
+  return strip.getSegment(strip.getCurrSegmentId()).frameNow();
 }
@@ -9,13 +9,13 @@
 
 void parseMQTTBriPayload(char* payload)
 {
-  if      (strstr(payload, "ON") || strstr(payload, "on") || strstr(payload, "true")) {bri = briLast; stateUpdated(CALL_MODE_DIRECT_CHANGE);}
-  else if (strstr(payload, "T" ) || strstr(payload, "t" )) {toggleOnOff(); stateUpdated(CALL_MODE_DIRECT_CHANGE);}
+  if      (strstr(payload, "ON") || strstr(payload, "on") || strstr(payload, "true")) {bri = briLast; queueStateUpdate(CALL_MODE_DIRECT_CHANGE);}
+  else if (strstr(payload, "T" ) || strstr(payload, "t" )) {toggleOnOff(); queueStateUpdate(CALL_MODE_DIRECT_CHANGE);}
   else {
     uint8_t in = strtoul(payload, NULL, 10);
     if (in == 0 && bri > 0) briLast = bri;
     bri = in;
-    stateUpdated(CALL_MODE_DIRECT_CHANGE);
+    queueStateUpdate(CALL_MODE_DIRECT_CHANGE);
   }
 }
 
@@ -101,9 +101,11 @@ void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties
 
   if (strcmp_P(topic, PSTR("/col")) == 0) {
     colorFromDecOrHexString(col, payloadStr);
-    colorUpdated(CALL_MODE_DIRECT_CHANGE);
+    applyValuesToSelectedSegs();
+    queueStateUpdate(CALL_MODE_DIRECT_CHANGE);
   } else if (strcmp_P(topic, PSTR("/api")) == 0) {
-    if (!requestJSONBufferLock(15)) {
+    if (!tryJSONRequestLock(15)) { // buffer busy or older requests queued, apply from main loop in order
+      deferJSONRequest(15, payloadStr, strlen(payloadStr));
       delete[] payloadStr;
       payloadStr = nullptr;
       return;
@@ -0,0 +1,164 @@
+#include "wled.h"
+
+/*
+ * Node list (other WLED instances found via info packets on the supplemental UDP port, see udp.cpp)
+ */
+
+#define NODE_INDEX_EMPTY 0xFFFF
+
+static uint16_t hashNodeName(const char *name)
+{
+  uint16_t h = 5381;
+  while (*name) h = h * 33 + (uint8_t)*name++;
+  return h;
+}
+
+size_t NodeTable::slotOf(uint32_t key) const
+{
+  key ^= key >> 16;
+  key *= 0x45d9f3b;
+  key ^= key >> 16;
+  return key & _indexMask;
+}
+
+// index slot of node with IP key, or -1
+int NodeTable::findSlot(uint32_t key) const
+{
+  if (!_index) return -1;
+  for (size_t slot = slotOf(key);; slot = (slot + 1) & _indexMask) {
+    uint16_t pos = _index[slot];
+    if (pos == NODE_INDEX_EMPTY) return -1;
+    if (uint32_t(_nodes[pos].ip) == key) return slot;
+  }
+}
+
+bool NodeTable::setCapacity(uint16_t capacity)
+{
+  free(_nodes);
+  free(_index);
+  _nodes = nullptr;
+  _index = nullptr;
+  _size = _capacity = _indexMask = 0;
+  _clearedVersion = ++_version;
+  if (!capacity) return true;
+
+  size_t slots = 2;
+  while (slots < 2U * capacity) slots <<= 1; // load factor <= 0.5
+  #ifdef ARDUINO_ARCH_ESP32
+  if (psramFound()) {
+    _nodes = (NodeStruct*)ps_calloc(capacity, sizeof(NodeStruct));
+    _index = (uint16_t*)ps_malloc(slots * sizeof(uint16_t));
+  } else
+  #endif
+  {
+    _nodes = (NodeStruct*)calloc(capacity, sizeof(NodeStruct));
+    _index = (uint16_t*)malloc(slots * sizeof(uint16_t));
+  }
+  if (!_nodes || !_index) {
+    DEBUG_PRINTLN(F("Node list allocation failed."));
+    free(_nodes);
+    free(_index);
+    _nodes = nullptr;
+    _index = nullptr;
+    return false;
+  }
+  memset(_index, 0xFF, slots * sizeof(uint16_t));
+  _capacity  = capacity;
+  _indexMask = slots - 1;
+  return true;
+}
+
+void NodeTable::clear()
+{
+  if (_index) memset(_index, 0xFF, (_indexMask + 1) * sizeof(uint16_t));
+  _size = 0;
+  _clearedVersion = ++_version; // clients need the full list
+}
+
+NodeStruct* NodeTable::find(IPAddress ip)
+{
+  int slot = findSlot(uint32_t(ip));
+  return slot < 0 ? nullptr : &_nodes[_index[slot]];
+}
+
+NodeStruct* NodeTable::findByName(const char *name)
+{
+  uint16_t h = hashNodeName(name);
+  for (size_t i = 0; i < _size; i++) {
+    if (_nodes[i].nameHash == h && !strcmp(_nodes[i].nodeName, name)) return &_nodes[i];
+  }
+  return nullptr;
+}
+
+NodeStruct* NodeTable::findUnit(uint8_t unit)
+{
+  for (size_t i = 0; i < _size; i++) if (_nodes[i].ip[3] == unit) return &_nodes[i];
+  return nullptr;
+}
+
+NodeStruct* NodeTable::add(IPAddress ip)
+{
+  NodeStruct *node = find(ip);
+  if (node || _size >= _capacity) return node;
+
+  node = new (&_nodes[_size]) NodeStruct(); // zeroed (IPAddress is not trivially constructible)
+  node->ip = ip;
+  node->lastSeen = millis();
+  size_t slot = slotOf(uint32_t(ip));
+  while (_index[slot] != NODE_INDEX_EMPTY) slot = (slot + 1) & _indexMask;
+  _index[slot] = _size++;
+  changed(node);
+  return node;
+}
+
+void NodeTable::remove(NodeStruct *node)
+{
+  int slot = findSlot(uint32_t(node->ip));
+  if (slot < 0) return;
+  uint16_t pos = _index[slot];
+
+  _removedIp[_removedCount % NODE_REMOVED_LOG]  = node->ip;
+  _removedVer[_removedCount % NODE_REMOVED_LOG] = ++_version;
+  _removedCount++;
+
+  // delete from index (backward shift, keeps probe sequences intact)
+  size_t hole = slot;
+  for (size_t next = (hole + 1) & _indexMask; _index[next] != NODE_INDEX_EMPTY; next = (next + 1) & _indexMask) {
+    size_t home = slotOf(uint32_t(_nodes[_index[next]].ip));
+    // move entry into hole if its home slot is not between hole and next (cyclically)
+    if (((next - home) & _indexMask) >= ((next - hole) & _indexMask)) {
+      _index[hole] = _index[next];
+      hole = next;
+    }
+  }
+  _index[hole] = NODE_INDEX_EMPTY;
+
+  // move last node into the gap
+  uint16_t last = --_size;
+  if (pos != last) {
+    _nodes[pos] = _nodes[last];
+    _index[findSlot(uint32_t(_nodes[pos].ip))] = pos;
+  }
+}
+
+void NodeTable::setName(NodeStruct *node, const char *name)
+{
+  if (!strncmp(node->nodeName, name, sizeof(node->nodeName))) return;
+  strlcpy(node->nodeName, name, sizeof(node->nodeName));
+  node->nameHash = hashNodeName(node->nodeName);
+  changed(node);
+}
+
+// IP addresses of nodes removed after version, false if more were removed than logged
+bool NodeTable::removedSince(uint32_t version, IPAddress *ips, size_t &count)
+{
+  count = 0;
+  if (version < _clearedVersion) return false;
+  size_t logged = MIN(_removedCount, (uint32_t)NODE_REMOVED_LOG);
+  for (size_t i = 0; i < logged; i++) {
+    size_t e = (_removedCount - 1 - i) % NODE_REMOVED_LOG; // newest first
+    if (_removedVer[e] <= version) return true;
+    ips[count++] = _removedIp[e];
+  }
+  return _removedCount <= NODE_REMOVED_LOG; // older removals may be missing
+}
@@ -90,6 +90,7 @@ void _overlayAnalogCountdown()
 void handleOverlayDraw() {
   usermods.handleOverlayDraw();
   if (overlayCurrent == 1) _overlayAnalogClock();
+  recordFrame(); // shown frame including overlays
 }
 
 /*
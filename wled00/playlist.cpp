@@ -5,28 +5,35 @@
  */
 
 typedef struct PlaylistEntry {
-  uint8_t preset; //ID of the preset to apply
-  uint16_t dur;   //Duration of the entry (in tenths of seconds)
-  uint16_t tr;    //Duration of the transition TO this entry (in tenths of seconds)
+  uint8_t  preset; //ID of the preset to apply
+  uint16_t tr;     //Duration of the transition TO this entry (in tenths of seconds)
+  uint32_t dur;    //Duration of the entry (in tenths of seconds)
 } ple;
 
-byte           playlistRepeat = 1;        //how many times to repeat the playlist (0 = infinitely)
-byte           playlistEndPreset = 0;     //what preset to apply after playlist end (0 = stay on last preset)
-byte           playlistOptions = 0;       //bit 0: shuffle playlist after each iteration. bits 1-7 TBD
+// a playlist entry may be a playlist itself: it is played (once if endless) and then the parent continues
+typedef struct Playlist {
+  PlaylistEntry *entries;
+  uint16_t len;        //number of playlist entries
+  int16_t  index;      //current entry (-1 before start)
+  uint16_t repeat;     //how many times to repeat the playlist (0 = infinitely)
+  byte     endPreset;  //what preset to apply after playlist end (0 = stay on last preset), not used for nested playlists
+  byte     options;    //bit 0: shuffle playlist after each iteration, see PL_OPTION_*
+} Playlist;
 
-PlaylistEntry *playlistEntries = nullptr;
-byte           playlistLen;               //number of playlist entries
-int8_t         playlistIndex = -1;
-uint16_t       playlistEntryDur = 0;      //duration of the current entry in tenths of seconds
+#define PLAYLIST_MAX_DUR  (0x7FFFFFFFUL / 100) // tenths of seconds (24 days)
+#define PLAYLIST_MAX_LATE 1000                   // ms, schedule restarts if a switch was delayed longer
 
-//values we need to keep about the parent playlist while inside sub-playlist
-//int8_t         parentPlaylistIndex = -1;
-//byte           parentPlaylistRepeat = 0;
-//byte           parentPlaylistPresetId = 0; //for re-loading
+static Playlist      playlists[PLAYLIST_MAX_DEPTH] = {}; // [0] is the loaded playlist, [playlistDepth] the running one
+static byte          playlistDepth = 0;
+static byte          playlistEntryPreset = 0;   //preset applied by the last switch (a playlist preset is nested)
+static bool          playlistPrefetched = false;
+static unsigned long playlistSwitchAt = 0;      //millis() the next entry starts at
+static unsigned long playlistLastSwitch = 0;
+static uint32_t      playlistEntryDur = 0;      //duration of the current entry in ms
 
 
-void shufflePlaylist() {
-  int currentIndex = playlistLen;
+static void shuffleEntries(Playlist &pl) {
+  int currentIndex = pl.len;
   PlaylistEntry temporaryValue;
 
   // While there remain elements to shuffle...
@@ -34,120 +41,210 @@ void shufflePlaylist() {
     // Pick a random element...
     int randomIndex = random(0, currentIndex);
     // And swap it with the current element.
-    temporaryValue = playlistEntries[currentIndex];
-    playlistEntries[currentIndex] = playlistEntries[randomIndex];
-    playlistEntries[randomIndex] = temporaryValue;
+    temporaryValue = pl.entries[currentIndex];
+    pl.entries[currentIndex] = pl.entries[randomIndex];
+    pl.entries[randomIndex] = temporaryValue;
   }
   DEBUG_PRINTLN(F("Playlist shuffle."));
 }
 
 
+void shufflePlaylist() {
+  shuffleEntries(playlists[playlistDepth]);
+}
+
+
 void unloadPlaylist() {
-  if (playlistEntries != nullptr) {
-    delete[] playlistEntries;
-    playlistEntries = nullptr;
+  for (int i = playlistDepth; i >= 0; i--) {
+    delete[] playlists[i].entries;
+    playlists[i].entries = nullptr;
+    playlists[i].len = 0;
   }
-  currentPlaylist = playlistIndex = -1;
-  playlistLen = playlistEntryDur = playlistOptions = 0;
+  playlistDepth = playlistEntryPreset = 0;
+  playlistPrefetched = false;
+  currentPlaylist = -1;
+  playlistEntryDur = 0;
   DEBUG_PRINTLN(F("Playlist unloaded."));
 }
 
 
 int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
-  unloadPlaylist();
+  // preset was applied as entry of the running playlist
+  bool nested = presetId && presetId == playlistEntryPreset && currentPlaylist >= 0;
+  if (nested) {
+    if (playlistDepth+1 >= PLAYLIST_MAX_DEPTH) return -1; // too deep (or recursive), skip entry
+  } else {
+    unloadPlaylist();
+  }
 
   JsonArray presets = playlistObj["ps"];
-  playlistLen = presets.size();
-  if (playlistLen == 0) return -1;
-  if (playlistLen > 100) playlistLen = 100;
+  size_t len = MIN(presets.size(), (size_t)PLAYLIST_MAX_ENTRIES);
+  if (len == 0) return -1;
 
-  playlistEntries = new PlaylistEntry[playlistLen];
-  if (playlistEntries == nullptr) return -1;
+  PlaylistEntry *entries = new PlaylistEntry[len];
+  if (entries == nullptr) return -1;
 
-  byte it = 0;
+  Playlist &pl = playlists[nested ? playlistDepth+1 : 0];
+  pl.entries = entries;
+  pl.len = len;
+  pl.index = -1;
+  pl.options = 0;
+
+  size_t it = 0;
   for (int ps : presets) {
-    if (it >= playlistLen) break;
-    playlistEntries[it].preset = ps;
+    if (it >= len) break;
+    entries[it].preset = ps;
     it++;
   }
 
   it = 0;
   JsonArray durations = playlistObj["dur"];
   if (durations.isNull()) {
-    playlistEntries[0].dur = playlistObj["dur"] | 100; //10 seconds as fallback
+    entries[0].dur = MIN(playlistObj["dur"] | 100UL, PLAYLIST_MAX_DUR); //10 seconds as fallback
     it = 1;
   } else {
-    for (int dur : durations) {
-      if (it >= playlistLen) break;
-      playlistEntries[it].dur = (dur > 1) ? dur : 100;
+    for (long dur : durations) {
+      if (it >= len) break;
+      entries[it].dur = (dur > 1) ? MIN((uint32_t)dur, PLAYLIST_MAX_DUR) : 100;
       it++;
     }
   }
-  for (int i = it; i < playlistLen; i++) playlistEntries[i].dur = playlistEntries[it -1].dur;
+  for (size_t i = it; i < len; i++) entries[i].dur = entries[it -1].dur;
 
   it = 0;
   JsonArray tr = playlistObj[F("transition")];
   if (tr.isNull()) {
-    playlistEntries[0].tr = playlistObj[F("transition")] | (transitionDelay / 100);
+    entries[0].tr = playlistObj[F("transition")] | (transitionDelay / 100);
     it = 1;
   } else {
     for (int transition : tr) {
-      if (it >= playlistLen) break;
-      playlistEntries[it].tr = transition;
+      if (it >= len) break;
+      entries[it].tr = transition;
       it++;
     }
   }
-  for (int i = it; i < playlistLen; i++) playlistEntries[i].tr = playlistEntries[it -1].tr;
+  for (size_t i = it; i < len; i++) entries[i].tr = entries[it -1].tr;
 
   int rep = playlistObj[F("repeat")];
   bool shuffle = false;
   if (rep < 0) { //support negative values as infinite + shuffle
     rep = 0; shuffle = true;
   }
+  if (nested && rep == 0) rep = 1; // endless nested playlist would never return to its parent
 
-  playlistRepeat = rep;
-  if (playlistRepeat > 0) playlistRepeat++; //add one extra repetition immediately since it will be deducted on first start
-  playlistEndPreset = playlistObj["end"] | 0;
+  pl.repeat = MIN(rep, UINT16_MAX -1);
+  if (pl.repeat > 0) pl.repeat++; //add one extra repetition immediately since it will be deducted on first start
+  pl.endPreset = playlistObj["end"] | 0;
   // if end preset is 255 restore original preset (if any running) upon playlist end
-  if (playlistEndPreset == 255 && currentPreset > 0) playlistEndPreset = currentPreset;
-  if (playlistEndPreset > 250) playlistEndPreset = 0;
+  if (pl.endPreset == 255 && currentPreset > 0) pl.endPreset = currentPreset;
+  if (pl.endPreset > 250) pl.endPreset = 0;
   shuffle = shuffle || playlistObj["r"];
-  if (shuffle) playlistOptions |= PL_OPTION_SHUFFLE;
+  if (shuffle) pl.options |= PL_OPTION_SHUFFLE;
 
+  playlistPrefetched = false;
+  if (nested) {
+    playlistDepth++;
+    playlistSwitchAt = playlistLastSwitch; // first entry starts instead of the parent entry
+    DEBUG_PRINTLN(F("Nested playlist loaded."));
+    return presetId;
+  }
+  playlistSwitchAt = millis();
   currentPlaylist = presetId;
   DEBUG_PRINTLN(F("Playlist loaded."));
   return currentPlaylist;
 }
 
 
+// preset the next switch applies (0 if none), shuffles an iteration ahead of its start
+static byte nextPlaylistPreset() {
+  for (int d = playlistDepth; d >= 0; d--) {
+    Playlist &pl = playlists[d];
+    if (pl.index >= 0 && pl.index+1 < pl.len) return pl.entries[pl.index+1].preset;
+    if (pl.repeat != 1) { // roll-over
+      if ((pl.options & PL_OPTION_SHUFFLE) && !(pl.options & PL_OPTION_SHUFFLED)) {
+        shuffleEntries(pl);
+        pl.options |= PL_OPTION_SHUFFLED;
+      }
+      return pl.entries[0].preset;
+    }
+    if (d == 0) return pl.endPreset;
+  }
+  return 0;
+}
+
+
+// parse preset into the preset cache ahead of its start, false if JSON buffer is busy
+static bool prefetchPlaylistPreset(byte preset) {
+  if (!tryJSONBufferLock(23)) return false;
+  if (prefetchPreset(preset, fileDoc)) {
+    // nested playlist: also its first entry (unless shuffled, the order is picked when it starts)
+    JsonObject nested = (*fileDoc)[F("playlist")];
+    if (!nested.isNull() && !nested["r"] && (nested[F("repeat")] | 0) >= 0) {
+      byte first = nested["ps"][0] | 0;
+      if (first) prefetchPreset(first, fileDoc);
+    }
+  }
+  releaseJSONBufferLock();
+  return true;
+}
+
+
 void handlePlaylist() {
-  static unsigned long presetCycledTime = 0;
+  if (currentPlaylist < 0 || playlists[playlistDepth].entries == nullptr) return;
+
+  long wait = playlistSwitchAt - millis();
+  if (wait > PLAYLIST_PREFETCH_TIME) return;
+  // next preset is read from flash and parsed before it is due, so applying it is just a copy
+  if (!playlistPrefetched) {
+    byte next = nextPlaylistPreset();
+    playlistPrefetched = !next || prefetchPlaylistPreset(next);
+  }
   // if fileDoc is not null JSON buffer is in use so just quit
-  if (currentPlaylist < 0 || playlistEntries == nullptr || fileDoc != nullptr) return;
+  if (wait > PLAYLIST_SWITCH_WAIT || fileDoc != nullptr) return;
+
+  waitUntilMillis(playlistSwitchAt); // preset is applied by handlePresets() in this loop
 
-  if (millis() - presetCycledTime > (100*playlistEntryDur)) {
-    presetCycledTime = millis();
-    if (bri == 0 || nightlightActive) return;
+  playlistLastSwitch = playlistSwitchAt;
+  if ((long)(millis() - playlistSwitchAt) > PLAYLIST_MAX_LATE) playlistLastSwitch = millis(); // far behind (e.g. JSON buffer was busy), restart schedule
+  if (bri == 0 || nightlightActive) {
+    playlistSwitchAt = playlistLastSwitch + playlistEntryDur;
+    return;
+  }
+  playlistPrefetched = false;
 
-    ++playlistIndex %= playlistLen; // -1 at 1st run (limit to playlistLen)
+  for (;;) {
+    Playlist &pl = playlists[playlistDepth];
+    if (++pl.index > 0 && pl.index < pl.len) break; // -1 at 1st run
 
     // playlist roll-over
-    if (!playlistIndex) {
-      if (playlistRepeat == 1) { //stop if all repetitions are done
-        unloadPlaylist();
-        if (playlistEndPreset) applyPreset(playlistEndPreset);
-        return;
+    pl.index = 0;
+    if (pl.repeat == 1) { //stop if all repetitions are done
+      if (playlistDepth) { // continue with parent playlist
+        delete[] pl.entries;
+        pl.entries = nullptr;
+        pl.len = 0;
+        playlistDepth--;
+        continue;
       }
-      if (playlistRepeat > 1) playlistRepeat--; // decrease repeat count on each index reset if not an endless playlist
-      // playlistRepeat == 0: endless loop
-      if (playlistOptions & PL_OPTION_SHUFFLE) shufflePlaylist(); // shuffle playlist and start over
+      byte endPreset = pl.endPreset;
+      unloadPlaylist();
+      if (endPreset) applyPreset(endPreset);
+      return;
     }
-
-    jsonTransitionOnce = true;
-    strip.setTransition(fadeTransition ? playlistEntries[playlistIndex].tr * 100 : 0);
-    playlistEntryDur = playlistEntries[playlistIndex].dur;
-    applyPreset(playlistEntries[playlistIndex].preset);
+    if (pl.repeat > 1) pl.repeat--; // decrease repeat count on each index reset if not an endless playlist
+    // pl.repeat == 0: endless loop
+    if (pl.options & PL_OPTION_SHUFFLED) pl.options &= ~PL_OPTION_SHUFFLED; // shuffled by prefetch already
+    else if (pl.options & PL_OPTION_SHUFFLE) shuffleEntries(pl); // shuffle playlist and start over
+    break;
   }
+
+  const PlaylistEntry &entry = playlists[playlistDepth].entries[playlists[playlistDepth].index];
+  jsonTransitionOnce = true;
+  strip.setTransition(fadeTransition ? entry.tr * 100 : 0);
+  playlistEntryDur = entry.dur * 100;
+  playlistSwitchAt = playlistLastSwitch + playlistEntryDur;
+  playlistEntryPreset = entry.preset;
+  applyPreset(entry.preset);
 }
 
 
@@ -156,12 +253,13 @@ void serializePlaylist(JsonObject sObj) {
   JsonArray ps = playlist.createNestedArray("ps");
   JsonArray dur = playlist.createNestedArray("dur");
   JsonArray transition = playlist.createNestedArray(F("transition"));
-  playlist[F("repeat")] = (playlistIndex < 0 && playlistRepeat > 0) ? playlistRepeat - 1 : playlistRepeat; // remove added repetition count (if not yet running)
-  playlist["end"] = playlistEndPreset;
-  playlist["r"] = playlistOptions & PL_OPTION_SHUFFLE;
-  for (int i=0; i<playlistLen; i++) {
-    ps.add(playlistEntries[i].preset);
-    dur.add(playlistEntries[i].dur);
-    transition.add(playlistEntries[i].tr);
+  const Playlist &pl = playlists[0];
+  playlist[F("repeat")] = (pl.index < 0 && pl.repeat > 0) ? pl.repeat - 1 : pl.repeat; // remove added repetition count (if not yet running)
+  playlist["end"] = pl.endPreset;
+  playlist["r"] = pl.options & PL_OPTION_SHUFFLE;
+  for (int i=0; i<pl.len; i++) {
+    ps.add(pl.entries[i].preset);
+    dur.add(pl.entries[i].dur);
+    transition.add(pl.entries[i].tr);
   }
 }
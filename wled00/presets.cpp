@@ -1,7 +1,7 @@
 #include "wled.h"
 
 /*
- * Methods to handle saving and loading presets to/from the filesystem
+ * Methods to handle saving and loading presets to/from the filesystem (see presetstore.cpp)
  */
 
 #ifdef ARDUINO_ARCH_ESP32
@@ -14,19 +14,110 @@ static volatile byte presetToSave = 0;
 static volatile int8_t saveLedmap = -1;
 static char quickLoad[9];
 static char saveName[33];
-static bool includeBri = true, segBounds = true, selectedOnly = false, playlistSave = false;;
+static bool includeBri = true, segBounds = true, selectedOnly = false, segPriority = false, playlistSave = false;;
 
 static const char *getFileName(bool persist = true) {
   return persist ? "/presets.json" : "/tmp.json";
 }
 
+static volatile bool presetCacheDirty = false;
+static volatile bool presetsToImport = true; // import presets.json (legacy file at boot or uploaded backup)
+
+// recently applied presets, already parsed (no FS access and no JSON parsing, just a copy)
+struct PresetCacheEntry {
+  PSRAMDynamicJsonDocument *doc;
+  uint8_t  id;
+  uint32_t lastUsed;
+};
+static PresetCacheEntry presetCache[PRESET_CACHE_ENTRIES] = {};
+static uint32_t presetCacheTick = 0;
+
+static void clearPresetCache() {
+  presetCacheDirty = false;
+  for (auto &e : presetCache) {
+    delete e.doc;
+    e.doc = nullptr;
+  }
+}
+
+static void cachePreset(byte index, JsonDocument *src) {
+  size_t len = src->memoryUsage();
+  if (len == 0 || len > PRESET_CACHE_MAX_SIZE) return;
+  PresetCacheEntry *slot = presetCache; // free or least recently used entry
+  for (auto &e : presetCache) {
+    if (!e.doc) { slot = &e; break; }
+    if (e.lastUsed < slot->lastUsed) slot = &e;
+  }
+  delete slot->doc;
+  slot->doc = new PSRAMDynamicJsonDocument(len);
+  if (slot->doc && (slot->doc->capacity() < len || !slot->doc->set(*src))) {
+    delete slot->doc;
+    slot->doc = nullptr;
+  }
+  if (!slot->doc) return;
+  slot->id = index;
+  slot->lastUsed = ++presetCacheTick;
+}
+
+// read preset from cache or preset store
+static bool readPreset(byte index, JsonDocument *dest, bool cache = true) {
+  if (presetCacheDirty) clearPresetCache();
+  for (auto &e : presetCache) {
+    if (!e.doc || e.id != index) continue;
+    e.lastUsed = ++presetCacheTick;
+    if (dest->set(*e.doc)) return true;
+  }
+
+  bool found = presetStoreRead(index, dest);
+  if (found && cache) cachePreset(index, dest);
+  return found;
+}
+
+// read and parse preset ahead of applying it (playlist), it is then applied from the cache
+bool prefetchPreset(byte index, JsonDocument *dest) {
+  if (index == 0 || index > 250) return false;
+  return readPreset(index, dest);
+}
+
+// presets were changed (may be called from async web server)
+void invalidatePresetCache() {
+  presetCacheDirty = true;
+}
+
+// import uploaded presets.json in loop (needs JSON buffer)
+void importPresets() {
+  presetsToImport = true;
+}
+
+// replace all presets with the ones from presets.json, keep the file as presets.bak
+static void importPresetsFile() {
+  if (!WLED_FS.exists(getFileName())) {
+    presetsToImport = false;
+    return;
+  }
+  if (!requestJSONBufferLock(22)) return; // try again next loop
+  presetsToImport = false;
+
+  DEBUG_PRINTLN(F("Importing presets.json"));
+  if (presetStoreImport(getFileName(), fileDoc)) {
+    WLED_FS.remove("/presets.bak");
+    WLED_FS.rename(getFileName(), "/presets.bak");
+    presetsModifiedTime = toki.second(); //unix time
+  } else {
+    errorFlag = ERR_FS_GENERAL;
+  }
+  invalidatePresetCache();
+  releaseJSONBufferLock();
+  updateFSInfo();
+}
+
 static void doSaveState() {
   bool persist = (presetToSave < 251);
   const char *filename = getFileName(persist);
 
   if (!requestJSONBufferLock(10)) return; // will set fileDoc
 
-  initPresetsFile(); // just in case if someone deleted presets.json using /edit
+  initPresetsFile(); // just in case if someone deleted preset store using /edit
   JsonObject sObj = doc.to<JsonObject>();
 
   DEBUG_PRINTLN(F("Serialize current state"));
@@ -34,7 +125,7 @@ static void doSaveState() {
     serializePlaylist(sObj);
     if (includeBri) sObj["on"] = true;
   } else {
-    serializeState(sObj, true, includeBri, segBounds, selectedOnly);
+    serializeState(sObj, true, includeBri, segBounds, selectedOnly, segPriority);
   }
   sObj["n"] = saveName;
   if (quickLoad[0]) sObj[F("ql")] = quickLoad;
@@ -65,9 +156,13 @@ static void doSaveState() {
     }
   } else
   #endif
-  writeObjectToFileUsingId(filename, presetToSave, fileDoc);
+  if (persist) presetStoreWrite(presetToSave, fileDoc);
+  else         writeObjectToFileUsingId(filename, presetToSave, fileDoc);
 
-  if (persist) presetsModifiedTime = toki.second(); //unix time
+  if (persist) {
+    presetsModifiedTime = toki.second(); //unix time
+    invalidatePresetCache();
+  }
   releaseJSONBufferLock();
   updateFSInfo();
 
@@ -83,7 +178,7 @@ bool getPresetName(byte index, String& name)
 {
   if (!requestJSONBufferLock(9)) return false;
   bool presetExists = false;
-  if (readObjectFromFileUsingId(getFileName(), index, &doc))
+  if (readPreset(index, &doc, false))
   {
     JsonObject fdo = doc.as<JsonObject>();
     if (fdo["n"]) {
@@ -97,18 +192,7 @@ bool getPresetName(byte index, String& name)
 
 void initPresetsFile()
 {
-  if (WLED_FS.exists(getFileName())) return;
-
-  StaticJsonDocument<64> doc;
-  JsonObject sObj = doc.to<JsonObject>();
-  sObj.createNestedObject("0");
-  File f = WLED_FS.open(getFileName(), "w");
-  if (!f) {
-    errorFlag = ERR_FS_GENERAL;
-    return;
-  }
-  serializeJson(doc, f);
-  f.close();
+  if (!initPresetStore()) errorFlag = ERR_FS_GENERAL;
 }
 
 bool applyPreset(byte index, byte callMode)
@@ -136,6 +220,11 @@ void handlePresets()
     return;
   }
 
+  if (presetsToImport && !fileDoc) {
+    importPresetsFile();
+    return;
+  }
+
   if (presetToApply == 0 || fileDoc) return; // no preset waiting to apply, or JSON buffer is already allocated, return to loop until free
 
   bool changePreset = false;
@@ -161,10 +250,20 @@ void handlePresets()
   } else
   #endif
   {
-  errorFlag = readObjectFromFileUsingId(filename, tmpPreset, fileDoc) ? ERR_NONE : ERR_FS_PLOAD;
+  bool found = tmpPreset < 255 ? readPreset(tmpPreset, fileDoc) : readObjectFromFileUsingId(filename, tmpPreset, fileDoc);
+  errorFlag = found ? ERR_NONE : ERR_FS_PLOAD;
   }
   fdo = fileDoc->as<JsonObject>();
 
+  strip.suspend(); // preset is applied as a whole, not while effects are rendered in a separate task
+  if (!strip.waitUntilIdle()) {
+    strip.resume();
+    presetToApply = tmpPreset; // retried in next loop
+    callModeToApply = tmpMode;
+    releaseJSONBufferLock();
+    return;
+  }
+
   //HTTP API commands
   const char* httpwin = fdo["win"];
   if (httpwin) {
@@ -181,6 +280,7 @@ void handlePresets()
     deserializeState(fdo, CALL_MODE_NO_NOTIFY, tmpPreset); // may change presetToApply by calling applyPreset()
   }
   if (!errorFlag && tmpPreset < 255 && changePreset) currentPreset = tmpPreset;
+  strip.resume();
 
   #if defined(ARDUINO_ARCH_ESP32)
   //Aircoookie recommended not to delete buffer
@@ -216,6 +316,7 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
     includeBri   = sObj["ib"].as<bool>() || sObj.size()==0 || index==255; // temporary preset needs brightness
     segBounds    = sObj["sb"].as<bool>() || sObj.size()==0 || index==255; // temporary preset needs bounds
     selectedOnly = sObj[F("sc")].as<bool>();
+    segPriority  = sObj[F("sp")].as<bool>() || sObj.size()==0 || index==255; // render priority (pri, mfps) of segments
     saveLedmap   = sObj[F("ledmap")] | -1;
   } else {
     // this is a playlist or API call
@@ -229,9 +330,10 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
       sObj.remove(F("error"));
       sObj.remove(F("psave"));
       if (sObj["n"].isNull()) sObj["n"] = saveName;
-      initPresetsFile(); // just in case if someone deleted presets.json using /edit
-      writeObjectToFileUsingId(getFileName(index<255), index, fileDoc);
+      initPresetsFile(); // just in case if someone deleted preset store using /edit
+      presetStoreWrite(index, fileDoc);
       presetsModifiedTime = toki.second(); //unix time
+      invalidatePresetCache();
       updateFSInfo();
     } else {
       // store playlist
@@ -244,7 +346,8 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
 
 void deletePreset(byte index) {
   StaticJsonDocument<24> empty;
-  writeObjectToFileUsingId(getFileName(), index, &empty);
+  presetStoreWrite(index, &empty);
   presetsModifiedTime = toki.second(); //unix time
+  invalidatePresetCache();
   updateFSInfo();
 }
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "wled.h"
+
+/*
+ * Indexed preset storage, replaces editing presets.json in place
+ *
+ * file:   header, records
+ * header: 'W','P','S', PSTORE_VERSION, then PSTORE_ENTRIES x {offset, length} (uint32 little endian, length 0 = no preset)
+ * record: preset JSON object (same as in presets.json)
+ *
+ * Saving a preset appends a new record and then updates its header entry, the old record is left in place until
+ * the file is compacted. Both writes use the same file handle and LittleFS commits them on close, so a power loss
+ * while saving leaves the previous version of the file. Compaction and import write a new file and replace
+ * the store with rename.
+ * This relies on LittleFS (WLED_FS on all platforms, see wled.h): it writes a file opened with "r+" copy-on-write
+ * and makes the changes visible together on close. On SPIFFS the header entry would be overwritten in place
+ * and could be torn by a power loss, so the store must not be used with it.
+ * GET /presets.json exports a standard presets.json (used by UI and for backup), an uploaded presets.json is imported.
+ * The FS editor lists the export as a read only presets.json (see wled_server.cpp).
+ */
+
+#define PSTORE_VERSION     1
+#define PSTORE_ENTRIES     251 // preset IDs 1-250, entry 0 is unused
+#define PSTORE_HEADER_SIZE (4 + PSTORE_ENTRIES*8)
+#define PSTORE_BUFSIZE     256
+#define PSTORE_COMPACT_MIN 4096 // don't compact if less space is wasted
+#define PSTORE_TMP_FILE    "/presets.tmp"
+
+static volatile uint8_t presetStoreExports = 0;  // running /presets.json responses (read records, no compaction)
+static volatile bool presetStoreCompacting = false;
+
+static uint32_t getU32(const uint8_t *p) {
+  return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void putU32(uint8_t *p, uint32_t v) {
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static bool isValidStore(File &f) {
+  uint8_t m[4];
+  return f.size() >= PSTORE_HEADER_SIZE && f.seek(0, SeekSet) && f.read(m, 4) == 4
+      && m[0] == 'W' && m[1] == 'P' && m[2] == 'S' && m[3] == PSTORE_VERSION;
+}
+
+static bool writeEmptyHeader(File &f) {
+  uint8_t buf[PSTORE_BUFSIZE] = {'W', 'P', 'S', PSTORE_VERSION};
+  size_t written = f.write(buf, MIN(PSTORE_BUFSIZE, PSTORE_HEADER_SIZE));
+  memset(buf, 0, 4);
+  while (written < PSTORE_HEADER_SIZE) {
+    size_t w = f.write(buf, MIN(PSTORE_BUFSIZE, PSTORE_HEADER_SIZE - written));
+    if (!w) return false;
+    written += w;
+  }
+  return true;
+}
+
+// returns false if there is no (valid) record for the preset
+static bool readEntry(File &f, uint8_t id, uint32_t &off, uint32_t &len) {
+  uint8_t e[8];
+  if (!f.seek(4 + id*8, SeekSet) || f.read(e, 8) != 8) return false;
+  off = getU32(e);
+  len = getU32(e+4);
+  return len && off >= PSTORE_HEADER_SIZE && off + len <= f.size();
+}
+
+static bool writeEntry(File &f, uint8_t id, uint32_t off, uint32_t len) {
+  uint8_t e[8];
+  putU32(e, off);
+  putU32(e+4, len);
+  return f.seek(4 + id*8, SeekSet) && f.write(e, 8) == 8;
+}
+
+// append record to the end of the file, returns length
+static uint32_t copyRecord(File &src, uint32_t off, uint32_t len, File &dst) {
+  uint8_t buf[PSTORE_BUFSIZE];
+  uint32_t copied = 0;
+  if (!src.seek(off, SeekSet) || !dst.seek(dst.size(), SeekSet)) return 0;
+  while (copied < len) {
+    size_t r = src.read(buf, MIN(PSTORE_BUFSIZE, len - copied));
+    if (!r || dst.write(buf, r) != r) return 0;
+    copied += r;
+  }
+  return copied;
+}
+
+// replace store with the file written to PSTORE_TMP_FILE
+static bool commitTmpStore() {
+  if (WLED_FS.rename(PSTORE_TMP_FILE, PRESETS_STORE_FILE)) return true;
+  WLED_FS.remove(PRESETS_STORE_FILE); // FS can't rename to an existing file (SPIFFS)
+  return WLED_FS.rename(PSTORE_TMP_FILE, PRESETS_STORE_FILE);
+}
+
+// rewrite store without unused records, not done while /presets.json is sent
+static bool compactPresetStore() {
+  if (presetStoreExports) return false;
+  presetStoreCompacting = true;
+  if (presetStoreExports) {
+    presetStoreCompacting = false;
+    return false;
+  }
+  DEBUG_PRINTLN(F("Compacting preset store"));
+  #ifdef WLED_DEBUG
+  uint32_t s = millis();
+  #endif
+
+  File src = WLED_FS.open(PRESETS_STORE_FILE, "r");
+  File dst = WLED_FS.open(PSTORE_TMP_FILE, "w+");
+  bool ok = src && dst && isValidStore(src) && writeEmptyHeader(dst);
+  for (uint8_t id = 1; ok && id < PSTORE_ENTRIES; id++) {
+    uint32_t off, len;
+    if (!readEntry(src, id, off, len)) continue;
+    uint32_t newOff = dst.size();
+    ok = copyRecord(src, off, len, dst) == len && writeEntry(dst, id, newOff, len);
+  }
+  if (src) src.close();
+  if (dst) dst.close();
+  ok = ok && commitTmpStore();
+  if (!ok) WLED_FS.remove(PSTORE_TMP_FILE);
+  presetStoreCompacting = false;
+  DEBUG_PRINTF("Compacted (%d) in %u ms\n", (int)ok, millis() - s);
+  return ok;
+}
+
+// create store if it does not exist (or is invalid), finish interrupted compaction/import
+bool initPresetStore() {
+  if (WLED_FS.exists(PSTORE_TMP_FILE)) {
+    if (!WLED_FS.exists(PRESETS_STORE_FILE)) commitTmpStore(); // old store was removed, new one is complete
+    else WLED_FS.remove(PSTORE_TMP_FILE);
+  }
+  File f = WLED_FS.open(PRESETS_STORE_FILE, "r");
+  if (f) {
+    bool valid = isValidStore(f);
+    f.close();
+    if (valid) return true;
+    DEBUG_PRINTLN(F("Preset store invalid!"));
+  }
+  f = WLED_FS.open(PRESETS_STORE_FILE, "w");
+  if (!f) return false;
+  bool ok = writeEmptyHeader(f);
+  f.close();
+  return ok;
+}
+
+bool presetStoreRead(uint8_t id, JsonDocument* dest) {
+  dest->clear();
+  if (id == 0 || id >= PSTORE_ENTRIES) return false;
+  File f = WLED_FS.open(PRESETS_STORE_FILE, "r");
+  if (!f) return false;
+  uint32_t off, len;
+  bool found = readEntry(f, id, off, len) && f.seek(off, SeekSet) && !deserializeJson(*dest, f);
+  f.close();
+  return found;
+}
+
+// save preset (null document deletes it), caller must hold JSON buffer lock (no concurrent writes)
+bool presetStoreWrite(uint8_t id, JsonDocument* content) {
+  if (id == 0 || id >= PSTORE_ENTRIES) return false;
+  size_t contentLen = content->isNull() ? 0 : measureJson(*content);
+
+  if (contentLen) {
+    updateFSInfo();
+    if (fsBytesUsed + contentLen + PSTORE_BUFSIZE > fsBytesTotal) compactPresetStore(); // reclaim space first
+    updateFSInfo();
+    if (fsBytesUsed + contentLen + PSTORE_BUFSIZE > fsBytesTotal) {
+      errorFlag = ERR_FS_QUOTA;
+      return false;
+    }
+  }
+
+  File f = WLED_FS.open(PRESETS_STORE_FILE, "r+");
+  if (!f || !isValidStore(f)) {
+    if (f) f.close();
+    if (!initPresetStore()) return false;
+    f = WLED_FS.open(PRESETS_STORE_FILE, "r+");
+    if (!f) return false;
+  }
+
+  uint32_t off = 0, len = 0;
+  if (contentLen) {
+    off = f.size();
+    if (f.seek(off, SeekSet)) len = serializeJson(*content, f);
+    if (len != contentLen) { // incomplete record is never referenced
+      f.close();
+      errorFlag = ERR_FS_QUOTA;
+      return false;
+    }
+  }
+  bool ok = writeEntry(f, id, off, len);
+
+  uint32_t used = PSTORE_HEADER_SIZE, size = f.size();
+  uint8_t e[PSTORE_BUFSIZE - PSTORE_BUFSIZE % 8]; // header entries, read in blocks
+  for (uint16_t i = 0; ok && i < PSTORE_ENTRIES; i += sizeof(e)/8) {
+    size_t n = MIN(sizeof(e)/8, PSTORE_ENTRIES - i);
+    if (!f.seek(4 + i*8, SeekSet) || f.read(e, n*8) != n*8) break;
+    for (size_t j = 0; j < n; j++) {
+      uint32_t o = getU32(e + j*8), l = getU32(e + j*8 + 4);
+      if (i + j && l && o >= PSTORE_HEADER_SIZE && o + l <= size) used += l; // same checks as readEntry()
+    }
+  }
+  uint32_t wasted = size - used;
+  f.close(); // commit
+  DEBUG_PRINTF("Preset %d stored, %u bytes unused\n", id, wasted);
+
+  if (!ok) errorFlag = ERR_FS_GENERAL;
+  else if (wasted > PSTORE_COMPACT_MIN && wasted > used) compactPresetStore();
+  return ok;
+}
+
+static std::vector<std::pair<uint8_t, uint32_t>> importList;
+
+static void addToImport(uint16_t id, uint32_t pos) {
+  if (id > 0 && id < PSTORE_ENTRIES) importList.emplace_back(id, pos);
+}
+
+// replace all presets with the ones from a presets.json file, buf is used to read them one at a time
+bool presetStoreImport(const char* file, JsonDocument* buf) {
+  if (presetStoreExports) return false;
+  importList.clear();
+  if (!indexObjectsInFile(file, addToImport)) return false;
+
+  File dst = WLED_FS.open(PSTORE_TMP_FILE, "w+");
+  bool ok = dst && writeEmptyHeader(dst);
+  for (auto &e : importList) {
+    if (!ok) break;
+    if (!readObjectFromFileAtPos(file, e.first, e.second, buf) || buf->as<JsonObject>().size() == 0) continue; // skip deleted
+    uint32_t off = dst.size();
+    size_t len = measureJson(*buf);
+    ok = dst.seek(off, SeekSet) && serializeJson(*buf, dst) == len && writeEntry(dst, e.first, off, len);
+  }
+  DEBUG_PRINTF("Imported %u presets\n", importList.size());
+  importList.clear();
+  importList.shrink_to_fit();
+  if (dst) dst.close();
+  ok = ok && commitTmpStore();
+  if (!ok) WLED_FS.remove(PSTORE_TMP_FILE);
+  buf->clear();
+  return ok;
+}
+
+// state of a /presets.json response: snapshot of header (records are not moved while exporting)
+struct PresetExport {
+  uint8_t  entries[PSTORE_ENTRIES*8];
+  uint16_t id  = 0;  // current part: 0 = opening, 1-250 = preset, PSTORE_ENTRIES = closing
+  uint32_t pos = 0;  // position in current part
+  PresetExport()  { presetStoreExports++; }
+  ~PresetExport() { presetStoreExports--; }
+};
+
+static size_t fillExport(PresetExport &ex, uint8_t *buf, size_t maxLen) {
+  File f;
+  size_t n = 0;
+  while (n < maxLen && ex.id <= PSTORE_ENTRIES) {
+    char key[12];
+    size_t keyLen;
+    uint32_t off = 0, len = 0;
+    if (ex.id == 0) {
+      keyLen = strlcpy(key, "{\"0\":{}", sizeof(key)); // dummy object, see file.cpp
+    } else if (ex.id == PSTORE_ENTRIES) {
+      keyLen = strlcpy(key, "}", sizeof(key));
+    } else {
+      off = getU32(ex.entries + ex.id*8);
+      len = getU32(ex.entries + ex.id*8 + 4);
+      if (!len) { ex.id++; continue; }
+      keyLen = sprintf(key, ",\"%d\":", ex.id);
+    }
+
+    if (ex.pos < keyLen) {
+      size_t c = MIN(keyLen - ex.pos, maxLen - n);
+      memcpy(buf + n, key + ex.pos, c);
+      n += c;
+      ex.pos += c;
+      continue;
+    }
+    uint32_t recPos = ex.pos - keyLen;
+    if (recPos < len) {
+      if (!f) f = WLED_FS.open(PRESETS_STORE_FILE, "r");
+      size_t c = 0;
+      if (f && f.seek(off + recPos, SeekSet)) c = f.read(buf + n, MIN(len - recPos, maxLen - n));
+      if (!c) { // file was changed, can't continue
+        ex.id = PSTORE_ENTRIES+1;
+        break;
+      }
+      n += c;
+      ex.pos += c;
+      continue;
+    }
+    ex.id++;
+    ex.pos = 0;
+  }
+  if (f) f.close();
+  return n;
+}
+
+// size of the /presets.json export
+size_t presetsJsonSize() {
+  File f = WLED_FS.open(PRESETS_STORE_FILE, "r");
+  if (!f || !isValidStore(f)) {
+    if (f) f.close();
+    return 0;
+  }
+  size_t size = 8; // {"0":{} and }
+  for (uint8_t id = 1; id < PSTORE_ENTRIES; id++) {
+    uint32_t off, len;
+    if (readEntry(f, id, off, len)) size += len + (id < 10 ? 5 : id < 100 ? 6 : 7); // ,"id":
+  }
+  f.close();
+  return size;
+}
+
+void servePresetsJson(AsyncWebServerRequest* request) {
+  std::shared_ptr<PresetExport> ex = std::make_shared<PresetExport>();
+  File f;
+  if (!presetStoreCompacting) f = WLED_FS.open(PRESETS_STORE_FILE, "r");
+  if (!f || !isValidStore(f) || f.read(ex->entries, sizeof(ex->entries)) != sizeof(ex->entries)) {
+    if (f) f.close();
+    request->send(503, "application/json", F("{\"error\":19}"));
+    return;
+  }
+  for (uint8_t id = 1; id < PSTORE_ENTRIES; id++) {
+    uint32_t off = getU32(ex->entries + id*8), len = getU32(ex->entries + id*8 + 4);
+    if (off < PSTORE_HEADER_SIZE || off + len > f.size()) putU32(ex->entries + id*8 + 4, 0);
+  }
+  f.close();
+
+  AsyncWebServerResponse *response = request->beginChunkedResponse("application/json", [ex](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+    return fillExport(*ex, buf, maxLen);
+  });
+  request->send(response);
+}
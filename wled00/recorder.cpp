@@ -0,0 +1,250 @@
+#include "wled.h"
+
+/*
+ * Frame recorder: captures the shown frames (composited segments and overlays, before brightness and current limiting)
+ * into a WLED frame file on the filesystem (format see fseq.cpp), to be replayed by frame playback or compared offline.
+ * The strip copies every pixel set into a capture buffer (WS2812FX::setCaptureBuffer()), so colors are recorded as
+ * set, not as restored from the bus (scaled by brightness, white calculated). RGBW strips are recorded with white.
+ * The file is downloadable over HTTP like any other file (GET /<name>, or /edit).
+ *
+ * Frames are recorded on a grid of step ms: a slot without a shown frame repeats the previous one (empty frame).
+ * They are encoded in the show callback (render task or loop) into a RAM buffer that is written to the file in loop,
+ * as the filesystem must not be accessed concurrently. If the buffer is full (filesystem too slow) a frame is dropped.
+ *
+ * JSON API (state): "rec":{"f":"/rec.wfr","on":bool,"step":ms (default frame time),"n":max. frames}
+ */
+
+#define REC_HEADER_SIZE  16
+#define REC_FS_RESERVE   32768 // stop recording if less filesystem space is left
+
+static volatile bool   recActive = false;      // frames are captured
+static volatile size_t recHead = 0, recTail = 0; // encoded data in recBuffer (producer: show, consumer: loop)
+static uint8_t  *recBuffer = nullptr;
+static size_t    recBufferSize = 0;
+static uint32_t *recFrame = nullptr;           // capture buffer: current frame (as set by strip.setPixelColor())
+static uint8_t  *recPrev = nullptr;            // last recorded frame (RGB or RGBW)
+static size_t    recPixels = 0;
+static uint8_t   recBpp = 3;                   // bytes per pixel
+static uint16_t  recStep = 0;
+static uint32_t  recMaxFrames = 0;
+static uint32_t  recStartTime = 0;            // millis() of first frame
+static volatile uint32_t recFrames = 0;        // frames (slots) recorded
+static volatile uint32_t recDropped = 0;
+static size_t    recWritten = 0;
+static File      recFile;
+static char      recFileName[33] = "";
+// requests from API (applied in loop)
+static volatile bool recStartRequested = false, recStopRequested = false;
+static char      recReqName[33] = "";
+static uint16_t  recReqStep = 0;
+static uint32_t  recReqFrames = 0;
+
+static void putU32(uint8_t *p, uint32_t v) {
+  for (size_t i = 0; i < 4; i++) p[i] = v >> (8*i);
+}
+
+static size_t worstFrameSize() {
+  return 4 + recBpp*recPixels + recPixels/64 + 2;
+}
+
+// encodes current frame (delta to recPrev) into dst, returns size including frame header
+static size_t encodeFrame(uint8_t *dst, bool key) {
+  enum : uint8_t { OP_NONE, OP_LIT, OP_SKIP, OP_RPT };
+  const size_t bpp = recBpp;
+  uint8_t op = OP_NONE, n = 0;
+  size_t pos = 4, opPos = 0;
+  uint8_t last[4] = {0};
+  for (size_t p = 0; p < recPixels; p++) {
+    uint32_t c = recFrame[p];
+    uint8_t rgb[4] = {R(c), G(c), B(c), W(c)}; // white is only stored if bpp is 4
+    uint8_t *prev = recPrev + p*bpp;
+    if (!key && !memcmp(prev, rgb, bpp)) {
+      if (op == OP_SKIP && n < 64) n++;
+      else { op = OP_SKIP; n = 1; opPos = pos++; }
+    } else {
+      if (op == OP_RPT && n < 64 && !memcmp(last, rgb, bpp)) n++;
+      else if (op == OP_LIT && !memcmp(last, rgb, bpp)) {
+        // repeated pixel: turn last literal into a repeat
+        if (n == 1) op = OP_RPT;
+        else { dst[opPos] = n-2; pos -= bpp; opPos = pos++; memcpy(dst+pos, rgb, bpp); pos += bpp; op = OP_RPT; n = 1; }
+        n++;
+      } else if (op == OP_LIT && n < 128) {
+        memcpy(dst+pos, rgb, bpp); pos += bpp; n++;
+      } else {
+        op = OP_LIT; n = 1; opPos = pos++;
+        memcpy(dst+pos, rgb, bpp); pos += bpp;
+      }
+      memcpy(last, rgb, bpp);
+      memcpy(prev, rgb, bpp);
+    }
+    dst[opPos] = (op == OP_LIT ? 0x00 : op == OP_SKIP ? 0x80 : 0xC0) | (n-1);
+  }
+  putU32(dst, (pos - 4) | (key ? FSEQ_WFR_KEY : 0));
+  return pos;
+}
+
+// show callback: record frame (may run in render task)
+void recordFrame() {
+  if (!recActive) return;
+  if (!recFrames) recStartTime = millis();
+  uint32_t slot = (millis() - recStartTime) / recStep;
+  if (recFrames && slot < recFrames) return; // slot recorded already
+  if (recTail == recHead) recHead = recTail = 0; // all written, start over at beginning of buffer
+
+  // slots without shown frame repeat the previous one
+  size_t head = recHead;
+  size_t empty = recFrames ? MIN(slot - recFrames, recMaxFrames - recFrames - 1) : 0;
+  if (head + 4*empty + worstFrameSize() > recBufferSize) {
+    recDropped++;
+    return;
+  }
+  for (size_t i = 0; i < empty; i++, head += 4) putU32(recBuffer + head, 0);
+  head += encodeFrame(recBuffer + head, recFrames == 0);
+  recFrames += empty + 1;
+  recHead = head;
+  if (recFrames >= recMaxFrames) recActive = false;
+}
+
+static void writeRecorded() {
+  size_t head = recHead, tail = recTail;
+  if (head <= tail) return;
+  recWritten += recFile.write(recBuffer + tail, head - tail);
+  recTail = head;
+}
+
+static void freeRecorder() {
+  free(recBuffer);
+  free(recPrev);
+  free(recFrame);
+  recBuffer = recPrev = nullptr;
+  recFrame = nullptr;
+}
+
+// returns false if render task is busy (recording is stopped, file is finished by handleRecorder())
+static bool stopRecording() {
+  if (!recBuffer) return true;
+  recActive = false; // no new frame is recorded
+  strip.suspend(); // frame may be being recorded in render task
+  bool idle = strip.waitUntilIdle();
+  if (idle) strip.setCaptureBuffer(nullptr, 0);
+  strip.resume();
+  if (!idle) return false;
+  writeRecorded();
+  recFile.close();
+  freeRecorder();
+
+  // number of frames in header
+  File f = WLED_FS.open(recFileName, "r+");
+  if (f) {
+    uint8_t n[4];
+    putU32(n, recFrames);
+    f.seek(8);
+    f.write(n, sizeof(n));
+    f.close();
+  }
+  updateFSInfo();
+  DEBUG_PRINTF("Recording stopped: %u frames, %u dropped, %u bytes\n", recFrames, recDropped, recWritten + REC_HEADER_SIZE);
+  return true;
+}
+
+static bool startRecording() {
+  recPixels = strip.getLengthTotal();
+  recBpp    = strip.hasWhiteChannel() ? 4 : 3;
+  recStep   = recReqStep ? recReqStep : MAX(strip.getFrameTime(), (uint16_t)1);
+  recMaxFrames = recReqFrames ? recReqFrames : UINT32_MAX;
+  recBufferSize = MAX((size_t)REC_BUFFER_SIZE, 2*worstFrameSize());
+  #ifdef ARDUINO_ARCH_ESP32
+  if (psramFound()) {
+    recBuffer = (uint8_t*)ps_malloc(recBufferSize);
+    recPrev   = (uint8_t*)ps_calloc(recPixels, recBpp);
+    recFrame  = (uint32_t*)ps_malloc(recPixels * sizeof(uint32_t));
+  } else
+  #endif
+  {
+    recBuffer = (uint8_t*)malloc(recBufferSize);
+    recPrev   = (uint8_t*)calloc(recPixels, recBpp);
+    recFrame  = (uint32_t*)malloc(recPixels * sizeof(uint32_t));
+  }
+  if (!recBuffer || !recPrev || !recFrame) {
+    DEBUG_PRINTLN(F("Recording: no memory."));
+    freeRecorder();
+    return false;
+  }
+
+  strlcpy(recFileName, recReqName, sizeof(recFileName));
+  recFile = WLED_FS.open(recFileName, "w");
+  if (!recFile) {
+    freeRecorder();
+    return false;
+  }
+  uint8_t header[REC_HEADER_SIZE] = {'W', 'F', 'R', FSEQ_WFR_VERSION};
+  putU32(header + 4, recPixels * recBpp);
+  header[12] = recStep & 0xFF;
+  header[13] = recStep >> 8;
+  header[14] = recBpp;
+  recFile.write(header, sizeof(header));
+  recHead = recTail = recWritten = 0;
+  recFrames = recDropped = 0;
+
+  // capture pixels as set from next frame on (all segments are rendered), others (frozen segments, gaps) as they are
+  strip.suspend();
+  bool idle = strip.waitUntilIdle();
+  if (idle) {
+    for (size_t p = 0; p < recPixels; p++) recFrame[p] = strip.getPixelColor(p);
+    strip.setCaptureBuffer(recFrame, recPixels);
+    strip.trigger();
+    recActive = true;
+  }
+  strip.resume();
+  if (!idle) {
+    recFile.close();
+    WLED_FS.remove(recFileName);
+    freeRecorder();
+    return false;
+  }
+  updateFSInfo();
+  DEBUG_PRINTF("Recording started: %s, %u pixels, %u ms\n", recFileName, recPixels, recStep);
+  return true;
+}
+
+void handleRecorder() {
+  if (recStopRequested || recStartRequested) {
+    if (!stopRecording()) return; // retried in next loop
+    recStopRequested = false;
+  }
+  if (recStartRequested) {
+    recStartRequested = false;
+    if (!startRecording()) errorFlag = ERR_FS_GENERAL;
+  }
+  if (!recBuffer) return;
+  writeRecorded();
+  if (!recActive) stopRecording(); // maximum number of frames recorded
+  else if (fsBytesUsed + recWritten + REC_FS_RESERVE > fsBytesTotal) {
+    DEBUG_PRINTLN(F("Recording: filesystem full."));
+    stopRecording();
+  }
+}
+
+// may be called from async web server, recording is started/stopped in loop
+void deserializeRecorder(JsonObject rec) {
+  if (rec["on"].isNull()) return;
+  if (!rec["on"]) {
+    recStopRequested = true;
+    return;
+  }
+  const char *name = rec["f"] | "/rec.wfr";
+  strlcpy(recReqName, name, sizeof(recReqName));
+  recReqStep   = rec[F("step")] | 0;
+  recReqFrames = rec["n"] | 0;
+  recStartRequested = true;
+}
+
+void serializeRecorder(JsonObject root) {
+  JsonObject rec = root.createNestedObject(F("rec"));
+  rec["on"] = recActive;
+  if (!recFileName[0]) return;
+  rec["f"] = recFileName;
+  rec[F("fr")] = recFrames;
+  rec[F("drop")] = recDropped;
+  rec[F("step")] = recStep;
+}
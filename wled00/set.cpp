@@ -92,7 +92,9 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     Bus::setCCTBlend(strip.cctBlending);
     Bus::setGlobalAWMode(request->arg(F("AW")).toInt());
     strip.setTargetFps(request->arg(F("FR")).toInt());
+    #ifndef WLED_ENABLE_RENDER_TASK
     useGlobalLedBuffer = request->hasArg(F("LD"));
+    #endif // always buffered for render task (see WLED::renderTask())
 
     bool busesChanged = false;
     for (uint8_t s = 0; s < WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES; s++) {
@@ -297,6 +299,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     syncGroups = request->arg(F("GS")).toInt();
     receiveGroups = request->arg(F("GR")).toInt();
+    udpMulticast = request->hasArg(F("UM"));
+    updateMulticastGroups();
 
     receiveNotificationBrightness = request->hasArg(F("RB"));
     receiveNotificationColor = request->hasArg(F("RC"));
@@ -313,11 +317,16 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     t = request->arg(F("UR")).toInt();
     if ((t>=0) && (t<30)) udpNumRetries = t;
+    udpDeltaSync = request->hasArg(F("UD"));
 
 
     nodeListEnabled = request->hasArg(F("NL"));
     if (!nodeListEnabled) Nodes.clear();
+    t = request->arg(F("NX")).toInt();
+    if (t > 0 && t <= WLED_NODES_LIMIT) nodeListSize = t; // applied after reboot
     nodeBroadcastEnabled = request->hasArg(F("NB"));
+    clockSyncEnabled = request->hasArg(F("CS"));
+    frameLockEnabled = request->hasArg(F("FL"));
 
     receiveDirect = request->hasArg(F("RD"));
     useMainSegmentOnly = request->hasArg(F("MO"));
@@ -734,6 +743,20 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   DEBUG_PRINT(F("API req: "));
   DEBUG_PRINTLN(req);
 
+  if (!requestStateLock()) { // state is being serialized with another JSON buffer
+    errorFlag = ERR_BUSY; // nothing applied
+    if (request) request->send(503, "application/json", F("{\"error\":4}"));
+    return true;
+  }
+  strip.suspend(); // segments must not change while effects are rendered in a separate task
+  if (!strip.waitUntilIdle()) {
+    strip.resume();
+    releaseStateLock();
+    errorFlag = ERR_BUSY; // nothing applied
+    if (request) request->send(503, "application/json", F("{\"error\":4}"));
+    return true;
+  }
+
   //segment select (sets main segment)
   pos = req.indexOf(F("SM="));
   if (pos > 0 && !realtimeMode) {
@@ -1105,12 +1128,14 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
     userVar1 = getNumVal(&req, pos);
   }
   // you can add more if you need
+  strip.resume();
+  releaseStateLock();
 
   // global col[], effectCurrent, ... are updated in stateChanged()
   if (!apply) return true; // when called by JSON API, do not call colorUpdated() here
 
   pos = req.indexOf(F("&NN")); //do not send UDP notifications this time
-  stateUpdated((pos > 0) ? CALL_MODE_NO_NOTIFY : CALL_MODE_DIRECT_CHANGE);
+  queueStateUpdate((pos > 0) ? CALL_MODE_NO_NOTIFY : CALL_MODE_DIRECT_CHANGE); // applied once per frame
 
   // internal call, does not send XML response
   pos = req.indexOf(F("IN"));
@@ -50,6 +50,16 @@ bool ESPAsyncE131::begin(bool multicast, uint16_t port, uint16_t universe, uint8
   return success;
 }
 
+bool ESPAsyncE131::beginMulticast(IPAddress group, uint16_t port) {
+  bool success = false;
+
+  if (udp.listenMulticast(group, port)) {
+    udp.onPacket(std::bind(&ESPAsyncE131::parsePacket, this, std::placeholders::_1));
+    success = true;
+  }
+  return success;
+}
+
 /////////////////////////////////////////////////////////
 //
 // Private init() members
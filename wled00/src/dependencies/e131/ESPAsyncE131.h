@@ -226,6 +226,9 @@ class ESPAsyncE131 {
 
     // Generic UDP listener, no physical or IP configuration
     bool begin(bool multicast, uint16_t port = E131_DEFAULT_PORT, uint16_t universe = 1, uint8_t n = 1);
+
+    // Listener that also joins the given multicast group (e.g. for DDP)
+    bool beginMulticast(IPAddress group, uint16_t port);
 };
 
 // Class to track e131 package priority
@@ -1,15 +1,118 @@
 #include "wled.h"
+#ifdef ARDUINO_ARCH_ESP32
+#include <lwip/tcpip.h>
+#endif
 
 /*
  * UDP sync notifier / Realtime / Hyperion / TPM2.NET
  */
 
 #define UDP_SEG_SIZE 36
-#define SEG_OFFSET (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE))
-#define WLEDPACKETSIZE (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE)+0)
+#define UDP_SYNC_TRAILER 3 //packet sequence, keyframe sequence, flags (follows last segment, version 13+)
+#define WLEDPACKETSIZE (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE)+UDP_SYNC_TRAILER)
 #define UDP_IN_MAXSIZE 1472
 #define PRESUMED_NETWORK_DELAY 3 //how many ms could it take on avg to reach the receiver? This will be added to transmitted times
 
+/*
+ * Delta sync: packets only contain the segments that differ from the last full packet (keyframe) of the sender,
+ * or were sent in a delta since (a segment that returned to its keyframe value must reach receivers too).
+ * Receivers have applied the keyframe already, so they can apply a delta like a regular packet (older versions do).
+ * A receiver that missed the keyframe requests a new one from the sender (0, UDP_SYNC_KEYFRAME_REQUEST, sequence),
+ * which is sent right away (once per keyframe, other receivers missing the same keyframe get the new one).
+ */
+#define UDP_SYNC_DELTA 0x01                 //flag: packet only contains segments changed since keyframe
+#define UDP_SYNC_KEYFRAME_REQUEST 250       //sent in place of the call mode, ignored by older versions (custom version)
+#define UDP_SYNC_KEYFRAME_INTERVAL 30000    //ms, send full packet at least that often
+
+static byte    *syncKeyframe = nullptr;     //segment records of last full packet sent
+static uint8_t  syncKeyframeSegs = 0;
+static uint8_t  syncSeq = 0, syncKeyframeSeq = 0;
+static unsigned long syncKeyframeTime = 0;
+static bool     syncKeyframeRequested = false;
+static bool     syncDeltaSent[MAX_NUM_SEGMENTS]; //segment records sent in a delta since keyframe
+static IPAddress syncRecvSender;            //receiver: keyframe last received
+static uint8_t  syncRecvSeq = 0;
+static unsigned long syncRecvRequestTime = 0;
+static IPAddress syncLastSender;            //receiver: last packet applied (duplicates arrive via several multicast groups)
+static uint8_t  syncLastSeq = 0, syncLastFlags = 0;
+
+/*
+ * Multicast transport (optional): instead of broadcasts, sync notifications are sent to one multicast group per
+ * sync group, node info and frame ticks to MULTICAST_NODES_GROUP. Nodes only join the groups of their receive
+ * sync groups, so stations are not woken up for traffic they discard (and multicast is not limited to the
+ * lowest basic rate like broadcast on many APs). Unicast and broadcast packets are still received.
+ */
+static uint8_t multicastJoined = 0;         //sync groups joined (bit 0 = group 1)
+static bool    multicastNodesJoined = false;
+static volatile bool multicastUpdate = false, multicastReconnect = false;
+
+IPAddress multicastAddress(uint8_t group)
+{
+  return IPAddress(239, 255, 87, group);
+}
+
+//arg: group, bit 8 set to join
+static void setMulticastMembershipCb(void *arg)
+{
+  uint16_t req = (uintptr_t)arg;
+  ip4_addr_t ifaddr, groupaddr;
+  ifaddr.addr = static_cast<uint32_t>(Network.localIP());
+  groupaddr.addr = static_cast<uint32_t>(multicastAddress(req & 0xFF));
+  if (req & 0x100) igmp_joingroup(&ifaddr, &groupaddr);
+  else             igmp_leavegroup(&ifaddr, &groupaddr);
+}
+
+//lwIP must only be called from its TCP/IP task on ESP32 (ESP8266 has no separate task)
+static bool setMulticastMembership(uint8_t group, bool join)
+{
+  void *req = (void*)(uintptr_t)(group | join << 8);
+  #ifdef ARDUINO_ARCH_ESP32
+  return tcpip_callback(setMulticastMembershipCb, req) == ERR_OK;
+  #else
+  setMulticastMembershipCb(req);
+  return true;
+  #endif
+}
+
+//requests joining the multicast groups of the receive sync groups, call after (re)connecting or changing sync settings
+//(may be called from async web server, memberships are changed in handleNotifications())
+void updateMulticastGroups(bool reconnect)
+{
+  if (reconnect) multicastReconnect = true;
+  multicastUpdate = true;
+}
+
+static void handleMulticastGroups()
+{
+  if (!multicastUpdate) return;
+  multicastUpdate = false;
+  if (multicastReconnect) { //memberships of a previous connection are gone
+    multicastReconnect = false;
+    multicastJoined = 0;
+    multicastNodesJoined = false;
+  }
+  bool nodes = udpMulticast && udp2Connected;
+  if (nodes != multicastNodesJoined && setMulticastMembership(MULTICAST_NODES_GROUP, nodes)) multicastNodesJoined = nodes;
+
+  uint8_t groups = (udpMulticast && udpConnected) ? receiveGroups : 0;
+  for (size_t i = 0; i < 8; i++) {
+    if (!(((groups ^ multicastJoined) >> i) & 0x01)) continue;
+    if (setMulticastMembership(i+1, (groups >> i) & 0x01)) multicastJoined ^= 1 << i;
+  }
+  if (multicastJoined != groups || multicastNodesJoined != nodes) multicastUpdate = true; //TCP/IP task queue was full, retry
+}
+
+bool beginMulticastPacket(WiFiUDP &udp, uint8_t group, uint16_t port)
+{
+  #ifdef ESP8266
+  return udp.beginPacketMulticast(multicastAddress(group), port, Network.localIP());
+  #else
+  return udp.beginPacket(multicastAddress(group), port);
+  #endif
+}
+
+static void sendNotification(byte callMode, bool followUp);
+
 void notify(byte callMode, bool followUp)
 {
   if (!udpConnected) return;
@@ -26,7 +129,13 @@ void notify(byte callMode, bool followUp)
     case CALL_MODE_ALEXA:         if (!notifyAlexa)  return; break;
     default: return;
   }
+  sendNotification(callMode, followUp);
+}
+
+static void sendNotification(byte callMode, bool followUp)
+{
   byte udpOut[WLEDPACKETSIZE];
+  if (!followUp) syncSeq++; //retransmissions keep the sequence number
   Segment& mainseg = strip.getMainSegment();
   udpOut[0] = 0; //0: wled notifier protocol 1: WARLS protocol
   udpOut[1] = callMode;
@@ -45,8 +154,8 @@ void notify(byte callMode, bool followUp)
   //3: supports FX intensity, 24 byte packet 4: supports transitionDelay 5: sup palette
   //6: supports timebase syncing, 29 byte packet 7: supports tertiary color 8: supports sys time sync, 36 byte packet
   //9: supports sync groups, 37 byte packet 10: supports CCT, 39 byte packet 11: per segment options, variable packet length (40+MAX_NUM_SEGMENTS*3)
-  //12: enhanced effect sliders, 2D & mapping options
-  udpOut[11] = 12;
+  //12: enhanced effect sliders, 2D & mapping options 13: packet only contains active segments, sequence trailer & delta packets
+  udpOut[11] = 13;
   col = mainseg.colors[1];
   udpOut[12] = R(col);
   udpOut[13] = G(col);
@@ -135,23 +244,75 @@ void notify(byte callMode, bool followUp)
     ++s;
   }
 
-  //uint16_t offs = SEG_OFFSET;
-  //next value to be added has index: udpOut[offs + 0]
-
-  IPAddress broadcastIp;
-  broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+  // delta sync: omit segments unchanged since keyframe (and not sent since), unless most segments are to be sent
+  bool delta = false;
+  if (udpDeltaSync && !syncKeyframe) syncKeyframe = (byte*)malloc(MAX_NUM_SEGMENTS*UDP_SEG_SIZE);
+  if (udpDeltaSync && syncKeyframe) {
+    bool send[MAX_NUM_SEGMENTS];
+    if (syncKeyframeSegs == s && !syncKeyframeRequested && millis() - syncKeyframeTime < UDP_SYNC_KEYFRAME_INTERVAL) {
+      size_t changed = 0;
+      for (size_t i = 0; i < s; i++) {
+        send[i] = syncDeltaSent[i] || memcmp(udpOut + 41 + i*UDP_SEG_SIZE, syncKeyframe + i*UDP_SEG_SIZE, UDP_SEG_SIZE);
+        if (send[i]) changed++;
+      }
+      delta = changed*2 <= s;
+    }
+    if (delta) {
+      size_t n = 0;
+      for (size_t i = 0; i < s; i++) {
+        if (!send[i]) continue;
+        syncDeltaSent[i] = true;
+        if (n != i) memmove(udpOut + 41 + n*UDP_SEG_SIZE, udpOut + 41 + i*UDP_SEG_SIZE, UDP_SEG_SIZE);
+        n++;
+      }
+      s = n;
+      udpOut[39] = s;
+    } else {
+      memcpy(syncKeyframe, udpOut + 41, s*UDP_SEG_SIZE);
+      memset(syncDeltaSent, 0, sizeof(syncDeltaSent));
+      syncKeyframeSegs = s;
+      syncKeyframeSeq = syncSeq;
+      syncKeyframeTime = millis();
+      syncKeyframeRequested = false;
+    }
+  } else syncKeyframeSegs = 0; //full packets sent since keyframe, receivers may have newer segments
+
+  // packet ends after last active segment (receivers use the segment count)
+  size_t len = 41 + s*UDP_SEG_SIZE;
+  udpOut[len++] = syncSeq;
+  udpOut[len++] = delta ? syncKeyframeSeq : syncSeq;
+  udpOut[len++] = delta ? UDP_SYNC_DELTA : 0;
+
+  if (udpMulticast) {
+    for (size_t i = 0; i < 8; i++) {
+      if (!((syncGroups >> i) & 0x01)) continue;
+      beginMulticastPacket(notifierUdp, i+1, udpPort);
+      notifierUdp.write(udpOut, len);
+      notifierUdp.endPacket();
+    }
+  } else {
+    IPAddress broadcastIp;
+    broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
 
-  notifierUdp.beginPacket(broadcastIp, udpPort);
-  notifierUdp.write(udpOut, WLEDPACKETSIZE);
-  notifierUdp.endPacket();
+    notifierUdp.beginPacket(broadcastIp, udpPort);
+    notifierUdp.write(udpOut, len);
+    notifierUdp.endPacket();
+  }
   notificationSentCallMode = callMode;
   notificationSentTime = millis();
   notificationCount = followUp ? notificationCount + 1 : 0;
 }
 
-void realtimeLock(uint32_t timeoutMs, byte md)
+// returns false if realtime mode could not be entered (render task busy), realtime data is dropped then
+bool realtimeLock(uint32_t timeoutMs, byte md)
 {
-  if (!realtimeMode && !realtimeOverride) {
+  bool entering = !realtimeMode && !realtimeOverride;
+  if (entering) {
+    strip.suspend();       // effects may be rendered in a separate task, let it finish current frame
+    if (!strip.waitUntilIdle()) {
+      strip.resume();
+      return false;        // next packet retries
+    }
     uint16_t stop, start;
     if (useMainSegmentOnly) {
       Segment& mainseg = strip.getMainSegment();
@@ -172,7 +333,7 @@ void realtimeLock(uint32_t timeoutMs, byte md)
     }
   }
   // if strip is off (bri==0) and not already in RTM
-  if (briT == 0 && !realtimeMode && !realtimeOverride) {
+  if (briT == 0 && entering) {
     strip.setBrightness(scaledBri(briLast), true);
   }
 
@@ -180,14 +341,21 @@ void realtimeLock(uint32_t timeoutMs, byte md)
     realtimeTimeout = (timeoutMs == 255001 || timeoutMs == 65000) ? UINT32_MAX : millis() + timeoutMs;
   }
   realtimeMode = md;
+  if (entering) strip.resume(); // render task does not render effects in realtime mode (except other segments if useMainSegmentOnly)
 
-  if (realtimeOverride) return;
+  if (realtimeOverride) return true;
   if (arlsForceMaxBri) strip.setBrightness(scaledBri(255), true);
   if (briT > 0 && md == REALTIME_MODE_GENERIC) strip.show();
+  return true;
 }
 
 void exitRealtime() {
   if (!realtimeMode) return;
+  strip.suspend(); // effects are rendered again as soon as realtime mode is inactive
+  if (!strip.waitUntilIdle()) {
+    strip.resume();
+    return;
+  }
   if (realtimeOverride == REALTIME_OVERRIDE_ONCE) realtimeOverride = REALTIME_OVERRIDE_NONE;
   strip.setBrightness(scaledBri(bri), true);
   realtimeTimeout = 0; // cancel realtime mode immediately
@@ -198,6 +366,7 @@ void exitRealtime() {
   } else {
     strip.show(); // possible fix for #3589
   }
+  strip.resume();
   updateInterfaces(CALL_MODE_WS_SEND);
 }
 
@@ -216,8 +385,10 @@ void handleNotifications()
 {
   IPAddress localIP;
 
+  handleMulticastGroups();
+
   //send second notification if enabled
-  if(udpConnected && (notificationCount < udpNumRetries) && ((millis()-notificationSentTime) > 250)){
+  if(udpConnected && notificationCount < udpNumRetries && ((millis()-notificationSentTime) > 250)){
     notify(notificationSentCallMode,true);
   }
 
@@ -250,7 +421,7 @@ void handleNotifications()
       DEBUG_PRINTLN(rgbUdp.remoteIP());
       uint8_t lbuf[packetSize];
       rgbUdp.read(lbuf, packetSize);
-      realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
+      if (!realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION)) return;
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
       uint16_t id = 0;
       uint16_t totalLen = strip.getLengthTotal();
@@ -264,7 +435,7 @@ void handleNotifications()
     }
   }
 
-  if (!(receiveNotifications || receiveDirect)) return;
+  if (!(receiveNotifications || receiveDirect || udpDeltaSync)) return; //delta sync senders must receive keyframe requests
 
   localIP = Network.localIP();
   //notifier and UDP realtime
@@ -280,33 +451,49 @@ void handleNotifications()
   if (isSupp && udpIn[0] == 255 && udpIn[1] == 1 && len >= 40) {
     if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return;
 
-    uint8_t unit = udpIn[39];
-    NodesMap::iterator it = Nodes.find(unit);
-    if (it == Nodes.end() && Nodes.size() < WLED_MAX_NODES) { // Create a new element when not present
-      Nodes[unit].age = 0;
-      it = Nodes.find(unit);
-    }
-
-    if (it != Nodes.end()) {
-      for (size_t x = 0; x < 4; x++) {
-        it->second.ip[x] = udpIn[x + 2];
-      }
-      it->second.age = 0; // reset 'age counter'
+    NodeStruct *node = Nodes.add(IPAddress(udpIn[2], udpIn[3], udpIn[4], udpIn[5])); // nullptr if node list is full
+    if (node) {
+      node->lastSeen = millis();
       char tmpNodeName[33] = { 0 };
       memcpy(&tmpNodeName[0], reinterpret_cast<byte *>(&udpIn[6]), 32);
       tmpNodeName[32]     = 0;
-      it->second.nodeName = tmpNodeName;
-      it->second.nodeName.trim();
-      it->second.nodeType = udpIn[38];
+      size_t n = strlen(tmpNodeName); // trim
+      while (n && isspace(tmpNodeName[n-1])) tmpNodeName[--n] = 0;
+      char *name = tmpNodeName;
+      while (isspace(*name)) name++;
+      Nodes.setName(node, name);
       uint32_t build = 0;
       if (len >= 44)
         for (size_t i=0; i<sizeof(uint32_t); i++)
           build |= udpIn[40+i]<<(8*i);
-      it->second.build = build;
+      if (node->nodeType != udpIn[38] || node->build != build) Nodes.changed(node); // pushed to WS clients
+      node->nodeType = udpIn[38];
+      node->build = build;
+      node->clockSync = len >= 45 && (udpIn[44] & 0x01);
     }
     return;
   }
 
+  // cluster clock sync request/response
+  if (isSupp && udpIn[0] == 255 && (udpIn[1] == 2 || udpIn[1] == 3)) {
+    if (notifier2Udp.remoteIP() != localIP) handleClockSyncPacket(udpIn, len, notifier2Udp.remoteIP(), notifier2Udp.remotePort());
+    return;
+  }
+
+  // frame tick of frame lock leader
+  if (isSupp && udpIn[0] == 255 && udpIn[1] == 4) {
+    if (notifier2Udp.remoteIP() != localIP) handleFrameLockTick(udpIn, len, notifier2Udp.remoteIP());
+    return;
+  }
+
+  //receiver of our delta sync packets missed the keyframe
+  if (udpIn[0] == 0 && udpIn[1] == UDP_SYNC_KEYFRAME_REQUEST && len >= 3) {
+    if (!udpDeltaSync || !syncKeyframe || !syncGroups || udpIn[2] != syncKeyframeSeq) return; //newer keyframe sent already
+    syncKeyframeRequested = true;
+    sendNotification(notificationSentCallMode, false); //new keyframe (sequence), retransmitted like a notification
+    return;
+  }
+
   //wled notifier, ignore if realtime packets active
   if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
   {
@@ -317,12 +504,40 @@ void handleNotifications()
     //compatibilityVersionByte:
     byte version = udpIn[11];
 
+    //delta packets are applied like full packets (they contain all global fields), a missed keyframe is requested
+    if (version > 12 && version < 200) {
+      size_t trailer = 41 + udpIn[39]*udpIn[40];
+      if (len < trailer + UDP_SYNC_TRAILER) return;
+      IPAddress sender = isSupp ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
+      if (sender == syncLastSender && udpIn[trailer] == syncLastSeq && udpIn[trailer+2] == syncLastFlags) return; //already applied
+      syncLastSender = sender;
+      syncLastSeq = udpIn[trailer];
+      syncLastFlags = udpIn[trailer+2];
+      if (!(udpIn[trailer+2] & UDP_SYNC_DELTA)) {
+        syncRecvSender = sender;
+        syncRecvSeq = udpIn[trailer];
+      } else if ((sender != syncRecvSender || udpIn[trailer+1] != syncRecvSeq) && millis() - syncRecvRequestTime > 1000) {
+        uint8_t request[3] = {0, UDP_SYNC_KEYFRAME_REQUEST, udpIn[trailer+1]};
+        notifierUdp.beginPacket(sender, udpPort);
+        notifierUdp.write(request, sizeof(request));
+        notifierUdp.endPacket();
+        syncRecvRequestTime = millis();
+      }
+    }
+
     // if we are not part of any sync group ignore message
     if (version < 9 || version > 199) {
       // legacy senders are treated as if sending in sync group 1 only
       if (!(receiveGroups & 0x01)) return;
     } else if (!(receiveGroups & udpIn[36])) return;
 
+    strip.suspend(); // segments must not change while effects are rendered in a separate task
+    if (!strip.waitUntilIdle()) {
+      strip.resume();
+      syncLastSender = IPAddress(0,0,0,0); // not applied, do not ignore a retransmission
+      return;
+    }
+
     bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
 
     // set transition time before making any segment changes
@@ -362,6 +577,7 @@ void handleNotifications()
         uint8_t numSrcSegs = udpIn[39];
         for (size_t i = 0; i < numSrcSegs; i++) {
           uint16_t ofs = 41 + i*udpIn[40]; //start of segment offset byte
+          if (ofs + udpIn[40] > len) break; //truncated packet
           uint8_t id = udpIn[0 +ofs];
           if (id > strip.getSegmentsNum()) break;
 
@@ -428,7 +644,7 @@ void handleNotifications()
         stateChanged = true;
       }
 
-      if (applyEffects && version > 5) {
+      if (applyEffects && version > 5 && !clockSyncLocked()) { // clock sync is more accurate
         uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
         t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
         t -= millis();
@@ -461,6 +677,8 @@ void handleNotifications()
       }
     }
 
+    strip.resume();
+
     nightlightActive = udpIn[6];
     if (nightlightActive) nightlightDelayMins = udpIn[7];
 
@@ -471,6 +689,12 @@ void handleNotifications()
 
   if (!receiveDirect) return;
 
+  //binary control commands
+  if (udpIn[0] == BINCMD_MAGIC) {
+    handleBinaryCommand(udpIn, len);
+    return;
+  }
+
   //TPM2.NET
   if (udpIn[0] == 0x9c)
   {
@@ -483,7 +707,7 @@ void handleNotifications()
     if (tpmType != 0xda) return; //return if notTPM2.NET data
 
     realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
-    realtimeLock(realtimeTimeoutMs, REALTIME_MODE_TPM2NET);
+    if (!realtimeLock(realtimeTimeoutMs, REALTIME_MODE_TPM2NET)) return;
     if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
     tpmPacketCount++; //increment the packet count
@@ -522,7 +746,7 @@ void handleNotifications()
       realtimeTimeout = 0;
       return;
     } else {
-      realtimeLock(udpIn[1]*1000 +1, REALTIME_MODE_UDP);
+      if (!realtimeLock(udpIn[1]*1000 +1, REALTIME_MODE_UDP)) return;
     }
     if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
@@ -616,20 +840,9 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
 \*********************************************************************************************/
 void refreshNodeList()
 {
-  for (NodesMap::iterator it = Nodes.begin(); it != Nodes.end();) {
-    bool mustRemove = true;
-
-    if (it->second.ip[0] != 0) {
-      if (it->second.age < 10) {
-        it->second.age++;
-        mustRemove = false;
-        ++it;
-      }
-    }
-
-    if (mustRemove) {
-      it = Nodes.erase(it);
-    }
+  for (size_t i = Nodes.size(); i > 0; i--) { // removal moves last node into the gap
+    NodeStruct &node = Nodes[i-1];
+    if (node.ip[0] == 0 || millis() - node.lastSeen > NODE_TIMEOUT) Nodes.remove(&node);
   }
 }
 
@@ -651,10 +864,11 @@ void sendSysInfoUDP()
   // 38: 1 byte node type id
   // 39: 1 byte node id
   // 40: 4 byte version ID
-  // 44 bytes total
+  // 44: 1 byte flags (bit 0: cluster clock sync enabled)
+  // 45 bytes total
 
   // send my info to the world...
-  uint8_t data[44] = {0};
+  uint8_t data[45] = {0};
   data[0] = 255;
   data[1] = 1;
 
@@ -681,9 +895,14 @@ void sendSysInfoUDP()
   uint32_t build = VERSION;
   for (size_t i=0; i<sizeof(uint32_t); i++)
     data[40+i] = (build>>(8*i)) & 0xFF;
+  data[44] = clockSyncEnabled;
 
-  IPAddress broadcastIP(255, 255, 255, 255);
-  notifier2Udp.beginPacket(broadcastIP, udpPort2);
+  if (udpMulticast) {
+    beginMulticastPacket(notifier2Udp, MULTICAST_NODES_GROUP, udpPort2);
+  } else {
+    IPAddress broadcastIP(255, 255, 255, 255);
+    notifier2Udp.beginPacket(broadcastIP, udpPort2);
+  }
   notifier2Udp.write(data, sizeof(data));
   notifier2Udp.endPacket();
 }
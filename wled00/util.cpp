@@ -198,25 +198,69 @@ bool isAsterisksOnly(const char* str, byte maxLen)
 
 
 //threading/network callback details: https://github.com/Aircoookie/WLED/pull/2336#discussion_r762276994
-bool requestJSONBufferLock(uint8_t module)
-{
-  unsigned long now = millis();
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE jsonPoolMux = portMUX_INITIALIZER_UNLOCKED; // buffers are requested from main loop and async (network) tasks
+#define JSON_POOL_LOCK   portENTER_CRITICAL(&jsonPoolMux)
+#define JSON_POOL_UNLOCK portEXIT_CRITICAL(&jsonPoolMux)
+#else
+#define JSON_POOL_LOCK
+#define JSON_POOL_UNLOCK
+#endif
 
-  while (jsonBufferLock && millis()-now < 1000) delay(1); // wait for a second for buffer lock
+// additional JSON buffers (global doc is the first buffer of the pool), allocated on first use and kept
+#if WLED_JSON_POOL_SIZE > 1
+static PSRAMDynamicJsonDocument *jsonPool[WLED_JSON_POOL_SIZE-1]      = {nullptr};
+static volatile uint8_t          jsonPoolOwner[WLED_JSON_POOL_SIZE-1] = {0};
+#endif
 
-  if (millis()-now >= 1000) {
-    DEBUG_PRINT(F("ERROR: Locking JSON buffer failed! ("));
-    DEBUG_PRINT(jsonBufferLock);
-    DEBUG_PRINTLN(")");
-    return false; // waiting time-outed
-  }
+static void updateJSONBufferPeak()
+{
+  uint8_t used = getJSONBuffersInUse();
+  if (used > jsonBufferPeak) jsonBufferPeak = used;
+}
 
-  jsonBufferLock = module ? module : 255;
+static void onJSONBufferLocked()
+{
   DEBUG_PRINT(F("JSON buffer locked. ("));
   DEBUG_PRINT(jsonBufferLock);
   DEBUG_PRINTLN(")");
   fileDoc = &doc;  // used for applying presets (presets.cpp)
   doc.clear();
+  updateJSONBufferPeak();
+}
+
+// takes global doc if it is free (non-blocking)
+bool tryJSONBufferLock(uint8_t module)
+{
+  bool locked = false;
+  JSON_POOL_LOCK;
+  if (!jsonBufferLock) {
+    jsonBufferLock = module ? module : 255;
+    locked = true;
+  }
+  JSON_POOL_UNLOCK;
+  if (!locked) return false;
+  onJSONBufferLocked();
+  return true;
+}
+
+bool requestJSONBufferLock(uint8_t module)
+{
+  unsigned long now = millis();
+
+  if (!tryJSONBufferLock(module)) {
+    jsonBufferWaits++;
+    do {
+      if (millis()-now >= 1000) {
+        jsonBufferFails++;
+        DEBUG_PRINT(F("ERROR: Locking JSON buffer failed! ("));
+        DEBUG_PRINT(jsonBufferLock);
+        DEBUG_PRINTLN(")");
+        return false; // waiting time-outed
+      }
+      delay(1); // wait for a second for buffer lock
+    } while (!tryJSONBufferLock(module));
+  }
   return true;
 }
 
@@ -230,6 +274,242 @@ void releaseJSONBufferLock()
   jsonBufferLock = 0;
 }
 
+// non-blocking request for a JSON buffer (use for serializing responses in network callbacks)
+// returns one of the pooled buffers (or global doc if it is free) or nullptr if all buffers are in use
+// buffer must be returned with releaseJSONBuffer()
+JsonDocument* requestJSONBuffer(uint8_t module)
+{
+  JsonDocument *pDoc = nullptr;
+  if (!module) module = 255;
+  #if WLED_JSON_POOL_SIZE > 1
+  int slot = -1;
+  JSON_POOL_LOCK;
+  for (size_t i = 0; i < WLED_JSON_POOL_SIZE-1; i++) if (!jsonPoolOwner[i]) {
+    jsonPoolOwner[i] = module;
+    slot = i;
+    break;
+  }
+  JSON_POOL_UNLOCK;
+  if (slot >= 0) {
+    if (!jsonPool[slot]) {
+      // do not allocate if it would leave too little heap for web server
+      #if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM) && defined(WLED_USE_PSRAM)
+      if (psramFound() || ESP.getFreeHeap() > JSON_BUFFER_SIZE + 2*MIN_HEAP_SIZE)
+      #else
+      if (ESP.getFreeHeap() > JSON_BUFFER_SIZE + 2*MIN_HEAP_SIZE)
+      #endif
+        jsonPool[slot] = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+      if (jsonPool[slot] && jsonPool[slot]->capacity() == 0) {
+        delete jsonPool[slot];
+        jsonPool[slot] = nullptr;
+      }
+    }
+    if (jsonPool[slot]) {
+      pDoc = jsonPool[slot];
+      pDoc->clear();
+    } else {
+      DEBUG_PRINTLN(F("JSON buffer allocation failed."));
+      jsonPoolOwner[slot] = 0; // try global buffer instead
+    }
+  }
+  #endif
+  if (pDoc) updateJSONBufferPeak();
+  else if (tryJSONBufferLock(module)) pDoc = &doc;
+  else {
+    jsonBufferFails++;
+    DEBUG_PRINTLN(F("ERROR: No free JSON buffer!"));
+  }
+  return pDoc;
+}
+
+void releaseJSONBuffer(JsonDocument *pDoc)
+{
+  if (pDoc == &doc) {
+    releaseJSONBufferLock();
+    return;
+  }
+  #if WLED_JSON_POOL_SIZE > 1
+  for (size_t i = 0; i < WLED_JSON_POOL_SIZE-1; i++) if (pDoc && jsonPool[i] == pDoc) {
+    pDoc->clear();
+    jsonPoolOwner[i] = 0;
+    return;
+  }
+  #endif
+}
+
+uint8_t getJSONBuffersInUse()
+{
+  uint8_t used = jsonBufferLock != 0;
+  #if WLED_JSON_POOL_SIZE > 1
+  for (size_t i = 0; i < WLED_JSON_POOL_SIZE-1; i++) used += jsonPoolOwner[i] != 0;
+  #endif
+  return used;
+}
+
+// strip/segment state is applied (deserializeState(), binary commands) and serialized (with pooled JSON buffers or
+// streamed) from main loop and async (network) tasks, the state lock keeps them apart
+// the task holding the lock may take it again (e.g. deserializeState() saving a preset)
+#ifdef ARDUINO_ARCH_ESP32
+#define STATE_LOCK_TASK ((void*)xTaskGetCurrentTaskHandle())
+#else
+#define STATE_LOCK_TASK nullptr // network callbacks do not interrupt main loop
+#endif
+static volatile uint8_t stateLock      = 0; // module holding the lock (for debugging)
+static volatile uint8_t stateLockDepth = 0;
+static void            *stateLockOwner = nullptr;
+
+// takes state lock if it is free or already held by calling task (non-blocking)
+bool tryStateLock(uint8_t module)
+{
+  bool locked = false;
+  void *task = STATE_LOCK_TASK;
+  JSON_POOL_LOCK;
+  if (!stateLockDepth || stateLockOwner == task) {
+    if (!stateLockDepth++) {
+      stateLock = module ? module : 255;
+      stateLockOwner = task;
+    }
+    locked = true;
+  }
+  JSON_POOL_UNLOCK;
+  return locked;
+}
+
+// waits up to STATE_LOCK_TIMEOUT for state lock (state is held only while it is applied or serialized)
+bool requestStateLock(uint8_t module)
+{
+  unsigned long now = millis();
+  while (!tryStateLock(module)) {
+    if (millis()-now >= STATE_LOCK_TIMEOUT) {
+      DEBUG_PRINT(F("ERROR: Locking state failed! ("));
+      DEBUG_PRINT(stateLock);
+      DEBUG_PRINTLN(")");
+      return false;
+    }
+    delay(1);
+  }
+  return true;
+}
+
+void releaseStateLock()
+{
+  JSON_POOL_LOCK;
+  if (stateLockDepth && !--stateLockDepth) {
+    stateLock = 0;
+    stateLockOwner = nullptr;
+  }
+  JSON_POOL_UNLOCK;
+}
+
+// JSON API requests that arrived while global JSON buffer was in use are queued (FIFO) and applied
+// from main loop instead of blocking network callbacks (or being dropped)
+// WS binary commands (module 24) are always queued: segments must not be changed from the async TCP task
+#define JSON_DEFER_QUEUE_SIZE 4
+#define JSON_DEFER_MAX_LEN    WS_MAX_JSON_SIZE // largest (reassembled) WS message
+static struct {
+  char    *payload;
+  size_t   len;
+  uint32_t client;  // WS client ID for response
+  uint8_t  module;  // originator (same ID as used with requestJSONBufferLock())
+} deferredJSON[JSON_DEFER_QUEUE_SIZE];
+static uint8_t deferredHead = 0, deferredCount = 0;
+
+// takes global doc for a new JSON API request (non-blocking), fails if it is in use or older requests are
+// still queued, the request must then be deferred with deferJSONRequest() so requests are applied in order
+bool tryJSONRequestLock(uint8_t module)
+{
+  bool locked = false;
+  JSON_POOL_LOCK;
+  if (!jsonBufferLock && !deferredCount) {
+    jsonBufferLock = module ? module : 255;
+    locked = true;
+  }
+  JSON_POOL_UNLOCK;
+  if (!locked) return false;
+  onJSONBufferLocked();
+  return true;
+}
+
+bool deferJSONRequest(uint8_t module, const char *payload, size_t len, uint32_t client)
+{
+  if (!payload || len == 0 || len > JSON_DEFER_MAX_LEN) return false;
+  char *copy = (char*)malloc(len+1);
+  if (!copy) return false;
+  memcpy(copy, payload, len);
+  copy[len] = '\0';
+  bool queued = false;
+  JSON_POOL_LOCK;
+  if (deferredCount < JSON_DEFER_QUEUE_SIZE) {
+    size_t i = (deferredHead + deferredCount) % JSON_DEFER_QUEUE_SIZE;
+    deferredJSON[i].payload = copy;
+    deferredJSON[i].len     = len;
+    deferredJSON[i].client  = client;
+    deferredJSON[i].module  = module;
+    deferredCount++;
+    queued = true;
+  }
+  JSON_POOL_UNLOCK;
+  if (!queued) {
+    free(copy);
+    DEBUG_PRINTLN(F("JSON request queue full."));
+    return false;
+  }
+  jsonBufferDeferred++;
+  DEBUG_PRINT(F("JSON request deferred. (")); DEBUG_PRINT(module); DEBUG_PRINTLN(")");
+  return true;
+}
+
+// called from main loop, applies oldest deferred request once global JSON buffer is free
+void handleDeferredJSON()
+{
+  if (!deferredCount) return;
+  if (deferredJSON[deferredHead].module == 24) {
+    if (!tryStateLock(24)) return; // binary commands need no JSON buffer, but state must not be serialized meanwhile
+  } else if (!tryJSONBufferLock(deferredJSON[deferredHead].module)) return;
+  JSON_POOL_LOCK;
+  char    *payload = deferredJSON[deferredHead].payload;
+  [[maybe_unused]] size_t len = deferredJSON[deferredHead].len;
+  [[maybe_unused]] uint32_t client = deferredJSON[deferredHead].client;
+  uint8_t  module  = deferredJSON[deferredHead].module;
+  deferredHead = (deferredHead + 1) % JSON_DEFER_QUEUE_SIZE;
+  deferredCount--;
+  JSON_POOL_UNLOCK;
+
+  switch (module) {
+    #ifdef WLED_ENABLE_WEBSOCKETS
+    case 11: // WS
+      handleWsJson(client, payload, len); // will release buffer lock
+      break;
+    case 24: // WS binary commands
+      handleWsBinary(client, (const uint8_t*)payload, len);
+      releaseStateLock();
+      break;
+    #endif
+    case 14: // HTTP JSON API
+      deserializeJson(doc, payload);
+      deserializeState(doc.as<JsonObject>());
+      releaseJSONBufferLock();
+      break;
+    #ifdef WLED_ENABLE_MQTT
+    case 15: // MQTT API (JSON or HTTP API)
+      if (payload[0] == '{') {
+        deserializeJson(doc, payload);
+        deserializeState(doc.as<JsonObject>());
+      } else {
+        String apireq = "win"; apireq += '&';
+        apireq += payload;
+        handleSet(nullptr, apireq);
+      }
+      releaseJSONBufferLock();
+      break;
+    #endif
+    default:
+      releaseJSONBufferLock();
+      break;
+  }
+  free(payload);
+}
+
 
 // extracts effect mode (or palette) name from names serialized string
 // caller must provide large enough buffer for name (including SR extensions)!
@@ -409,6 +689,18 @@ uint16_t crc16(const unsigned char* data_p, size_t length) {
 }
 
 
+// waits (in loop) until millis() reaches ms, for events scheduled to the millisecond (playlist, cue list)
+void waitUntilMillis(unsigned long ms) {
+  int64_t now = localMicros();
+  int64_t at = now - now % 1000 + (int64_t)(long)(ms - (uint32_t)(now / 1000)) * 1000;
+  while (at - now > 2000) { // let other tasks run, delay() may return up to 1 tick late
+    delay(1);
+    now = localMicros();
+  }
+  if (at > now) delayMicroseconds(at - now);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Begin simulateSound (to enable audio enhanced effects to display something)
 ///////////////////////////////////////////////////////////////////////////////
@@ -421,26 +713,30 @@ typedef enum UM_SoundSimulations {
   UMS_14_3
 } um_soundSimulations_t;
 
+// simulated audio data of the segment being rendered by each render worker, recalculated in every frame from
+// frame time and segment PRNG (segments rendered in parallel do not share it, nodes with synced time agree)
+struct SoundSimData {
+  float    volumeSmth;
+  uint16_t volumeRaw;
+  uint8_t  fftResult[16];
+  uint8_t  samplePeak;
+  float    FFT_MajorPeak;
+  float    my_magnitude;
+  uint8_t  maxVol;
+  uint8_t  binNum;
+};
+
+static SoundSimData soundSim[WLED_RENDER_WORKERS];
+static um_data_t   *soundSimUmData[WLED_RENDER_WORKERS] = {nullptr};
+
+// audio data for the segment being rendered (SEGMENT)
 um_data_t* simulateSound(uint8_t simulationId)
 {
-  static uint8_t samplePeak;
-  static float   FFT_MajorPeak;
-  static uint8_t maxVol;
-  static uint8_t binNum;
-
-  static float    volumeSmth;
-  static uint16_t volumeRaw;
-  static float    my_magnitude;
-
-  //arrays
-  uint8_t *fftResult;
-
-  static um_data_t* um_data = nullptr;
+  unsigned w = RENDER_WORKER_ID;
+  SoundSimData &sim = soundSim[w];
+  um_data_t* &um_data = soundSimUmData[w];
 
   if (!um_data) {
-    //claim storage for arrays
-    fftResult = (uint8_t *)malloc(sizeof(uint8_t) * 16);
-
     // initialize um_data pointer structure
     // NOTE!!!
     // This may change as AudioReactive usermod may change
@@ -448,20 +744,20 @@ um_data_t* simulateSound(uint8_t simulationId)
     um_data->u_size = 8;
     um_data->u_type = new um_types_t[um_data->u_size];
     um_data->u_data = new void*[um_data->u_size];
-    um_data->u_data[0] = &volumeSmth;
-    um_data->u_data[1] = &volumeRaw;
-    um_data->u_data[2] = fftResult;
-    um_data->u_data[3] = &samplePeak;
-    um_data->u_data[4] = &FFT_MajorPeak;
-    um_data->u_data[5] = &my_magnitude;
-    um_data->u_data[6] = &maxVol;
-    um_data->u_data[7] = &binNum;
-  } else {
-    // get arrays from um_data
-    fftResult =  (uint8_t*)um_data->u_data[2];
+    um_data->u_data[0] = &sim.volumeSmth;
+    um_data->u_data[1] = &sim.volumeRaw;
+    um_data->u_data[2] = sim.fftResult;
+    um_data->u_data[3] = &sim.samplePeak;
+    um_data->u_data[4] = &sim.FFT_MajorPeak;
+    um_data->u_data[5] = &sim.my_magnitude;
+    um_data->u_data[6] = &sim.maxVol;
+    um_data->u_data[7] = &sim.binNum;
   }
 
-  uint32_t ms = millis();
+  Segment &seg = SEGMENT;
+  uint8_t *fftResult = sim.fftResult;
+  float &volumeSmth = sim.volumeSmth;
+  uint32_t ms = seg.frameNow(); // beatsin8() and friends use it too
 
   switch (simulationId) {
     default:
@@ -472,35 +768,22 @@ um_data_t* simulateSound(uint8_t simulationId)
         volumeSmth = fftResult[8];
       break;
     case UMS_WeWillRockYou:
+      memset(fftResult, 0, 16); // bins not hit in this part of the beat are silent
+      volumeSmth = 0;
       if (ms%2000 < 200) {
-        volumeSmth = random8(255);
+        volumeSmth = seg.random8(255);
         for (int i = 0; i<5; i++)
-          fftResult[i] = random8(255);
-      }
-      else if (ms%2000 < 400) {
-        volumeSmth = 0;
-        for (int i = 0; i<16; i++)
-          fftResult[i] = 0;
+          fftResult[i] = seg.random8(255);
       }
-      else if (ms%2000 < 600) {
-        volumeSmth = random8(255);
+      else if (ms%2000 >= 400 && ms%2000 < 600) {
+        volumeSmth = seg.random8(255);
         for (int i = 5; i<11; i++)
-          fftResult[i] = random8(255);
+          fftResult[i] = seg.random8(255);
       }
-      else if (ms%2000 < 800) {
-        volumeSmth = 0;
-        for (int i = 0; i<16; i++)
-          fftResult[i] = 0;
-      }
-      else if (ms%2000 < 1000) {
-        volumeSmth = random8(255);
+      else if (ms%2000 >= 800 && ms%2000 < 1000) {
+        volumeSmth = seg.random8(255);
         for (int i = 11; i<16; i++)
-          fftResult[i] = random8(255);
-      }
-      else {
-        volumeSmth = 0;
-        for (int i = 0; i<16; i++)
-          fftResult[i] = 0;
+          fftResult[i] = seg.random8(255);
       }
       break;
     case UMS_10_13:
@@ -515,13 +798,13 @@ um_data_t* simulateSound(uint8_t simulationId)
       break;
   }
 
-  samplePeak    = random8() > 250;
-  FFT_MajorPeak = 21 + (volumeSmth*volumeSmth) / 8.0f; // walk thru full range of 21hz...8200hz
-  maxVol        = 31;  // this gets feedback fro UI
-  binNum        = 8;   // this gets feedback fro UI
-  volumeRaw = volumeSmth;
-  my_magnitude = 10000.0f / 8.0f; //no idea if 10000 is a good value for FFT_Magnitude ???
-  if (volumeSmth < 1 ) my_magnitude = 0.001f;             // noise gate closed - mute
+  sim.samplePeak    = seg.random8() > 250;
+  sim.FFT_MajorPeak = 21 + (volumeSmth*volumeSmth) / 8.0f; // walk thru full range of 21hz...8200hz
+  sim.maxVol        = 31;  // this gets feedback fro UI
+  sim.binNum        = 8;   // this gets feedback fro UI
+  sim.volumeRaw = volumeSmth;
+  sim.my_magnitude = 10000.0f / 8.0f; //no idea if 10000 is a good value for FFT_Magnitude ???
+  if (volumeSmth < 1 ) sim.my_magnitude = 0.001f;             // noise gate closed - mute
 
   return um_data;
 }
@@ -60,6 +60,11 @@ void WLED::loop()
   handleSerial();
   handleImprovWifiScan();
   handleNotifications();
+  handleFseq();
+  handleRecorder();
+  handleClockSync();
+  handleFrameLock();
+  handleStateUpdates();
   handleTransitions();
 #ifdef WLED_ENABLE_DMX
   handleDMX();
@@ -69,7 +74,11 @@ void WLED::loop()
   #ifdef WLED_DEBUG
   unsigned long usermodMillis = millis();
   #endif
-  usermods.loop();
+  if (usermods.getModCount()) {
+    strip.suspend(); // usermods may change segments and busses
+    if (strip.waitUntilIdle()) usermods.loop();
+    strip.resume();
+  }
   #ifdef WLED_DEBUG
   usermodMillis = millis() - usermodMillis;
   avgUsermodMillis += usermodMillis;
@@ -101,6 +110,7 @@ void WLED::loop()
     #endif
     handleNightlight();
     handlePlaylist();
+    handleCueList();
     yield();
 
     #ifndef WLED_DISABLE_HUESYNC
@@ -109,9 +119,14 @@ void WLED::loop()
     #endif
 
     handlePresets();
+    handleDeferredJSON();
     yield();
 
-    if (!offMode || strip.isOffRefreshRequired())
+    if ((!offMode || strip.isOffRefreshRequired())
+    #ifdef WLED_ENABLE_RENDER_TASK
+      && !renderTaskHandle  // effects are rendered in renderTask()
+    #endif
+      )
       strip.service();
     #ifdef ESP8266
     else if (!noWifiSleep)
@@ -156,7 +171,9 @@ void WLED::loop()
 
   //LED settings have been saved, re-init busses
   //This code block causes severe FPS drop on ESP32 with the original "if (busConfigs[0] != nullptr)" conditional. Investigate!
-  if (doInitBusses) {
+  bool reinit = doInitBusses || loadLedmap >= 0;
+  if (reinit) strip.suspend(); // busses and segments must not be used by render task
+  if (doInitBusses && strip.waitUntilIdle()) { // retried in next loop if render task is busy
     doInitBusses = false;
     DEBUG_PRINTLN(F("Re-init busses."));
     bool aligned = strip.checkSegmentAlignment(); //see if old segments match old bus(ses)
@@ -180,10 +197,11 @@ void WLED::loop()
     else strip.fixInvalidSegments();
     doSerializeConfig = true;
   }
-  if (loadLedmap >= 0) {
+  if (loadLedmap >= 0 && strip.waitUntilIdle()) {
     if (!strip.deserializeMap(loadLedmap) && strip.isMatrix && loadLedmap == 0) strip.setUpMatrix();
     loadLedmap = -1;
   }
+  if (reinit) strip.resume();
   yield();
   if (doSerializeConfig) serializeConfig();
 
@@ -295,6 +313,7 @@ void WLED::setup()
   #endif
 
   #ifdef ARDUINO_ARCH_ESP32
+  mainTaskHandle = xTaskGetCurrentTaskHandle();
   pinMode(hardwareRX, INPUT_PULLDOWN); delay(1);        // suppress noise in case RX pin is floating (at low noise energy) - see issue #3128
   #endif
   Serial.begin(115200);
@@ -410,10 +429,9 @@ pinManager.allocateMultiplePins(pins, sizeof(pins)/sizeof(managed_pin_type), Pin
     errorFlag = ERR_FS_BEGIN;
   }
 #ifdef WLED_ADD_EEPROM_SUPPORT
-  else deEEP();
-#else
-  initPresetsFile();
+  else deEEP(); // creates presets.json, imported in first handlePresets()
 #endif
+  initPresetsFile();
   updateFSInfo();
 
   // generate module IDs must be done before AP setup
@@ -425,6 +443,7 @@ pinManager.allocateMultiplePins(pins, sizeof(pins)/sizeof(managed_pin_type), Pin
 
   DEBUG_PRINTLN(F("Reading config"));
   deserializeConfigFromFS();
+  Nodes.setCapacity(nodeListSize);
 
 #if defined(STATUSLED) && STATUSLED>=0
   if (!pinManager.isPinAllocated(STATUSLED)) {
@@ -437,10 +456,17 @@ pinManager.allocateMultiplePins(pins, sizeof(pins)/sizeof(managed_pin_type), Pin
   DEBUG_PRINTLN(F("Initializing strip"));
   beginStrip();
   DEBUG_PRINT(F("heap ")); DEBUG_PRINTLN(ESP.getFreeHeap());
+  #ifdef WLED_ENABLE_RENDER_TASK
+  if (ESP.getChipCores() > 1) {
+    DEBUG_PRINTLN(F("Starting render task"));
+    xTaskCreatePinnedToCore(renderTask, "Render", WLED_RENDER_TASK_STACK, nullptr, 1, &renderTaskHandle, WLED_RENDER_TASK_CORE);
+  }
+  #endif
 
   DEBUG_PRINTLN(F("Usermods setup"));
   userSetup();
   usermods.setup();
+  initJSONCache(); // all effects are registered now
   DEBUG_PRINT(F("heap ")); DEBUG_PRINTLN(ESP.getFreeHeap());
 
   if (strcmp(clientSSID, DEFAULT_CLIENT_SSID) == 0)
@@ -506,6 +532,23 @@ pinManager.allocateMultiplePins(pins, sizeof(pins)/sizeof(managed_pin_type), Pin
   #endif
 }
 
+#ifdef WLED_ENABLE_RENDER_TASK
+// renders effects on the other core while loop() handles network, presets, etc.
+// effects render into the bus buffers (useGlobalLedBuffer is forced, so the buffer is the back buffer), show() hands
+// them to the drivers which transmit asynchronously (RMT/I2S), so the next frame is computed while the previous one is sent;
+// no lock is needed for the handoff as render and show run in this task only.
+// loop() synchronises with it via strip.suspend()/waitUntilIdle()/resume() before changing segments or busses,
+// suspend() nests and waitUntilIdle() fails if a frame takes longer than STRIP_IDLE_TIMEOUT (nothing must be changed then)
+void WLED::renderTask(void *)
+{
+  for (;;) {
+    if ((!realtimeMode || realtimeOverride || useMainSegmentOnly) && (!offMode || strip.isOffRefreshRequired()))
+      strip.service(); // returns immediately if suspended or no frame is due
+    vTaskDelay(1);     // let idle task on this core run
+  }
+}
+#endif
+
 void WLED::beginStrip()
 {
   // Initialize NeoPixel Strip and button
@@ -778,12 +821,14 @@ void WLED::initInterfaces()
       udpRgbConnected = rgbUdp.begin(udpRgbPort);
     if (udpConnected && udpPort2 != udpPort && udpPort2 != udpRgbPort)
       udp2Connected = notifier2Udp.begin(udpPort2);
+    updateMulticastGroups(true);
   }
   if (ntpEnabled)
     ntpConnected = ntpUdp.begin(ntpLocalPort);
 
   e131.begin(e131Multicast, e131Port, e131Universe, E131_MAX_UNIVERSE_COUNT);
-  ddp.begin(false, DDP_DEFAULT_PORT);
+  if (udpMulticast) ddp.beginMulticast(multicastAddress(MULTICAST_DDP_GROUP), DDP_DEFAULT_PORT);
+  else              ddp.begin(false, DDP_DEFAULT_PORT);
   reconnectHue();
 #ifndef WLED_DISABLE_MQTT
   initMqtt();
@@ -815,9 +860,13 @@ void WLED::handleConnection()
       DEBUG_PRINT(F("Heap too low! "));
       DEBUG_PRINTLN(heap);
       forceReconnect = true;
-      strip.purgeSegments(true); // remove all but one segments from memory
-    } else if (heap < MIN_HEAP_SIZE) {
+      if (requestStateLock()) { // segments must not be serialized by network callbacks meanwhile
+        strip.purgeSegments(true); // remove all but one segments from memory
+        releaseStateLock();
+      }
+    } else if (heap < MIN_HEAP_SIZE && requestStateLock()) {
       strip.purgeSegments();
+      releaseStateLock();
     }
     lastHeap = heap;
     heapTime = now;
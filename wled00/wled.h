@@ -60,6 +60,15 @@
   #define WLED_WATCHDOG_TIMEOUT 0
 #endif
 
+//optionally run effects in a separate task on the other core of dual core ESP32 (renders next frame while main loop handles network)
+//#define WLED_ENABLE_RENDER_TASK
+//optionally render segments that do not overlap in parallel on both cores of dual core ESP32
+//#define WLED_ENABLE_PARALLEL_RENDER
+//effect names, effect data and palettes JSON responses are cached in RAM on ESP32 (uses 10-30kB, PSRAM if available)
+#if !defined(ESP8266) && !defined(WLED_DISABLE_JSON_CACHE)
+  #define WLED_ENABLE_JSON_CACHE
+#endif
+
 //optionally disable brownout detector on ESP32.
 //This is generally a terrible idea, but improves boot success on boards with a 3.3v regulator + cap setup that can't provide 400mA peaks
 //#define WLED_DISABLE_BROWNOUT_DET
@@ -99,6 +108,20 @@
     #include <esp_now.h>
   #endif
 #endif
+#if defined(WLED_ENABLE_RENDER_TASK) && (!defined(ARDUINO_ARCH_ESP32) || defined(CONFIG_FREERTOS_UNICORE))
+  #undef WLED_ENABLE_RENDER_TASK   // requires dual core ESP32
+#endif
+#if defined(WLED_ENABLE_PARALLEL_RENDER) && (!defined(ARDUINO_ARCH_ESP32) || defined(CONFIG_FREERTOS_UNICORE))
+  #undef WLED_ENABLE_PARALLEL_RENDER  // requires dual core ESP32
+#endif
+#ifdef WLED_ENABLE_RENDER_TASK
+  #ifndef WLED_RENDER_TASK_CORE
+    #define WLED_RENDER_TASK_CORE 0  // loop() runs on core 1
+  #endif
+  #ifndef WLED_RENDER_TASK_STACK
+    #define WLED_RENDER_TASK_STACK 8192
+  #endif
+#endif
 #include <Wire.h>
 #include <SPI.h>
 
@@ -365,9 +388,14 @@ WLED_GLOBAL bool simplifiedUI          _INIT(false);   // enable simplified UI
 WLED_GLOBAL byte cacheInvalidate       _INIT(0);       // used to invalidate browser cache when switching from regular to simplified UI
 
 // Sync CONFIG
-WLED_GLOBAL NodesMap Nodes;
+WLED_GLOBAL NodeTable Nodes;
+WLED_GLOBAL uint16_t nodeListSize _INIT(WLED_MAX_NODES);   // capacity of node list (applied at boot)
 WLED_GLOBAL bool nodeListEnabled _INIT(true);
 WLED_GLOBAL bool nodeBroadcastEnabled _INIT(true);
+WLED_GLOBAL bool clockSyncEnabled _INIT(false);     // lock effect timebase to other nodes (see clocksync.cpp)
+WLED_GLOBAL bool frameLockEnabled _INIT(false);     // show frames at the same time as other nodes (see framelock.cpp)
+WLED_GLOBAL uint32_t frameLockLate   _INIT(0);      // frame lock statistics
+WLED_GLOBAL uint32_t frameLockMissed _INIT(0);
 
 WLED_GLOBAL byte buttonType[WLED_MAX_BUTTONS]  _INIT({BTN_TYPE_PUSH});
 #if defined(IRTYPE) && defined(IRPIN)
@@ -394,6 +422,8 @@ WLED_GLOBAL bool notifyAlexa  _INIT(false);                       // send notifi
 WLED_GLOBAL bool notifyMacro  _INIT(false);                       // send notification for macro
 WLED_GLOBAL bool notifyHue    _INIT(true);                        // send notification if Hue light changes
 WLED_GLOBAL uint8_t udpNumRetries _INIT(0);                       // Number of times a UDP sync message is retransmitted. Increase to increase reliability
+WLED_GLOBAL bool udpDeltaSync _INIT(false);                       // only send segments changed since last full sync message
+WLED_GLOBAL bool udpMulticast _INIT(false);                       // use multicast groups instead of broadcast for sync, node list & DDP
 
 WLED_GLOBAL bool alexaEnabled _INIT(false);                       // enable device discovery by Amazon Echo
 WLED_GLOBAL char alexaInvocationName[33] _INIT("Light");          // speech control name of device. Choose something voice-to-text can understand
@@ -709,6 +739,12 @@ WLED_GLOBAL WS2812FX strip _INIT(WS2812FX());
 WLED_GLOBAL BusConfig* busConfigs[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] _INIT({nullptr}); //temporary, to remember values from network callback until after
 WLED_GLOBAL bool doInitBusses _INIT(false);
 WLED_GLOBAL int8_t loadLedmap _INIT(-1);
+#ifdef WLED_ENABLE_RENDER_TASK
+WLED_GLOBAL TaskHandle_t renderTaskHandle _INIT(nullptr);  // effects are rendered in WLED::renderTask() if set
+#endif
+#ifdef ARDUINO_ARCH_ESP32
+WLED_GLOBAL TaskHandle_t mainTaskHandle _INIT(nullptr);    // task running WLED::loop(), other tasks are network callbacks
+#endif
 #ifndef ESP8266
 WLED_GLOBAL char  *ledmapNames[WLED_MAX_LEDMAPS-1] _INIT_N(({nullptr}));
 #endif
@@ -756,6 +792,12 @@ WLED_GLOBAL int8_t spi_sclk  _INIT(SPISCLKPIN);
 // global ArduinoJson buffer
 WLED_GLOBAL StaticJsonDocument<JSON_BUFFER_SIZE> doc;
 WLED_GLOBAL volatile uint8_t jsonBufferLock _INIT(0);
+// JSON buffer contention counters (reported in /json/info)
+WLED_GLOBAL uint8_t  jsonBufferPeak     _INIT(0); // max. number of buffers in use at the same time
+WLED_GLOBAL uint16_t jsonBufferWaits    _INIT(0); // requests that had to wait for global buffer
+WLED_GLOBAL uint16_t jsonBufferFails    _INIT(0); // requests that did not get a buffer
+WLED_GLOBAL uint16_t jsonBufferDeferred _INIT(0); // requests queued for main loop
+WLED_GLOBAL uint32_t stateUpdatesCoalesced _INIT(0); // API state changes merged into another update (see queueStateUpdate())
 
 // enable additional debug output
 #if defined(WLED_DEBUG_HOST)
@@ -862,5 +904,8 @@ public:
   void handleStatusLED();
   void enableWatchdog();
   void disableWatchdog();
+  #ifdef WLED_ENABLE_RENDER_TASK
+  static void renderTask(void *);
+  #endif
 };
 #endif        // WLED_H
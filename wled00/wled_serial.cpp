@@ -185,9 +185,7 @@ void handleSerial()
         if (!realtimeOverride) setRealtimePixel(pixel++, red, green, blue, 0);
         if (--count > 0) state = AdaState::Data_Red;
         else {
-          realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
-
-          if (!realtimeOverride) strip.show();
+          if (realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT) && !realtimeOverride) strip.show();
           state = AdaState::Header_A;
         }
         break;
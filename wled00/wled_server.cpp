@@ -18,9 +18,6 @@
  * Integrated HTTP web server page declarations
  */
 
-bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request);
-void setStaticContentCacheHeaders(AsyncWebServerResponse *response);
-
 // define flash strings once (saves flash memory)
 static const char s_redirecting[] PROGMEM = "Redirecting...";
 static const char s_content_enc[] PROGMEM = "Content-Encoding";
@@ -64,21 +61,96 @@ void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t
       request->send(200, "text/plain", F("Configuration restore successful.\nRebooting..."));
     } else {
       if (filename.indexOf(F("palette")) >= 0 && filename.indexOf(F(".json")) >= 0) strip.loadCustomPalettes();
+      if (filename.indexOf(F("presets.json")) >= 0) importPresets(); // replaces all presets
       request->send(200, "text/plain", F("File Uploaded!"));
     }
     cacheInvalidate++;
   }
 }
 
+#ifdef WLED_ENABLE_FS_EDITOR
+// FS editor that also lists presets.json: it is exported from the preset store (see presetstore.cpp) and read only,
+// a presets.json backup is restored with /upload (which imports it)
+class PresetsFSEditor : public AsyncWebHandler {
+  public:
+    #ifdef ARDUINO_ARCH_ESP32
+    PresetsFSEditor() : _editor(WLED_FS) {}
+    #else
+    PresetsFSEditor() : _editor("","",WLED_FS) {}
+    #endif
+
+    bool canHandle(AsyncWebServerRequest *request) {
+      return isPresetsGet(request) || _editor.canHandle(request); // editor does not handle files that don't exist
+    }
+
+    void handleRequest(AsyncWebServerRequest *request) {
+      if (request->method() == HTTP_GET && request->hasParam("list")) listFiles(request);
+      else if (isPresetsGet(request)) servePresetsJson(request);
+      else if (isPresetsFile(request->hasParam("path", true) ? request->getParam("path", true)->value() : String())
+            || (request->hasParam("data", true, true) && isPresetsFile(request->getParam("data", true, true)->value())))
+        request->send(403, "text/plain", F("presets.json is read only, restore a backup in Security & Updates."));
+      else _editor.handleRequest(request);
+    }
+
+    void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final) {
+      if (!isPresetsFile(filename)) _editor.handleUpload(request, filename, index, data, len, final);
+    }
+
+    bool isRequestHandlerTrivial() { return false; }
+
+  private:
+    SPIFFSEditor _editor;
+
+    static bool isPresetsFile(const String &path) {
+      return path.equals(F("/presets.json")) || path.equals(F("presets.json"));
+    }
+
+    static bool isPresetsGet(AsyncWebServerRequest *request) {
+      if (request->method() != HTTP_GET || !request->url().equalsIgnoreCase(F("/edit"))) return false;
+      return isPresetsFile(request->arg("edit")) || isPresetsFile(request->arg("download"));
+    }
+
+    // same as the editor's list, with presets.json in the root directory
+    static void listFiles(AsyncWebServerRequest *request) {
+      String path = request->getParam("list")->value();
+      String output = "[";
+      #ifdef ARDUINO_ARCH_ESP32
+      File dir = WLED_FS.open(path);
+      for (File entry = dir.openNextFile(); entry; entry = dir.openNextFile()) {
+      #else
+      Dir dir = WLED_FS.openDir(path);
+      while (dir.next()) {
+        File entry = dir.openFile("r");
+      #endif
+        if (output.length() > 1) output += ',';
+        output += F("{\"type\":\"file\",\"name\":\"");
+        output += entry.name();
+        output += F("\",\"size\":");
+        output += entry.size();
+        output += '}';
+        entry.close();
+      }
+      if (path.equals("/") && !WLED_FS.exists(F("/presets.json"))) { // not yet imported legacy file is listed as is
+        if (output.length() > 1) output += ',';
+        #ifdef ARDUINO_ARCH_ESP32
+        output += F("{\"type\":\"file\",\"name\":\"/presets.json\",\"size\":"); // same form as entry.name()
+        #else
+        output += F("{\"type\":\"file\",\"name\":\"presets.json\",\"size\":");
+        #endif
+        output += presetsJsonSize();
+        output += '}';
+      }
+      output += ']';
+      request->send(200, "application/json", output);
+    }
+};
+#endif
+
 void createEditHandler(bool enable) {
   if (editHandler != nullptr) server.removeHandler(editHandler);
   if (enable) {
     #ifdef WLED_ENABLE_FS_EDITOR
-      #ifdef ARDUINO_ARCH_ESP32
-      editHandler = &server.addHandler(new SPIFFSEditor(WLED_FS));//http_username,http_password));
-      #else
-      editHandler = &server.addHandler(new SPIFFSEditor("","",WLED_FS));//http_username,http_password));
-      #endif
+      editHandler = &server.addHandler(new PresetsFSEditor());
     #else
       editHandler = &server.on(SET_F("/edit"), HTTP_GET, [](AsyncWebServerRequest *request){
         serveMessage(request, 501, "Not implemented", F("The FS editor is disabled in this build."), 254);
@@ -173,11 +245,25 @@ void initServer()
     serveJson(request);
   });
 
+  // presets are kept in preset store, exported in presets.json format
+  server.on(SET_F("/presets.json"), HTTP_GET, [](AsyncWebServerRequest *request){
+    servePresetsJson(request);
+  });
+
   AsyncCallbackJsonWebHandler* handler = new AsyncCallbackJsonWebHandler(F("/json"), [](AsyncWebServerRequest *request) {
     bool verboseResponse = false;
-    bool isConfig = false;
-
-    if (!requestJSONBufferLock(14)) return;
+    const String& url = request->url();
+    bool isConfig = url.indexOf("cfg") > -1;
+
+    if (!isConfig && !tryJSONRequestLock(14)) {
+      // buffer busy or older requests queued: apply from main loop in order (without state in response)
+      if (deferJSONRequest(14, (const char*)request->_tempObject, request->contentLength()))
+        request->send(200, "application/json", F("{\"success\":true}"));
+      else
+        request->send(503, "application/json", F("{\"error\":3}")); // ERR_NOBUF
+      return;
+    }
+    if (isConfig && !requestJSONBufferLock(14)) return;
 
     DeserializationError error = deserializeJson(doc, (uint8_t*)(request->_tempObject));
     JsonObject root = doc.as<JsonObject>();
@@ -188,8 +274,6 @@ void initServer()
     }
     if (root.containsKey("pin")) checkSettingsPIN(root["pin"].as<const char*>());
 
-    const String& url = request->url();
-    isConfig = url.indexOf("cfg") > -1;
     if (!isConfig) {
       /*
       #ifdef WLED_DEBUG
@@ -415,19 +499,28 @@ void initServer()
   });
 }
 
-bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request)
+// ETag of static content changes with version and uploaded files, eTagSuffix is used for generated (cached) content
+static void generateEtag(char *etag, uint16_t eTagSuffix)
+{
+  if (eTagSuffix) sprintf_P(etag, PSTR("%8d-%02x-%04x"), VERSION, cacheInvalidate, eTagSuffix);
+  else            sprintf_P(etag, PSTR("%8d-%02x"), VERSION, cacheInvalidate);
+}
+
+bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request, uint16_t eTagSuffix)
 {
   AsyncWebHeader* header = request->getHeader("If-None-Match");
-  if (header && header->value() == String(VERSION)) {
+  char etag[20];
+  generateEtag(etag, eTagSuffix);
+  if (header && header->value() == etag) {
     request->send(304);
     return true;
   }
   return false;
 }
 
-void setStaticContentCacheHeaders(AsyncWebServerResponse *response)
+void setStaticContentCacheHeaders(AsyncWebServerResponse *response, uint16_t eTagSuffix)
 {
-  char tmp[12];
+  char tmp[20];
   // https://medium.com/@codebyamir/a-web-developers-guide-to-browser-caching-cc41f3b73e7c
   #ifndef WLED_DEBUG
   //this header name is misleading, "no-cache" will not disable cache,
@@ -436,7 +529,7 @@ void setStaticContentCacheHeaders(AsyncWebServerResponse *response)
   #else
   response->addHeader(F("Cache-Control"),"no-store,max-age=0"); // prevent caching if debug build
   #endif
-  sprintf_P(tmp, PSTR("%8d-%02x"), VERSION, cacheInvalidate);
+  generateEtag(tmp, eTagSuffix);
   response->addHeader(F("ETag"), tmp);
 }
 
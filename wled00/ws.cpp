@@ -7,24 +7,284 @@
 
 uint16_t wsLiveClientId = 0;
 unsigned long wsLastLiveTime = 0;
-//uint8_t* wsFrameBuffer = nullptr;
 
 #define WS_LIVE_INTERVAL 40
 
+// Binary live view v3 (client sends {"lv":true,"lz":true}), a frame is sent in one or more chunks:
+// header: 'L', 3, flags (bit 0: key frame, bit 1: last chunk of frame), frame sequence,
+//         width, height, index of first pixel in chunk (uint16 big endian each)
+// followed by operations on RGB pixels (row by row):
+//   0x00-0x7F: n+1 literal pixels follow (3 bytes each)
+//   0x80-0xBF: n+1 pixels are unchanged since previous frame
+//   0xC0-0xFF: next pixel (3 bytes) is repeated n+1 times
+// Matrices (and long strips) are downscaled by averaging boxes of scale x scale LEDs to fit WS_LIVE_MAX_PIXELS.
+// Frame rate adapts to the client (WS queue) and to the time needed for encoding.
+#ifdef ESP8266
+  #define WS_LIVE_MAX_PIXELS 256U
+  #define WS_LIVE_CHUNK_SIZE 800U
+#else
+  #define WS_LIVE_MAX_PIXELS 8192U
+  #define WS_LIVE_CHUNK_SIZE 4096U
+#endif
+#define WS_LIVE_HEADER_SIZE    10
+#define WS_LIVE_KEY_INTERVAL   64   // frames between key frames
+#define WS_LIVE_MAX_INTERVAL   500  // ms, slowest update rate if client can't keep up
+
+// state/info and node list messages are serialized into chunks of this size and sent as continuation frames
+#ifdef ESP8266
+  #define WS_JSON_CHUNK_SIZE 1024U
+#else
+  #define WS_JSON_CHUNK_SIZE 2048U
+#endif
+
+// node list changes are pushed as {"nd":<same as /json/nodes?v=<previous version>>}
+#define WS_NODES_INTERVAL      1000 // ms, changes in between are sent together
+static uint32_t      wsNodesVersion = 0;
+static unsigned long wsNodesTime = 0;
+
+static bool     wsLiveDelta = false;   // live view client uses v3 protocol
+static uint8_t *wsLivePrev = nullptr;  // previous frame (RGB) for delta encoding
+static size_t   wsLivePrevLen = 0;
+static uint8_t  wsLiveSeq = 0;
+static uint8_t  wsLiveFrames = 0;      // frames since last key frame
+static uint16_t wsLiveInterval = WS_LIVE_INTERVAL;
+
+// applies complete JSON message from client (from async TCP task)
+static void receiveWsJson(AsyncWebSocketClient * client, const char *data, size_t len)
+{
+  // do not block async TCP task waiting for JSON buffer, apply request from main loop instead
+  // (also if older requests are queued, a newer value must not be overwritten by a stale one)
+  if (tryJSONRequestLock(11)) handleWsJson(client->id(), data, len);
+  else if (!deferJSONRequest(11, data, len, client->id())) client->text(F("{\"error\":3}"));
+}
+
+// acknowledges binary command packet (see bincmd.cpp), result as returned by handleBinaryCommand()
+static void sendBinaryAckWs(AsyncWebSocketClient * client, int result)
+{
+  uint8_t ack[4] = {BINCMD_MAGIC, BINCMD_VERSION, BINCMD_ACK_OK, 0};
+  if (result < 0) ack[2] = -result;
+  else            ack[3] = MIN(result, 255);
+  client->binary(ack, sizeof(ack));
+}
+
+// Delta updates: clients sending {"dt":true} receive only top level state/info fields and segments that changed
+// since the last update they were sent: {"b":<base version>,"d":<new version>,"state":{...,"seg":[...]},"info":{...}}
+// removed fields are sent as null, removed segments as {"id":n,"stop":0}; a client that missed an update (base
+// version does not match) requests full state with {"v":true}. Changes are detected by hashing each serialized
+// field, fields are tracked by name (conditional fields may appear or disappear without affecting others).
+typedef struct {
+  uint32_t id;    // WS client ID (0 = unused)
+  uint32_t ver;   // version of fields the client was last sent
+  bool     delta; // client accepts delta updates
+} WsClientInfo;
+
+#define WS_DELTA_KEY_LEN 16 // longer keys are not tracked (always sent)
+
+typedef struct {
+  char     key[WS_DELTA_KEY_LEN]; // field name ("" = unused slot)
+  uint32_t hash;  // hash of serialized value (0 = field was removed)
+  uint32_t ver;   // version when it last changed
+} WsFieldInfo;
+
+static WsClientInfo wsClients[WS_MAX_DELTA_CLIENTS] = {};
+static WsFieldInfo  wsStateFields[WS_DELTA_STATE_FIELDS] = {};
+static WsFieldInfo  wsInfoFields[WS_DELTA_INFO_FIELDS] = {};
+static_assert(WS_DELTA_STATE_FIELDS <= 64 && WS_DELTA_INFO_FIELDS <= 64, "updateWsFields() tracks up to 64 fields");
+static WsFieldInfo  wsSegFields[MAX_NUM_SEGMENTS] = {};
+static uint32_t     wsDeltaVersion = 1;
+
+// FNV-1a hash of printed characters (serialized JSON is hashed without storing it)
+class HashPrint : public Print {
+  public:
+    uint32_t hash = 2166136261UL;
+    size_t write(uint8_t c) override { hash = (hash ^ c) * 16777619UL; return 1; }
+};
+
+static WsClientInfo* findWsClient(uint32_t id)
+{
+  for (auto &c : wsClients) if (c.id == id) return &c;
+  return nullptr;
+}
+
+// every connected client needs a slot (state is only sent to tracked clients), if all are in use the oldest
+// client's slot is taken: handleWs() limits the number of clients to WS_MAX_DELTA_CLIENTS by closing the oldest ones
+static void addWsClient(uint32_t id)
+{
+  WsClientInfo *c = nullptr;
+  for (auto &o : wsClients) {
+    if (o.id && !ws.client(o.id)) o.id = 0; // no longer connected
+    if (!c || (c->id && (!o.id || o.id < c->id))) c = &o;
+  }
+  *c = {id, 0, false};
+}
+
+static void removeWsClient(uint32_t id)
+{
+  WsClientInfo *c = findWsClient(id);
+  if (c) c->id = 0;
+}
+
+static void setWsClientDelta(uint32_t id, bool delta)
+{
+  WsClientInfo *c = findWsClient(id);
+  if (c) c->delta = delta;
+  DEBUG_PRINTF("WS client %u delta updates: %d\n", id, (int)(c && delta));
+}
+
+// remembers that client received full state (all current fields)
+static void setWsClientSynced(uint32_t id)
+{
+  WsClientInfo *c = findWsClient(id);
+  if (c) c->ver = wsDeltaVersion;
+}
+
+// index of field with name key (or of free slot with key ""), -1 if not found
+static int findWsField(const WsFieldInfo *fields, size_t maxFields, const char *key)
+{
+  for (size_t i = 0; i < maxFields; i++) if (!strcmp(fields[i].key, key)) return i;
+  return -1;
+}
+
+// updates hash and version of each top level field by name, fields that are not in root anymore are marked removed
+// fields with long names or that do not fit into the table are not tracked (always sent)
+static void updateWsFields(JsonObject root, WsFieldInfo *fields, size_t maxFields)
+{
+  uint64_t seen = 0; // fields present in root
+  for (JsonPair kv : root) {
+    const char *key = kv.key().c_str();
+    if (strlen(key) >= WS_DELTA_KEY_LEN) continue;
+    int i = findWsField(fields, maxFields, key);
+    if (i < 0) {
+      i = findWsField(fields, maxFields, ""); // free slot
+      if (i < 0) continue;
+      strcpy(fields[i].key, key);
+      fields[i].hash = 0;
+    }
+    seen |= 1ULL << i;
+    HashPrint h;
+    serializeJson(kv.value(), h);
+    h.hash |= 1; // 0 is reserved for removed field
+    if (fields[i].hash != h.hash) { fields[i].hash = h.hash; fields[i].ver = wsDeltaVersion; }
+  }
+  for (size_t i = 0; i < maxFields; i++) {
+    if ((seen & (1ULL << i)) || !fields[i].key[0] || !fields[i].hash) continue;
+    fields[i].hash = 0; // removed
+    fields[i].ver = wsDeltaVersion;
+  }
+}
+
+// copies fields that changed after version base and adds removed ones as null
+// (keys of src are not copied, src must outlive dst)
+static void copyWsFields(JsonObject src, JsonObject dst, const WsFieldInfo *fields, size_t maxFields, uint32_t base)
+{
+  for (JsonPair kv : src) {
+    const char *key = kv.key().c_str();
+    int i = strlen(key) < WS_DELTA_KEY_LEN ? findWsField(fields, maxFields, key) : -1;
+    if (i < 0 || fields[i].ver > base) dst[key] = kv.value();
+  }
+  for (size_t i = 0; i < maxFields; i++) {
+    if (fields[i].key[0] && !fields[i].hash && fields[i].ver > base) dst[(char*)fields[i].key] = nullptr; // removed (key is copied)
+  }
+}
+
+// sends changed fields to all delta clients, returns false if it was not possible (full state needs to be sent)
+static bool sendDeltaWs()
+{
+  byte err = errorFlag; // serializeStateHead() clears it, but full state may still need to be sent to other clients
+  PSRAMDynamicJsonDocument head(2*JSON_STREAM_PIECE_SIZE); // kept for all clients, not enlarged like stream pieces
+  PSRAMDynamicJsonDocument info(4*JSON_STREAM_PIECE_SIZE);
+  PSRAMDynamicJsonDocument seg(2*JSON_STREAM_PIECE_SIZE);
+  if (!head.capacity() || !info.capacity() || !seg.capacity()) return false;
+  serializeStateHead(head.to<JsonObject>());
+  errorFlag = err;
+  serializeInfo(info.to<JsonObject>());
+  if (head.overflowed() || info.overflowed()) return false;
+
+  wsDeltaVersion++;
+  updateWsFields(head.as<JsonObject>(), wsStateFields, WS_DELTA_STATE_FIELDS);
+  updateWsFields(info.as<JsonObject>(), wsInfoFields, WS_DELTA_INFO_FIELDS);
+  for (size_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    uint32_t hash = 0; // removed or inactive segment
+    if (i < strip.getSegmentsNum() && strip.getSegment(i).isActive()) {
+      JsonObject o = seg.to<JsonObject>();
+      serializeSegment(o, strip.getSegment(i), i);
+      HashPrint h;
+      serializeJson(seg, h);
+      hash = h.hash | 1;
+    }
+    if (wsSegFields[i].hash != hash) { wsSegFields[i].hash = hash; wsSegFields[i].ver = wsDeltaVersion; }
+  }
+
+  // clients that missed the same updates share the message (usually all of them)
+  for (auto &c : wsClients) {
+    if (!c.id || !c.delta || c.ver == wsDeltaVersion) continue;
+    uint32_t base = c.ver;
+
+    JsonDocument *pDoc = requestJSONBuffer(12);
+    if (!pDoc) return false;
+    JsonObject root = pDoc->to<JsonObject>();
+    root["b"] = base;
+    root["d"] = wsDeltaVersion;
+    JsonObject state = root.createNestedObject("state");
+    copyWsFields(head.as<JsonObject>(), state, wsStateFields, WS_DELTA_STATE_FIELDS, base);
+    JsonArray segs;
+    for (size_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+      if (wsSegFields[i].ver <= base) continue;
+      if (segs.isNull()) segs = state.createNestedArray("seg");
+      JsonObject o = segs.createNestedObject();
+      if (wsSegFields[i].hash) serializeSegment(o, strip.getSegment(i), i);
+      else { o["id"] = i; o["stop"] = 0; }
+    }
+    if (state.size() == 0) root.remove("state");
+    JsonObject inf = root.createNestedObject("info");
+    copyWsFields(info.as<JsonObject>(), inf, wsInfoFields, WS_DELTA_INFO_FIELDS, base);
+    if (inf.size() == 0) root.remove("info");
+
+    AsyncWebSocketMessageBuffer *buffer = nullptr;
+    if (root.size() > 2 && !pDoc->overflowed()) {
+      size_t len = measureJson(*pDoc);
+      buffer = ws.makeBuffer(len);
+      if (buffer) serializeJson(*pDoc, (char *)buffer->get(), len);
+    }
+    bool failed = pDoc->overflowed() || (root.size() > 2 && !buffer);
+    releaseJSONBuffer(pDoc);
+    if (failed) {
+      DEBUG_PRINTLN(F("WS delta update failed."));
+      return false;
+    }
+
+    if (buffer) buffer->lock();
+    for (auto &o : wsClients) {
+      if (!o.id || !o.delta || o.ver != base) continue;
+      AsyncWebSocketClient *client = ws.client(o.id);
+      if (client && buffer) client->text(buffer);
+      o.ver = wsDeltaVersion;
+    }
+    if (buffer) buffer->unlock();
+    DEBUG_PRINTF("WS delta update %u -> %u sent.\n", base, wsDeltaVersion);
+  }
+  ws._cleanBuffers();
+  return true;
+}
+
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
   if(type == WS_EVT_CONNECT){
     //client connected
     DEBUG_PRINTLN(F("WS client connected."));
+    ws.cleanupClients(WS_MAX_DELTA_CLIENTS); // oldest client is closed if all slots are in use
+    addWsClient(client->id());
     sendDataWs(client);
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
     if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    freeWsReassembly(client->id());
+    removeWsClient(client->id());
     DEBUG_PRINTLN(F("WS client disconnected."));
   } else if(type == WS_EVT_DATA){
     // data packet
     AwsFrameInfo * info = (AwsFrameInfo*)arg;
-    if(info->final && info->index == 0 && info->len == len){
+    if(info->final && info->num == 0 && info->index == 0 && info->len == len){
       // the whole message is in a single frame and we got all of its data (max. 1450 bytes)
       if(info->opcode == WS_TEXT)
       {
@@ -35,55 +295,23 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
           return;
         }
 
-        bool verboseResponse = false;
-        if (!requestJSONBufferLock(11)) return;
-
-        DeserializationError error = deserializeJson(doc, data, len);
-        JsonObject root = doc.as<JsonObject>();
-        if (error || root.isNull()) {
-          releaseJSONBufferLock();
-          return;
-        }
-        if (root["v"] && root.size() == 1) {
-          //if the received value is just "{"v":true}", send only to this client
-          verboseResponse = true;
-        } else if (root.containsKey("lv")) {
-          wsLiveClientId = root["lv"] ? client->id() : 0;
-        } else {
-          verboseResponse = deserializeState(root);
-        }
-        releaseJSONBufferLock(); // will clean fileDoc
-
-        if (!interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
-          if (verboseResponse) {
-            sendDataWs(client);
-          } else {
-            // we have to send something back otherwise WS connection closes
-            client->text(F("{\"success\":true}"));
-          }
-          // force broadcast in 500ms after updating client
-          //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
-        }
+        receiveWsJson(client, (const char*)data, len);
+      } else if (info->opcode == WS_BINARY) {
+        // binary control commands must not change segments from async TCP task, applied from main loop (handleWsBinary())
+        if (!deferJSONRequest(24, (const char*)data, len, client->id())) sendBinaryAckWs(client, -BINCMD_ACK_BUSY);
       }
     } else {
       //message is comprised of multiple frames or the frame is split into multiple packets
-      //if(info->index == 0){
-        //if (!wsFrameBuffer && len < 4096) wsFrameBuffer = new uint8_t[4096];
-      //}
-
-      //if (wsFrameBuffer && len < 4096 && info->index + info->)
-      //{
-
-      //}
-
-      if((info->index + len) == info->len){
-        if(info->final){
-          if(info->message_opcode == WS_TEXT) {
-            client->text(F("{\"error\":9}")); // ERR_JSON we do not handle split packets right now
-          }
+      DEBUG_PRINTLN(F("WS multipart message."));
+      if (info->message_opcode == WS_TEXT) {
+        byte error;
+        WsReassembly *r = reassembleWs(client->id(), info->num, info->index, info->len, info->final, data, len, error);
+        if (error) client->text(error == ERR_JSON ? F("{\"error\":9}") : F("{\"error\":3}"));
+        if (r) {
+          receiveWsJson(client, r->data, r->len);
+          freeWsReassembly(*r);
         }
       }
-      DEBUG_PRINTLN(F("WS multipart message."));
     }
   } else if(type == WS_EVT_ERROR){
     //error was received from the other end
@@ -96,60 +324,245 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
   }
 }
 
-void sendDataWs(AsyncWebSocketClient * client)
+// applies binary command packet received from WS client (from main loop)
+void handleWsBinary(uint32_t clientId, const uint8_t *data, size_t len)
 {
-  if (!ws.count()) return;
-  AsyncWebSocketMessageBuffer * buffer;
+  int result = handleBinaryCommand(data, len);
+  AsyncWebSocketClient *client = ws.client(clientId);
+  if (client) sendBinaryAckWs(client, result);
+}
+
+// applies JSON API request received from WS client, global JSON buffer must already be locked (and will be released)
+void handleWsJson(uint32_t clientId, const char *data, size_t len)
+{
+  bool verboseResponse = false;
+  DeserializationError error = deserializeJson(doc, data, len);
+  JsonObject root = doc.as<JsonObject>();
+  if (error || root.isNull()) {
+    releaseJSONBufferLock();
+    AsyncWebSocketClient *client = ws.client(clientId);
+    if (client) client->text(F("{\"error\":9}")); // request does not fit JSON buffer or is invalid
+    return;
+  }
+  if (root.containsKey("dt")) {
+    // client can merge changed fields into its state (see sendDeltaWs())
+    setWsClientDelta(clientId, root["dt"]);
+    root.remove("dt");
+  }
+  if (root.size() == 0) {
+    // nothing else to do
+  } else if (root["v"] && root.size() == 1) {
+    //if the received value is just "{"v":true}", send only to this client
+    verboseResponse = true;
+  } else if (root.containsKey("lv")) {
+    wsLiveClientId = root["lv"] ? clientId : 0;
+    wsLiveDelta = root["lz"] | false;
+    wsLiveFrames = WS_LIVE_KEY_INTERVAL; // (re)start with a key frame
+    wsLiveInterval = WS_LIVE_INTERVAL;
+  } else {
+    verboseResponse = deserializeState(root);
+  }
+  releaseJSONBufferLock(); // will clean fileDoc
 
-  if (!requestJSONBufferLock(12)) return;
+  AsyncWebSocketClient *client = ws.client(clientId);
+  if (client && !interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
+    if (verboseResponse) {
+      sendDataWs(client);
+    } else {
+      // we have to send something back otherwise WS connection closes
+      client->text(F("{\"success\":true}"));
+    }
+    // force broadcast in 500ms after updating client
+    //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
+  }
+}
+
+// JSON message serialized once into a chain of chunks that are sent as a text frame followed by continuation frames,
+// no buffer of the full message length is needed. Chunks are shared by all clients the message is queued for.
+class WsChunks {
+  public:
+    ~WsChunks() { for (auto &c : _chunks) free(c.data); }
+    bool append(const char *pgm);      // PROGMEM text
+    bool append(JsonStreamer &stream); // remaining stream, false if out of memory or stream failed
+
+    size_t   count() const          { return _chunks.size(); }
+    uint8_t* data(size_t i) const   { return _chunks[i].data; }
+    size_t   length(size_t i) const { return _chunks[i].len; }
 
-  JsonObject state = doc.createNestedObject("state");
-  serializeState(state);
-  JsonObject info  = doc.createNestedObject("info");
-  serializeInfo(info);
+  private:
+    typedef struct {
+      uint8_t *data;
+      size_t   len;
+    } Chunk;
+    std::vector<Chunk> _chunks;
 
-  size_t len = measureJson(doc);
-  DEBUG_PRINTF("JSON buffer size: %u for WS request (%u).\n", doc.memoryUsage(), len);
+    uint8_t* space(size_t &avail);
+};
 
-  size_t heap1 = ESP.getFreeHeap();
-  DEBUG_PRINT(F("heap ")); DEBUG_PRINTLN(ESP.getFreeHeap());
-  #ifdef ESP8266
-  if (len>heap1) {
-    DEBUG_PRINTLN(F("Out of memory (WS)!"));
+// free space at end of last chunk (a new one is added if it is full), nullptr if out of memory
+uint8_t* WsChunks::space(size_t &avail)
+{
+  if (_chunks.empty() || _chunks.back().len == WS_JSON_CHUNK_SIZE) {
+    uint8_t *p = (uint8_t*)malloc(WS_JSON_CHUNK_SIZE);
+    if (!p) return nullptr;
+    _chunks.push_back({p, 0});
+  }
+  avail = WS_JSON_CHUNK_SIZE - _chunks.back().len;
+  return _chunks.back().data + _chunks.back().len;
+}
+
+bool WsChunks::append(const char *pgm)
+{
+  size_t len = strlen_P(pgm), avail;
+  while (len) {
+    uint8_t *p = space(avail);
+    if (!p) return false;
+    size_t n = MIN(len, avail);
+    memcpy_P(p, pgm, n);
+    _chunks.back().len += n;
+    pgm += n;
+    len -= n;
+  }
+  return true;
+}
+
+bool WsChunks::append(JsonStreamer &stream)
+{
+  size_t avail;
+  for (;;) {
+    uint8_t *p = space(avail);
+    if (!p) return false;
+    size_t n = stream.read(p, avail);
+    if (!n) break;
+    _chunks.back().len += n;
+  }
+  if (!_chunks.back().len) { // stream ended at chunk boundary
+    free(_chunks.back().data);
+    _chunks.pop_back();
+  }
+  return !stream.failed() && !stream.busy() && !_chunks.empty();
+}
+
+// writes an unmasked (server) frame using the public AsyncClient API, nothing is written if it does not fit
+static size_t sendWsFrame(AsyncClient *client, bool final, uint8_t opcode, const uint8_t *data, size_t len)
+{
+  uint8_t header[4];
+  size_t headerLen = len < 126 ? 2 : 4;
+  header[0] = (final ? 0x80 : 0x00) | (opcode & 0x0F);
+  if (len < 126) header[1] = len;
+  else {
+    header[1] = 126;
+    header[2] = len >> 8;
+    header[3] = len & 0xFF;
+  }
+  if (!client->canSend() || client->space() < headerLen + len) return 0;
+  if (client->add((const char*)header, headerLen) != headerLen || client->add((const char*)data, len) != len) return 0;
+  client->send(); // data is queued even if it cannot be sent right away
+  return len;
+}
+
+// largest frame payload that fits into the TCP send buffer (including a 4 byte header)
+static size_t wsFrameWindow(AsyncClient *client)
+{
+  if (!client->canSend() || client->space() <= 4) return 0;
+  return MIN(client->space() - 4, 0xFFFFU);
+}
+
+// WS message sending shared chunks, a frame is sent once the previous one is acknowledged (like AsyncWebSocketBasicMessage)
+class WsChunkMessage : public AsyncWebSocketMessage {
+  public:
+    WsChunkMessage(const std::shared_ptr<WsChunks> &chunks) : _chunks(chunks), _chunk(0), _pos(0), _ack(0), _acked(0) { _status = WS_MSG_SENDING; }
+
+    void   ack(size_t len, uint32_t time);
+    size_t send(AsyncClient *client);
+    bool   betweenFrames() const { return _acked == _ack; }
+
+  private:
+    std::shared_ptr<WsChunks> _chunks;
+    size_t _chunk, _pos; // next data to send
+    size_t _ack, _acked; // bytes (including frame headers) sent and acknowledged
+};
+
+void WsChunkMessage::ack(size_t len, uint32_t time)
+{
+  _acked += len;
+  if (_chunk >= _chunks->count() && _acked >= _ack) _status = WS_MSG_SENT;
+}
+
+size_t WsChunkMessage::send(AsyncClient *client)
+{
+  if (_status != WS_MSG_SENDING || _acked < _ack || _chunk >= _chunks->count()) return 0;
+  size_t window = wsFrameWindow(client);
+  if (!window) return 0;
+  size_t len = MIN(_chunks->length(_chunk) - _pos, window);
+  bool final = _chunk == _chunks->count() - 1 && _pos + len == _chunks->length(_chunk);
+  uint8_t opcode = (_chunk || _pos) ? WS_CONTINUATION : WS_TEXT;
+  if (sendWsFrame(client, final, opcode, _chunks->data(_chunk) + _pos, len) != len) {
+    _status = WS_MSG_ERROR; // frame could not be written, message is dropped
+    return 0;
+  }
+  _ack += len + (len < 126 ? 2 : 4); // frame header
+  _pos += len;
+  if (_pos == _chunks->length(_chunk)) { _chunk++; _pos = 0; }
+  return len;
+}
+
+// queues message for one client or all tracked clients (except those receiving delta updates if skipDelta)
+static void queueChunksWs(const std::shared_ptr<WsChunks> &chunks, AsyncWebSocketClient *client = nullptr, bool skipDelta = false)
+{
+  if (client) {
+    client->message(new WsChunkMessage(chunks)); // deleted by client when sent
     return;
   }
-  #endif
-  buffer = ws.makeBuffer(len); // will not allocate correct memory sometimes on ESP8266
-  #ifdef ESP8266
-  size_t heap2 = ESP.getFreeHeap();
-  DEBUG_PRINT(F("heap ")); DEBUG_PRINTLN(ESP.getFreeHeap());
-  #else
-  size_t heap2 = 0; // ESP32 variants do not have the same issue and will work without checking heap allocation
-  #endif
-  if (!buffer || heap1-heap2<len) {
-    releaseJSONBufferLock();
-    DEBUG_PRINTLN(F("WS buffer allocation failed."));
-    ws.closeAll(1013); //code 1013 = temporary overload, try again later
-    ws.cleanupClients(0); //disconnect all clients to release memory
-    ws._cleanBuffers();
-    return; //out of memory
+  for (auto &c : wsClients) {
+    if (!c.id || (skipDelta && c.delta)) continue;
+    AsyncWebSocketClient *wsc = ws.client(c.id);
+    if (wsc) wsc->message(new WsChunkMessage(chunks));
   }
+}
 
-  buffer->lock();
-  serializeJson(doc, (char *)buffer->get(), len);
+void sendDataWs(AsyncWebSocketClient * client)
+{
+  if (!ws.count()) return;
 
-  DEBUG_PRINT(F("Sending WS data "));
+  // which clients need full state
+  size_t tracked = 0, deltas = 0;
+  for (auto &c : wsClients) {
+    if (c.id && !ws.client(c.id)) c.id = 0; // no longer connected
+    if (!c.id) continue;
+    tracked++;
+    if (c.delta) deltas++;
+  }
+  StateLockGuard stateGuard(12); // state must not change while it is serialized
+  if (!stateGuard) {
+    DEBUG_PRINTLN(F("WS state not sent (state in use)."));
+    return;
+  }
+  bool deltaSent = false;
+  if (!client && deltas && tracked >= ws.count()) {
+    deltaSent = sendDeltaWs();
+    if (deltaSent && deltas == tracked) return; // no client needs full state
+  }
+
+  // serialized piece by piece into chunks, if memory runs out this update is dropped (clients get the next one)
+  std::shared_ptr<WsChunks> chunks = std::make_shared<WsChunks>();
+  JsonStreamer stream(JSON_PATH_STATE_INFO);
+  if (!chunks->append(stream)) {
+    DEBUG_PRINTLN(F("WS state incomplete (out of memory)."));
+    return;
+  }
+  DEBUG_PRINTF("Sending WS data in %u chunks ", chunks->count());
+
+  queueChunksWs(chunks, client, deltaSent);
   if (client) {
-    client->text(buffer);
+    setWsClientSynced(client->id());
     DEBUG_PRINTLN(F("to a single client."));
+  } else if (deltaSent) {
+    DEBUG_PRINTLN(F("to clients without delta updates."));
   } else {
-    ws.textAll(buffer);
+    for (auto &c : wsClients) if (c.id) c.ver = wsDeltaVersion;
     DEBUG_PRINTLN(F("to multiple clients."));
   }
-  buffer->unlock();
-  ws._cleanBuffers();
-
-  releaseJSONBufferLock();
 }
 
 bool sendLiveLedsWs(uint32_t wsClient)
@@ -212,17 +625,145 @@ bool sendLiveLedsWs(uint32_t wsClient)
   return true;
 }
 
-void handleWs()
+// averaged (box filter) and brightness scaled color of output pixel x,y (scale x scale LEDs of a w x h layout)
+static uint32_t getLivePixel(size_t x, size_t y, size_t w, size_t h, size_t scale)
 {
-  if (millis() - wsLastLiveTime > WS_LIVE_INTERVAL)
-  {
-    #ifdef ESP8266
-    ws.cleanupClients(3);
+  uint32_t r = 0, g = 0, b = 0, n = 0;
+  size_t xEnd = MIN(w, (x+1)*scale), yEnd = MIN(h, (y+1)*scale);
+  for (size_t j = y*scale; j < yEnd; j++) for (size_t i = x*scale; i < xEnd; i++) {
+    uint32_t c = strip.getPixelColor(j*w + i);
+    r += qadd8(W(c), R(c)); // add white channel to RGB channels as a simple RGBW -> RGB map
+    g += qadd8(W(c), G(c));
+    b += qadd8(W(c), B(c));
+    n++;
+  }
+  if (n > 1) { r /= n; g /= n; b /= n; }
+  uint8_t bri = strip.getBrightness();
+  return RGBW32(scale8(r, bri), scale8(g, bri), scale8(b, bri), 0);
+}
+
+// sends current frame using v3 protocol (delta/RLE encoded chunks)
+static bool sendLiveFrameWs(uint32_t wsClient)
+{
+  AsyncWebSocketClient * wsc = ws.client(wsClient);
+  if (!wsc) return false;
+  if (wsc->queueLength() > 0) {
+    // client (or network) can't keep up, reduce frame rate
+    wsLiveInterval = MIN(WS_LIVE_MAX_INTERVAL, wsLiveInterval + wsLiveInterval/2);
+    return true;
+  }
+  unsigned long start = millis();
+
+  size_t w = strip.getLengthTotal(), h = 1;
+#ifndef WLED_DISABLE_2D
+  if (strip.isMatrix) {
+    w = Segment::maxWidth;
+    h = Segment::maxHeight;
+  }
+#endif
+  size_t scale = 1;
+  while (((w+scale-1)/scale) * ((h+scale-1)/scale) > WS_LIVE_MAX_PIXELS) scale++;
+  size_t ow = (w+scale-1)/scale, oh = (h+scale-1)/scale;
+
+  if (wsLivePrevLen != ow*oh*3) {
+    free(wsLivePrev);
+    wsLivePrevLen = ow*oh*3;
+    #ifdef ARDUINO_ARCH_ESP32
+    wsLivePrev = (uint8_t*)(psramFound() ? ps_malloc(wsLivePrevLen) : malloc(wsLivePrevLen));
     #else
-    ws.cleanupClients();
+    wsLivePrev = (uint8_t*)malloc(wsLivePrevLen);
     #endif
+    wsLiveFrames = WS_LIVE_KEY_INTERVAL; // layout changed, start over
+  }
+  uint8_t *chunk = (uint8_t*)malloc(WS_LIVE_CHUNK_SIZE);
+  if (!chunk) return false;
+
+  bool key = !wsLivePrev || wsLiveFrames >= WS_LIVE_KEY_INTERVAL; // without previous frame every frame is a key frame
+  if (key) wsLiveFrames = 0;
+  wsLiveFrames++;
+  chunk[0] = 'L';
+  chunk[1] = 3; //version
+  chunk[3] = wsLiveSeq++;
+  chunk[4] = ow >> 8; chunk[5] = ow & 0xFF;
+  chunk[6] = oh >> 8; chunk[7] = oh & 0xFF;
+
+  enum : uint8_t { OP_NONE, OP_LIT, OP_SKIP, OP_RPT };
+  uint8_t op = OP_NONE, n = 0; // current operation and its length
+  size_t opPos = 0, pos = 0, first = 0;
+  uint8_t last[3] = {0};
+  size_t pixels = ow*oh;
+  for (size_t p = 0; p <= pixels; p++) {
+    if (p == pixels || pos == 0 || pos + 4 > WS_LIVE_CHUNK_SIZE) {
+      if (pos) { // chunk complete
+        chunk[2] = key | (p == pixels)<<1;
+        wsc->binary(chunk, pos);
+      }
+      if (p == pixels) break;
+      chunk[8] = p >> 8; chunk[9] = p & 0xFF;
+      pos = WS_LIVE_HEADER_SIZE;
+      op = OP_NONE;
+      first = p;
+    }
+    uint32_t c = getLivePixel(p % ow, p / ow, w, h, scale);
+    uint8_t rgb[3] = {(uint8_t)R(c), (uint8_t)G(c), (uint8_t)B(c)};
+    uint8_t *prev = wsLivePrev ? wsLivePrev + p*3 : nullptr;
+    if (!key && prev && !memcmp(prev, rgb, 3)) {
+      if (op == OP_SKIP && n < 64) n++;
+      else { op = OP_SKIP; n = 1; opPos = pos++; }
+    } else {
+      if (op == OP_RPT && n < 64 && !memcmp(last, rgb, 3)) n++;
+      else if (op == OP_LIT && p > first && !memcmp(last, rgb, 3)) {
+        // repeated pixel: turn last literal into a repeat
+        if (n == 1) op = OP_RPT;
+        else { chunk[opPos] = n-2; pos -= 3; opPos = pos++; memcpy(chunk+pos, rgb, 3); pos += 3; op = OP_RPT; n = 1; }
+        n++;
+      } else if (op == OP_LIT && n < 128) {
+        memcpy(chunk+pos, rgb, 3); pos += 3; n++;
+      } else {
+        op = OP_LIT; n = 1; opPos = pos++;
+        memcpy(chunk+pos, rgb, 3); pos += 3;
+      }
+      memcpy(last, rgb, 3);
+      if (prev) memcpy(prev, rgb, 3);
+    }
+    chunk[opPos] = (op == OP_LIT ? 0x00 : op == OP_SKIP ? 0x80 : 0xC0) | (n-1);
+  }
+  free(chunk);
+
+  // adapt update rate: recover towards WS_LIVE_INTERVAL but spend at most ~25% of time encoding
+  unsigned long took = millis() - start;
+  wsLiveInterval = MAX(MAX((unsigned long)WS_LIVE_INTERVAL, 4*took), (unsigned long)(wsLiveInterval - wsLiveInterval/8));
+  wsLiveInterval = MIN(wsLiveInterval, WS_LIVE_MAX_INTERVAL);
+  return true;
+}
+
+// pushes node list changes (added/removed nodes, changed name, type, state or version) to WS clients
+static void sendNodesWs()
+{
+  uint32_t since = wsNodesVersion;
+  if (Nodes.version() == since || millis() - wsNodesTime < WS_NODES_INTERVAL) return;
+  wsNodesTime = millis();
+  wsNodesVersion = Nodes.version();
+  if (!ws.count()) return; // clients load the full list when it is shown
+
+  std::shared_ptr<WsChunks> chunks = std::make_shared<WsChunks>();
+  JsonStreamer stream(JSON_PATH_NODES, since);
+  if (chunks->append(PSTR("{\"nd\":")) && chunks->append(stream) && chunks->append(PSTR("}"))) queueChunksWs(chunks);
+}
+
+void handleWs()
+{
+  sendNodesWs();
+  if (millis() - wsLastLiveTime > (wsLiveDelta ? wsLiveInterval : WS_LIVE_INTERVAL))
+  {
+    ws.cleanupClients(WS_MAX_DELTA_CLIENTS); // every client must have a slot in wsClients
     bool success = true;
-    if (wsLiveClientId) success = sendLiveLedsWs(wsLiveClientId);
+    if (wsLiveClientId) success = wsLiveDelta ? sendLiveFrameWs(wsLiveClientId) : sendLiveLedsWs(wsLiveClientId);
+    else if (wsLivePrev) {
+      free(wsLivePrev); // live view stopped
+      wsLivePrev = nullptr;
+      wsLivePrevLen = 0;
+    }
     wsLastLiveTime = millis();
     if (!success) wsLastLiveTime -= 20; //try again in 20ms if failed due to non-empty WS queue
   }
@@ -0,0 +1,64 @@
+#include "wled.h"
+
+/*
+ * WebSocket text messages split into multiple frames (or a frame split into multiple TCP packets) are collected
+ * per client until complete (see wsEvent()). Called from the async TCP task only.
+ */
+#ifdef WLED_ENABLE_WEBSOCKETS
+
+static WsReassembly wsReassembly[WS_REASSEMBLY_SLOTS] = {};
+
+void freeWsReassembly(WsReassembly &r)
+{
+  free(r.data);
+  r = {0, nullptr, 0, 0};
+}
+
+// client disconnected
+void freeWsReassembly(uint32_t client)
+{
+  for (auto &r : wsReassembly) if (r.client == client) freeWsReassembly(r);
+}
+
+// appends part of a fragmented text message (frame number, index of data within frame and frame length as in AwsFrameInfo),
+// returns reassembly slot once the message is complete (to be freed with freeWsReassembly() after it is applied)
+// error is set if message had to be dropped (ERR_NOBUF: no free slot or out of memory, ERR_JSON: too large)
+WsReassembly* reassembleWs(uint32_t client, uint32_t frame, uint64_t index, uint64_t frameLen, bool final, const uint8_t *data, size_t len, byte &error)
+{
+  WsReassembly *r = nullptr;
+  error = ERR_NONE;
+  for (auto &s : wsReassembly) {
+    if (s.client && millis() - s.started > WS_REASSEMBLY_TIMEOUT) freeWsReassembly(s); // incomplete for too long
+    if (s.client == client) r = &s;
+  }
+  if (frame == 0 && index == 0) { // start of new message
+    if (r) freeWsReassembly(*r);
+    for (auto &s : wsReassembly) if (!s.client) { r = &s; break; }
+    if (!r) {
+      DEBUG_PRINTLN(F("WS no reassembly slot."));
+      error = ERR_NOBUF;
+      return nullptr;
+    }
+    *r = {client, nullptr, 0, millis()};
+  }
+  if (!r) return nullptr; // start was missed, dropped or timed out
+
+  if (r->len + len > WS_MAX_JSON_SIZE) {
+    DEBUG_PRINTLN(F("WS message too large."));
+    freeWsReassembly(*r);
+    error = ERR_JSON;
+    return nullptr;
+  }
+  char *p = (char*)realloc(r->data, r->len + len);
+  if (!p) {
+    freeWsReassembly(*r);
+    error = ERR_NOBUF;
+    return nullptr;
+  }
+  memcpy(p + r->len, data, len);
+  r->data = p;
+  r->len += len;
+  return (final && index + len == frameLen) ? r : nullptr;
+}
+
+#endif
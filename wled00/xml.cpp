@@ -483,6 +483,7 @@ void getSettingsJS(byte subPage, char* dest)
     [[maybe_unused]] char nS[32];
     sappend('v',SET_F("UP"),udpPort);
     sappend('v',SET_F("U2"),udpPort2);
+    sappend('c',SET_F("UM"),udpMulticast);
     sappend('v',SET_F("GS"),syncGroups);
     sappend('v',SET_F("GR"),receiveGroups);
 
@@ -496,9 +497,13 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('c',SET_F("SH"),notifyHue);
     sappend('c',SET_F("SM"),notifyMacro);
     sappend('v',SET_F("UR"),udpNumRetries);
+    sappend('c',SET_F("UD"),udpDeltaSync);
 
     sappend('c',SET_F("NL"),nodeListEnabled);
+    sappend('v',SET_F("NX"),nodeListSize);
     sappend('c',SET_F("NB"),nodeBroadcastEnabled);
+    sappend('c',SET_F("CS"),clockSyncEnabled);
+    sappend('c',SET_F("FL"),frameLockEnabled);
 
     sappend('c',SET_F("RD"),receiveDirect);
     sappend('c',SET_F("MO"),useMainSegmentOnly);